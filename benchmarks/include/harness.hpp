@@ -0,0 +1,634 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include "build_info.hpp"
+#include "json.hpp"
+#include "machine.hpp"
+#include "perf_counters.hpp"
+
+#include <mpp/util/cfg.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+	struct config
+	{
+		std::size_t warmup   = 2;
+		std::size_t reps     = 15;
+		std::size_t max_size = 4096;
+		double max_seconds   = 2.0; // Time budget of a single benchmark, min_reps repetitions run regardless
+		std::string filter;         // Only run benchmarks whose name contains this
+		std::string json_path;      // Also write the results there as JSON if not empty
+		bool counters     = false;  // Read hardware counters around the repetitions
+		bool roofline     = false;  // Place every result on the roofline of the machine
+		bool thread_sweep = false;  // Repeat every benchmark from 1 thread up to mpp::max_threads()
+	};
+
+	// Fewer repetitions a side can't make bench_compare's test significant, however big the change
+	inline constexpr auto min_reps = std::size_t{ 8 };
+
+	struct result
+	{
+		std::string name;
+		std::string buf;
+		std::size_t size;
+		std::size_t threads; // mpp::max_threads() during the run
+		double flops; // Per repetition, 0 if the benchmark only moves memory
+		double bytes; // Per repetition, the minimum traffic of reading the inputs and writing the output once
+		std::vector<double> samples_ns;
+		counter_values counters; // Per repetition, including the threads of the pool
+	};
+
+	/**
+	 * Nearest-rank percentile, p is in [0, 1]
+	 */
+	[[nodiscard]] inline auto percentile(std::vector<double> samples, double p) -> double
+	{
+		if (samples.empty())
+		{
+			return 0.0;
+		}
+
+		std::ranges::sort(samples);
+
+		const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(samples.size())));
+		return samples[std::clamp(rank, std::size_t{ 1 }, samples.size()) - 1];
+	}
+
+	[[nodiscard]] inline auto median(const std::vector<double>& samples) -> double
+	{
+		return percentile(samples, 0.5);
+	}
+
+	/**
+	 * Keeps the compiler from optimizing away a result that is never read
+	 */
+	template<typename T>
+	inline void do_not_optimize(const T& val)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "g"(&val) : "memory");
+#else
+		static const volatile void* sink = nullptr;
+		sink                             = &val;
+#endif
+	}
+
+	/**
+	 * Model name of the first CPU as reported by /proc/cpuinfo, "unknown" elsewhere
+	 */
+	[[nodiscard]] inline auto cpu_model() -> std::string
+	{
+		auto file = std::ifstream{ "/proc/cpuinfo" };
+		auto line = std::string{};
+
+		while (std::getline(file, line))
+		{
+			if (line.starts_with("model name"))
+			{
+				if (const auto colon = line.find(':'); colon != std::string::npos)
+				{
+					const auto begin = line.find_first_not_of(' ', colon + 1);
+					return begin == std::string::npos ? std::string{} : line.substr(begin);
+				}
+			}
+		}
+
+		return "unknown";
+	}
+
+	class suite
+	{
+		config cfg_;
+		std::string program_;
+		std::vector<result> results_;
+		std::size_t max_threads_ = mpp::max_threads();
+		std::map<std::size_t, machine_peaks> peaks_; // By thread count
+		bool printed_header_ = false;
+		bool warned_counters_ = false;
+
+		[[noreturn]] static void usage(const char* program)
+		{
+			std::cerr << "Usage: " << program
+					  << " [--reps N] [--warmup N] [--max-size N] [--max-seconds S] [--filter NAME] [--json PATH]"
+					  << " [--counters] [--roofline] [--thread-sweep]\n";
+			std::exit(EXIT_FAILURE);
+		}
+
+		void print_header()
+		{
+			std::cout << std::left << std::setw(36) << "benchmark" << std::setw(8) << "buf" << std::right
+					  << std::setw(7) << "size";
+
+			if (cfg_.thread_sweep)
+			{
+				std::cout << std::setw(8) << "threads";
+			}
+
+			std::cout << std::setw(7) << "reps" << std::setw(14) << "median(us)"
+					  << std::setw(14) << "p99(us)" << std::setw(11) << "GFLOP/s" << std::setw(11) << "GB/s";
+
+			if (cfg_.roofline)
+			{
+				std::cout << std::setw(8) << "AI" << std::setw(11) << "roof" << std::setw(8) << "%roof" << std::setw(8)
+						  << "bound";
+			}
+
+			if (cfg_.counters)
+			{
+				std::cout << std::setw(7) << "IPC" << std::setw(10) << "cyc/flop" << std::setw(10) << "cyc/elem"
+						  << std::setw(10) << "L1m/elem" << std::setw(10) << "LLCm/elem" << std::setw(10) << "brm/elem";
+			}
+
+			std::cout << '\n';
+			printed_header_ = true;
+		}
+
+		void print_row(const result& res)
+		{
+			if (!printed_header_)
+			{
+				print_header();
+			}
+
+			const auto med = median(res.samples_ns);
+
+			std::cout << std::left << std::setw(36) << res.name << std::setw(8) << res.buf << std::right
+					  << std::setw(7) << res.size;
+
+			if (cfg_.thread_sweep)
+			{
+				std::cout << std::setw(8) << res.threads;
+			}
+
+			std::cout << std::setw(7) << res.samples_ns.size() << std::fixed
+					  << std::setprecision(2) << std::setw(14) << med / 1e3 << std::setw(14)
+					  << percentile(res.samples_ns, 0.99) / 1e3 << std::setw(11) << res.flops / med << std::setw(11)
+					  << res.bytes / med;
+
+			if (cfg_.roofline)
+			{
+				print_roofline(res);
+			}
+
+			if (cfg_.counters)
+			{
+				print_counters(res);
+			}
+
+			std::cout << std::defaultfloat << std::endl;
+		}
+
+		/**
+		 * The arithmetic intensity, the roof it puts the result under in GFLOP/s (GB/s when it doesn't compute),
+		 * how close the result gets to it, and which ceiling it's under
+		 */
+		void print_roofline(const result& res)
+		{
+			const auto& peaks = peaks_for(res.threads);
+			const auto med    = median(res.samples_ns);
+
+			if (res.flops > 0.0)
+			{
+				const auto intensity = res.flops / res.bytes;
+				const auto roof      = std::min(peaks.gflops, intensity * peaks.gbs);
+
+				std::cout << std::setw(8) << intensity << std::setw(11) << roof << std::setw(8)
+						  << res.flops / med / roof * 100.0 << std::setw(8)
+						  << (roof < peaks.gflops ? "memory" : "compute");
+			}
+			else
+			{
+				std::cout << std::setw(8) << 0.0 << std::setw(11) << peaks.gbs << std::setw(8)
+						  << res.bytes / med / peaks.gbs * 100.0 << std::setw(8) << "memory";
+			}
+		}
+
+		[[nodiscard]] auto peaks_for(std::size_t threads) -> const machine_peaks&
+		{
+			if (const auto found = peaks_.find(threads); found != peaks_.end())
+			{
+				return found->second;
+			}
+
+			const auto& peaks = peaks_.emplace(threads, measure_peaks(threads)).first->second;
+
+			std::cout << "Roofline on " << threads << " thread(s): " << std::fixed << std::setprecision(2)
+					  << peaks.gflops << " GFLOP/s (double), " << peaks.gbs << " GB/s (STREAM triad)"
+					  << std::defaultfloat << std::endl;
+
+			return peaks;
+		}
+
+		/**
+		 * Powers of two up to the thread limit, and the limit itself
+		 */
+		[[nodiscard]] auto thread_counts() const -> std::vector<std::size_t>
+		{
+			auto out = std::vector<std::size_t>{};
+
+			for (auto threads = std::size_t{ 1 }; threads < max_threads_; threads *= 2)
+			{
+				out.push_back(threads);
+			}
+
+			out.push_back(max_threads_);
+			return out;
+		}
+
+		void print_scaling() const
+		{
+			std::cout << "\nThread scaling (efficiency = 1 thread median / (threads * median))\n"
+					  << std::left << std::setw(36) << "benchmark" << std::setw(8) << "buf" << std::right
+					  << std::setw(7) << "size" << std::setw(8) << "threads" << std::setw(14) << "median(us)"
+					  << std::setw(10) << "speedup" << std::setw(12) << "efficiency" << '\n';
+
+			auto serial_ns = 0.0;
+
+			for (const auto& res : results_)
+			{
+				const auto med = median(res.samples_ns);
+
+				// The sweep of a benchmark always starts with a single thread
+				if (res.threads == 1)
+				{
+					serial_ns = med;
+				}
+
+				const auto speedup = serial_ns / med;
+
+				std::cout << std::left << std::setw(36) << res.name << std::setw(8) << res.buf << std::right
+						  << std::setw(7) << res.size << std::setw(8) << res.threads << std::fixed
+						  << std::setprecision(2) << std::setw(14) << med / 1e3 << std::setw(10) << speedup
+						  << std::setw(11) << speedup / static_cast<double>(res.threads) * 100.0 << '%'
+						  << std::defaultfloat << '\n';
+			}
+		}
+
+		/**
+		 * Rates per flop and per element of an operand, "-" where the counters are unavailable
+		 */
+		static void print_counters(const result& res)
+		{
+			const auto ratio = [](int width, const std::optional<double>& num, std::optional<double> den) {
+				if (num && den && *den > 0.0)
+				{
+					std::cout << std::setw(width) << *num / *den;
+				}
+				else
+				{
+					std::cout << std::setw(width) << '-';
+				}
+			};
+
+			const auto elems = std::optional{ static_cast<double>(res.size) * static_cast<double>(res.size) };
+
+			ratio(7, res.counters[instructions], res.counters[cycles]);
+			ratio(10, res.counters[cycles], res.flops);
+			ratio(10, res.counters[cycles], elems);
+			ratio(10, res.counters[l1d_read_misses], elems);
+			ratio(10, res.counters[llc_misses], elems);
+			ratio(10, res.counters[branch_misses], elems);
+		}
+
+		void warn_counters(const std::string& error)
+		{
+			if (!error.empty() && !warned_counters_)
+			{
+				std::cerr << "Some perf counters are unavailable (" << error
+						  << "), check /proc/sys/kernel/perf_event_paranoid and whether the machine exposes a PMU\n";
+				warned_counters_ = true;
+			}
+		}
+
+		void write_json(std::ostream& os) const
+		{
+			const auto field = [&](std::string_view key, std::string_view val, bool last = false) {
+				os << "    ";
+				json::write_string(os, key);
+				os << ": ";
+				json::write_string(os, val);
+				os << (last ? "\n" : ",\n");
+			};
+
+			os << std::setprecision(std::numeric_limits<double>::max_digits10);
+			os << "{\n  \"context\": {\n";
+			field("program", program_);
+			field("git_sha", build_info::git_sha);
+			field("compiler", build_info::compiler);
+			field("build_type", build_info::build_type);
+			field("flags", build_info::flags);
+			field("cpu", cpu_model());
+			os << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+
+			if (!peaks_.empty())
+			{
+				os << "    \"roofline\": [";
+
+				for (auto first = true; const auto& [threads, peaks] : peaks_)
+				{
+					os << (first ? "" : ", ") << "{\"threads\": " << threads << ", \"peak_gflops\": " << peaks.gflops
+					   << ", \"stream_gbs\": " << peaks.gbs << "}";
+					first = false;
+				}
+
+				os << "],\n";
+			}
+
+			os << "    \"timestamp\": "
+			   << std::chrono::duration_cast<std::chrono::seconds>(
+					  std::chrono::system_clock::now().time_since_epoch())
+					  .count()
+			   << "\n  },\n  \"benchmarks\": [";
+
+			for (auto idx = std::size_t{}; idx < results_.size(); ++idx)
+			{
+				const auto& res = results_[idx];
+
+				os << (idx == 0 ? "\n" : ",\n") << "    {\"name\": ";
+				json::write_string(os, res.name);
+				os << ", \"buf\": ";
+				json::write_string(os, res.buf);
+				os << ", \"size\": " << res.size << ", \"threads\": " << res.threads << ", \"flops\": " << res.flops
+				   << ", \"bytes\": " << res.bytes << ", \"samples_ns\": [";
+
+				for (auto sample = std::size_t{}; sample < res.samples_ns.size(); ++sample)
+				{
+					os << (sample == 0 ? "" : ", ") << res.samples_ns[sample];
+				}
+
+				os << "], \"counters\": {";
+
+				// Unavailable events are left out
+				auto first = true;
+
+				for (auto event = std::size_t{}; event < counter_count; ++event)
+				{
+					if (res.counters[event])
+					{
+						os << (first ? "" : ", ") << '"' << counter_names[event] << "\": " << *res.counters[event];
+						first = false;
+					}
+				}
+
+				os << "}}";
+			}
+
+			os << "\n  ]\n}\n";
+		}
+
+		/**
+		 * Warms fn up, then times its repetitions into res
+		 */
+		template<typename Fn>
+		void measure(result res, Fn& fn)
+		{
+			using clock = std::chrono::steady_clock;
+
+			// Measure the roof before anything is timed, so its report doesn't land in the middle of a row
+			if (cfg_.roofline)
+			{
+				std::ignore = peaks_for(res.threads);
+			}
+
+			const auto time_once = [&]() {
+				const auto start = clock::now();
+				do_not_optimize(fn());
+				return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+			};
+
+			const auto budget_ns = cfg_.max_seconds * 1e9;
+
+			// Warm up caches, the allocator and the thread pool, unless a single run already blows the budget
+			for (auto rep = std::size_t{}; rep < cfg_.warmup; ++rep)
+			{
+				if (time_once() > budget_ns)
+				{
+					break;
+				}
+			}
+
+			auto total_ns = 0.0;
+
+			// Opened after the warmup so the thread pool's workers exist and get counted
+			auto counters = std::optional<perf_counters>{};
+
+			if (cfg_.counters)
+			{
+				counters.emplace();
+				warn_counters(counters->error());
+				counters->start();
+			}
+
+			for (auto rep = std::size_t{}; rep < cfg_.reps && (rep < min_reps || total_ns < budget_ns); ++rep)
+			{
+				res.samples_ns.push_back(time_once());
+				total_ns += res.samples_ns.back();
+			}
+
+			if (counters)
+			{
+				res.counters = counters->stop();
+
+				for (auto& count : res.counters)
+				{
+					if (count)
+					{
+						*count /= static_cast<double>(res.samples_ns.size());
+					}
+				}
+			}
+
+			print_row(res);
+			results_.push_back(std::move(res));
+		}
+
+	public:
+		suite(int argc, char** argv) : program_(argc > 0 ? argv[0] : "")
+		{
+			if (const auto slash = program_.find_last_of("/\\"); slash != std::string::npos)
+			{
+				program_.erase(0, slash + 1);
+			}
+
+			const auto next = [&](int& idx) -> std::string_view {
+				if (idx + 1 >= argc)
+				{
+					usage(argv[0]);
+				}
+
+				return argv[++idx];
+			};
+
+			for (auto idx = 1; idx < argc; ++idx)
+			{
+				const auto arg = std::string_view{ argv[idx] };
+
+				if (arg == "--reps")
+				{
+					cfg_.reps = std::max(std::stoul(std::string{ next(idx) }), min_reps);
+				}
+				else if (arg == "--warmup")
+				{
+					cfg_.warmup = std::stoul(std::string{ next(idx) });
+				}
+				else if (arg == "--max-size")
+				{
+					cfg_.max_size = std::stoul(std::string{ next(idx) });
+				}
+				else if (arg == "--max-seconds")
+				{
+					cfg_.max_seconds = std::stod(std::string{ next(idx) });
+				}
+				else if (arg == "--filter")
+				{
+					cfg_.filter = next(idx);
+				}
+				else if (arg == "--json")
+				{
+					cfg_.json_path = next(idx);
+				}
+				else if (arg == "--counters")
+				{
+					cfg_.counters = true;
+				}
+				else if (arg == "--roofline")
+				{
+					cfg_.roofline = true;
+				}
+				else if (arg == "--thread-sweep")
+				{
+					cfg_.thread_sweep = true;
+				}
+				else
+				{
+					usage(argv[0]);
+				}
+			}
+		}
+
+		[[nodiscard]] auto cfg() const noexcept -> const config&
+		{
+			return cfg_;
+		}
+
+		[[nodiscard]] auto results() const noexcept -> const std::vector<result>&
+		{
+			return results_;
+		}
+
+		/**
+		 * Powers of two from min_size up to the configured maximum
+		 */
+		[[nodiscard]] auto sizes(std::size_t min_size = 2) const -> std::vector<std::size_t>
+		{
+			auto out = std::vector<std::size_t>{};
+
+			for (auto size = min_size; size <= cfg_.max_size; size *= 2)
+			{
+				out.push_back(size);
+			}
+
+			return out;
+		}
+
+		[[nodiscard]] auto enabled(std::string_view name) const -> bool
+		{
+			return cfg_.filter.empty() || name.find(cfg_.filter) != std::string_view::npos;
+		}
+
+		/**
+		 * Times fn, the inputs should be prepared beforehand so only the operation itself is measured
+		 */
+		template<typename Fn>
+		void run(const std::string& name,
+			const std::string& buf,
+			std::size_t size,
+			double flops,
+			double bytes,
+			Fn&& fn)
+		{
+			if (!enabled(name))
+			{
+				return;
+			}
+
+			if (!cfg_.thread_sweep)
+			{
+				measure(result{ name, buf, size, mpp::max_threads(), flops, bytes, {}, {} }, fn);
+				return;
+			}
+
+			for (const auto threads : thread_counts())
+			{
+				mpp::set_max_threads(threads);
+				measure(result{ name, buf, size, threads, flops, bytes, {}, {} }, fn);
+			}
+
+			mpp::set_max_threads(max_threads_);
+		}
+
+		/**
+		 * Writes the JSON results if asked to, returns the exit code of the benchmark
+		 */
+		[[nodiscard]] auto finish() const -> int
+		{
+			if (cfg_.thread_sweep)
+			{
+				print_scaling();
+			}
+
+			if (cfg_.json_path.empty())
+			{
+				return EXIT_SUCCESS;
+			}
+
+			auto file = std::ofstream{ cfg_.json_path };
+			write_json(file);
+			file.close();
+
+			if (!file)
+			{
+				std::cerr << "Failed to write " << cfg_.json_path << '\n';
+				return EXIT_FAILURE;
+			}
+
+			return EXIT_SUCCESS;
+		}
+	};
+} // namespace bench
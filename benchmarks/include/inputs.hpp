@@ -0,0 +1,80 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/mat.hpp>
+
+#include <cstddef>
+#include <random>
+
+namespace bench
+{
+	/**
+	 * Uniform values in [-1, 1], always seeded the same so runs are comparable
+	 */
+	template<typename T>
+	[[nodiscard]] auto random_mat(std::size_t rows, std::size_t cols, unsigned seed = 42) -> mpp::mat<T>
+	{
+		auto gen  = std::mt19937{ seed };
+		auto dist = std::uniform_real_distribution<double>{ -1.0, 1.0 };
+
+		return mpp::mat<T>(rows, cols, [&]() {
+			return static_cast<T>(dist(gen));
+		});
+	}
+
+	/**
+	 * Random matrix with a dominant diagonal, so factorizations without pivoting stay well conditioned
+	 */
+	template<typename T>
+	[[nodiscard]] auto well_conditioned_mat(std::size_t n, unsigned seed = 42) -> mpp::mat<T>
+	{
+		auto out = random_mat<T>(n, n, seed);
+
+		for (auto idx = std::size_t{}; idx < n; ++idx)
+		{
+			out(idx, idx) += static_cast<T>(n);
+		}
+
+		return out;
+	}
+
+	/**
+	 * Well conditioned lower (or upper) triangular matrix
+	 */
+	template<typename T>
+	[[nodiscard]] auto triangular_mat(std::size_t n, bool lower, unsigned seed = 42) -> mpp::mat<T>
+	{
+		auto out = well_conditioned_mat<T>(n, seed);
+
+		for (auto row = std::size_t{}; row < n; ++row)
+		{
+			for (auto col = std::size_t{}; col < n; ++col)
+			{
+				if (lower ? col > row : col < row)
+				{
+					out(row, col) = T{};
+				}
+			}
+		}
+
+		return out;
+	}
+} // namespace bench
@@ -0,0 +1,343 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/**
+ * Just enough JSON to write benchmark results and read them back, not a general purpose library
+ */
+namespace bench::json
+{
+	struct value;
+
+	using array  = std::vector<value>;
+	using object = std::vector<std::pair<std::string, value>>;
+
+	struct value
+	{
+		std::variant<std::nullptr_t, bool, double, std::string, array, object> data;
+
+		[[nodiscard]] auto find(std::string_view key) const -> const value*
+		{
+			if (const auto* obj = std::get_if<object>(&data))
+			{
+				for (const auto& [name, val] : *obj)
+				{
+					if (name == key)
+					{
+						return &val;
+					}
+				}
+			}
+
+			return nullptr;
+		}
+
+		[[nodiscard]] auto at(std::string_view key) const -> const value&
+		{
+			if (const auto* val = find(key))
+			{
+				return *val;
+			}
+
+			throw std::runtime_error("Missing JSON key: " + std::string{ key });
+		}
+
+		[[nodiscard]] auto num() const -> double
+		{
+			return std::get<double>(data);
+		}
+
+		[[nodiscard]] auto str() const -> const std::string&
+		{
+			return std::get<std::string>(data);
+		}
+
+		[[nodiscard]] auto arr() const -> const array&
+		{
+			return std::get<array>(data);
+		}
+	};
+
+	inline void write_string(std::ostream& os, std::string_view str)
+	{
+		static constexpr auto hex = std::string_view{ "0123456789abcdef" };
+
+		os << '"';
+
+		for (const auto c : str)
+		{
+			switch (c)
+			{
+			case '"':
+				os << "\\\"";
+				break;
+			case '\\':
+				os << "\\\\";
+				break;
+			case '\n':
+				os << "\\n";
+				break;
+			case '\t':
+				os << "\\t";
+				break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20)
+				{
+					const auto code = static_cast<unsigned char>(c);
+					os << "\\u00" << hex[code >> 4] << hex[code & 0xf];
+				}
+				else
+				{
+					os << c;
+				}
+			}
+		}
+
+		os << '"';
+	}
+
+	class parser
+	{
+		std::string_view text_;
+		std::size_t pos_ = 0;
+
+		[[noreturn]] void fail(const char* what) const
+		{
+			throw std::runtime_error(std::string{ "Invalid JSON at offset " } + std::to_string(pos_) + ": " + what);
+		}
+
+		void skip_ws()
+		{
+			while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_])))
+			{
+				++pos_;
+			}
+		}
+
+		[[nodiscard]] auto peek() -> char
+		{
+			skip_ws();
+
+			if (pos_ >= text_.size())
+			{
+				fail("unexpected end");
+			}
+
+			return text_[pos_];
+		}
+
+		void expect(char c)
+		{
+			if (peek() != c)
+			{
+				fail("unexpected character");
+			}
+
+			++pos_;
+		}
+
+		[[nodiscard]] auto consume(std::string_view word) -> bool
+		{
+			skip_ws();
+
+			if (text_.substr(pos_, word.size()) == word)
+			{
+				pos_ += word.size();
+				return true;
+			}
+
+			return false;
+		}
+
+		[[nodiscard]] auto parse_string() -> std::string
+		{
+			expect('"');
+
+			auto out = std::string{};
+
+			while (pos_ < text_.size() && text_[pos_] != '"')
+			{
+				auto c = text_[pos_++];
+
+				if (c == '\\')
+				{
+					if (pos_ >= text_.size())
+					{
+						fail("unterminated escape");
+					}
+
+					switch (c = text_[pos_++])
+					{
+					case 'n':
+						c = '\n';
+						break;
+					case 't':
+						c = '\t';
+						break;
+					case 'r':
+						c = '\r';
+						break;
+					case 'b':
+						c = '\b';
+						break;
+					case 'f':
+						c = '\f';
+						break;
+					case 'u':
+						// Only the control characters written by write_string are expected here
+						if (pos_ + 4 > text_.size())
+						{
+							fail("truncated unicode escape");
+						}
+
+						c = static_cast<char>(std::stoi(std::string{ text_.substr(pos_, 4) }, nullptr, 16));
+						pos_ += 4;
+						break;
+					default:
+						break;
+					}
+				}
+
+				out.push_back(c);
+			}
+
+			if (pos_ >= text_.size())
+			{
+				fail("unterminated string");
+			}
+
+			++pos_;
+			return out;
+		}
+
+		[[nodiscard]] auto parse_number() -> double
+		{
+			const auto begin = text_.data() + pos_;
+			auto* end        = static_cast<char*>(nullptr);
+			const auto num   = std::strtod(begin, &end);
+
+			if (end == begin)
+			{
+				fail("expected a value");
+			}
+
+			pos_ += static_cast<std::size_t>(end - begin);
+			return num;
+		}
+
+		[[nodiscard]] auto parse_value() -> value
+		{
+			switch (peek())
+			{
+			case '{':
+			{
+				++pos_;
+				auto obj = object{};
+
+				if (peek() == '}')
+				{
+					++pos_;
+					return { std::move(obj) };
+				}
+
+				do
+				{
+					auto key = parse_string();
+					expect(':');
+					obj.emplace_back(std::move(key), parse_value());
+				} while (consume(","));
+
+				expect('}');
+				return { std::move(obj) };
+			}
+			case '[':
+			{
+				++pos_;
+				auto arr = array{};
+
+				if (peek() == ']')
+				{
+					++pos_;
+					return { std::move(arr) };
+				}
+
+				do
+				{
+					arr.push_back(parse_value());
+				} while (consume(","));
+
+				expect(']');
+				return { std::move(arr) };
+			}
+			case '"':
+				return { parse_string() };
+			default:
+				if (consume("true"))
+				{
+					return { true };
+				}
+
+				if (consume("false"))
+				{
+					return { false };
+				}
+
+				if (consume("null"))
+				{
+					return { nullptr };
+				}
+
+				return { parse_number() };
+			}
+		}
+
+	public:
+		explicit parser(std::string_view text) : text_(text) {}
+
+		[[nodiscard]] auto parse() -> value
+		{
+			auto out = parse_value();
+			skip_ws();
+
+			if (pos_ != text_.size())
+			{
+				fail("trailing characters");
+			}
+
+			return out;
+		}
+	};
+
+	[[nodiscard]] inline auto parse(std::string_view text) -> value
+	{
+		return parser{ text }.parse();
+	}
+} // namespace bench::json
@@ -0,0 +1,179 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+	/**
+	 * Ceilings of the roofline model
+	 */
+	struct machine_peaks
+	{
+		double gflops; // Double precision
+		double gbs;    // STREAM triad
+	};
+
+	namespace detail
+	{
+		/**
+		 * Runs fn(thread) on `threads` threads at once (the caller being one of them) and returns the wall time
+		 */
+		template<typename Fn>
+		[[nodiscard]] auto time_on_threads(std::size_t threads, Fn fn) -> double
+		{
+			const auto start = std::chrono::steady_clock::now();
+
+			{
+				auto workers = std::vector<std::jthread>{};
+
+				for (auto thread = std::size_t{ 1 }; thread < threads; ++thread)
+				{
+					workers.emplace_back(fn, thread);
+				}
+
+				fn(std::size_t{});
+			}
+
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		// Volatile stores keep the measured work from being optimized away
+		inline volatile auto sink = 0.0;
+
+		// Enough independent chains to hide the latency of the FP pipes, the compiler vectorizes across them
+		inline constexpr auto peak_lanes = std::size_t{ 64 };
+		inline constexpr auto peak_iters = std::size_t{ 1 } << 22;
+
+		[[nodiscard]] inline auto peak_kernel(double seed) -> double
+		{
+			auto acc = std::array<double, peak_lanes>{};
+			acc.fill(seed);
+
+			// Converges to 1 instead of overflowing or going subnormal
+			const auto mul = 0.999999;
+			const auto add = 0.000001;
+
+			for (auto iter = std::size_t{}; iter < peak_iters; ++iter)
+			{
+				for (auto& lane : acc)
+				{
+					lane = lane * mul + add;
+				}
+			}
+
+			auto sum = 0.0;
+
+			for (const auto lane : acc)
+			{
+				sum += lane;
+			}
+
+			return sum;
+		}
+	} // namespace detail
+
+	/**
+	 * Double precision GFLOP/s of `threads` threads doing independent multiply-adds. It's compiled with the flags of
+	 * the benchmarks, so it's the peak their code generation can reach (e.g. without FMA unless it's enabled)
+	 */
+	[[nodiscard]] inline auto measure_peak_gflops(std::size_t threads) -> double
+	{
+		auto best = 0.0;
+
+		for (auto rep = 0; rep < 3; ++rep)
+		{
+			const auto seconds = detail::time_on_threads(threads, [](std::size_t thread) {
+				detail::sink = detail::peak_kernel(static_cast<double>(thread) + 2.0);
+			});
+
+			const auto flops =
+				2.0 * static_cast<double>(detail::peak_lanes * detail::peak_iters) * static_cast<double>(threads);
+
+			best = std::max(best, flops / seconds / 1e9);
+		}
+
+		return best;
+	}
+
+	/**
+	 * GB/s of the STREAM triad a = b + s * c on `threads` threads, over arrays far bigger than any cache. Like STREAM,
+	 * only the 24 bytes an element reads and writes are counted (not the write-allocate of a)
+	 */
+	[[nodiscard]] inline auto measure_stream_gbs(std::size_t threads) -> double
+	{
+		constexpr auto elems = std::size_t{ 1 } << 23;
+		constexpr auto reps  = 5;
+
+		const auto a = std::make_unique_for_overwrite<double[]>(elems);
+		const auto b = std::make_unique_for_overwrite<double[]>(elems);
+		const auto c = std::make_unique_for_overwrite<double[]>(elems);
+
+		const auto chunk_of = [&](std::size_t thread) {
+			const auto chunk = (elems + threads - 1) / threads;
+			return std::pair{ std::min(thread * chunk, elems), std::min((thread + 1) * chunk, elems) };
+		};
+
+		// First touch from the thread that uses the chunk, so the pages end up on its NUMA node
+		std::ignore = detail::time_on_threads(threads, [&](std::size_t thread) {
+			const auto [begin, end] = chunk_of(thread);
+
+			for (auto idx = begin; idx < end; ++idx)
+			{
+				a[idx] = 0.0;
+				b[idx] = 1.0;
+				c[idx] = 2.0;
+			}
+		});
+
+		auto best = 0.0;
+
+		for (auto rep = 0; rep < reps; ++rep)
+		{
+			const auto seconds = detail::time_on_threads(threads, [&](std::size_t thread) {
+				const auto [begin, end] = chunk_of(thread);
+
+				for (auto idx = begin; idx < end; ++idx)
+				{
+					a[idx] = b[idx] + 3.0 * c[idx];
+				}
+			});
+
+			best = std::max(best, 24.0 * static_cast<double>(elems) / seconds / 1e9);
+		}
+
+		detail::sink = a[elems / 2];
+		return best;
+	}
+
+	[[nodiscard]] inline auto measure_peaks(std::size_t threads) -> machine_peaks
+	{
+		return { measure_peak_gflops(threads), measure_stream_gbs(threads) };
+	}
+} // namespace bench
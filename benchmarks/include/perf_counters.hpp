@@ -0,0 +1,246 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+	#define BENCH_HAS_PERF_EVENTS
+
+	#include <linux/perf_event.h>
+	#include <sys/ioctl.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+
+	#include <cerrno>
+	#include <cstdint>
+	#include <cstring>
+	#include <filesystem>
+	#include <vector>
+#endif
+
+namespace bench
+{
+	inline constexpr auto counter_names =
+		std::array{ "cycles", "instructions", "l1d_read_misses", "llc_misses", "branch_misses" };
+
+	inline constexpr auto counter_count = counter_names.size();
+
+	enum counter : std::size_t
+	{
+		cycles,
+		instructions,
+		l1d_read_misses,
+		llc_misses,
+		branch_misses
+	};
+
+	/**
+	 * Counts of each event, empty if the event couldn't be counted on this machine
+	 */
+	using counter_values = std::array<std::optional<double>, counter_count>;
+
+	/**
+	 * Hardware counters of every thread of the process (so the thread pool's workers are included) through Linux's
+	 * perf_event_open. Threads spawned after construction aren't counted, so warm the pool up first.
+	 * Events are opened separately rather than as a group so the kernel can multiplex them on PMUs with few slots,
+	 * the counts are scaled by the fraction of time they actually ran
+	 */
+	class perf_counters
+	{
+#ifdef BENCH_HAS_PERF_EVENTS
+		std::array<std::vector<int>, counter_count> fds_;
+		std::string error_;
+
+		[[nodiscard]] static auto attr_of(std::size_t event) -> perf_event_attr
+		{
+			auto attr        = perf_event_attr{};
+			attr.size        = sizeof(perf_event_attr);
+			attr.disabled    = 1;
+			attr.exclude_hv  = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+			// Counting the kernel needs perf_event_paranoid <= 1, the kernels we benchmark barely enter it anyway
+			attr.exclude_kernel = 1;
+
+			switch (event)
+			{
+			case cycles:
+				attr.type   = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_CPU_CYCLES;
+				break;
+			case instructions:
+				attr.type   = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+				break;
+			case l1d_read_misses:
+				attr.type   = PERF_TYPE_HW_CACHE;
+				attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+							  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+				break;
+			case llc_misses:
+				attr.type   = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_CACHE_MISSES;
+				break;
+			default:
+				attr.type   = PERF_TYPE_HARDWARE;
+				attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+				break;
+			}
+
+			return attr;
+		}
+
+		void for_each_fd(unsigned long request)
+		{
+			for (const auto& fds : fds_)
+			{
+				for (const auto fd : fds)
+				{
+					ioctl(fd, request, 0);
+				}
+			}
+		}
+
+	public:
+		perf_counters()
+		{
+			auto tids = std::vector<pid_t>{};
+
+			for (const auto& task : std::filesystem::directory_iterator{ "/proc/self/task" })
+			{
+				tids.push_back(static_cast<pid_t>(std::stol(task.path().filename().string())));
+			}
+
+			for (auto event = std::size_t{}; event < counter_count; ++event)
+			{
+				auto attr = attr_of(event);
+
+				for (const auto tid : tids)
+				{
+					const auto fd = syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0UL);
+
+					if (fd < 0)
+					{
+						// A thread may have exited in the meantime, but any other failure means the event is unusable
+						if (errno == ESRCH)
+						{
+							continue;
+						}
+
+						error_ = std::string{ counter_names[event] } + ": " + std::strerror(errno);
+
+						for (const auto opened : fds_[event])
+						{
+							close(opened);
+						}
+
+						fds_[event].clear();
+						break;
+					}
+
+					fds_[event].push_back(static_cast<int>(fd));
+				}
+			}
+		}
+
+		~perf_counters()
+		{
+			for (const auto& fds : fds_)
+			{
+				for (const auto fd : fds)
+				{
+					close(fd);
+				}
+			}
+		}
+
+		perf_counters(const perf_counters&)                    = delete;
+		perf_counters(perf_counters&&)                         = delete;
+		auto operator=(const perf_counters&) -> perf_counters& = delete;
+		auto operator=(perf_counters&&) -> perf_counters&      = delete;
+
+		/**
+		 * Why the last unavailable event couldn't be opened, empty if all of them were
+		 */
+		[[nodiscard]] auto error() const -> const std::string&
+		{
+			return error_;
+		}
+
+		void start()
+		{
+			for_each_fd(PERF_EVENT_IOC_RESET);
+			for_each_fd(PERF_EVENT_IOC_ENABLE);
+		}
+
+		[[nodiscard]] auto stop() -> counter_values
+		{
+			for_each_fd(PERF_EVENT_IOC_DISABLE);
+
+			auto out = counter_values{};
+
+			for (auto event = std::size_t{}; event < counter_count; ++event)
+			{
+				if (fds_[event].empty())
+				{
+					continue;
+				}
+
+				auto total = 0.0;
+
+				for (const auto fd : fds_[event])
+				{
+					// value, time enabled, time running
+					auto buf = std::array<std::uint64_t, 3>{};
+
+					if (read(fd, buf.data(), sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)) || buf[2] == 0)
+					{
+						continue;
+					}
+
+					total += static_cast<double>(buf[0]) * static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+				}
+
+				out[event] = total;
+			}
+
+			return out;
+		}
+#else
+	public:
+		[[nodiscard]] auto error() const -> const std::string&
+		{
+			static const auto error = std::string{ "perf events are only supported on Linux" };
+			return error;
+		}
+
+		void start() {}
+
+		[[nodiscard]] auto stop() -> counter_values
+		{
+			return {};
+		}
+#endif
+	};
+} // namespace bench
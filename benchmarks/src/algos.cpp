@@ -0,0 +1,121 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <mpp/algo.hpp>
+#include <mpp/mat.hpp>
+
+#include "harness.hpp"
+#include "inputs.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+using namespace mpp;
+
+namespace
+{
+	template<typename Mat, typename Vec>
+	void bench_algos(bench::suite& suite,
+		const std::string& buf,
+		const Mat& a,
+		const Mat& lower,
+		const Mat& upper,
+		const Vec& b)
+	{
+		const auto size = a.rows();
+		const auto half = size / 2;
+		const auto n    = static_cast<double>(size);
+		const auto elem = static_cast<double>(sizeof(typename Mat::value_type));
+
+		// Nominal flop counts of the kernels as they're implemented: LU without pivoting is 2n^3/3, and the inverse
+		// adds a forward and a backward substitution (2n^2 together) for every column
+		suite.run("det", buf, size, 2 * n * n * n / 3, n * n * elem, [&]() {
+			return det(a);
+		});
+		suite.run("lu", buf, size, 2 * n * n * n / 3, 3 * n * n * elem, [&]() {
+			return lu(a);
+		});
+		suite.run("inv", buf, size, 2 * n * n * n / 3 + 2 * n * n * n, 2 * n * n * elem, [&]() {
+			return inv(a);
+		});
+		suite.run("trps", buf, size, 0, 2 * n * n * elem, [&]() {
+			return trps(a);
+		});
+		suite.run("block (top left quarter)", buf, size, 0, 2 * static_cast<double>(half * half) * elem, [&]() {
+			return block(a, std::size_t{}, std::size_t{}, half - 1, half - 1);
+		});
+		suite.run("fwd_sub", buf, size, n * n, (n * n + 2 * n) * elem, [&]() {
+			return fwd_sub(lower, b);
+		});
+		suite.run("back_sub", buf, size, n * n, (n * n + 2 * n) * elem, [&]() {
+			return back_sub(upper, b);
+		});
+	}
+
+	template<typename T>
+	void bench_dyn(bench::suite& suite, std::size_t size)
+	{
+		const auto a     = bench::well_conditioned_mat<T>(size);
+		const auto lower = bench::triangular_mat<T>(size, true);
+		const auto upper = bench::triangular_mat<T>(size, false);
+		const auto b     = bench::random_mat<T>(size, 1);
+
+		bench_algos(suite, "vector", a, lower, upper, b);
+	}
+
+	template<typename T, std::size_t N>
+	void bench_fixed(bench::suite& suite)
+	{
+		using mat_t = mat<T, std::array<T, N * N>>;
+		using vec_t = mat<T, std::array<T, N>>;
+
+		if (N > suite.cfg().max_size)
+		{
+			return;
+		}
+
+		const auto a     = mat_t{ bench::well_conditioned_mat<T>(N) };
+		const auto lower = mat_t{ bench::triangular_mat<T>(N, true) };
+		const auto upper = mat_t{ bench::triangular_mat<T>(N, false) };
+		const auto b     = vec_t{ bench::random_mat<T>(N, 1) };
+
+		bench_algos(suite, "array", a, lower, upper, b);
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	auto suite = bench::suite{ argc, argv };
+
+	for (const auto size : suite.sizes())
+	{
+		bench_dyn<double>(suite, size);
+	}
+
+	// Fixed buffers live inside the matrix object (and on the stack here), so they're only swept over small sizes
+	bench_fixed<double, 2>(suite);
+	bench_fixed<double, 4>(suite);
+	bench_fixed<double, 8>(suite);
+	bench_fixed<double, 16>(suite);
+	bench_fixed<double, 32>(suite);
+	bench_fixed<double, 64>(suite);
+
+	return suite.finish();
+}
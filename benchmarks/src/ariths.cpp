@@ -0,0 +1,114 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <mpp/algo/trps.hpp>
+#include <mpp/arith.hpp>
+#include <mpp/mat.hpp>
+
+#include "harness.hpp"
+#include "inputs.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+using namespace mpp;
+
+namespace
+{
+	template<typename Mat>
+	void bench_ariths(bench::suite& suite, const std::string& buf, const Mat& a, const Mat& b)
+	{
+		using value_type = typename Mat::value_type;
+
+		const auto size   = a.rows();
+		const auto n      = static_cast<double>(size);
+		const auto elem   = static_cast<double>(sizeof(value_type));
+		const auto suffix = std::string{ std::is_same_v<value_type, float> ? " (float)" : " (double)" };
+
+		suite.run("operator*" + suffix, buf, size, 2 * n * n * n, 3 * n * n * elem, [&]() {
+			return Mat{ a * b };
+		});
+		suite.run("operator* lazy trps" + suffix, buf, size, 2 * n * n * n, 3 * n * n * elem, [&]() {
+			return Mat{ trps(a, lazy) * b };
+		});
+		suite.run("operator+" + suffix, buf, size, n * n, 3 * n * n * elem, [&]() {
+			return Mat{ a + b };
+		});
+		suite.run("operator-" + suffix, buf, size, n * n, 3 * n * n * elem, [&]() {
+			return Mat{ a - b };
+		});
+		suite.run("operator* scalar" + suffix, buf, size, n * n, 2 * n * n * elem, [&]() {
+			return Mat{ a * value_type{ 2 } };
+		});
+		suite.run("operator/ scalar" + suffix, buf, size, n * n, 2 * n * n * elem, [&]() {
+			return Mat{ a / value_type{ 2 } };
+		});
+	}
+
+	template<typename T>
+	void bench_dyn(bench::suite& suite, std::size_t size)
+	{
+		bench_ariths(suite, "vector", bench::random_mat<T>(size, size, 1), bench::random_mat<T>(size, size, 2));
+	}
+
+	template<typename T, std::size_t N>
+	void bench_fixed(bench::suite& suite)
+	{
+		using mat_t = mat<T, std::array<T, N * N>>;
+
+		if (N > suite.cfg().max_size)
+		{
+			return;
+		}
+
+		bench_ariths(suite,
+			"array",
+			mat_t{ bench::random_mat<T>(N, N, 1) },
+			mat_t{ bench::random_mat<T>(N, N, 2) });
+	}
+
+	template<typename T>
+	void bench_type(bench::suite& suite)
+	{
+		for (const auto size : suite.sizes())
+		{
+			bench_dyn<T>(suite, size);
+		}
+
+		// Fixed buffers live inside the matrix object (and on the stack here), so they're only swept over small sizes
+		bench_fixed<T, 2>(suite);
+		bench_fixed<T, 4>(suite);
+		bench_fixed<T, 8>(suite);
+		bench_fixed<T, 16>(suite);
+		bench_fixed<T, 32>(suite);
+		bench_fixed<T, 64>(suite);
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	auto suite = bench::suite{ argc, argv };
+
+	bench_type<float>(suite);
+	bench_type<double>(suite);
+
+	return suite.finish();
+}
@@ -0,0 +1,308 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "harness.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+	// Regressions fail the comparison with EXIT_FAILURE, bad invocations and unreadable files with this
+	constexpr auto exit_usage = 2;
+
+	struct options
+	{
+		std::string old_path;
+		std::string new_path;
+		double threshold = 0.05; // Relative slowdown of the median tolerated before failing
+		double alpha     = 0.05; // Significance level of the Mann-Whitney U test
+	};
+
+	[[noreturn]] void usage(const char* program)
+	{
+		std::cerr << "Usage: " << program << " OLD.json NEW.json [--threshold FRACTION] [--alpha P]\n";
+		std::exit(exit_usage);
+	}
+
+	[[nodiscard]] auto read_results(const std::string& path) -> bench::json::value
+	{
+		auto file = std::ifstream{ path };
+
+		if (!file)
+		{
+			throw std::runtime_error("Failed to open " + path);
+		}
+
+		auto buffer = std::stringstream{};
+		buffer << file.rdbuf();
+		return bench::json::parse(buffer.str());
+	}
+
+	[[nodiscard]] auto samples_of(const bench::json::value& res) -> std::vector<double>
+	{
+		auto out = std::vector<double>{};
+
+		for (const auto& sample : res.at("samples_ns").arr())
+		{
+			out.push_back(sample.num());
+		}
+
+		return out;
+	}
+
+	/**
+	 * Two-sided p-value of the Mann-Whitney U test, using the normal approximation with tie and continuity
+	 * corrections. It's rough below bench::min_reps samples a side, where even a complete separation can't reach
+	 * p < 0.05
+	 */
+	[[nodiscard]] auto mann_whitney(const std::vector<double>& lhs, const std::vector<double>& rhs) -> double
+	{
+		struct ranked
+		{
+			double val;
+			bool from_lhs;
+		};
+
+		auto pooled = std::vector<ranked>{};
+
+		for (const auto val : lhs)
+		{
+			pooled.push_back({ val, true });
+		}
+
+		for (const auto val : rhs)
+		{
+			pooled.push_back({ val, false });
+		}
+
+		std::ranges::sort(pooled, {}, &ranked::val);
+
+		const auto n1 = static_cast<double>(lhs.size());
+		const auto n2 = static_cast<double>(rhs.size());
+		const auto n  = n1 + n2;
+
+		auto rank_sum_lhs = 0.0;
+		auto tie_term     = 0.0;
+
+		// Tied values share the average of the ranks they span
+		for (auto first = std::size_t{}; first < pooled.size();)
+		{
+			auto last = first;
+
+			while (last < pooled.size() && pooled[last].val == pooled[first].val)
+			{
+				++last;
+			}
+
+			const auto ties = static_cast<double>(last - first);
+			const auto rank = static_cast<double>(first + last + 1) / 2.0;
+
+			for (auto idx = first; idx < last; ++idx)
+			{
+				if (pooled[idx].from_lhs)
+				{
+					rank_sum_lhs += rank;
+				}
+			}
+
+			tie_term += ties * ties * ties - ties;
+			first = last;
+		}
+
+		const auto u    = rank_sum_lhs - n1 * (n1 + 1.0) / 2.0;
+		const auto mean = n1 * n2 / 2.0;
+		const auto var  = n1 * n2 / 12.0 * ((n + 1.0) - tie_term / (n * (n - 1.0)));
+
+		if (n1 == 0.0 || n2 == 0.0 || var <= 0.0)
+		{
+			return 1.0;
+		}
+
+		const auto z = std::max(std::abs(u - mean) - 0.5, 0.0) / std::sqrt(var);
+		return std::erfc(z / std::sqrt(2.0));
+	}
+
+	[[nodiscard]] auto parse_options(int argc, char** argv) -> options
+	{
+		auto opts        = options{};
+		auto positionals = std::vector<std::string>{};
+
+		for (auto idx = 1; idx < argc; ++idx)
+		{
+			const auto arg = std::string_view{ argv[idx] };
+
+			if (arg == "--threshold" || arg == "--alpha")
+			{
+				if (idx + 1 >= argc)
+				{
+					usage(argv[0]);
+				}
+
+				(arg == "--threshold" ? opts.threshold : opts.alpha) = std::stod(argv[++idx]);
+			}
+			else if (arg.starts_with("--"))
+			{
+				usage(argv[0]);
+			}
+			else
+			{
+				positionals.emplace_back(arg);
+			}
+		}
+
+		if (positionals.size() != 2)
+		{
+			usage(argv[0]);
+		}
+
+		opts.old_path = positionals[0];
+		opts.new_path = positionals[1];
+		return opts;
+	}
+
+	void print_context(std::string_view label, const bench::json::value& results)
+	{
+		const auto& context = results.at("context");
+
+		std::cout << label << ": " << context.at("program").str() << " @ " << context.at("git_sha").str() << ", "
+				  << context.at("compiler").str() << " " << context.at("flags").str() << ", "
+				  << context.at("cpu").str() << '\n';
+	}
+
+	/**
+	 * Prints a row per benchmark present in both runs, returns EXIT_FAILURE if any of them got significantly slower
+	 */
+	[[nodiscard]] auto compare(const options& opts,
+		const bench::json::value& old_results,
+		const bench::json::value& new_results) -> int
+	{
+		print_context("old", old_results);
+		print_context("new", new_results);
+
+		std::cout << '\n'
+				  << std::left << std::setw(36) << "benchmark" << std::setw(8) << "buf" << std::right << std::setw(7)
+				  << "size" << std::setw(14) << "old(us)" << std::setw(14) << "new(us)" << std::setw(10) << "change"
+				  << std::setw(10) << "p-value" << "  verdict\n";
+
+		const auto& old_benchmarks = old_results.at("benchmarks").arr();
+		auto regressions           = std::size_t{};
+		auto unmatched             = std::size_t{};
+		auto undersampled          = std::size_t{};
+
+		for (const auto& new_res : new_results.at("benchmarks").arr())
+		{
+			const auto matches = [&](const bench::json::value& old_res) {
+				const auto* old_threads = old_res.find("threads");
+				const auto* new_threads = new_res.find("threads");
+
+				// Results written before thread counts were recorded match any of them
+				return old_res.at("name").str() == new_res.at("name").str() &&
+					   old_res.at("buf").str() == new_res.at("buf").str() &&
+					   old_res.at("size").num() == new_res.at("size").num() &&
+					   (!old_threads || !new_threads || old_threads->num() == new_threads->num());
+			};
+
+			const auto old_res = std::ranges::find_if(old_benchmarks, matches);
+
+			if (old_res == old_benchmarks.end())
+			{
+				++unmatched;
+				continue;
+			}
+
+			const auto old_samples = samples_of(*old_res);
+			const auto new_samples = samples_of(new_res);
+			const auto old_median  = bench::median(old_samples);
+			const auto new_median  = bench::median(new_samples);
+			const auto change      = new_median / old_median - 1.0;
+			const auto p_value     = mann_whitney(old_samples, new_samples);
+			const auto significant = p_value < opts.alpha;
+
+			auto verdict = std::string_view{ "same" };
+
+			// "same" would only mean the test had no chance, so such benchmarks are reported as unknown instead
+			if (std::min(old_samples.size(), new_samples.size()) < bench::min_reps)
+			{
+				verdict = "too few samples";
+				++undersampled;
+			}
+			else if (significant && change > opts.threshold)
+			{
+				verdict = "SLOWER";
+				++regressions;
+			}
+			else if (significant && change < -opts.threshold)
+			{
+				verdict = "faster";
+			}
+
+			std::cout << std::left << std::setw(36) << new_res.at("name").str() << std::setw(8)
+					  << new_res.at("buf").str() << std::right << std::setw(7) << new_res.at("size").num()
+					  << std::fixed << std::setprecision(2) << std::setw(14) << old_median / 1e3 << std::setw(14)
+					  << new_median / 1e3 << std::showpos << std::setw(9) << change * 100.0 << '%' << std::noshowpos
+					  << std::setprecision(4) << std::setw(10) << p_value << "  " << verdict << std::defaultfloat
+					  << '\n';
+		}
+
+		if (unmatched > 0)
+		{
+			std::cout << '\n' << unmatched << " benchmark(s) only in " << opts.new_path << " were skipped\n";
+		}
+
+		if (undersampled > 0)
+		{
+			std::cout << '\n'
+					  << "warning: " << undersampled << " benchmark(s) had fewer than " << bench::min_reps
+					  << " repetitions on a side and couldn't be compared, rerun them to compare them\n";
+		}
+
+		std::cout << '\n'
+				  << regressions << " significant slowdown(s) above " << opts.threshold * 100.0 << "% (alpha "
+				  << opts.alpha << ")\n";
+
+		return regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+} // namespace
+
+auto main(int argc, char** argv) -> int
+{
+	try
+	{
+		const auto opts = parse_options(argc, argv);
+		return compare(opts, read_results(opts.old_path), read_results(opts.new_path));
+	}
+	catch (const std::exception& err)
+	{
+		std::cerr << err.what() << '\n';
+		return exit_usage;
+	}
+}
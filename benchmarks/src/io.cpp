@@ -0,0 +1,235 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <mpp/algo.hpp>
+#include <mpp/arith.hpp>
+#include <mpp/io.hpp>
+#include <mpp/mat.hpp>
+
+#include "harness.hpp"
+#include "inputs.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace mpp;
+
+namespace
+{
+	[[nodiscard]] auto temp_path(const std::string& name) -> std::filesystem::path
+	{
+		return std::filesystem::temp_directory_path() / ("mpp_io_benchmark_" + name);
+	}
+
+	void write_text(const std::filesystem::path& path, const mat<double>& obj)
+	{
+		auto file = std::ofstream{ path };
+		file << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+		for (auto row = std::size_t{}; row < obj.rows(); ++row)
+		{
+			for (auto col = std::size_t{}; col < obj.cols(); ++col)
+			{
+				file << obj(row, col) << (col + 1 == obj.cols() ? '\n' : ' ');
+			}
+		}
+	}
+
+	// The std::getline + std::istringstream + std::stod parsing of the test data, which loaders copied
+	[[nodiscard]] auto read_text_baseline(const std::filesystem::path& path) -> mat<double>
+	{
+		auto file = std::ifstream{ path };
+		auto rows = std::vector<std::vector<double>>{};
+		auto line = std::string{};
+
+		while (std::getline(file, line))
+		{
+			auto stream = std::istringstream{ line };
+			auto& row   = rows.emplace_back();
+			auto token  = std::string{};
+
+			while (stream >> token)
+			{
+				row.push_back(std::stod(token));
+			}
+		}
+
+		return mat<double>{ rows };
+	}
+
+	void bench_files(bench::suite& suite)
+	{
+		for (const auto size : suite.sizes(256))
+		{
+			const auto obj       = bench::random_mat<double>(size, size);
+			const auto bin_path  = temp_path("mat.bin");
+			const auto text_path = temp_path("mat.txt");
+			const auto npy_path  = temp_path("mat.npy");
+			const auto mtx_path  = temp_path("mat.mtx");
+
+			save_binary(bin_path, obj);
+			write_text(text_path, obj);
+			save_npy(npy_path, obj);
+			save_matrix_market(mtx_path, obj);
+
+			const auto bin_bytes  = static_cast<double>(std::filesystem::file_size(bin_path));
+			const auto text_bytes = static_cast<double>(std::filesystem::file_size(text_path));
+			const auto npy_bytes  = static_cast<double>(std::filesystem::file_size(npy_path));
+			const auto mtx_bytes  = static_cast<double>(std::filesystem::file_size(mtx_path));
+
+			// Bytes are those of the file, so the bandwidth column is the read or write throughput
+			suite.run("save_binary", "vector", size, 0, bin_bytes, [&]() {
+				save_binary(bin_path, obj);
+				return bin_path;
+			});
+
+			suite.run("load_binary", "vector", size, 0, bin_bytes, [&]() {
+				return load_binary<double>(bin_path);
+			});
+
+			// Mapping alone is free, summing touches every page so it's comparable with loading
+			suite.run("map_binary + sum", "mapped", size, 0, bin_bytes, [&]() {
+				const auto view = map_binary<double>(bin_path);
+				auto sum        = 0.0;
+
+				for (const auto val : view)
+				{
+					sum += val;
+				}
+
+				return sum;
+			});
+
+			suite.run("text istringstream", "vector", size, 0, text_bytes, [&]() {
+				return read_text_baseline(text_path);
+			});
+
+			suite.run("read_text", "vector", size, 0, text_bytes, [&]() {
+				return read_text<double>(text_path);
+			});
+
+			suite.run("save_npy", "vector", size, 0, npy_bytes, [&]() {
+				save_npy(npy_path, obj);
+				return npy_path;
+			});
+
+			suite.run("load_npy", "vector", size, 0, npy_bytes, [&]() {
+				return load_npy<double>(npy_path);
+			});
+
+			suite.run("save_matrix_market", "vector", size, 0, mtx_bytes, [&]() {
+				save_matrix_market(mtx_path, obj);
+				return mtx_path;
+			});
+
+			suite.run("load_matrix_market", "vector", size, 0, mtx_bytes, [&]() {
+				return load_matrix_market<double>(mtx_path);
+			});
+
+			std::filesystem::remove(bin_path);
+			std::filesystem::remove(text_path);
+			std::filesystem::remove(npy_path);
+			std::filesystem::remove(mtx_path);
+		}
+	}
+
+	void bench_tiled(bench::suite& suite)
+	{
+		for (const auto size : suite.sizes(256))
+		{
+			const auto a_path   = temp_path("a.tiled");
+			const auto b_path   = temp_path("b.tiled");
+			const auto out_path = temp_path("out.tiled");
+
+			const auto a = bench::random_mat<double>(size, size);
+			const auto b = bench::random_mat<double>(size, size);
+
+			const auto tile_size = size / 4;
+			const auto a_file    = save_tiled(a_path, a, tile_size);
+			const auto b_file    = save_tiled(b_path, b, tile_size);
+			auto out             = tiled_file<double>::create(out_path, size, size, tile_size);
+
+			const auto flops = 2.0 * static_cast<double>(size) * static_cast<double>(size) * static_cast<double>(size);
+			const auto bytes = 3.0 * static_cast<double>(size * size * sizeof(double));
+
+			suite.run("in-memory mul", "vector", size, flops, bytes, [&]() {
+				return mat<double>{ a * b };
+			});
+
+			// Half a matrix worth of tiles resident, so A and B are read several times
+			suite.run("tiled_mul", "tiled", size, flops, bytes, [&]() {
+				tiled_mul(a_file, b_file, out, size * size * sizeof(double) / 2);
+				return out.rows();
+			});
+
+			// Factorizations work in place, so every repetition starts from a fresh copy of an SPD matrix
+			auto spd = mat<double>{ a * trps(a) };
+
+			for (auto idx = std::size_t{}; idx < size; ++idx)
+			{
+				spd(idx, idx) += static_cast<double>(size);
+			}
+
+			std::ignore = save_tiled(a_path, spd, tile_size);
+
+			suite.run("lu", "vector", size, 2.0 * flops / 6.0, bytes / 3.0, [&]() {
+				return lu(spd);
+			});
+
+			suite.run("copy + tiled_lu", "tiled", size, 2.0 * flops / 6.0, bytes / 3.0, [&]() {
+				std::filesystem::copy_file(a_path, out_path, std::filesystem::copy_options::overwrite_existing);
+
+				auto file = tiled_file<double>::open(out_path, file_access::read_write);
+				tiled_lu(file);
+
+				return file.rows();
+			});
+
+			suite.run("copy + tiled_cholesky", "tiled", size, flops / 6.0, bytes / 3.0, [&]() {
+				std::filesystem::copy_file(a_path, out_path, std::filesystem::copy_options::overwrite_existing);
+
+				auto file = tiled_file<double>::open(out_path, file_access::read_write);
+				tiled_cholesky(file);
+
+				return file.rows();
+			});
+
+			std::filesystem::remove(a_path);
+			std::filesystem::remove(b_path);
+			std::filesystem::remove(out_path);
+		}
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	auto suite = bench::suite{ argc, argv };
+
+	bench_files(suite);
+	bench_tiled(suite);
+
+	return suite.finish();
+}
@@ -0,0 +1,331 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <mpp/arith.hpp>
+#include <mpp/banded.hpp>
+#include <mpp/iterative.hpp>
+#include <mpp/mat.hpp>
+#include <mpp/sparse.hpp>
+
+#include "harness.hpp"
+#include "inputs.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace mpp;
+
+namespace
+{
+	// Nonzeros per row, in the range of discretized PDEs
+	constexpr auto row_nnz = std::size_t{ 16 };
+
+	[[nodiscard]] auto random_triplets(std::size_t size) -> std::vector<triplet<double>>
+	{
+		auto gen   = std::mt19937{ 42 };
+		auto index = std::uniform_int_distribution<std::size_t>{ 0, size - 1 };
+		auto value = std::uniform_real_distribution<double>{ -1.0, 1.0 };
+
+		auto triplets = std::vector<triplet<double>>{};
+		triplets.reserve(size * row_nnz);
+
+		for (auto row = std::size_t{}; row < size; ++row)
+		{
+			for (auto idx = std::size_t{}; idx < row_nnz; ++idx)
+			{
+				triplets.push_back({ row, index(gen), value(gen) });
+			}
+		}
+
+		return triplets;
+	}
+
+	// 5-point stencil of a side x side grid, shifted so it's symmetric positive definite
+	[[nodiscard]] auto grid_laplacian(std::size_t side) -> sparse_mat<double>
+	{
+		auto triplets = std::vector<triplet<double>>{};
+		triplets.reserve(side * side * 5);
+
+		for (auto y = std::size_t{}; y < side; ++y)
+		{
+			for (auto x = std::size_t{}; x < side; ++x)
+			{
+				const auto node = y * side + x;
+
+				triplets.push_back({ node, node, 4.5 });
+
+				if (x > 0)
+				{
+					triplets.push_back({ node, node - 1, -1.0 });
+					triplets.push_back({ node - 1, node, -1.0 });
+				}
+
+				if (y > 0)
+				{
+					triplets.push_back({ node, node - side, -1.0 });
+					triplets.push_back({ node - side, node, -1.0 });
+				}
+			}
+		}
+
+		return { side * side, side * side, triplets };
+	}
+
+	void bench_sparse(bench::suite& suite)
+	{
+		for (const auto size : suite.sizes(64))
+		{
+			const auto triplets = random_triplets(size);
+			const auto a        = sparse_mat{ size, size, triplets };
+			const auto a_csc    = sparse_mat<double, csc>{ a };
+			const auto dense    = mat<double>{ a };
+			const auto x        = bench::random_mat<double>(size, 1);
+			const auto block    = bench::random_mat<double>(size, row_nnz);
+
+			const auto nnz       = static_cast<double>(a.nnz());
+			const auto dim       = static_cast<double>(size);
+			const auto mat_bytes = nnz * static_cast<double>(sizeof(double) + sizeof(std::size_t));
+			const auto vec_bytes = 2.0 * dim * sizeof(double);
+
+			suite.run("sparse_mat from triplets", "csr", size, 0, 2.0 * mat_bytes, [&]() {
+				return sparse_mat{ size, size, triplets };
+			});
+
+			// Flops of the dense baseline are those of the nonzeros too, so the rates compare directly
+			suite.run("dense * vector", "vector", size, 2.0 * nnz, dim * dim * sizeof(double) + vec_bytes, [&]() {
+				return mat<double>{ dense * x };
+			});
+
+			suite.run("sparse * vector", "csr", size, 2.0 * nnz, mat_bytes + vec_bytes, [&]() {
+				return mat<double>{ a * x };
+			});
+
+			suite.run("sparse * vector", "csc", size, 2.0 * nnz, mat_bytes + vec_bytes, [&]() {
+				return mat<double>{ a_csc * x };
+			});
+
+			suite.run("sparse * mat", "csr", size, 2.0 * nnz * row_nnz, mat_bytes + vec_bytes * row_nnz, [&]() {
+				return mat<double>{ a * block };
+			});
+
+			suite.run("sparse * mat", "csc", size, 2.0 * nnz * row_nnz, mat_bytes + vec_bytes * row_nnz, [&]() {
+				return mat<double>{ a_csc * block };
+			});
+
+			suite.run("dense + sparse", "csr", size, nnz, 2.0 * dim * dim * sizeof(double) + mat_bytes, [&]() {
+				return mat<double>{ dense + a };
+			});
+		}
+	}
+
+	// Grids of (size / 16)^2 unknowns
+	void bench_factor(bench::suite& suite)
+	{
+		for (const auto size : suite.sizes(64))
+		{
+			const auto side = size / 16;
+			const auto a    = grid_laplacian(side);
+			const auto b    = bench::random_mat<double>(side * side, 1);
+			const auto amd  = sparse_analyze(a);
+			const auto nd   = sparse_analyze(a, fill_ordering::nested_dissection);
+
+			const auto amd_flops = sparse_cholesky_t::flops(a, amd);
+			const auto nd_flops  = sparse_cholesky_t::flops(a, nd);
+			const auto nd_bytes  = static_cast<double>(nd.factor_nnz() * sizeof(double));
+
+			suite.run("sparse_analyze amd", "csr", size, 0, 0, [&]() {
+				return sparse_analyze(a);
+			});
+
+			suite.run("sparse_analyze nested_dissection", "csr", size, 0, 0, [&]() {
+				return sparse_analyze(a, fill_ordering::nested_dissection);
+			});
+
+			suite.run("sparse_cholesky amd", "csr", size, amd_flops, 0, [&]() {
+				return sparse_cholesky(a, amd);
+			});
+
+			suite.run("sparse_cholesky nested_dissection", "csr", size, nd_flops, nd_bytes, [&]() {
+				return sparse_cholesky(a, nd);
+			});
+
+			suite.run("sparse_lu nested_dissection", "csr", size, 2.0 * nd_flops, 2.0 * nd_bytes, [&]() {
+				return sparse_lu(a, nd);
+			});
+
+			const auto factors     = sparse_cholesky(a, nd);
+			const auto solve_flops = 4.0 * static_cast<double>(nd.factor_nnz());
+
+			suite.run("sparse_factors::solve", "csr", size, solve_flops, nd_bytes, [&]() {
+				return factors.solve(b);
+			});
+		}
+	}
+
+	// The same grids, solved to a relative residual of 1e-8 with workspaces reused between repetitions
+	void bench_krylov(bench::suite& suite)
+	{
+		for (const auto size : suite.sizes(64))
+		{
+			const auto side    = size / 16;
+			const auto a       = grid_laplacian(side);
+			const auto b       = bench::random_mat<double>(side * side, 1);
+			const auto options = krylov_options{ .tolerance = 1e-8 };
+
+			auto x         = mat<double>(side * side, 1);
+			auto workspace = krylov_workspace<double>{};
+
+			suite.run("cg", "csr", size, 0, 0, [&]() {
+				std::ranges::fill(x, 0.0);
+				return cg(a, b, x, workspace, options).iterations;
+			});
+
+			suite.run("bicgstab", "csr", size, 0, 0, [&]() {
+				std::ranges::fill(x, 0.0);
+				return bicgstab(a, b, x, workspace, options).iterations;
+			});
+
+			suite.run("gmres", "csr", size, 0, 0, [&]() {
+				std::ranges::fill(x, 0.0);
+				return gmres(a, b, x, workspace, options).iterations;
+			});
+
+			const auto jacobi = jacobi_preconditioner{ a };
+			const auto ic     = ic0_preconditioner{ a };
+			const auto ilu    = ilu0_preconditioner{ a };
+
+			suite.run("ilu0_preconditioner", "csr", size, 0, 0, [&]() {
+				return ilu0_preconditioner{ a }.size();
+			});
+
+			suite.run("ilu0_preconditioner::apply", "csr", size, 0, 0, [&]() {
+				ilu.apply(b, x);
+				return x(0, 0);
+			});
+
+			suite.run("cg jacobi", "csr", size, 0, 0, [&]() {
+				std::ranges::fill(x, 0.0);
+				return cg(a, b, x, workspace, jacobi, options).iterations;
+			});
+
+			suite.run("cg ic0", "csr", size, 0, 0, [&]() {
+				std::ranges::fill(x, 0.0);
+				return cg(a, b, x, workspace, ic, options).iterations;
+			});
+
+			suite.run("bicgstab ilu0", "csr", size, 0, 0, [&]() {
+				std::ranges::fill(x, 0.0);
+				return bicgstab(a, b, x, workspace, ilu, options).iterations;
+			});
+
+			suite.run("gmres ilu0", "csr", size, 0, 0, [&]() {
+				std::ranges::fill(x, 0.0);
+				return gmres(a, b, x, workspace, ilu, options).iterations;
+			});
+		}
+	}
+	// Pentadiagonal and tridiagonal systems of size * 256 unknowns, a million at the largest size, and batches of
+	// `size` tridiagonal systems of 256 unknowns
+	void bench_banded(bench::suite& suite)
+	{
+		constexpr auto batch_rows = std::size_t{ 256 };
+
+		for (const auto size : suite.sizes(64))
+		{
+			const auto n     = size * batch_rows;
+			const auto b     = bench::random_mat<double>(n, 1);
+			const auto bytes = static_cast<double>(5 * n * sizeof(double));
+
+			auto a   = band_mat<double>(n, n, 2, 2);
+			auto tri = tridiag_mat<double>(n);
+
+			for (auto col = std::size_t{}; col < n; ++col)
+			{
+				for (auto row = (col > 2 ? col - 2 : 0); row < std::min(n, col + 3); ++row)
+				{
+					a.at(row, col) = row == col ? 6.0 : -1.0;
+				}
+
+				tri.diag()[col] = 4.0;
+
+				if (col + 1 < n)
+				{
+					tri.lower()[col] = -1.0;
+					tri.upper()[col] = -1.0;
+				}
+			}
+
+			suite.run("band_mat * mat", "band", size, 10.0 * static_cast<double>(n), bytes, [&]() {
+				return mat<double>{ a * b };
+			});
+
+			suite.run("band_lu", "band", size, band_lu_t::flops(a), bytes, [&]() {
+				return band_lu(a);
+			});
+
+			suite.run("band_cholesky", "band", size, band_cholesky_t::flops(a), bytes, [&]() {
+				return band_cholesky(a);
+			});
+
+			const auto factors = band_cholesky(a);
+
+			suite.run("band_factors::solve", "band", size, 10.0 * static_cast<double>(n), bytes, [&]() {
+				return factors.solve(b);
+			});
+
+			auto x       = std::vector<double>(n);
+			auto scratch = std::vector<double>(n);
+
+			suite.run("tridiag_solve", "band", size, 8.0 * static_cast<double>(n), bytes, [&]() {
+				std::ranges::copy(b, x.begin());
+				tridiag_solve(tri, std::span{ x }, std::span{ scratch });
+				return x[0];
+			});
+
+			const auto lower = std::vector<double>(n, -1.0);
+			const auto diag  = std::vector<double>(n, 4.0);
+
+			suite.run("tridiag_solve_batch", "band", size, 8.0 * static_cast<double>(n), bytes, [&]() {
+				std::ranges::copy(b, x.begin());
+				tridiag_solve_batch(std::span{ lower },
+					std::span{ diag },
+					std::span{ lower },
+					std::span{ x },
+					std::span{ scratch },
+					size);
+				return x[0];
+			});
+		}
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	auto suite = bench::suite{ argc, argv };
+
+	bench_sparse(suite);
+	bench_factor(suite);
+	bench_krylov(suite);
+	bench_banded(suite);
+
+	return suite.finish();
+}
@@ -0,0 +1,153 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <mpp/arith.hpp>
+#include <mpp/mat.hpp>
+#include <mpp/util/cfg.hpp>
+
+#include "harness.hpp"
+#include "inputs.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+
+using namespace mpp;
+
+namespace
+{
+	constexpr auto crossovers = std::array<std::size_t, 4>{ 0, 128, 256, 512 };
+
+	[[nodiscard]] auto recursion_levels(std::size_t size, std::size_t crossover) -> std::size_t
+	{
+		// Mirrors the recursion condition of the product, which halves the matrix until it drops under the crossover
+		auto levels = std::size_t{};
+
+		for (; crossover != 0 && size >= std::max(crossover, std::size_t{ 2 }); size /= 2)
+		{
+			++levels;
+		}
+
+		return levels;
+	}
+
+	[[nodiscard]] auto max_abs_err(const mat<float>& out, const mat<double>& ref) -> double
+	{
+		auto err = 0.0;
+
+		for (auto row = std::size_t{}; row < ref.rows(); ++row)
+		{
+			for (auto col = std::size_t{}; col < ref.cols(); ++col)
+			{
+				err = std::max(err, std::abs(static_cast<double>(out(row, col)) - ref(row, col)));
+			}
+		}
+
+		return err;
+	}
+
+	void bench_speed(bench::suite& suite)
+	{
+		for (const auto size : suite.sizes(256))
+		{
+			const auto a = bench::random_mat<double>(size, size, 1);
+			const auto b = bench::random_mat<double>(size, size, 2);
+			const auto n = static_cast<double>(size);
+
+			for (const auto crossover : crossovers)
+			{
+				set_strassen_crossover(crossover);
+
+				// Flops are the nominal 2n^3 of the classical product, so the speedup of skipping work shows up as a
+				// higher rate
+				suite.run("operator* crossover " + std::to_string(crossover),
+					"vector",
+					size,
+					2 * n * n * n,
+					3 * n * n * sizeof(double),
+					[&]() {
+						return mat<double>{ a * b };
+					});
+			}
+		}
+
+		set_strassen_crossover(0);
+	}
+
+	void report_error_growth(const bench::suite& suite)
+	{
+		// Strassen-Winograd trades accuracy for speed, with an error bound that grows with every recursion level.
+		// Single precision products are compared against a double precision one to show how much is actually lost
+		if (!suite.enabled("error growth"))
+		{
+			return;
+		}
+
+		std::cout << "\nerror growth of single precision products against a double precision reference\n"
+				  << std::setw(7) << "size" << std::setw(11) << "crossover" << std::setw(8) << "levels"
+				  << std::setw(16) << "max abs err" << std::setw(16) << "normwise err" << std::setw(14)
+				  << "vs classical" << '\n';
+
+		for (const auto size : suite.sizes(256))
+		{
+			const auto a   = bench::random_mat<double>(size, size, 1);
+			const auto b   = bench::random_mat<double>(size, size, 2);
+			const auto a_f = mat<float>{ a };
+			const auto b_f = mat<float>{ b };
+
+			set_strassen_crossover(0);
+
+			const auto ref           = mat<double>{ a * b };
+			const auto classical_err = max_abs_err(mat<float>{ a_f * b_f }, ref);
+
+			for (const auto crossover : crossovers)
+			{
+				set_strassen_crossover(crossover);
+
+				const auto err = max_abs_err(mat<float>{ a_f * b_f }, ref);
+
+				// |A| and |B| are at most 1, so n * eps is the scale of the classical error bound
+				const auto normwise =
+					err / (static_cast<double>(size) * static_cast<double>(std::numeric_limits<float>::epsilon()));
+
+				std::cout << std::setw(7) << size << std::setw(11) << crossover << std::setw(8)
+						  << recursion_levels(size, crossover) << std::scientific << std::setprecision(3)
+						  << std::setw(16) << err << std::setw(16) << normwise << std::fixed << std::setprecision(2)
+						  << std::setw(14) << err / classical_err << std::defaultfloat << '\n';
+			}
+		}
+
+		set_strassen_crossover(0);
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	auto suite = bench::suite{ argc, argv };
+
+	bench_speed(suite);
+	report_error_growth(suite);
+
+	return suite.finish();
+}
@@ -23,6 +23,9 @@
 #include <mpp/algo/block.hpp>
 #include <mpp/algo/det.hpp>
 #include <mpp/algo/fwd_sub.hpp>
+#include <mpp/algo/grouped_mul.hpp>
 #include <mpp/algo/inv.hpp>
 #include <mpp/algo/lu.hpp>
+#include <mpp/algo/tiled_factor.hpp>
+#include <mpp/algo/tiled_mul.hpp>
 #include <mpp/algo/trps.hpp>
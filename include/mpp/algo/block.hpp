@@ -19,26 +19,27 @@
 
 #pragma once
 
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/algo_impl.hpp>
 #include <mpp/detail/util/cpo_base.hpp>
+#include <mpp/detail/util/trps_impl.hpp>
 #include <mpp/detail/util/util.hpp>
 #include <mpp/mat.hpp>
 
-#include <algorithm>
 #include <cassert>
 #include <cstddef>
-#include <iterator>
-#include <ranges>
+#include <string_view>
 
 namespace mpp
 {
 	namespace detail
 	{
-		constexpr void assert_valid_block_dims(std::size_t rows,
-			std::size_t cols,
-			std::size_t top_row_idx,
-			std::size_t top_col_idx,
-			std::size_t bottom_row_idx,
-			std::size_t bottom_col_idx)
+		constexpr void assert_valid_block_dims([[maybe_unused]] std::size_t rows,
+			[[maybe_unused]] std::size_t cols,
+			[[maybe_unused]] std::size_t top_row_idx,
+			[[maybe_unused]] std::size_t top_col_idx,
+			[[maybe_unused]] std::size_t bottom_row_idx,
+			[[maybe_unused]] std::size_t bottom_col_idx)
 		{
 			// Out of bounds asserts
 
@@ -64,36 +65,22 @@ namespace mpp
 			const auto cols = obj.cols();
 			assert_valid_block_dims(rows, cols, top_row_idx, top_col_idx, bottom_row_idx, bottom_col_idx);
 
-			using buf_t  = typename To::buffer_type;
-			using val_t  = typename To::value_type;
-			using diff_t = typename To::difference_type;
-
 			const auto block_rows = bottom_row_idx - top_row_idx + 1;
 			const auto block_cols = bottom_col_idx - top_col_idx + 1;
 
-			auto buf = buf_t{};
-			resize_buf_if_dyn(buf, block_rows, block_cols, val_t{});
-
-			auto buf_begin = std::ranges::begin(buf);
-			auto obj_begin = std::ranges::begin(obj);
-
-			for (auto row = top_row_idx; row <= bottom_row_idx; ++row, buf_begin += static_cast<diff_t>(block_cols))
-			{
-				auto row_begin_index = static_cast<diff_t>(idx_1d(cols, row, top_col_idx));
-				auto row_begin       = std::next(obj_begin, row_begin_index);
-
-				std::ranges::copy_n(row_begin, static_cast<diff_t>(block_cols), buf_begin);
-			}
-
-			return To{ block_rows, block_cols, std::move(buf) };
+			return make_mat_with<To>(block_rows, block_cols, [&](auto out) {
+				copy_strided(block_rows, block_cols, strided_of(obj).sub(top_row_idx, top_col_idx), out);
+			});
 		}
 	} // namespace detail
 
 	struct block_t : public detail::cpo_base<block_t>
 	{
-		template<typename T, typename Buf, typename To = mat<T, Buf>>
+		static constexpr auto name = std::string_view{ "block" };
+
+		template<typename T, typename Buf, typename Layout, typename To = mat<T, result_buf_t<Buf>, Layout>>
 		requires(detail::is_mat<To>::value) [[nodiscard]] friend inline auto tag_invoke(block_t,
-			const mat<T, Buf>& obj,
+			const mat<T, Buf, Layout>& obj,
 			std::size_t top_row_idx,
 			std::size_t top_col_idx,
 			std::size_t bottom_row_idx,
@@ -26,6 +26,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <string_view>
+#include <vector>
 
 namespace mpp
 {
@@ -56,7 +58,24 @@ namespace mpp
 				return static_cast<To>(ad - bc);
 			}
 
-			auto buf = obj.buffer();
+			// det(A) = det(transpose(A)), so the buffer of any unpadded layout can be factored as is
+			auto buf = [&]() {
+				using buf_t = typename Mat::buffer_type;
+
+				if constexpr (Mat::layout_type::padded)
+				{
+					return copy_into_new_buf<scratch_vector<typename Mat::value_type>>(obj, rows, cols);
+				}
+				else if constexpr (is_fixed_buf<buf_t>)
+				{
+					// Fixed buffers are copied on the stack
+					return obj.buffer();
+				}
+				else
+				{
+					return scratch_vector<typename Mat::value_type>(obj.buffer().begin(), obj.buffer().end());
+				}
+			}();
 
 			// The determinant of a LU Decomposition is det(A) = det(L) * det(U) Since det(L) is always 1, we can avoid
 			// creating L entirely
@@ -68,10 +87,19 @@ namespace mpp
 
 	struct det_t : public detail::cpo_base<det_t>
 	{
-		template<typename T, typename Buf, typename To = T>
-		requires(std::is_arithmetic_v<To>)
-			[[nodiscard]] friend inline auto tag_invoke(det_t, const mat<T, Buf>& obj, std::type_identity<To> = {})
-				-> To // @TODO: ISSUE #20
+		static constexpr auto name = std::string_view{ "det" };
+
+		// LU Decomposition without storing L
+		[[nodiscard]] static auto flops(const auto& obj, const auto&...) noexcept -> double // @TODO: ISSUE #20
+		{
+			const auto n = static_cast<double>(obj.rows());
+			return 2.0 * n * n * n / 3.0;
+		}
+
+		template<typename T, typename Buf, typename Layout, typename To = T>
+		requires(std::is_arithmetic_v<To>) [[nodiscard]] friend inline auto tag_invoke(det_t,
+			const mat<T, Buf, Layout>& obj,
+			std::type_identity<To> = {}) -> To // @TODO: ISSUE #20
 		{
 			return detail::det_impl<To>(obj);
 		}
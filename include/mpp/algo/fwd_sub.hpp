@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <cstddef>
+#include <string_view>
 
 namespace mpp
 {
@@ -37,18 +38,32 @@ namespace mpp
 			assert(b.cols() == 1);
 
 			const auto rows = a.rows();
-			auto buf        = fwd_sub_buf<typename To::buffer_type>(a.data(), b.data(), rows);
+			auto buf        = fwd_sub_buf<typename To::buffer_type>(strided_of(a), strided_of(b), rows);
 
-			return To{ rows, 1, std::move(buf) };
+			return mat_from_row_major<To>(rows, 1, std::move(buf));
 		}
 	} // namespace detail
 
 	struct fwd_sub_t : public detail::cpo_base<fwd_sub_t>
 	{
-		template<typename AT, typename BT, typename ABuf, typename BBuf, typename To = mat<std::common_type_t<AT, BT>>>
+		static constexpr auto name = std::string_view{ "fwd_sub" };
+
+		[[nodiscard]] static auto flops(const auto& a, const auto& b, const auto&...) noexcept
+			-> double // @TODO: ISSUE #20
+		{
+			return static_cast<double>(a.rows()) * static_cast<double>(a.rows()) * static_cast<double>(b.cols());
+		}
+
+		template<typename AT,
+			typename BT,
+			typename ABuf,
+			typename BBuf,
+			typename ALayout,
+			typename BLayout,
+			typename To = mat<std::common_type_t<AT, BT>>>
 		requires(detail::is_mat<To>::value) friend inline auto tag_invoke(fwd_sub_t,
-			const mat<AT, ABuf>& a,
-			const mat<BT, BBuf>& b,
+			const mat<AT, ABuf, ALayout>& a,
+			const mat<BT, BBuf, BLayout>& b,
 			std::type_identity<To> = {}) -> To // @TODO: ISSUE #20
 		{
 			return detail::fwd_sub_impl<To>(a, b);
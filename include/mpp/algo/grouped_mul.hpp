@@ -0,0 +1,118 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/cpo_base.hpp>
+#include <mpp/detail/util/gemm_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/mat.hpp>
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mpp
+{
+	namespace detail
+	{
+		template<typename Problem, std::size_t Idx>
+		using problem_mat_t = std::remove_cvref_t<decltype(std::get<Idx>(std::declval<Problem>()))>;
+
+		// Tuple-like (A, B, C) where C is a mutable matrix and all three share the same value type
+		template<typename Problem>
+		concept gemm_problem = is_mat<problem_mat_t<Problem, 0>>::value && is_mat<problem_mat_t<Problem, 1>>::value &&
+			is_mat<problem_mat_t<Problem, 2>>::value &&
+			std::same_as<typename problem_mat_t<Problem, 0>::value_type, typename problem_mat_t<Problem, 2>::value_type> &&
+			std::same_as<typename problem_mat_t<Problem, 1>::value_type, typename problem_mat_t<Problem, 2>::value_type> &&
+			!std::is_const_v<std::remove_reference_t<decltype(std::get<2>(std::declval<Problem>()))>>;
+
+		template<typename Problems>
+		inline void grouped_mul_impl(Problems&& problems) // @TODO: ISSUE #20
+		{
+			using c_mat_t = problem_mat_t<std::ranges::range_reference_t<Problems>, 2>;
+			using val_t   = typename c_mat_t::value_type;
+
+			auto tasks = std::vector<gemm_task<val_t>>{};
+
+			if constexpr (std::ranges::sized_range<Problems>)
+			{
+				tasks.reserve(std::ranges::size(problems));
+			}
+
+			for (auto&& problem : problems)
+			{
+				const auto& a = std::get<0>(problem);
+				const auto& b = std::get<1>(problem);
+				auto& c       = std::get<2>(problem);
+
+				assert(a.cols() == b.rows());
+
+				const auto m = a.rows();
+				const auto n = b.cols();
+				const auto k = a.cols();
+
+				if (c.rows() != m || c.cols() != n)
+				{
+					c = c_mat_t{ m, n };
+				}
+
+				tasks.push_back({ strided_of(a), strided_of(b), strided_of_mut(c), m, n, k, false });
+			}
+
+			run_gemm_tasks(tasks);
+		}
+	} // namespace detail
+
+	struct grouped_mul_t : public detail::cpo_base<grouped_mul_t>
+	{
+		static constexpr auto name = std::string_view{ "grouped_mul" };
+
+		template<std::ranges::forward_range Problems>
+		[[nodiscard]] static auto flops(const Problems& problems) noexcept -> double // @TODO: ISSUE #20
+		{
+			auto out = 0.0;
+
+			for (auto&& problem : problems)
+			{
+				out += 2.0 * static_cast<double>(std::get<0>(problem).rows()) *
+					static_cast<double>(std::get<1>(problem).cols()) * static_cast<double>(std::get<0>(problem).cols());
+			}
+
+			return out;
+		}
+
+		template<std::ranges::forward_range Problems>
+		requires(detail::gemm_problem<std::ranges::range_reference_t<Problems>>) friend inline auto tag_invoke(
+			grouped_mul_t,
+			Problems&& problems) -> void // @TODO: ISSUE #20
+		{
+			detail::grouped_mul_impl(std::forward<Problems>(problems));
+		}
+	};
+
+	inline constexpr auto grouped_mul = grouped_mul_t{};
+} // namespace mpp
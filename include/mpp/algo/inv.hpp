@@ -26,6 +26,7 @@
 
 #include <cassert>
 #include <cstddef>
+#include <string_view>
 
 namespace mpp
 {
@@ -85,14 +86,18 @@ namespace mpp
 			{
 				// @FIXME: We can't use to_buf_t since it'll fail for containers such as std::array because we can't
 				// change their size
-				using subst_buf_t = std::vector<to_val_t>;
+				using subst_buf_t = scratch_vector<to_val_t>;
 				auto l            = subst_buf_t{};
 				auto u            = copy_into_new_buf<subst_buf_t>(obj, rows, cols);
 				init_identity_buf(l, rows, cols, to_val_t{}, to_val_t{ 1 });
 
-				const auto det_ = lu_algo<to_val_t, true, true>(rows, cols, l, u);
+				[[maybe_unused]] const auto det_ = lu_algo<to_val_t, true, true>(rows, cols, l, u);
 				assert(!is_zero_or_nan(det_));
 
+				using view_t      = strided_view<const to_val_t>;
+				const auto l_view = view_t{ l.data(), cols, 1 };
+				const auto u_view = view_t{ u.data(), cols, 1 };
+
 				auto x_buf = subst_buf_t{};
 				resize_buf_if_dyn(x_buf, rows, 1, to_val_t{});
 
@@ -113,12 +118,12 @@ namespace mpp
 					x_buf[last_col_idx] = to_val_t{};
 					x_buf[row]          = to_val_t{ 1 };
 
-					auto l_x_buf = fwd_sub_buf<subst_buf_t>(l, x_buf, rows);
+					auto l_x_buf = fwd_sub_buf<subst_buf_t>(l_view, view_t{ x_buf.data(), 1, 1 }, rows);
 
 					// Use l_x_buf to do back substitution to solve Ax=B with A=u and b=l_x_buf. The
 					// inv_col now corresponds to a column of the inverse matrix
 
-					auto inv_col = back_sub_buf<subst_buf_t>(u, std::move(l_x_buf), rows);
+					auto inv_col = back_sub_buf<subst_buf_t>(u_view, view_t{ l_x_buf.data(), 1, 1 }, rows);
 
 					for (auto col = std::size_t{}; auto val : inv_col)
 					{
@@ -127,16 +132,25 @@ namespace mpp
 				}
 			}
 
-			return To{ rows, cols, std::move(buf) };
+			return mat_from_row_major<To>(rows, cols, std::move(buf));
 		}
 	} // namespace detail
 
 	struct inv_t : public detail::cpo_base<inv_t>
 	{
-		template<typename T, typename Buf, typename To = mat<T, Buf>>
-		requires(detail::is_mat<To>::value)
-			[[nodiscard]] friend inline auto tag_invoke(inv_t, const mat<T, Buf>& obj, std::type_identity<To> = {})
-				-> To // @TODO: ISSUE #20
+		static constexpr auto name = std::string_view{ "inv" };
+
+		// LU Decomposition, then a forward and a backward substitution per column
+		[[nodiscard]] static auto flops(const auto& obj, const auto&...) noexcept -> double // @TODO: ISSUE #20
+		{
+			const auto n = static_cast<double>(obj.rows());
+			return 2.0 * n * n * n / 3.0 + 2.0 * n * n * n;
+		}
+
+		template<typename T, typename Buf, typename Layout, typename To = mat<T, result_buf_t<Buf>, Layout>>
+		requires(detail::is_mat<To>::value) [[nodiscard]] friend inline auto tag_invoke(inv_t,
+			const mat<T, Buf, Layout>& obj,
+			std::type_identity<To> = {}) -> To // @TODO: ISSUE #20
 		{
 			return detail::inv_impl<To>(obj);
 		}
@@ -26,6 +26,7 @@
 
 #include <cassert>
 #include <cstddef>
+#include <string_view>
 
 namespace mpp
 {
@@ -49,15 +50,24 @@ namespace mpp
 
 			lu_algo<buf_t, true, false>(rows, cols, l, u);
 
-			return { To{ rows, cols, std::move(l) }, To{ rows, cols, std::move(u) } };
+			return { mat_from_row_major<To>(rows, cols, std::move(l)),
+				mat_from_row_major<To>(rows, cols, std::move(u)) };
 		}
 	} // namespace detail
 
 	struct lu_t : public detail::cpo_base<lu_t>
 	{
-		template<typename T, typename Buf, typename To = mat<T, Buf>>
+		static constexpr auto name = std::string_view{ "lu" };
+
+		[[nodiscard]] static auto flops(const auto& obj, const auto&...) noexcept -> double // @TODO: ISSUE #20
+		{
+			const auto n = static_cast<double>(obj.rows());
+			return 2.0 * n * n * n / 3.0;
+		}
+
+		template<typename T, typename Buf, typename Layout, typename To = mat<T, result_buf_t<Buf>, Layout>>
 		requires(detail::is_mat<To>::value) friend inline auto tag_invoke(lu_t,
-			const mat<T, Buf>& obj,
+			const mat<T, Buf, Layout>& obj,
 			std::type_identity<To> = {}) -> std::pair<To, To> // @TODO: ISSUE #20
 		{
 			return detail::lu_impl<To>(obj);
@@ -0,0 +1,76 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/cpo_base.hpp>
+#include <mpp/detail/util/tiled_impl.hpp>
+#include <mpp/io/tiled.hpp>
+
+#include <string_view>
+
+namespace mpp
+{
+	struct tiled_lu_t : public detail::cpo_base<tiled_lu_t>
+	{
+		static constexpr auto name = std::string_view{ "tiled_lu" };
+
+		[[nodiscard]] static auto flops(const auto& obj) noexcept -> double // @TODO: ISSUE #20
+		{
+			const auto n = static_cast<double>(obj.rows());
+			return 2.0 * n * n * n / 3.0;
+		}
+
+		/**
+		 * LU decomposition of a square matrix on disk in place, like lu without pivoting: L (with an implicit unit
+		 * diagonal) below the diagonal and U on and above it. Throws std::runtime_error if a tile can't be read or
+		 * written
+		 */
+		template<typename T>
+		friend inline auto tag_invoke(tiled_lu_t, tiled_file<T>& obj) -> void // @TODO: ISSUE #20
+		{
+			detail::tiled_lu_impl(obj);
+		}
+	};
+
+	struct tiled_cholesky_t : public detail::cpo_base<tiled_cholesky_t>
+	{
+		static constexpr auto name = std::string_view{ "tiled_cholesky" };
+
+		[[nodiscard]] static auto flops(const auto& obj) noexcept -> double // @TODO: ISSUE #20
+		{
+			const auto n = static_cast<double>(obj.rows());
+			return n * n * n / 3.0;
+		}
+
+		/**
+		 * Cholesky factor L (A = L * L^T) of a symmetric positive definite matrix on disk in place, in its lower
+		 * triangle. Only the lower triangle of A is read, the diagonal tiles get zeros above the diagonal and the tiles
+		 * above them aren't touched. Throws std::runtime_error if a tile can't be read or written
+		 */
+		template<typename T>
+		friend inline auto tag_invoke(tiled_cholesky_t, tiled_file<T>& obj) -> void // @TODO: ISSUE #20
+		{
+			detail::tiled_cholesky_impl(obj);
+		}
+	};
+
+	inline constexpr auto tiled_lu       = tiled_lu_t{};
+	inline constexpr auto tiled_cholesky = tiled_cholesky_t{};
+} // namespace mpp
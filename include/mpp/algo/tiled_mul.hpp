@@ -0,0 +1,280 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/cpo_base.hpp>
+#include <mpp/detail/util/gemm_impl.hpp>
+#include <mpp/detail/util/io_worker.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/io/tiled.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <string_view>
+#include <vector>
+
+namespace mpp
+{
+	namespace detail
+	{
+		// Tiles of the smallest step: a 1 x 1 block of C and two panels of one tile each for A and B
+		inline constexpr auto tiled_mul_min_tiles = std::size_t{ 5 };
+
+		/**
+		 * Tiles of C kept in memory at once, as block_rows x block_cols. The C block plus two A panels of block_rows
+		 * tiles and two B panels of block_cols tiles (one being multiplied, one being read) have to fit in the budget,
+		 * that's rows * cols + 2 * (rows + cols) tiles. A square block reads A and B the least often for a given size
+		 */
+		[[nodiscard]] inline auto tiled_mul_block(std::size_t budget_tiles,
+			std::size_t row_tiles,
+			std::size_t col_tiles) -> std::pair<std::size_t, std::size_t>
+		{
+			assert(budget_tiles >= tiled_mul_min_tiles);
+
+			auto side = std::size_t{ 1 };
+
+			while ((side + 1) * (side + 1) + 4 * (side + 1) <= budget_tiles)
+			{
+				++side;
+			}
+
+			const auto block_rows = std::min(side, row_tiles);
+
+			// Memory left over by a short C goes to wider blocks
+			const auto spare      = budget_tiles - 2 * block_rows;
+			const auto block_cols = std::clamp(spare / (block_rows + 2), std::size_t{ 1 }, col_tiles);
+
+			return { block_rows, block_cols };
+		}
+
+		template<typename T>
+		inline void tiled_mul_impl(const tiled_file<T>& a,
+			const tiled_file<T>& b,
+			tiled_file<T>& out,
+			std::size_t max_memory) // @TODO: ISSUE #20
+		{
+			assert(a.cols() == b.rows());
+			assert(out.rows() == a.rows() && out.cols() == b.cols());
+			assert(a.tile_size() == b.tile_size() && a.tile_size() == out.tile_size());
+
+			const auto tile_size  = out.tile_size();
+			const auto tile_elems = out.tile_elems();
+			const auto row_tiles  = out.row_tiles();
+			const auto col_tiles  = out.col_tiles();
+			const auto k_tiles    = a.col_tiles();
+
+			if (row_tiles == 0 || col_tiles == 0)
+			{
+				return;
+			}
+
+			const auto budget_tiles = max_memory / (tile_elems * sizeof(T));
+
+			if (budget_tiles < tiled_mul_min_tiles)
+			{
+				throw std::invalid_argument("tiled_mul needs memory for at least " +
+					std::to_string(tiled_mul_min_tiles) + " tiles of " + out.path().string());
+			}
+
+			const auto [block_rows, block_cols] = tiled_mul_block(budget_tiles, row_tiles, col_tiles);
+
+			auto c_block = scratch_vector<T>(block_rows * block_cols * tile_elems);
+
+			// Nothing to multiply, C is zeros
+			if (k_tiles == 0)
+			{
+				for (auto tile_row = std::size_t{}; tile_row < row_tiles; ++tile_row)
+				{
+					for (auto tile_col = std::size_t{}; tile_col < col_tiles; ++tile_col)
+					{
+						out.write_tile(tile_row, tile_col, c_block.data());
+					}
+				}
+
+				return;
+			}
+
+			/**
+			 * Steps go over the blocks of C row by row, and over the tile columns of A (tile rows of B) within each
+			 * block. A step multiplies a panel of A tiles with a panel of B tiles into the block, so A is read once per
+			 * block column and B once per block row, and every tile of C is written once
+			 */
+			const auto block_row_count = div_round_up(row_tiles, block_rows);
+			const auto block_col_count = div_round_up(col_tiles, block_cols);
+			const auto steps           = block_row_count * block_col_count * k_tiles;
+
+			struct step_t
+			{
+				std::size_t first_row; // First tile row and column of the C block
+				std::size_t first_col;
+				std::size_t rows; // Tile rows and columns of the C block
+				std::size_t cols;
+				std::size_t k;
+			};
+
+			const auto step_at = [&](std::size_t step) {
+				const auto block = step / k_tiles;
+
+				const auto first_row = block / block_col_count * block_rows;
+				const auto first_col = block % block_col_count * block_cols;
+
+				return step_t{ first_row,
+					first_col,
+					std::min(block_rows, row_tiles - first_row),
+					std::min(block_cols, col_tiles - first_col),
+					step % k_tiles };
+			};
+
+			struct panels_t
+			{
+				scratch_vector<T> a;
+				scratch_vector<T> b;
+			};
+
+			auto panels = std::array<panels_t, 2>{};
+
+			for (auto& panel : panels)
+			{
+				panel.a.resize(block_rows * tile_elems);
+				panel.b.resize(block_cols * tile_elems);
+			}
+
+			// Last, so pending reads and writes finish before the buffers they use are freed
+			auto io = io_worker{};
+
+			const auto read_panels = [&](std::size_t step_idx) {
+				return io.submit([&a, &b, &panels, tile_elems, step = step_at(step_idx), buf = step_idx % 2]() {
+					for (auto row = std::size_t{}; row < step.rows; ++row)
+					{
+						a.read_tile(step.first_row + row, step.k, panels[buf].a.data() + row * tile_elems);
+					}
+
+					for (auto col = std::size_t{}; col < step.cols; ++col)
+					{
+						b.read_tile(step.k, step.first_col + col, panels[buf].b.data() + col * tile_elems);
+					}
+				});
+			};
+
+			auto reading = read_panels(0);
+			auto writing = std::future<void>{};
+
+			auto tasks = std::vector<gemm_task<T>>{};
+			tasks.reserve(block_rows * block_cols);
+
+			for (auto step_idx = std::size_t{}; step_idx < steps; ++step_idx)
+			{
+				const auto step = step_at(step_idx);
+
+				reading.get();
+
+				// The next panels are read while these ones are multiplied
+				if (step_idx + 1 < steps)
+				{
+					reading = read_panels(step_idx + 1);
+				}
+
+				if (step.k == 0)
+				{
+					// The previous block has to be written out before its memory is reused
+					if (writing.valid())
+					{
+						writing.get();
+					}
+
+					std::ranges::fill(c_block, T{});
+				}
+
+				const auto& panel = panels[step_idx % 2];
+
+				tasks.clear();
+
+				for (auto row = std::size_t{}; row < step.rows; ++row)
+				{
+					for (auto col = std::size_t{}; col < step.cols; ++col)
+					{
+						tasks.push_back({ { panel.a.data() + row * tile_elems, tile_size, 1 },
+							{ panel.b.data() + col * tile_elems, tile_size, 1 },
+							{ c_block.data() + (row * block_cols + col) * tile_elems, tile_size, 1 },
+							out.tile_rows(step.first_row + row),
+							out.tile_cols(step.first_col + col),
+							a.tile_cols(step.k),
+							true });
+					}
+				}
+
+				run_gemm_tasks(tasks);
+
+				if (step.k + 1 == k_tiles)
+				{
+					writing = io.submit([&out, &c_block, block_cols, tile_elems, step]() {
+						for (auto row = std::size_t{}; row < step.rows; ++row)
+						{
+							for (auto col = std::size_t{}; col < step.cols; ++col)
+							{
+								out.write_tile(step.first_row + row,
+									step.first_col + col,
+									c_block.data() + (row * block_cols + col) * tile_elems);
+							}
+						}
+					});
+				}
+			}
+
+			writing.get();
+		}
+	} // namespace detail
+
+	struct tiled_mul_t : public detail::cpo_base<tiled_mul_t>
+	{
+		static constexpr auto name = std::string_view{ "tiled_mul" };
+
+		template<typename T, typename... Rest>
+		[[nodiscard]] static auto flops(const tiled_file<T>& a, const tiled_file<T>& b, const Rest&...) noexcept
+			-> double // @TODO: ISSUE #20
+		{
+			return 2.0 * static_cast<double>(a.rows()) * static_cast<double>(b.cols()) * static_cast<double>(a.cols());
+		}
+
+		/**
+		 * out = a * b for matrices on disk, keeping at most about max_memory bytes of tiles in memory. Tiles are read
+		 * ahead in the background while the previous ones are multiplied, and every tile of out is written once.
+		 * Throws std::invalid_argument if max_memory can't hold the 5 tiles of the smallest step, and
+		 * std::runtime_error if a tile can't be read or written
+		 */
+		template<typename T>
+		friend inline auto tag_invoke(tiled_mul_t,
+			const tiled_file<T>& a,
+			const tiled_file<T>& b,
+			tiled_file<T>& out,
+			std::size_t max_memory = default_tiled_memory) -> void // @TODO: ISSUE #20
+		{
+			detail::tiled_mul_impl(a, b, out, max_memory);
+		}
+	};
+
+	inline constexpr auto tiled_mul = tiled_mul_t{};
+} // namespace mpp
@@ -19,11 +19,16 @@
 
 #pragma once
 
+#include <mpp/detail/expr/expr_trps.hpp>
+#include <mpp/detail/util/algo_impl.hpp>
 #include <mpp/detail/util/cpo_base.hpp>
+#include <mpp/detail/util/trps_impl.hpp>
 #include <mpp/detail/util/util.hpp>
 #include <mpp/mat.hpp>
 
+#include <algorithm>
 #include <cstddef>
+#include <string_view>
 #include <type_traits>
 
 namespace mpp
@@ -35,36 +40,83 @@ namespace mpp
 		{
 			const auto rows = obj.rows();
 			const auto cols = obj.cols();
-			const auto data = obj.data();
 
-			auto buf = typename To::buffer_type{};
-			resize_buf_if_dyn(buf, cols, rows, typename To::value_type{});
+			return make_mat_with<To>(cols, rows, [&](auto out) {
+				copy_strided(rows, cols, strided_of(obj), out.trps());
+			});
+		}
+
+		template<typename Mat>
+		inline void trps_inplace_impl(Mat& obj) // @TODO: ISSUE #20
+		{
+			using layout_t = typename Mat::layout_type;
+
+			const auto rows     = obj.rows();
+			const auto cols     = obj.cols();
+			const auto [rs, cs] = layout_t::strides(rows, cols);
 
-			for (auto col = std::size_t{}; col < cols; ++col)
+			if (rows == cols)
 			{
-				for (auto row = std::size_t{}; row < rows; ++row)
-				{
-					auto idx      = detail::idx_1d(cols, row, col);
-					auto trps_idx = detail::idx_1d(rows, col, row);
+				// Swapping across the diagonal doesn't depend on the storage order, and the leading dimension skips
+				// over any padding
+				trps_inplace_square(rows, obj.data(), std::max(rs, cs));
+				return;
+			}
 
-					buf[trps_idx] = data[idx];
-				}
+			if constexpr (layout_t::padded)
+			{
+				// Padded rows change length with the transpose, so the elements can't be permuted within the buffer
+				obj = trps_impl<Mat>(obj);
 			}
+			else
+			{
+				// The buffer of a column major matrix is the row major buffer of its transpose
+				if constexpr (std::is_same_v<layout_t, col_major>)
+				{
+					trps_inplace_cycles(cols, rows, obj.data());
+				}
+				else
+				{
+					trps_inplace_cycles(rows, cols, obj.data());
+				}
 
-			return To{ cols, rows, std::move(buf) };
+				obj.reshape(cols, rows);
+			}
 		}
 	} // namespace detail
 
 	struct trps_t : public detail::cpo_base<trps_t>
 	{
-		template<typename T, typename Buf, typename To = mat<T, Buf>>
-		requires(detail::is_mat<To>::value)
-			[[nodiscard]] friend inline auto tag_invoke(trps_t, const mat<T, Buf>& obj, std::type_identity<To> = {})
-				-> To // @TODO: ISSUE #20
+		static constexpr auto name = std::string_view{ "trps" };
+
+		template<typename T, typename Buf, typename Layout, typename To = mat<T, result_buf_t<Buf>, Layout>>
+		requires(detail::is_mat<To>::value) [[nodiscard]] friend inline auto tag_invoke(trps_t,
+			const mat<T, Buf, Layout>& obj,
+			std::type_identity<To> = {}) -> To // @TODO: ISSUE #20
 		{
 			return detail::trps_impl<To>(obj);
 		}
+
+		template<typename Derived, typename T>
+		[[nodiscard]] friend inline auto tag_invoke(trps_t, const detail::expr_base<Derived, T>& obj, lazy_tag)
+			-> detail::expr_trps<Derived> // @TODO: ISSUE #20
+		{
+			return detail::expr_trps<Derived>{ static_cast<const Derived&>(obj) };
+		}
 	};
 
 	inline constexpr auto trps = trps_t{};
+
+	struct trps_inplace_t : public detail::cpo_base<trps_inplace_t>
+	{
+		static constexpr auto name = std::string_view{ "trps_inplace" };
+
+		template<typename T, typename Buf, typename Layout>
+		friend inline auto tag_invoke(trps_inplace_t, mat<T, Buf, Layout>& obj) -> void // @TODO: ISSUE #20
+		{
+			detail::trps_inplace_impl(obj);
+		}
+	};
+
+	inline constexpr auto trps_inplace = trps_inplace_t{};
 } // namespace mpp
@@ -25,6 +25,7 @@
 #include <mpp/mat.hpp>
 
 #include <cstddef>
+#include <string_view>
 
 namespace mpp
 {
@@ -35,6 +36,9 @@ namespace mpp
 																									b(row, col)) {
 			return a(row, col) + b(row, col);
 		};
+
+		template<>
+		inline constexpr std::string_view expr_op_name<decltype(add_op)> = "operator+";
 	} // namespace detail
 
 	template<typename ADerived, typename BDerived, typename T>
@@ -46,16 +50,18 @@ namespace mpp
 		return { a, b, a.rows(), a.cols(), detail::add_op };
 	}
 
-	template<typename T, typename ABuf, typename BBuf>
-	inline auto operator+=(mat<T, ABuf>& a, const mat<T, BBuf>& b) -> mat<T>& // @TODO: ISSUE #20
+	template<typename T, typename ABuf, typename BBuf, typename Layout>
+	inline auto operator+=(mat<T, ABuf, Layout>& a, const mat<T, BBuf, Layout>& b)
+		-> mat<T, ABuf, Layout>& // @TODO: ISSUE #20
 	{
 		std::ranges::transform(a, b, a.begin(), std::plus{});
 
 		return a;
 	}
 
-	template<typename T, typename Buf, typename Expr>
-	inline auto operator+=(mat<T, Buf>& a, const detail::expr_base<Expr, T>& b) -> mat<T, Buf>& // @TODO: ISSUE #20
+	template<typename T, typename Buf, typename Layout, typename Expr>
+	inline auto operator+=(mat<T, Buf, Layout>& a, const detail::expr_base<Expr, T>& b)
+		-> mat<T, Buf, Layout>& // @TODO: ISSUE #20
 	{
 		const auto rows = a.rows();
 		const auto cols = a.cols();
@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <string_view>
 
 namespace mpp
 {
@@ -37,6 +38,9 @@ namespace mpp
 										   std::size_t col) noexcept -> decltype(lhs(row, col) / rhs) {
 			return lhs(row, col) / rhs;
 		};
+
+		template<>
+		inline constexpr std::string_view expr_op_name<decltype(div_op)> = "operator/ scalar";
 	} // namespace detail
 
 	template<typename Derived, typename T>
@@ -57,8 +61,8 @@ namespace mpp
 		return { obj, val, obj.rows(), obj.cols(), detail::div_op };
 	}
 
-	template<typename T, typename Buf>
-	inline auto operator/=(mat<T, Buf>& obj, T val) -> mat<T, Buf>& // @TODO: ISSUE #20
+	template<typename T, typename Buf, typename Layout>
+	inline auto operator/=(mat<T, Buf, Layout>& obj, T val) -> mat<T, Buf, Layout>& // @TODO: ISSUE #20
 	{
 		// Can't use bind_front here because we want elem / val, not val / elem
 		std::ranges::transform(obj, obj.begin(), [&val](const auto& elem) {
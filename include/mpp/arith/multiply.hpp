@@ -22,12 +22,17 @@
 #include <mpp/detail/expr/expr_binary_op.hpp>
 #include <mpp/detail/expr/expr_binary_val_op.hpp>
 #include <mpp/detail/util/algo_impl.hpp>
+#include <mpp/detail/util/gemm_impl.hpp>
+#include <mpp/detail/util/strassen_impl.hpp>
+#include <mpp/util/cfg.hpp>
 #include <mpp/mat.hpp>
 
 #include <algorithm>
 #include <cstddef>
 #include <functional>
+#include <string_view>
 #include <type_traits>
+#include <vector>
 
 namespace mpp
 {
@@ -38,9 +43,58 @@ namespace mpp
 			return a(row, col) * b;
 		};
 
-		inline constexpr auto mul_op = [](const auto& a, const auto& b, std::size_t row, std::size_t col) noexcept ->
-			typename std::remove_cvref_t<decltype(a)>::value_type {
-				using value_type = typename std::remove_cvref_t<decltype(a)>::value_type;
+		template<>
+		inline constexpr std::string_view expr_op_name<decltype(mul_val_op)> = "operator* scalar";
+
+		template<typename Derived, typename T>
+		[[nodiscard]] inline auto gemm_operand(const expr_base<Derived, T>& obj, scratch_vector<T>& storage)
+			-> strided_view<const T> // @TODO: ISSUE #20
+		{
+			const auto rows = obj.rows();
+			const auto cols = obj.cols();
+
+			if constexpr (strided_expr<Derived>)
+			{
+				return strided_of(static_cast<const Derived&>(obj));
+			}
+			else if constexpr (evaluable_into<Derived, T>)
+			{
+				storage.resize(rows * cols);
+				static_cast<const Derived&>(obj).eval_into(strided_view<T>{ storage.data(), cols, 1 });
+
+				return { storage.data(), cols, 1 };
+			}
+			else
+			{
+				// Materializing nested expressions once is cheaper than recomputing each element k times
+				storage.resize(rows * cols);
+
+				for (auto row = std::size_t{}; row < rows; ++row)
+				{
+					for (auto col = std::size_t{}; col < cols; ++col)
+					{
+						storage[idx_1d(cols, row, col)] = obj(row, col);
+					}
+				}
+
+				return { storage.data(), cols, 1 };
+			}
+		}
+
+		struct mul_op_t
+		{
+			template<typename A, typename B>
+			[[nodiscard]] static auto flops(const A& a, const B& b) noexcept -> double
+			{
+				return 2.0 * static_cast<double>(a.rows()) * static_cast<double>(b.cols()) *
+					static_cast<double>(a.cols());
+			}
+
+			template<typename A, typename B>
+			[[nodiscard]] auto operator()(const A& a, const B& b, std::size_t row, std::size_t col) const noexcept ->
+				typename A::value_type
+			{
+				using value_type = typename A::value_type;
 
 				const auto a_cols = a.cols();
 				auto res          = value_type{};
@@ -51,7 +105,38 @@ namespace mpp
 				}
 
 				return res;
-			};
+			}
+
+			template<typename ADerived, typename BDerived, typename T>
+			void eval_into(const expr_base<ADerived, T>& a,
+				const expr_base<BDerived, T>& b,
+				strided_view<T> out) const // @TODO: ISSUE #20
+			{
+				auto a_storage = scratch_vector<T>{};
+				auto b_storage = scratch_vector<T>{};
+
+				const auto m         = a.rows();
+				const auto n         = b.cols();
+				const auto k         = a.cols();
+				const auto a_view    = gemm_operand(a, a_storage);
+				const auto b_view    = gemm_operand(b, b_storage);
+				const auto crossover = strassen_crossover();
+
+				if (strassen_recurses(m, n, k, crossover))
+				{
+					strassen(m, n, k, a_view, b_view, out, crossover);
+				}
+				else
+				{
+					gemm(m, n, k, a_view, b_view, out);
+				}
+			}
+		};
+
+		inline constexpr auto mul_op = mul_op_t{};
+
+		template<>
+		inline constexpr std::string_view expr_op_name<decltype(mul_op)> = "operator*";
 	} // namespace detail
 
 	template<typename Derived, typename T>
@@ -81,8 +166,8 @@ namespace mpp
 		return { a, b, a.rows(), b.cols(), detail::mul_op };
 	}
 
-	template<typename T, typename Buf>
-	inline auto operator*=(mat<T, Buf>& obj, T val) -> mat<T, Buf>& // @TODO: ISSUE #20
+	template<typename T, typename Buf, typename Layout>
+	inline auto operator*=(mat<T, Buf, Layout>& obj, T val) -> mat<T, Buf, Layout>& // @TODO: ISSUE #20
 	{
 		std::ranges::transform(obj, obj.begin(), std::bind_front(std::multiplies<>{}, val));
 
@@ -0,0 +1,122 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/arith/multiply.hpp>
+#include <mpp/banded/band_mat.hpp>
+#include <mpp/detail/expr/expr_binary_op.hpp>
+#include <mpp/detail/util/banded_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+namespace mpp
+{
+	namespace detail
+	{
+		/**
+		 * Diagonals under and over the diagonal
+		 */
+		template<typename T>
+		[[nodiscard]] inline auto band_widths(const band_mat<T>& obj) noexcept -> std::pair<std::size_t, std::size_t>
+		{
+			return { obj.lower(), obj.upper() };
+		}
+
+		template<typename T>
+		[[nodiscard]] inline auto band_widths(const tridiag_mat<T>&) noexcept -> std::pair<std::size_t, std::size_t>
+		{
+			return { 1, 1 };
+		}
+
+		/**
+		 * Products of a banded left operand with a right one that's read densely
+		 */
+		struct band_mul_op_t
+		{
+			template<typename A, typename B>
+			[[nodiscard]] static auto flops(const A& a, const B& b) noexcept -> double
+			{
+				const auto [lower, upper] = band_widths(a);
+
+				return 2.0 * static_cast<double>(a.rows() * (lower + upper + 1)) * static_cast<double>(b.cols());
+			}
+
+			template<typename A, typename B>
+			[[nodiscard]] auto operator()(const A& a, const B& b, std::size_t row, std::size_t col) const noexcept ->
+				typename A::value_type
+			{
+				const auto [lower, upper] = band_widths(a);
+				const auto last           = std::min(a.cols(), row + upper + 1);
+
+				auto res = typename A::value_type{};
+
+				for (auto idx = row > lower ? row - lower : 0; idx < last; ++idx)
+				{
+					res += a(row, idx) * b(idx, col);
+				}
+
+				return res;
+			}
+
+			template<typename A, typename B, typename T>
+			void eval_into(const A& a, const B& b, strided_view<T> out) const // @TODO: ISSUE #20
+			{
+				auto storage      = scratch_vector<T>{};
+				const auto b_view = gemm_operand(b, storage);
+
+				if constexpr (std::is_same_v<A, tridiag_mat<T>>)
+				{
+					tridiag_mul(a.lower().data(), a.diag().data(), a.upper().data(), a.rows(), b_view, out, b.cols());
+				}
+				else
+				{
+					band_mul(a.view(), b_view, out, b.cols());
+				}
+			}
+		};
+
+		inline constexpr auto band_mul_op = band_mul_op_t{};
+
+		template<>
+		inline constexpr std::string_view expr_op_name<decltype(band_mul_op)> = "operator* banded";
+	} // namespace detail
+
+	template<typename T, typename Derived>
+	[[nodiscard]] inline auto operator*(const band_mat<T>& a, const detail::expr_base<Derived, T>& b) noexcept
+		-> detail::expr_binary_op<band_mat<T>,
+			detail::expr_base<Derived, T>,
+			decltype(detail::band_mul_op)> // @TODO: ISSUE #20
+	{
+		return { a, b, a.rows(), b.cols(), detail::band_mul_op };
+	}
+
+	template<typename T, typename Derived>
+	[[nodiscard]] inline auto operator*(const tridiag_mat<T>& a, const detail::expr_base<Derived, T>& b) noexcept
+		-> detail::expr_binary_op<tridiag_mat<T>,
+			detail::expr_base<Derived, T>,
+			decltype(detail::band_mul_op)> // @TODO: ISSUE #20
+	{
+		return { a, b, a.rows(), b.cols(), detail::band_mul_op };
+	}
+} // namespace mpp
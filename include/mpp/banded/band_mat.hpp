@@ -0,0 +1,347 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/banded_impl.hpp>
+#include <mpp/detail/util/sparse_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mpp
+{
+	/**
+	 * Matrix that only stores the band of `lower` diagonals under its diagonal and `upper` ones over it, in the layout
+	 * of LAPACK: column after column, each holding lower + upper + 1 elements, so element (row, col) is at
+	 * (upper + row - col) + col * ld(). Slots of the layout outside the matrix are kept at zero
+	 */
+	template<typename T>
+	class band_mat : public detail::expr_base<band_mat<T>, T>
+	{
+		std::size_t rows_  = 0;
+		std::size_t cols_  = 0;
+		std::size_t lower_ = 0;
+		std::size_t upper_ = 0;
+
+		std::vector<T> bands_;
+
+	public:
+		using value_type = T;
+
+		band_mat() = default;
+
+		/**
+		 * rows x cols matrix of zeros
+		 */
+		band_mat(std::size_t rows, std::size_t cols, std::size_t lower, std::size_t upper) :
+			rows_(rows),
+			cols_(cols),
+			lower_(lower),
+			upper_(upper),
+			bands_((lower + upper + 1) * cols) // @TODO: ISSUE #20
+		{
+		}
+
+		/**
+		 * Takes over an array in the layout above
+		 */
+		band_mat(std::size_t rows, std::size_t cols, std::size_t lower, std::size_t upper, std::vector<T> bands) :
+			rows_(rows),
+			cols_(cols),
+			lower_(lower),
+			upper_(upper),
+			bands_(std::move(bands)) // @TODO: ISSUE #20
+		{
+			assert(bands_.size() == ld() * cols_);
+		}
+
+		/**
+		 * Band of a dense expression, elements outside of it are dropped
+		 */
+		template<typename Derived>
+		band_mat(const detail::expr_base<Derived, T>& obj, std::size_t lower, std::size_t upper) :
+			band_mat(obj.rows(), obj.cols(), lower, upper) // @TODO: ISSUE #20
+		{
+			const auto band = view();
+
+			for (auto col = std::size_t{}; col < cols_; ++col)
+			{
+				for (auto row = band.first_row(col); row < band.last_row(col); ++row)
+				{
+					band(row, col) = obj(row, col);
+				}
+			}
+		}
+
+		[[nodiscard]] auto rows() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return rows_;
+		}
+
+		[[nodiscard]] auto cols() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return cols_;
+		}
+
+		/**
+		 * Diagonals under the diagonal
+		 */
+		[[nodiscard]] auto lower() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return lower_;
+		}
+
+		/**
+		 * Diagonals over the diagonal
+		 */
+		[[nodiscard]] auto upper() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return upper_;
+		}
+
+		/**
+		 * Elements stored per column
+		 */
+		[[nodiscard]] auto ld() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return lower_ + upper_ + 1;
+		}
+
+		[[nodiscard]] auto bands() const noexcept -> std::span<const T> // @TODO: ISSUE #20
+		{
+			return bands_;
+		}
+
+		[[nodiscard]] auto bands() noexcept -> std::span<T> // @TODO: ISSUE #20
+		{
+			return bands_;
+		}
+
+		[[nodiscard]] auto in_band(std::size_t row, std::size_t col) const noexcept -> bool // @TODO: ISSUE #20
+		{
+			return view().in_band(row, col);
+		}
+
+		[[nodiscard]] auto operator()(std::size_t row, std::size_t col) const noexcept -> T // @TODO: ISSUE #20
+		{
+			assert(row < rows_ && col < cols_);
+
+			return in_band(row, col) ? view()(row, col) : T{};
+		}
+
+		/**
+		 * Elements in the band can be changed in place
+		 */
+		[[nodiscard]] auto at(std::size_t row, std::size_t col) noexcept -> T& // @TODO: ISSUE #20
+		{
+			assert(row < rows_ && col < cols_ && in_band(row, col));
+
+			return view()(row, col);
+		}
+
+		/**
+		 * Writes the matrix densely, zeros included
+		 */
+		void eval_into(detail::strided_view<T> out) const // @TODO: ISSUE #20
+		{
+			const auto band = view();
+
+			detail::fill_strided(out, rows_, cols_, T{});
+
+			for (auto col = std::size_t{}; col < cols_; ++col)
+			{
+				for (auto row = band.first_row(col); row < band.last_row(col); ++row)
+				{
+					out(row, col) = band(row, col);
+				}
+			}
+		}
+
+		[[nodiscard]] auto view() const noexcept -> detail::band_view<const T> // @TODO: ISSUE #20
+		{
+			return { bands_.data(), rows_, cols_, lower_, upper_ };
+		}
+
+		[[nodiscard]] auto view() noexcept -> detail::band_view<T> // @TODO: ISSUE #20
+		{
+			return { bands_.data(), rows_, cols_, lower_, upper_ };
+		}
+	};
+
+	/**
+	 * Square tridiagonal matrix in the layout of LAPACK's gtsv: its n - 1 elements under the diagonal, its n on the
+	 * diagonal and its n - 1 over it, each in an array of its own
+	 */
+	template<typename T>
+	class tridiag_mat : public detail::expr_base<tridiag_mat<T>, T>
+	{
+		std::vector<T> lower_;
+		std::vector<T> diag_;
+		std::vector<T> upper_;
+
+	public:
+		using value_type = T;
+
+		tridiag_mat() = default;
+
+		/**
+		 * n x n matrix of zeros
+		 */
+		explicit tridiag_mat(std::size_t n) :
+			lower_(n > 0 ? n - 1 : 0),
+			diag_(n),
+			upper_(n > 0 ? n - 1 : 0) // @TODO: ISSUE #20
+		{
+		}
+
+		tridiag_mat(std::vector<T> lower, std::vector<T> diag, std::vector<T> upper) :
+			lower_(std::move(lower)),
+			diag_(std::move(diag)),
+			upper_(std::move(upper)) // @TODO: ISSUE #20
+		{
+			assert(lower_.size() + 1 == std::max(diag_.size(), std::size_t{ 1 }) && lower_.size() == upper_.size());
+		}
+
+		[[nodiscard]] auto rows() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return diag_.size();
+		}
+
+		[[nodiscard]] auto cols() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return diag_.size();
+		}
+
+		[[nodiscard]] auto lower() const noexcept -> std::span<const T> // @TODO: ISSUE #20
+		{
+			return lower_;
+		}
+
+		[[nodiscard]] auto lower() noexcept -> std::span<T> // @TODO: ISSUE #20
+		{
+			return lower_;
+		}
+
+		[[nodiscard]] auto diag() const noexcept -> std::span<const T> // @TODO: ISSUE #20
+		{
+			return diag_;
+		}
+
+		[[nodiscard]] auto diag() noexcept -> std::span<T> // @TODO: ISSUE #20
+		{
+			return diag_;
+		}
+
+		[[nodiscard]] auto upper() const noexcept -> std::span<const T> // @TODO: ISSUE #20
+		{
+			return upper_;
+		}
+
+		[[nodiscard]] auto upper() noexcept -> std::span<T> // @TODO: ISSUE #20
+		{
+			return upper_;
+		}
+
+		[[nodiscard]] auto operator()(std::size_t row, std::size_t col) const noexcept -> T // @TODO: ISSUE #20
+		{
+			assert(row < rows() && col < cols());
+
+			if (row == col)
+			{
+				return diag_[row];
+			}
+
+			if (row == col + 1)
+			{
+				return lower_[col];
+			}
+
+			return col == row + 1 ? upper_[row] : T{};
+		}
+
+		/**
+		 * Writes the matrix densely, zeros included
+		 */
+		void eval_into(detail::strided_view<T> out) const // @TODO: ISSUE #20
+		{
+			const auto n = rows();
+
+			detail::fill_strided(out, n, n, T{});
+
+			for (auto idx = std::size_t{}; idx < n; ++idx)
+			{
+				out(idx, idx) = diag_[idx];
+
+				if (idx + 1 < n)
+				{
+					out(idx + 1, idx) = lower_[idx];
+					out(idx, idx + 1) = upper_[idx];
+				}
+			}
+		}
+
+		/**
+		 * The same matrix as a band_mat with one diagonal on each side
+		 */
+		[[nodiscard]] explicit operator band_mat<T>() const // @TODO: ISSUE #20
+		{
+			const auto n = rows();
+			auto out     = band_mat<T>(n, n, 1, 1);
+
+			for (auto idx = std::size_t{}; idx < n; ++idx)
+			{
+				out.at(idx, idx) = diag_[idx];
+
+				if (idx + 1 < n)
+				{
+					out.at(idx + 1, idx) = lower_[idx];
+					out.at(idx, idx + 1) = upper_[idx];
+				}
+			}
+
+			return out;
+		}
+	};
+
+	namespace detail
+	{
+		template<typename T>
+		struct is_banded : std::false_type
+		{
+		};
+
+		template<typename T>
+		struct is_banded<band_mat<T>> : std::true_type
+		{
+		};
+
+		template<typename T>
+		struct is_banded<tridiag_mat<T>> : std::true_type
+		{
+		};
+	} // namespace detail
+} // namespace mpp
@@ -0,0 +1,309 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/algo/lu.hpp>
+#include <mpp/banded/band_mat.hpp>
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/banded_impl.hpp>
+#include <mpp/detail/util/cpo_base.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/mat.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace mpp
+{
+	/**
+	 * Factors of a square banded matrix, kept in the band they came from: the LU decomposition has the multipliers of
+	 * its unit lower L under the diagonal and U on and over it, the Cholesky factor L only has a lower band
+	 */
+	template<typename T>
+	class band_factors
+	{
+		band_mat<T> factors_;
+		bool cholesky_ = false;
+
+	public:
+		using value_type = T;
+
+		band_factors() = default;
+
+		band_factors(band_mat<T> factors, bool cholesky) :
+			factors_(std::move(factors)),
+			cholesky_(cholesky) // @TODO: ISSUE #20
+		{
+			assert(factors_.rows() == factors_.cols());
+			assert(!cholesky_ || factors_.upper() == 0);
+
+			if (cholesky_)
+			{
+				detail::band_cholesky_inplace(factors_.view());
+			}
+			else
+			{
+				detail::band_lu_inplace(factors_.view());
+			}
+		}
+
+		[[nodiscard]] auto rows() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return factors_.rows();
+		}
+
+		[[nodiscard]] auto cols() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return factors_.cols();
+		}
+
+		[[nodiscard]] auto is_cholesky() const noexcept -> bool // @TODO: ISSUE #20
+		{
+			return cholesky_;
+		}
+
+		[[nodiscard]] auto factors() const noexcept -> const band_mat<T>& // @TODO: ISSUE #20
+		{
+			return factors_;
+		}
+
+		/**
+		 * x = A^-1 * x in place for one right hand side
+		 */
+		void solve_inplace(std::span<T> x) const // @TODO: ISSUE #20
+		{
+			assert(x.size() == rows());
+
+			solve_rows(x.data(), 1);
+		}
+
+		/**
+		 * X = A^-1 * B for every column of B at once
+		 */
+		template<typename Derived>
+		[[nodiscard]] auto solve(const detail::expr_base<Derived, T>& b) const -> mat<T> // @TODO: ISSUE #20
+		{
+			assert(b.rows() == rows());
+
+			auto x = mat<T>{ b };
+
+			solve_rows(x.data(), x.cols());
+
+			return x;
+		}
+
+	private:
+		void solve_rows(T* x, std::size_t cols) const
+		{
+			if (cholesky_)
+			{
+				detail::band_cholesky_solve(factors_.view(), x, cols);
+			}
+			else
+			{
+				detail::band_lu_solve(factors_.view(), x, cols);
+			}
+		}
+	};
+
+	struct band_lu_t : public detail::cpo_base<band_lu_t>
+	{
+		static constexpr auto name = std::string_view{ "band_lu" };
+
+		[[nodiscard]] static auto flops(const auto& obj) noexcept -> double // @TODO: ISSUE #20
+		{
+			return 2.0 * static_cast<double>(obj.rows() * obj.lower() * (obj.upper() + 1));
+		}
+
+		/**
+		 * LU decomposition of a square banded matrix without pivoting (like lu), in O(n * lower * upper). Without
+		 * pivoting the factors fit in the band of the matrix
+		 */
+		template<typename T>
+		[[nodiscard]] friend inline auto tag_invoke(band_lu_t, const band_mat<T>& obj)
+			-> band_factors<T> // @TODO: ISSUE #20
+		{
+			return { obj, false };
+		}
+	};
+
+	struct band_cholesky_t : public detail::cpo_base<band_cholesky_t>
+	{
+		static constexpr auto name = std::string_view{ "band_cholesky" };
+
+		[[nodiscard]] static auto flops(const auto& obj) noexcept -> double // @TODO: ISSUE #20
+		{
+			return static_cast<double>(obj.rows() * obj.lower() * (obj.lower() + 3));
+		}
+
+		/**
+		 * Cholesky factor of a symmetric positive definite banded matrix in O(n * lower^2), only the diagonal and the
+		 * band under it are read
+		 */
+		template<typename T>
+		[[nodiscard]] friend inline auto tag_invoke(band_cholesky_t, const band_mat<T>& obj)
+			-> band_factors<T> // @TODO: ISSUE #20
+		{
+			assert(obj.rows() == obj.cols());
+
+			const auto n = obj.rows();
+			auto lower   = band_mat<T>(n, n, obj.lower(), 0);
+
+			const auto from = obj.view();
+			const auto to   = lower.view();
+
+			for (auto col = std::size_t{}; col < n; ++col)
+			{
+				for (auto row = col; row < to.last_row(col); ++row)
+				{
+					to(row, col) = from(row, col);
+				}
+			}
+
+			return { std::move(lower), true };
+		}
+	};
+
+	struct tridiag_solve_t : public detail::cpo_base<tridiag_solve_t>
+	{
+		static constexpr auto name = std::string_view{ "tridiag_solve" };
+
+		/**
+		 * X = A^-1 * B with the Thomas algorithm in O(n) per column of B. It doesn't pivot, so A needs pivots away from
+		 * zero, which diagonally dominant (and symmetric positive definite) matrices have
+		 */
+		template<typename T, typename Derived>
+		[[nodiscard]] friend inline auto tag_invoke(tridiag_solve_t,
+			const tridiag_mat<T>& obj,
+			const detail::expr_base<Derived, T>& b) -> mat<T> // @TODO: ISSUE #20
+		{
+			assert(b.rows() == obj.rows());
+
+			auto x = mat<T>{ b };
+
+			auto scratch = detail::scratch_vector<T>(obj.rows());
+
+			detail::tridiag_solve(obj.lower().data(),
+				obj.diag().data(),
+				obj.upper().data(),
+				obj.rows(),
+				x.data(),
+				x.cols(),
+				scratch.data());
+
+			return x;
+		}
+
+		/**
+		 * x = A^-1 * x in place for one right hand side, with scratch of n elements
+		 */
+		template<typename T>
+		friend inline void tag_invoke(tridiag_solve_t,
+			const tridiag_mat<T>& obj,
+			std::span<T> x,
+			std::span<T> scratch) // @TODO: ISSUE #20
+		{
+			assert(x.size() == obj.rows() && scratch.size() >= obj.rows());
+
+			detail::tridiag_solve(obj.lower().data(),
+				obj.diag().data(),
+				obj.upper().data(),
+				obj.rows(),
+				x.data(),
+				1,
+				scratch.data());
+		}
+	};
+
+	struct tridiag_solve_batch_t : public detail::cpo_base<tridiag_solve_batch_t>
+	{
+		static constexpr auto name = std::string_view{ "tridiag_solve_batch" };
+
+		/**
+		 * Solves many independent tridiagonal systems of the same size in place with the Thomas algorithm, on several
+		 * threads when there are enough of them. The systems are interleaved: element k of system s is at
+		 * k * systems + s in every array, and lower[s] and upper[(n - 1) * systems + s] aren't read. x holds the right
+		 * hand sides and gets the solutions, scratch has the size of x
+		 */
+		template<typename T>
+		friend inline void tag_invoke(tridiag_solve_batch_t,
+			std::span<const T> lower,
+			std::span<const T> diag,
+			std::span<const T> upper,
+			std::span<T> x,
+			std::span<T> scratch,
+			std::size_t systems) // @TODO: ISSUE #20
+		{
+			assert(systems > 0 && diag.size() % systems == 0);
+			assert(lower.size() == diag.size() && upper.size() == diag.size() && x.size() == diag.size());
+			assert(scratch.size() >= diag.size());
+
+			detail::tridiag_solve_batch(lower.data(),
+				diag.data(),
+				upper.data(),
+				diag.size() / systems,
+				systems,
+				x.data(),
+				scratch.data());
+		}
+	};
+
+	inline constexpr auto band_lu             = band_lu_t{};
+	inline constexpr auto band_cholesky       = band_cholesky_t{};
+	inline constexpr auto tridiag_solve       = tridiag_solve_t{};
+	inline constexpr auto tridiag_solve_batch = tridiag_solve_batch_t{};
+
+	/**
+	 * L and U stay banded, with the lower and the upper band of the matrix
+	 */
+	template<typename T>
+	[[nodiscard]] inline auto tag_invoke(lu_t, const band_mat<T>& obj)
+		-> std::pair<band_mat<T>, band_mat<T>> // @TODO: ISSUE #20
+	{
+		const auto factors = band_lu(obj);
+		const auto lu      = factors.factors().view();
+		const auto n       = obj.rows();
+
+		auto l = band_mat<T>(n, n, obj.lower(), 0);
+		auto u = band_mat<T>(n, n, 0, obj.upper());
+
+		for (auto col = std::size_t{}; col < n; ++col)
+		{
+			l.at(col, col) = T{ 1 };
+
+			for (auto row = lu.first_row(col); row < lu.last_row(col); ++row)
+			{
+				if (row > col)
+				{
+					l.at(row, col) = lu(row, col);
+				}
+				else
+				{
+					u.at(row, col) = lu(row, col);
+				}
+			}
+		}
+
+		return { std::move(l), std::move(u) };
+	}
+} // namespace mpp
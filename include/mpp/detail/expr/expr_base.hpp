@@ -19,11 +19,21 @@
 
 #pragma once
 
+#include <mpp/detail/util/util.hpp>
+
 #include <cstddef>
 #include <stdexcept>
+#include <string_view>
 
 namespace mpp::detail
 {
+	/**
+	 * Name mpp::stats reports the materialization of an expression with this operation under, it's specialized next
+	 * to each operation
+	 */
+	template<typename Op>
+	inline constexpr std::string_view expr_op_name = "expression";
+
 	/**
 	 * Base class for expression objects
 	 */
@@ -59,4 +69,45 @@ namespace mpp::detail
 			return derived()(row, col);
 		}
 	};
+
+	/**
+	 * Matrices, and expressions that only re-index a matrix (e.g. a lazy transpose), can be read in place through a
+	 * strided view instead of being materialized
+	 */
+	template<typename Expr>
+	concept strided_expr = is_mat<Expr>::value || requires(const Expr& expr)
+	{
+		expr.strided();
+	};
+
+	template<strided_expr Expr>
+	[[nodiscard]] inline auto strided_of(const Expr& expr) noexcept // @TODO: ISSUE #20
+	{
+		if constexpr (is_mat<Expr>::value)
+		{
+			const auto [rs, cs] = Expr::layout_type::strides(expr.rows(), expr.cols());
+			return strided_view<const typename Expr::value_type>{ expr.data(), rs, cs };
+		}
+		else
+		{
+			return expr.strided();
+		}
+	}
+
+	template<typename Mat>
+	requires(is_mat<Mat>::value) [[nodiscard]] inline auto strided_of_mut(Mat& obj) noexcept // @TODO: ISSUE #20
+		-> strided_view<typename Mat::value_type>
+	{
+		const auto [rs, cs] = Mat::layout_type::strides(obj.rows(), obj.cols());
+		return { obj.data(), rs, cs };
+	}
+
+	/**
+	 * Expressions that know a faster way to produce all of their elements at once than computing them one by one
+	 */
+	template<typename Expr, typename T>
+	concept evaluable_into = requires(const Expr& expr, strided_view<T> out)
+	{
+		expr.eval_into(out);
+	};
 } // namespace mpp::detail
\ No newline at end of file
@@ -46,6 +46,23 @@ namespace mpp::detail
 	public:
 		using value_type = typename Left::value_type;
 
+		static constexpr auto op_name = expr_op_name<Op>;
+
+		/**
+		 * Estimated flops of evaluating every element, for mpp::stats
+		 */
+		[[nodiscard]] auto flops() const noexcept -> double // @TODO: ISSUE #20
+		{
+			if constexpr (requires { Op::flops(left_, right_); })
+			{
+				return Op::flops(left_, right_);
+			}
+			else
+			{
+				return static_cast<double>(result_rows_) * static_cast<double>(result_cols_);
+			}
+		}
+
 		expr_binary_op(const Left& a,
 			const Right& b,
 			std::size_t result_rows,
@@ -75,5 +92,15 @@ namespace mpp::detail
 		{
 			return op_(left_, right_, row_index, col_index);
 		}
+
+		template<typename T>
+		requires requires(const Op& op, const Left& left, const Right& right, strided_view<T> out)
+		{
+			op.eval_into(left, right, out);
+		}
+		void eval_into(strided_view<T> out) const // @TODO: ISSUE #20
+		{
+			op_.eval_into(left_, right_, out);
+		}
 	};
 } // namespace mpp::detail
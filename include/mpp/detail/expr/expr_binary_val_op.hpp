@@ -46,6 +46,16 @@ namespace mpp::detail
 	public:
 		using value_type = T;
 
+		static constexpr auto op_name = expr_op_name<Op>;
+
+		/**
+		 * Estimated flops of evaluating every element, for mpp::stats
+		 */
+		[[nodiscard]] auto flops() const noexcept -> double // @TODO: ISSUE #20
+		{
+			return static_cast<double>(result_rows_) * static_cast<double>(result_cols_);
+		}
+
 		expr_binary_val_op(const Obj& obj,
 			T val,
 			std::size_t result_rows,
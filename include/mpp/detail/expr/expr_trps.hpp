@@ -0,0 +1,78 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/trps_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+
+#include <cstddef>
+#include <string_view>
+
+namespace mpp::detail
+{
+	/**
+	 * Transpose expression object, reads the operand with swapped indices instead of copying it
+	 *
+	 * Consumers that understand strides (e.g. matrix multiplication) read the operand in place, so the transposed
+	 * copy is only made when a result is materialized
+	 */
+	template<typename Obj>
+	class [[nodiscard]] expr_trps : public expr_base<expr_trps<Obj>, typename Obj::value_type>
+	{
+		// Store the operand by reference to avoid copying it
+		const Obj& obj_;
+
+	public:
+		using value_type = typename Obj::value_type;
+
+		static constexpr auto op_name = std::string_view{ "trps (lazy)" };
+
+		explicit expr_trps(const Obj& obj) noexcept : obj_(obj) {} // @TODO: ISSUE #20
+
+		[[nodiscard]] auto rows() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return obj_.cols();
+		}
+
+		[[nodiscard]] auto cols() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return obj_.rows();
+		}
+
+		[[nodiscard]] auto operator()(std::size_t row_index, std::size_t col_index) const noexcept
+			-> value_type // @TODO: ISSUE #20
+		{
+			return obj_(col_index, row_index);
+		}
+
+		[[nodiscard]] auto strided() const noexcept -> strided_view<const value_type> requires(strided_expr<Obj>)
+		{
+			return strided_of(obj_).trps();
+		}
+
+		void eval_into(strided_view<value_type> out) const requires(strided_expr<Obj>) // @TODO: ISSUE #20
+		{
+			// Writing the operand into the transposed output is a strided copy, which picks the tiled transpose
+			// when the storage orders differ
+			copy_strided(obj_.rows(), obj_.cols(), strided_of(obj_), out.trps());
+		}
+	};
+} // namespace mpp::detail
@@ -22,6 +22,7 @@
 #include <compare>
 #include <cstddef>
 #include <iterator>
+#include <utility>
 
 namespace mpp::detail
 {
@@ -36,7 +37,15 @@ namespace mpp::detail
 		using traits = std::iterator_traits<It>;
 
 		It current_;
-		std::size_t cols_;
+		std::size_t row_stride_;
+		std::size_t col_stride_;
+
+		[[nodiscard]] auto offset_of(const std::pair<typename traits::difference_type,
+			typename traits::difference_type>& p) const noexcept -> typename traits::difference_type
+		{
+			using diff_t = typename traits::difference_type;
+			return p.first * static_cast<diff_t>(row_stride_) + p.second * static_cast<diff_t>(col_stride_);
+		}
 
 	public:
 		using value_type        = typename traits::value_type;
@@ -47,8 +56,15 @@ namespace mpp::detail
 																// but we do meet its requirements
 
 		explicit mat_iter(It current, std::size_t cols) noexcept(std::is_nothrow_copy_constructible_v<It>) :
+			mat_iter(current, cols, 1) // @TODO: ISSUE #20
+		{
+		}
+
+		mat_iter(It current, std::size_t row_stride, std::size_t col_stride) noexcept(
+			std::is_nothrow_copy_constructible_v<It>) :
 			current_(current),
-			cols_(cols) // @TODO: ISSUE #20
+			row_stride_(row_stride),
+			col_stride_(col_stride) // @TODO: ISSUE #20
 		{
 		}
 
@@ -72,7 +88,7 @@ namespace mpp::detail
 
 		auto operator++(int) noexcept -> mat_iter // @TODO: ISSUE #20
 		{
-			auto old = mat_iter<It>(current_, cols_);
+			auto old = mat_iter<It>(current_, row_stride_, col_stride_);
 
 			++current_;
 			return old;
@@ -86,12 +102,12 @@ namespace mpp::detail
 
 		[[nodiscard]] friend auto operator+(const mat_iter& iter, difference_type n) -> mat_iter // @TODO: ISSUE #20
 		{
-			return mat_iter(iter.current_ + n, iter.cols_);
+			return mat_iter(iter.current_ + n, iter.row_stride_, iter.col_stride_);
 		}
 
 		[[nodiscard]] friend auto operator+(difference_type n, const mat_iter& iter) -> mat_iter // @TODO: ISSUE #20
 		{
-			return mat_iter(iter.current_ + n, iter.cols_);
+			return mat_iter(iter.current_ + n, iter.row_stride_, iter.col_stride_);
 		}
 
 		auto operator--() -> mat_iter& // @TODO: ISSUE #20
@@ -102,7 +118,7 @@ namespace mpp::detail
 
 		auto operator--(int) -> mat_iter // @TODO: ISSUE #20
 		{
-			auto old = mat_iter<It>(current_, cols_);
+			auto old = mat_iter<It>(current_, row_stride_, col_stride_);
 
 			--current_;
 			return old;
@@ -116,7 +132,7 @@ namespace mpp::detail
 
 		[[nodiscard]] friend auto operator-(const mat_iter& iter, difference_type n) -> mat_iter // @TODO: ISSUE #20
 		{
-			return mat_iter(iter.current_ - n, iter.cols_);
+			return mat_iter(iter.current_ - n, iter.row_stride_, iter.col_stride_);
 		}
 
 		[[nodiscard]] auto operator[](difference_type n) -> reference // @TODO: ISSUE #20
@@ -154,7 +170,8 @@ namespace mpp::detail
 			using std::swap;
 
 			swap(a.current_, b.current_);
-			swap(a.cols_, b.cols_);
+			swap(a.row_stride_, b.row_stride_);
+			swap(a.col_stride_, b.col_stride_);
 		}
 
 		/**
@@ -163,46 +180,43 @@ namespace mpp::detail
 
 		auto advance_fwd_rows(difference_type rows) -> mat_iter& // @TODO: ISSUE #20
 		{
-			current_ += static_cast<difference_type>(cols_) * rows;
+			current_ += static_cast<difference_type>(row_stride_) * rows;
 			return *this;
 		}
 
 		auto advance_back_rows(difference_type rows) -> mat_iter& // @TODO: ISSUE #20
 		{
-			current_ -= static_cast<difference_type>(cols_) * rows;
+			current_ -= static_cast<difference_type>(row_stride_) * rows;
 			return *this;
 		}
 
 		[[nodiscard]] friend auto operator+(const mat_iter& iter, const std::pair<difference_type, difference_type>& p)
 			-> mat_iter // @TODO: ISSUE #20
 		{
-			const auto offset = p.first * static_cast<difference_type>(iter.cols_) + p.second;
-			return mat_iter(iter.current_ + offset, iter.cols_);
+			return mat_iter(iter.current_ + iter.offset_of(p), iter.row_stride_, iter.col_stride_);
 		}
 
 		[[nodiscard]] friend auto operator+(const std::pair<difference_type, difference_type>& p,
 			const mat_iter& iter) -> mat_iter // @TODO: ISSUE #20
 		{
-			const auto offset = p.first * static_cast<difference_type>(iter.cols_) + p.second;
-			return mat_iter(iter.current_ + offset, iter.cols_);
+			return mat_iter(iter.current_ + iter.offset_of(p), iter.row_stride_, iter.col_stride_);
 		}
 
 		[[nodiscard]] friend auto operator-(const mat_iter& iter, const std::pair<difference_type, difference_type>& p)
 			-> mat_iter // @TODO: ISSUE #20
 		{
-			const auto offset = p.first * static_cast<difference_type>(iter.cols_) + p.second;
-			return mat_iter(iter.current_ - offset, iter.cols_);
+			return mat_iter(iter.current_ - iter.offset_of(p), iter.row_stride_, iter.col_stride_);
 		}
 
 		auto operator+=(const std::pair<difference_type, difference_type>& p) -> mat_iter& // @TODO: ISSUE #20
 		{
-			current_ += p.first * static_cast<difference_type>(cols_) + p.second;
+			current_ += offset_of(p);
 			return *this;
 		}
 
 		auto operator-=(const std::pair<difference_type, difference_type>& p) -> mat_iter& // @TODO: ISSUE #20
 		{
-			current_ -= p.first * static_cast<difference_type>(cols_) + p.second;
+			current_ -= offset_of(p);
 			return *this;
 		}
 	};
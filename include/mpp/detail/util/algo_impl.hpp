@@ -19,14 +19,25 @@
 
 #pragma once
 
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/trps_impl.hpp>
 #include <mpp/detail/util/util.hpp>
 #include <mpp/mat.hpp>
 
+#ifdef MPP_INSTRUMENT
+	#include <mpp/detail/util/instrument.hpp>
+
+	#include <optional>
+#endif
+
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <memory>
+#include <ranges>
 #include <type_traits>
+#include <utility>
 
 namespace mpp::detail
 {
@@ -51,6 +62,78 @@ namespace mpp::detail
 		}
 	}
 
+	/**
+	 * Copies a matrix into a new compact row major buffer, which is what the factorization kernels work on
+	 */
+	template<typename Buf, typename Mat>
+	inline auto copy_into_new_buf(const Mat& obj, std::size_t rows, std::size_t cols) -> Buf // @TODO: ISSUE #20
+	{
+		using val_t = typename Buf::value_type;
+
+		auto buf = Buf{};
+		resize_buf_if_dyn(buf, rows, cols, val_t{});
+
+		if constexpr (std::is_same_v<typename Mat::layout_type, row_major>)
+		{
+			std::ranges::copy(obj, std::ranges::begin(buf));
+		}
+		else
+		{
+			copy_strided(rows, cols, strided_of(obj), strided_view<val_t>{ buf.data(), cols, 1 });
+		}
+
+		return buf;
+	}
+
+	/**
+	 * Builds a rows x cols To whose elements are written by fill through a strided view. Unpadded layouts fill a bare
+	 * buffer and hand it over, padded layouts can't adopt buffers so they're filled in place
+	 */
+	template<typename To>
+	inline auto make_mat_with(std::size_t rows, std::size_t cols, auto&& fill) -> To // @TODO: ISSUE #20
+	{
+		using val_t    = typename To::value_type;
+		using layout_t = typename To::layout_type;
+
+		if constexpr (layout_t::padded)
+		{
+			auto out = To(rows, cols);
+			fill(strided_of_mut(out));
+
+			return out;
+		}
+		else
+		{
+			auto buf = typename To::buffer_type{};
+			resize_buf_if_dyn<layout_t>(buf, rows, cols, val_t{});
+
+			const auto [rs, cs] = layout_t::strides(rows, cols);
+			fill(strided_view<val_t>{ buf.data(), rs, cs });
+
+			return To{ rows, cols, std::move(buf) };
+		}
+	}
+
+	/**
+	 * Builds a To out of a compact row major buffer, reordering it when To uses another layout
+	 */
+	template<typename To, typename Buf>
+	inline auto mat_from_row_major(std::size_t rows, std::size_t cols, Buf&& buf) -> To // @TODO: ISSUE #20
+	{
+		if constexpr (std::is_same_v<typename To::layout_type, row_major>)
+		{
+			return To{ rows, cols, std::forward<Buf>(buf) };
+		}
+		else
+		{
+			using buf_val_t = typename std::remove_cvref_t<Buf>::value_type;
+
+			return make_mat_with<To>(rows, cols, [&](auto out) {
+				copy_strided(rows, cols, strided_view<const buf_val_t>{ buf.data(), cols, 1 }, out);
+			});
+		}
+	}
+
 	template<typename To, bool FillL, bool GetDet>
 	inline auto lu_algo(std::size_t rows, std::size_t cols, auto& l, auto& u) -> To // @TODO: ISSUE #20
 	{
@@ -63,8 +146,20 @@ namespace mpp::detail
 
 		auto det_ = To{ 1 };
 
+#ifdef MPP_INSTRUMENT
+		auto panel = std::optional<instrument::span>{};
+#endif
+
 		for (auto row = std::size_t{}; row < rows; ++row)
 		{
+#ifdef MPP_INSTRUMENT
+			if (row % instrument::lu_panel_rows == 0)
+			{
+				panel.reset();
+				panel.emplace(instrument::lu_panel_span, row, rows, cols);
+			}
+#endif
+
 			// Micro-optimization: allow other indexes to reference this instead of multi-step calculation
 			const auto diag_front_idx = idx_1d(cols, row, std::size_t{});
 			const auto diag_idx       = diag_front_idx + row;
@@ -108,8 +203,14 @@ namespace mpp::detail
 	template<typename Buf>
 	inline auto back_sub_buf(const auto& a, const auto& b, std::size_t n) -> Buf // @TODO: ISSUE #20
 	{
+		// a and b are anything indexable with (row, col), e.g. matrices or strided views
+
 		using buf_val_t = typename Buf::value_type;
 
+#ifdef MPP_INSTRUMENT
+		const auto sweep = instrument::span{ instrument::back_sweep_span, n };
+#endif
+
 		auto buf = Buf{};
 
 		resize_buf_if_dyn(buf, n, 1, buf_val_t{});
@@ -122,14 +223,14 @@ namespace mpp::detail
 		{
 			const auto row_idx = row - 1;
 
-			auto res = static_cast<buf_val_t>(b[idx_1d(1, row_idx, 0)]);
+			auto res = static_cast<buf_val_t>(b(row_idx, 0));
 
 			for (auto col = n - 1; col > row_idx; --col)
 			{
-				res -= a[idx_1d(n, row_idx, col)] * buf[col];
+				res -= a(row_idx, col) * buf[col];
 			}
 
-			const auto diag = static_cast<buf_val_t>(a[idx_1d(n, row_idx, row_idx)]);
+			const auto diag = static_cast<buf_val_t>(a(row_idx, row_idx));
 
 			assert(!is_zero_or_nan(diag));
 
@@ -144,8 +245,14 @@ namespace mpp::detail
 	template<typename Buf>
 	inline auto fwd_sub_buf(const auto& a, const auto& b, std::size_t n) -> Buf // @TODO: ISSUE #20
 	{
+		// a and b are anything indexable with (row, col), e.g. matrices or strided views
+
 		using buf_val_t = typename Buf::value_type;
 
+#ifdef MPP_INSTRUMENT
+		const auto sweep = instrument::span{ instrument::fwd_sweep_span, n };
+#endif
+
 		auto buf = Buf{};
 
 		resize_buf_if_dyn(buf, n, 1, buf_val_t{});
@@ -156,14 +263,14 @@ namespace mpp::detail
 		 */
 		for (auto row = std::size_t{}; row < n; ++row)
 		{
-			auto res = static_cast<buf_val_t>(b[idx_1d(1, row, 0)]);
+			auto res = static_cast<buf_val_t>(b(row, 0));
 
 			for (auto col = std::size_t{}; col < row; ++col)
 			{
-				res -= a[idx_1d(n, row, col)] * buf[col];
+				res -= a(row, col) * buf[col];
 			}
 
-			const auto diag = static_cast<buf_val_t>(a[idx_1d(n, row, row)]);
+			const auto diag = static_cast<buf_val_t>(a(row, row));
 
 			assert(!is_zero_or_nan(diag));
 
@@ -0,0 +1,488 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/algo_impl.hpp>
+#include <mpp/detail/util/thread_pool.hpp>
+#include <mpp/detail/util/util.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+namespace mpp::detail
+{
+	// Below this many multiply-adds, banded kernels don't wake up the thread pool
+	inline constexpr auto band_par_madds = std::size_t{ 1 } << 16;
+
+	// Rows of a banded product, and systems of a batch of tridiagonal ones, that a task takes. Systems of a batch are
+	// interleaved, so a task's systems are contiguous and the loops over them vectorize
+	inline constexpr auto band_rows_per_task      = std::size_t{ 256 };
+	inline constexpr auto tridiag_systems_per_task = std::size_t{ 64 };
+
+	/**
+	 * Band of a matrix in the layout of LAPACK: column after column, each holding the upper + 1 + lower elements
+	 * around the diagonal, so element (row, col) is at (upper + row - col) + col * ld
+	 */
+	template<typename T>
+	struct band_view
+	{
+		T* data;
+		std::size_t rows;
+		std::size_t cols;
+		std::size_t lower;
+		std::size_t upper;
+
+		[[nodiscard]] auto ld() const noexcept -> std::size_t
+		{
+			return lower + upper + 1;
+		}
+
+		[[nodiscard]] auto in_band(std::size_t row, std::size_t col) const noexcept -> bool
+		{
+			return row + upper >= col && row <= col + lower;
+		}
+
+		[[nodiscard]] auto operator()(std::size_t row, std::size_t col) const noexcept -> T&
+		{
+			return data[upper + row - col + col * ld()];
+		}
+
+		// Rows of the band in a column
+		[[nodiscard]] auto first_row(std::size_t col) const noexcept -> std::size_t
+		{
+			return col > upper ? col - upper : 0;
+		}
+
+		[[nodiscard]] auto last_row(std::size_t col) const noexcept -> std::size_t
+		{
+			return std::min(rows, col + lower + 1);
+		}
+	};
+
+	/**
+	 * Runs fn(first, last) over [0, n) in tasks of `per_task`, in parallel if madds is big enough
+	 */
+	template<typename Fn>
+	inline void for_each_band_task(std::size_t n, std::size_t per_task, std::size_t madds, Fn&& fn)
+	{
+		if (madds < band_par_madds || max_threads() <= 1)
+		{
+			fn(std::size_t{}, n);
+			return;
+		}
+
+		parallel_for(div_round_up(n, per_task), [&](std::size_t task) {
+			fn(task * per_task, std::min(n, (task + 1) * per_task));
+		});
+	}
+
+	/**
+	 * LU decomposition without pivoting (like lu) in place: U goes to the diagonal and above, and the multipliers of
+	 * the unit lower L below it. Without pivoting there's no fill-in outside the band
+	 */
+	template<typename T>
+	inline void band_lu_inplace(band_view<T> a)
+	{
+		const auto n = std::min(a.rows, a.cols);
+
+		for (auto k = std::size_t{}; k < n; ++k)
+		{
+			const auto pivot = a(k, k);
+
+			assert(!is_zero_or_nan(pivot));
+
+			const auto row_last = a.last_row(k);
+			const auto col_last = std::min(a.cols, k + a.upper + 1);
+
+			// The column of L under the pivot is contiguous, and so is every column of the update
+			auto* const l_col = &a(k, k);
+
+			for (auto row = k + 1; row < row_last; ++row)
+			{
+				l_col[row - k] /= pivot;
+			}
+
+			for (auto col = k + 1; col < col_last; ++col)
+			{
+				auto* const a_col = &a(k, col);
+				const auto u_elem = a_col[0];
+
+				for (auto row = k + 1; row < row_last; ++row)
+				{
+					a_col[row - k] -= l_col[row - k] * u_elem;
+				}
+			}
+		}
+	}
+
+	/**
+	 * Cholesky decomposition in place of a band that only stores the diagonal and below (upper is zero)
+	 */
+	template<typename T>
+	inline void band_cholesky_inplace(band_view<T> a)
+	{
+		assert(a.upper == 0);
+
+		for (auto k = std::size_t{}; k < a.cols; ++k)
+		{
+			auto* const l_col = &a(k, k);
+
+			assert(l_col[0] > T{});
+
+			const auto diag     = std::sqrt(l_col[0]);
+			const auto row_last = a.last_row(k);
+
+			l_col[0] = diag;
+
+			for (auto row = k + 1; row < row_last; ++row)
+			{
+				l_col[row - k] /= diag;
+			}
+
+			// Only the lower triangle of the trailing update is kept
+			for (auto col = k + 1; col < row_last; ++col)
+			{
+				auto* const a_col = &a(col, col);
+				const auto l_elem = l_col[col - k];
+
+				for (auto row = col; row < row_last; ++row)
+				{
+					a_col[row - col] -= l_col[row - k] * l_elem;
+				}
+			}
+		}
+	}
+
+	/**
+	 * x = U^-1 * L^-1 * x for the factors of band_lu_inplace, where x is n x m in row major
+	 */
+	template<typename T>
+	inline void band_lu_solve(band_view<const T> lu, T* x, std::size_t m)
+	{
+		const auto n = lu.cols;
+
+		for (auto col = std::size_t{}; col < n; ++col)
+		{
+			const auto* const l_col = &lu(col, col);
+			const auto* const x_col = x + col * m;
+
+			for (auto row = col + 1; row < lu.last_row(col); ++row)
+			{
+				const auto l_elem = l_col[row - col];
+				auto* const x_row = x + row * m;
+
+				for (auto rhs = std::size_t{}; rhs < m; ++rhs)
+				{
+					x_row[rhs] -= l_elem * x_col[rhs];
+				}
+			}
+		}
+
+		for (auto col = n; col-- > 0;)
+		{
+			auto* const x_col = x + col * m;
+			const auto diag   = lu(col, col);
+
+			for (auto rhs = std::size_t{}; rhs < m; ++rhs)
+			{
+				x_col[rhs] /= diag;
+			}
+
+			for (auto row = lu.first_row(col); row < col; ++row)
+			{
+				const auto u_elem = lu(row, col);
+				auto* const x_row = x + row * m;
+
+				for (auto rhs = std::size_t{}; rhs < m; ++rhs)
+				{
+					x_row[rhs] -= u_elem * x_col[rhs];
+				}
+			}
+		}
+	}
+
+	/**
+	 * x = L^-T * L^-1 * x for the factor of band_cholesky_inplace, where x is n x m in row major
+	 */
+	template<typename T>
+	inline void band_cholesky_solve(band_view<const T> l, T* x, std::size_t m)
+	{
+		const auto n = l.cols;
+
+		for (auto col = std::size_t{}; col < n; ++col)
+		{
+			const auto* const l_col = &l(col, col);
+			auto* const x_col       = x + col * m;
+
+			for (auto rhs = std::size_t{}; rhs < m; ++rhs)
+			{
+				x_col[rhs] /= l_col[0];
+			}
+
+			for (auto row = col + 1; row < l.last_row(col); ++row)
+			{
+				const auto l_elem = l_col[row - col];
+				auto* const x_row = x + row * m;
+
+				for (auto rhs = std::size_t{}; rhs < m; ++rhs)
+				{
+					x_row[rhs] -= l_elem * x_col[rhs];
+				}
+			}
+		}
+
+		// L^T has the columns of L as its rows
+		for (auto col = n; col-- > 0;)
+		{
+			const auto* const l_col = &l(col, col);
+			auto* const x_col       = x + col * m;
+
+			for (auto row = col + 1; row < l.last_row(col); ++row)
+			{
+				const auto l_elem       = l_col[row - col];
+				const auto* const x_row = x + row * m;
+
+				for (auto rhs = std::size_t{}; rhs < m; ++rhs)
+				{
+					x_col[rhs] -= l_elem * x_row[rhs];
+				}
+			}
+
+			for (auto rhs = std::size_t{}; rhs < m; ++rhs)
+			{
+				x_col[rhs] /= l_col[0];
+			}
+		}
+	}
+
+	/**
+	 * out = a * b for a band a and a dense b of n columns, a task of rows at a time
+	 */
+	template<typename T>
+	inline void band_mul(band_view<const T> a, strided_view<const T> b, strided_view<T> out, std::size_t n)
+	{
+		const auto madds = a.rows * a.ld() * n;
+
+		for_each_band_task(a.rows, band_rows_per_task, madds, [&](std::size_t first, std::size_t last) {
+			for (auto row = first; row < last; ++row)
+			{
+				const auto col_first = row > a.lower ? row - a.lower : 0;
+				const auto col_last  = std::min(a.cols, row + a.upper + 1);
+
+				// Matrix-vector products keep the sum in a register
+				if (n == 1)
+				{
+					auto sum = T{};
+
+					for (auto inner = col_first; inner < col_last; ++inner)
+					{
+						sum += a(row, inner) * b(inner, 0);
+					}
+
+					out(row, 0) = sum;
+					continue;
+				}
+
+				for (auto col = std::size_t{}; col < n; ++col)
+				{
+					out(row, col) = T{};
+				}
+
+				for (auto inner = col_first; inner < col_last; ++inner)
+				{
+					const auto elem = a(row, inner);
+
+					for (auto col = std::size_t{}; col < n; ++col)
+					{
+						out(row, col) += elem * b(inner, col);
+					}
+				}
+			}
+		});
+	}
+
+	/**
+	 * out = a * b for a tridiagonal a of diagonals (lower, diag, upper) and a dense b of n columns
+	 */
+	template<typename T>
+	inline void tridiag_mul(const T* lower,
+		const T* diag,
+		const T* upper,
+		std::size_t rows,
+		strided_view<const T> b,
+		strided_view<T> out,
+		std::size_t n)
+	{
+		for_each_band_task(rows, band_rows_per_task, rows * 3 * n, [&](std::size_t first, std::size_t last) {
+			for (auto row = first; row < last; ++row)
+			{
+				for (auto col = std::size_t{}; col < n; ++col)
+				{
+					auto sum = diag[row] * b(row, col);
+
+					if (row > 0)
+					{
+						sum += lower[row - 1] * b(row - 1, col);
+					}
+
+					if (row + 1 < rows)
+					{
+						sum += upper[row] * b(row + 1, col);
+					}
+
+					out(row, col) = sum;
+				}
+			}
+		});
+	}
+
+	/**
+	 * Thomas algorithm: x = A^-1 * x for a tridiagonal A of diagonals (lower, diag, upper), where x is rows x m in
+	 * row major. It's Gaussian elimination without pivoting, so it needs pivots away from zero (which diagonally
+	 * dominant matrices have). scratch holds the rows - 1 eliminated upper diagonal
+	 */
+	template<typename T>
+	inline void tridiag_solve(const T* lower,
+		const T* diag,
+		const T* upper,
+		std::size_t rows,
+		T* x,
+		std::size_t m,
+		T* scratch)
+	{
+		if (rows == 0)
+		{
+			return;
+		}
+
+		auto pivot = diag[0];
+
+		for (auto row = std::size_t{}; row < rows; ++row)
+		{
+			auto* const x_row = x + row * m;
+
+			if (row > 0)
+			{
+				const auto l_elem       = lower[row - 1];
+				const auto* const x_prev = x_row - m;
+
+				pivot = diag[row] - l_elem * scratch[row - 1];
+
+				for (auto rhs = std::size_t{}; rhs < m; ++rhs)
+				{
+					x_row[rhs] -= l_elem * x_prev[rhs];
+				}
+			}
+
+			assert(!is_zero_or_nan(pivot));
+
+			const auto inv_pivot = T{ 1 } / pivot;
+
+			if (row + 1 < rows)
+			{
+				scratch[row] = upper[row] * inv_pivot;
+			}
+
+			for (auto rhs = std::size_t{}; rhs < m; ++rhs)
+			{
+				x_row[rhs] *= inv_pivot;
+			}
+		}
+
+		for (auto row = rows - 1; row-- > 0;)
+		{
+			auto* const x_row        = x + row * m;
+			const auto* const x_next = x_row + m;
+
+			for (auto rhs = std::size_t{}; rhs < m; ++rhs)
+			{
+				x_row[rhs] -= scratch[row] * x_next[rhs];
+			}
+		}
+	}
+
+	/**
+	 * Thomas algorithm for a batch of independent tridiagonal systems of the same size, interleaved: element k of
+	 * system s is at k * systems + s in every array (lower at k = 0 and upper at k = rows - 1 aren't read). x holds
+	 * the right hand sides and gets the solutions, scratch has the size of x
+	 */
+	template<typename T>
+	inline void tridiag_solve_batch(const T* lower,
+		const T* diag,
+		const T* upper,
+		std::size_t rows,
+		std::size_t systems,
+		T* x,
+		T* scratch)
+	{
+		if (rows == 0)
+		{
+			return;
+		}
+
+		// scratch keeps the upper diagonal divided by the pivots of the elimination, for the back substitution (the
+		// last row has no upper element, so it gets 0)
+		for_each_band_task(systems,
+			tridiag_systems_per_task,
+			rows * systems * 8,
+			[&](std::size_t first, std::size_t last) {
+				for (auto sys = first; sys < last; ++sys)
+				{
+					assert(!is_zero_or_nan(diag[sys]));
+
+					const auto inv_pivot = T{ 1 } / diag[sys];
+
+					scratch[sys] = rows > 1 ? upper[sys] * inv_pivot : T{};
+					x[sys] *= inv_pivot;
+				}
+
+				for (auto row = std::size_t{ 1 }; row < rows; ++row)
+				{
+					const auto at   = row * systems;
+					const auto prev = at - systems;
+
+					for (auto sys = first; sys < last; ++sys)
+					{
+						const auto pivot = diag[at + sys] - lower[at + sys] * scratch[prev + sys];
+
+						assert(!is_zero_or_nan(pivot));
+
+						const auto inv_pivot = T{ 1 } / pivot;
+
+						scratch[at + sys] = row + 1 < rows ? upper[at + sys] * inv_pivot : T{};
+						x[at + sys]       = (x[at + sys] - lower[at + sys] * x[prev + sys]) * inv_pivot;
+					}
+				}
+
+				for (auto row = rows - 1; row-- > 0;)
+				{
+					const auto at   = row * systems;
+					const auto next = at + systems;
+
+					for (auto sys = first; sys < last; ++sys)
+					{
+						x[at + sys] -= scratch[at + sys] * x[next + sys];
+					}
+				}
+			});
+	}
+} // namespace mpp::detail
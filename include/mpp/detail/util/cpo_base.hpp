@@ -21,6 +21,10 @@
 
 #include <mpp/detail/util/tag_invoke.hpp>
 
+#ifdef MPP_INSTRUMENT
+	#include <mpp/detail/util/instrument.hpp>
+#endif
+
 namespace mpp::detail
 {
 	template<typename CPO>
@@ -31,6 +35,10 @@ namespace mpp::detail
 			noexcept(noexcept(tag_invoke_cpo(CPO{}, std::forward<Args>(args)...)))
 				-> tag_invoke_result_t<CPO, Args...> // @TODO: ISSUE #20
 		{
+#ifdef MPP_INSTRUMENT
+			const auto probe = instrument::cpo_probe<CPO>(args...);
+#endif
+
 			// Practically empty CPO objects gets optimized out, so it's okay to create it to help overload resolution
 			return tag_invoke_cpo(CPO{}, std::forward<Args>(args)...);
 		}
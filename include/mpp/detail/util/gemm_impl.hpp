@@ -0,0 +1,372 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/thread_pool.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/util/cfg.hpp>
+
+#ifdef MPP_INSTRUMENT
+	#include <mpp/detail/util/instrument.hpp>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace mpp::detail
+{
+	// Register block of the micro-kernel (rows of A x columns of B kept in accumulators)
+	inline constexpr auto gemm_mr = std::size_t{ 4 };
+	inline constexpr auto gemm_nr = std::size_t{ 8 };
+
+	// Cache blocks: a packed MC x KC block of A stays in L2 and a packed KC x NC panel of B stays in L3
+	inline constexpr auto gemm_kc = std::size_t{ 256 };
+	inline constexpr auto gemm_mc = std::size_t{ 128 };
+	inline constexpr auto gemm_nc = std::size_t{ 2048 };
+
+	// Below this many multiply-adds, packing costs more than it saves
+	inline constexpr auto gemm_small_madds = std::size_t{ 24 * 24 * 24 };
+
+	// Below this many multiply-adds, waking up the thread pool costs more than it saves
+	inline constexpr auto gemm_par_madds = std::size_t{ 96 * 96 * 96 };
+
+	template<typename T>
+	[[nodiscard]] inline auto gemm_pack_buf(std::size_t which, std::size_t size) -> T*
+	{
+		// Packing buffers are reused across calls on the same thread, so steady-state GEMMs don't allocate
+		static thread_local auto bufs = std::array<scratch_vector<T>, 2>{};
+
+		auto& buf = bufs[which];
+
+		if (buf.size() < size)
+		{
+			buf.resize(size);
+		}
+
+		return buf.data();
+	}
+
+	template<typename T>
+	inline void gemm_pack_a(strided_view<const T> a, std::size_t mc, std::size_t kc, T* out)
+	{
+		// Lays out MR-row micro-panels so the micro-kernel reads A sequentially
+
+		for (auto ir = std::size_t{}; ir < mc; ir += gemm_mr)
+		{
+			const auto rows = std::min(gemm_mr, mc - ir);
+
+			for (auto k = std::size_t{}; k < kc; ++k)
+			{
+				for (auto i = std::size_t{}; i < gemm_mr; ++i)
+				{
+					*out++ = i < rows ? a(ir + i, k) : T{};
+				}
+			}
+		}
+	}
+
+	template<typename T>
+	inline void gemm_pack_b(strided_view<const T> b, std::size_t kc, std::size_t nc, T* out)
+	{
+		// Lays out NR-column micro-panels so the micro-kernel reads B sequentially
+
+		for (auto jr = std::size_t{}; jr < nc; jr += gemm_nr)
+		{
+			const auto cols = std::min(gemm_nr, nc - jr);
+
+			for (auto k = std::size_t{}; k < kc; ++k)
+			{
+				for (auto j = std::size_t{}; j < gemm_nr; ++j)
+				{
+					*out++ = j < cols ? b(k, jr + j) : T{};
+				}
+			}
+		}
+	}
+
+	template<typename T>
+	inline void gemm_micro_kernel(std::size_t kc,
+		const T* a,
+		const T* b,
+		strided_view<T> c,
+		std::size_t rows,
+		std::size_t cols,
+		bool accumulate)
+	{
+		auto acc = std::array<std::array<T, gemm_nr>, gemm_mr>{};
+
+		for (auto k = std::size_t{}; k < kc; ++k, a += gemm_mr, b += gemm_nr)
+		{
+			for (auto i = std::size_t{}; i < gemm_mr; ++i)
+			{
+				const auto a_val = a[i];
+
+				for (auto j = std::size_t{}; j < gemm_nr; ++j)
+				{
+					acc[i][j] += a_val * b[j];
+				}
+			}
+		}
+
+		for (auto i = std::size_t{}; i < rows; ++i)
+		{
+			for (auto j = std::size_t{}; j < cols; ++j)
+			{
+				if (accumulate)
+				{
+					c(i, j) += acc[i][j];
+				}
+				else
+				{
+					c(i, j) = acc[i][j];
+				}
+			}
+		}
+	}
+
+	template<typename T>
+	inline void gemm_small(std::size_t m,
+		std::size_t n,
+		std::size_t k,
+		strided_view<const T> a,
+		strided_view<const T> b,
+		strided_view<T> c,
+		bool accumulate)
+	{
+		for (auto row = std::size_t{}; row < m; ++row)
+		{
+			for (auto col = std::size_t{}; col < n; ++col)
+			{
+				auto res = T{};
+
+				for (auto idx = std::size_t{}; idx < k; ++idx)
+				{
+					res += a(row, idx) * b(idx, col);
+				}
+
+				if (accumulate)
+				{
+					c(row, col) += res;
+				}
+				else
+				{
+					c(row, col) = res;
+				}
+			}
+		}
+	}
+
+	/**
+	 * Single-threaded C = A * B (or C += A * B when accumulating), where A is m x k and B is k x n
+	 *
+	 * Implementation follows the BLIS/GotoBLAS loop structure: B is packed per KC x NC panel, A per MC x KC block,
+	 * and an MR x NR register block is computed per micro-kernel call
+	 */
+	template<typename T>
+	inline void gemm_serial(std::size_t m,
+		std::size_t n,
+		std::size_t k,
+		strided_view<const T> a,
+		strided_view<const T> b,
+		strided_view<T> c,
+		bool accumulate = false)
+	{
+#ifdef MPP_INSTRUMENT
+		const auto call_span = instrument::span{ instrument::gemm_span, m, n, k };
+#endif
+
+		if (m == 0 || n == 0 || k == 0 || m * n * k <= gemm_small_madds)
+		{
+			gemm_small(m, n, k, a, b, c, accumulate);
+			return;
+		}
+
+		const auto max_kc = std::min(k, gemm_kc);
+		auto* packed_a    = gemm_pack_buf<T>(0, round_up(std::min(m, gemm_mc), gemm_mr) * max_kc);
+		auto* packed_b    = gemm_pack_buf<T>(1, round_up(std::min(n, gemm_nc), gemm_nr) * max_kc);
+
+		for (auto jc = std::size_t{}; jc < n; jc += gemm_nc)
+		{
+			const auto nc = std::min(gemm_nc, n - jc);
+
+			for (auto pc = std::size_t{}; pc < k; pc += gemm_kc)
+			{
+				const auto kc = std::min(gemm_kc, k - pc);
+
+				// Only the first KC block may overwrite C, the rest add onto it
+				const auto accumulate_block = accumulate || pc != 0;
+
+				gemm_pack_b(b.sub(pc, jc), kc, nc, packed_b);
+
+				for (auto ic = std::size_t{}; ic < m; ic += gemm_mc)
+				{
+					const auto mc = std::min(gemm_mc, m - ic);
+
+#ifdef MPP_INSTRUMENT
+					const auto block_span = instrument::span{ instrument::gemm_block_span, mc, nc, kc };
+#endif
+
+					gemm_pack_a(a.sub(ic, pc), mc, kc, packed_a);
+
+					for (auto jr = std::size_t{}; jr < nc; jr += gemm_nr)
+					{
+						for (auto ir = std::size_t{}; ir < mc; ir += gemm_mr)
+						{
+							gemm_micro_kernel(kc,
+								packed_a + ir * kc,
+								packed_b + jr * kc,
+								c.sub(ic + ir, jc + jr),
+								std::min(gemm_mr, mc - ir),
+								std::min(gemm_nr, nc - jr),
+								accumulate_block);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * One independent C = A * B problem, or a tile of one
+	 */
+	template<typename T>
+	struct gemm_task
+	{
+		strided_view<const T> a;
+		strided_view<const T> b;
+		strided_view<T> c;
+		std::size_t m;
+		std::size_t n;
+		std::size_t k;
+		bool accumulate;
+
+		[[nodiscard]] auto madds() const noexcept -> std::size_t
+		{
+			return m * n * k;
+		}
+
+		void operator()() const
+		{
+			gemm_serial(m, n, k, a, b, c, accumulate);
+		}
+	};
+
+	/**
+	 * Splits a task into about `pieces` tiles of C, keeping tile edges on register block boundaries
+	 */
+	template<typename T>
+	inline void split_gemm_task(const gemm_task<T>& task, std::size_t pieces, std::vector<gemm_task<T>>& out)
+	{
+		const auto row_tiles = std::clamp(pieces, std::size_t{ 1 }, div_round_up(task.m, gemm_mr));
+		const auto col_tiles = std::clamp(div_round_up(pieces, row_tiles), std::size_t{ 1 }, div_round_up(task.n, gemm_nr));
+
+		const auto tile_rows = round_up(div_round_up(task.m, row_tiles), gemm_mr);
+		const auto tile_cols = round_up(div_round_up(task.n, col_tiles), gemm_nr);
+
+		for (auto row = std::size_t{}; row < task.m; row += tile_rows)
+		{
+			for (auto col = std::size_t{}; col < task.n; col += tile_cols)
+			{
+				out.push_back({ task.a.sub(row, 0),
+					task.b.sub(0, col),
+					task.c.sub(row, col),
+					std::min(tile_rows, task.m - row),
+					std::min(tile_cols, task.n - col),
+					task.k,
+					task.accumulate });
+			}
+		}
+	}
+
+	/**
+	 * Runs independent GEMM tasks across the thread pool, balancing the load by multiply-add count: big tasks are cut
+	 * into tiles no bigger than a fair share of the total, and the tiles are handed out biggest first
+	 */
+	template<typename T>
+	inline void run_gemm_tasks(const std::vector<gemm_task<T>>& tasks, std::size_t threads = max_threads())
+	{
+		auto total_madds = std::size_t{};
+
+		for (const auto& task : tasks)
+		{
+			total_madds += task.madds();
+		}
+
+		if (threads <= 1 || total_madds < gemm_par_madds)
+		{
+			for (const auto& task : tasks)
+			{
+				task();
+			}
+
+			return;
+		}
+
+		// A few tiles per thread lets the dynamic scheduling even out the imbalance of the last tiles
+		const auto share = std::max(total_madds / (threads * 4), gemm_small_madds);
+
+		auto tiles = std::vector<gemm_task<T>>{};
+		tiles.reserve(tasks.size());
+
+		for (const auto& task : tasks)
+		{
+			if (task.madds() > share)
+			{
+				split_gemm_task(task, div_round_up(task.madds(), share), tiles);
+			}
+			else
+			{
+				tiles.push_back(task);
+			}
+		}
+
+		std::ranges::sort(tiles, std::ranges::greater{}, &gemm_task<T>::madds);
+
+		parallel_for(
+			tiles.size(),
+			[&](std::size_t tile) {
+				tiles[tile]();
+			},
+			threads);
+	}
+
+	/**
+	 * C = A * B (or C += A * B), multithreaded when the product is big enough
+	 */
+	template<typename T>
+	inline void gemm(std::size_t m,
+		std::size_t n,
+		std::size_t k,
+		strided_view<const T> a,
+		strided_view<const T> b,
+		strided_view<T> c,
+		bool accumulate = false)
+	{
+		if (max_threads() <= 1 || m * n * k < gemm_par_madds)
+		{
+			gemm_serial(m, n, k, a, b, c, accumulate);
+			return;
+		}
+
+		run_gemm_tasks(std::vector<gemm_task<T>>{ { a, b, c, m, n, k, accumulate } });
+	}
+} // namespace mpp::detail
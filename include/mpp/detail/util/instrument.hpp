@@ -0,0 +1,679 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * Counters behind mpp::stats and spans behind mpp::trace. The hooks that feed them (in cpo_base, the materialization
+ * of expressions and the kernels) only exist when MPP_INSTRUMENT is defined, so define it for every translation unit
+ * of a program or for none of them
+ */
+namespace mpp::detail::instrument
+{
+	// Enough for every CPO and expression, ops registered past it aren't recorded
+	inline constexpr auto max_ops = std::size_t{ 32 };
+
+	// Class c holds calls whose biggest dimension is in [2^(c-1), 2^c), class 0 those with an empty operand
+	inline constexpr auto size_classes = std::size_t{ 33 };
+
+	[[nodiscard]] inline auto size_class_of(std::size_t rows, std::size_t cols) noexcept -> std::size_t
+	{
+		return std::min(static_cast<std::size_t>(std::bit_width(std::max(rows, cols))), size_classes - 1);
+	}
+
+	struct counters
+	{
+		std::atomic<std::uint64_t> calls{};
+		std::atomic<std::uint64_t> ns{};
+		std::atomic<std::uint64_t> flops{};
+		std::atomic<std::uint64_t> allocs{};
+		std::atomic<std::uint64_t> alloc_bytes{};
+		std::atomic<std::uint64_t> peak_bytes{}; // The highest of any call
+	};
+
+	// Each power of 2 of latencies is split into 16 linear buckets, so a bucket is within 1/16 of the values in it
+	inline constexpr auto latency_sub_bits = 4;
+	inline constexpr auto latency_subs     = std::size_t{ 1 } << latency_sub_bits;
+	inline constexpr auto latency_buckets  = (64 - latency_sub_bits + 1) * latency_subs;
+
+	/**
+	 * Log-linear bucket of a latency in ns: exact below 32ns, then 16 buckets per power of 2
+	 */
+	[[nodiscard]] constexpr auto latency_bucket_of(std::uint64_t ns) noexcept -> std::size_t
+	{
+		if (ns < latency_subs)
+		{
+			return static_cast<std::size_t>(ns);
+		}
+
+		const auto exp = std::bit_width(ns) - 1;
+		const auto sub = static_cast<std::size_t>(ns >> (exp - latency_sub_bits)) - latency_subs;
+
+		return static_cast<std::size_t>(exp - latency_sub_bits + 1) * latency_subs + sub;
+	}
+
+	/**
+	 * Middle of the range of latencies in a bucket
+	 */
+	[[nodiscard]] constexpr auto latency_of_bucket(std::size_t bucket) noexcept -> std::uint64_t
+	{
+		if (bucket < latency_subs)
+		{
+			return bucket;
+		}
+
+		const auto shift = static_cast<int>(bucket / latency_subs) - 1;
+		const auto lower = static_cast<std::uint64_t>(latency_subs + bucket % latency_subs) << shift;
+
+		return lower + ((std::uint64_t{ 1 } << shift) >> 1);
+	}
+
+	struct latency_histogram
+	{
+		std::array<std::atomic<std::uint64_t>, latency_buckets> counts{};
+	};
+
+	/**
+	 * Latency of the call at quantile q (e.g. 0.99) of the counts of a histogram, 0 if there are none
+	 */
+	[[nodiscard]] inline auto latency_quantile(const std::vector<std::uint64_t>& counts, double q) noexcept
+		-> std::uint64_t
+	{
+		auto total = std::uint64_t{};
+
+		for (const auto count : counts)
+		{
+			total += count;
+		}
+
+		if (total == 0)
+		{
+			return 0;
+		}
+
+		// The rank-th smallest call, counting from 1
+		const auto rank = std::max(std::uint64_t{ 1 },
+			static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(total))));
+		auto seen       = std::uint64_t{};
+
+		for (auto bucket = std::size_t{}; bucket < counts.size(); ++bucket)
+		{
+			seen += counts[bucket];
+
+			if (seen >= rank)
+			{
+				return latency_of_bucket(bucket);
+			}
+		}
+
+		return latency_of_bucket(counts.size() - 1);
+	}
+
+	/**
+	 * Allocations made through accounting_allocator during one instrumented call, on the calling thread
+	 */
+	struct alloc_frame
+	{
+		alloc_frame* parent;
+		std::uint64_t allocs;
+		std::uint64_t bytes;
+		std::int64_t start_live; // Live bytes of the thread when the call started
+		std::int64_t peak_live;
+	};
+
+	struct alloc_state
+	{
+		// Memory can be freed by another thread than the one that allocated it, so this can go negative
+		std::int64_t live = 0;
+		alloc_frame* frame = nullptr; // Innermost call in progress
+	};
+
+	inline thread_local auto this_thread_allocs = alloc_state{};
+
+	inline void on_alloc(std::size_t bytes) noexcept
+	{
+		auto& state = this_thread_allocs;
+		state.live += static_cast<std::int64_t>(bytes);
+
+		if (auto* const frame = state.frame; frame != nullptr)
+		{
+			++frame->allocs;
+			frame->bytes += bytes;
+			frame->peak_live = std::max(frame->peak_live, state.live);
+		}
+	}
+
+	inline void on_free(std::size_t bytes) noexcept
+	{
+		this_thread_allocs.live -= static_cast<std::int64_t>(bytes);
+	}
+
+	/**
+	 * std::allocator that reports what it allocates to the instrumented call in progress on the thread
+	 */
+	template<typename T>
+	class accounting_allocator
+	{
+	public:
+		using value_type = T;
+
+		accounting_allocator() noexcept = default;
+
+		template<typename U>
+		accounting_allocator(const accounting_allocator<U>&) noexcept
+		{
+		}
+
+		[[nodiscard]] auto allocate(std::size_t count) -> T*
+		{
+			auto* const ptr = std::allocator<T>{}.allocate(count);
+			on_alloc(count * sizeof(T));
+			return ptr;
+		}
+
+		void deallocate(T* ptr, std::size_t count) noexcept
+		{
+			on_free(count * sizeof(T));
+			std::allocator<T>{}.deallocate(ptr, count);
+		}
+
+		template<typename U>
+		[[nodiscard]] friend auto operator==(const accounting_allocator&, const accounting_allocator<U>&) noexcept
+			-> bool
+		{
+			return true;
+		}
+	};
+
+	/**
+	 * What a span stands for, with the names of its (up to 3) arguments, empty names are unused arguments
+	 */
+	struct span_kind
+	{
+		std::string_view name;
+		std::array<std::string_view, 3> args;
+	};
+
+	// Fields are atomics so a trace can be written while threads record, see trace_ring
+	struct trace_event
+	{
+		std::atomic<const span_kind*> kind{};
+		std::atomic<std::uint64_t> start_ns{};
+		std::atomic<std::uint64_t> dur_ns{};
+		std::array<std::atomic<std::uint64_t>, 3> args{};
+	};
+
+	// Spans kept per thread, older ones get overwritten
+	inline constexpr auto trace_capacity = std::size_t{ 1 } << 15;
+
+	/**
+	 * Ring buffer of the spans of one thread. Only its thread writes it, a trace written meanwhile may see the oldest
+	 * events being overwritten, so write traces while the library is idle to get them exact
+	 */
+	struct trace_ring
+	{
+		std::array<trace_event, trace_capacity> events;
+		std::atomic<std::uint64_t> head{}; // Spans recorded so far, the last trace_capacity of them are kept
+	};
+
+	/**
+	 * Time spans are measured from, so they start around 0 in a trace
+	 */
+	[[nodiscard]] inline auto trace_epoch() noexcept -> std::chrono::steady_clock::time_point
+	{
+		static const auto epoch = std::chrono::steady_clock::now();
+		return epoch;
+	}
+
+	/**
+	 * Counters of one thread. Only that thread writes them, so its relaxed RMWs never contend, and snapshots read
+	 * them from any thread
+	 */
+	struct thread_block
+	{
+		std::array<std::array<counters, size_classes>, max_ops> ops;
+		std::atomic<bool> owned{ true };
+
+		// Allocated on the first call of an op in a size class, most of them are never used
+		std::array<std::array<std::atomic<latency_histogram*>, size_classes>, max_ops> latencies{};
+
+		// Allocated on the first span of the thread, it's big
+		std::atomic<trace_ring*> ring{};
+		std::size_t index = 0; // Position in the registry, the thread id of its spans
+
+		explicit thread_block(std::size_t idx) noexcept : index(idx) {}
+
+		thread_block(const thread_block&) = delete;
+		thread_block(thread_block&&)      = delete;
+
+		auto operator=(const thread_block&) -> thread_block& = delete;
+		auto operator=(thread_block&&) -> thread_block& = delete;
+
+		~thread_block()
+		{
+			delete ring.load(std::memory_order_acquire);
+
+			for (auto& op : latencies)
+			{
+				for (auto& histogram : op)
+				{
+					delete histogram.load(std::memory_order_acquire);
+				}
+			}
+		}
+	};
+
+	class registry
+	{
+		mutable std::mutex mtx_;
+		std::array<std::string_view, max_ops> names_{};
+		std::size_t op_count_ = 0;
+
+		// Blocks outlive their threads so their counts stay in the totals, and get reused by new threads
+		std::vector<std::unique_ptr<thread_block>> blocks_;
+
+	public:
+		/**
+		 * Id of the op with this name, max_ops if there's no room left for it
+		 */
+		[[nodiscard]] auto register_op(std::string_view name) noexcept -> std::size_t
+		{
+			const auto lock = std::scoped_lock{ mtx_ };
+
+			const auto names = std::span{ names_.data(), op_count_ };
+			const auto found = std::ranges::find(names, name);
+
+			if (found != names.end())
+			{
+				return static_cast<std::size_t>(found - names.begin());
+			}
+
+			if (op_count_ == max_ops)
+			{
+				return max_ops;
+			}
+
+			names_[op_count_] = name;
+			return op_count_++;
+		}
+
+		/**
+		 * A block no thread owns anymore, or a new one. Null if it can't be allocated, the thread goes unrecorded then
+		 */
+		[[nodiscard]] auto acquire_block() noexcept -> thread_block*
+		{
+			const auto lock = std::scoped_lock{ mtx_ };
+
+			for (const auto& block : blocks_)
+			{
+				auto owned = false;
+
+				if (block->owned.compare_exchange_strong(owned, true, std::memory_order_acquire))
+				{
+					return block.get();
+				}
+			}
+
+			try
+			{
+				return blocks_.emplace_back(std::make_unique<thread_block>(blocks_.size())).get();
+			}
+			catch (const std::bad_alloc&)
+			{
+				return nullptr;
+			}
+		}
+
+		[[nodiscard]] auto op_names() const -> std::vector<std::string_view>
+		{
+			const auto lock = std::scoped_lock{ mtx_ };
+			return { names_.begin(), names_.begin() + static_cast<std::ptrdiff_t>(op_count_) };
+		}
+
+		/**
+		 * Calls fn(const thread_block&) for every block, including those of threads that exited
+		 */
+		template<typename Fn>
+		void for_each_block(Fn&& fn) const
+		{
+			const auto lock = std::scoped_lock{ mtx_ };
+
+			for (const auto& block : blocks_)
+			{
+				fn(*block);
+			}
+		}
+	};
+
+	[[nodiscard]] inline auto global_registry() noexcept -> registry&
+	{
+		std::ignore = trace_epoch();
+
+		// Leaked on purpose, threads that exit during static destruction (e.g. the pool's workers) still release
+		// their block into it
+		static auto* const reg = new registry{};
+		return *reg;
+	}
+
+	struct block_owner
+	{
+		thread_block* block = global_registry().acquire_block();
+
+		block_owner() noexcept = default;
+
+		block_owner(const block_owner&) = delete;
+		block_owner(block_owner&&)      = delete;
+
+		auto operator=(const block_owner&) -> block_owner& = delete;
+		auto operator=(block_owner&&) -> block_owner& = delete;
+
+		~block_owner()
+		{
+			if (block != nullptr)
+			{
+				block->owned.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	[[nodiscard]] inline auto this_thread_block() noexcept -> thread_block*
+	{
+		thread_local auto owner = block_owner{};
+		return owner.block;
+	}
+
+	inline void record_span(const span_kind& kind,
+		std::chrono::steady_clock::time_point start,
+		std::chrono::steady_clock::time_point end,
+		const std::array<std::uint64_t, 3>& args) noexcept
+	{
+		auto* const block = this_thread_block();
+
+		if (block == nullptr)
+		{
+			return;
+		}
+
+		auto* ring = block->ring.load(std::memory_order_relaxed);
+
+		if (ring == nullptr)
+		{
+			ring = new (std::nothrow) trace_ring{};
+
+			if (ring == nullptr)
+			{
+				return;
+			}
+
+			block->ring.store(ring, std::memory_order_release);
+		}
+
+		const auto to_ns = [](auto duration) {
+			return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+		};
+
+		const auto head = ring->head.load(std::memory_order_relaxed);
+		auto& event     = ring->events[head % trace_capacity];
+
+		event.kind.store(&kind, std::memory_order_relaxed);
+		event.start_ns.store(to_ns(start - trace_epoch()), std::memory_order_relaxed);
+		event.dur_ns.store(to_ns(end - start), std::memory_order_relaxed);
+
+		for (auto arg = std::size_t{}; arg < args.size(); ++arg)
+		{
+			event.args[arg].store(args[arg], std::memory_order_relaxed);
+		}
+
+		ring->head.store(head + 1, std::memory_order_release);
+	}
+
+	inline void record_latency(thread_block& block, std::size_t op, std::size_t size_class, std::uint64_t ns) noexcept
+	{
+		auto& slot      = block.latencies[op][size_class];
+		auto* histogram = slot.load(std::memory_order_relaxed);
+
+		if (histogram == nullptr)
+		{
+			histogram = new (std::nothrow) latency_histogram{};
+
+			if (histogram == nullptr)
+			{
+				return;
+			}
+
+			slot.store(histogram, std::memory_order_release);
+		}
+
+		histogram->counts[latency_bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Records a span of its own lifetime into the ring of the thread
+	 */
+	class span
+	{
+		using clock = std::chrono::steady_clock;
+
+		const span_kind* kind_;
+		std::array<std::uint64_t, 3> args_;
+		clock::time_point start_;
+
+	public:
+		explicit span(const span_kind& kind,
+			std::uint64_t arg0 = 0,
+			std::uint64_t arg1 = 0,
+			std::uint64_t arg2 = 0) noexcept :
+			kind_(&kind),
+			args_{ arg0, arg1, arg2 },
+			start_(clock::now())
+		{
+		}
+
+		span(const span&) = delete;
+		span(span&&)      = delete;
+
+		auto operator=(const span&) -> span& = delete;
+		auto operator=(span&&) -> span& = delete;
+
+		~span()
+		{
+			record_span(*kind_, start_, clock::now(), args_);
+		}
+	};
+
+	// Spans of the kernels, lu_algo isn't blocked so its "panels" are groups of lu_panel_rows elimination steps
+	inline constexpr auto lu_panel_rows = std::size_t{ 64 };
+
+	inline constexpr auto lu_panel_span   = span_kind{ "lu panel", { "first_row", "rows", "cols" } };
+	inline constexpr auto gemm_span       = span_kind{ "gemm", { "m", "n", "k" } };
+	inline constexpr auto gemm_block_span = span_kind{ "gemm block", { "mc", "nc", "kc" } };
+	inline constexpr auto fwd_sweep_span  = span_kind{ "fwd_sub sweep", { "n", {}, {} } };
+	inline constexpr auto back_sweep_span = span_kind{ "back_sub sweep", { "n", {}, {} } };
+	inline constexpr auto pool_task_span  = span_kind{ "pool task", { "task", "tasks", {} } };
+
+	/**
+	 * Id of the op Tag stands for, registered on first use
+	 */
+	template<typename Tag>
+	[[nodiscard]] auto op_id(std::string_view name) noexcept -> std::size_t
+	{
+		static const auto id = global_registry().register_op(name);
+		return id;
+	}
+
+	/**
+	 * Times its own lifetime and records it with the shape and estimated flops of the call
+	 */
+	class probe
+	{
+		using clock = std::chrono::steady_clock;
+
+		const span_kind* kind_;
+		std::size_t op_;
+		std::size_t rows_;
+		std::size_t cols_;
+		double flops_;
+		alloc_frame frame_;
+		clock::time_point start_;
+
+	public:
+		probe(const span_kind& kind, std::size_t op, std::size_t rows, std::size_t cols, double flops) noexcept :
+			kind_(&kind),
+			op_(op),
+			rows_(rows),
+			cols_(cols),
+			flops_(flops),
+			frame_{ this_thread_allocs.frame, 0, 0, this_thread_allocs.live, this_thread_allocs.live },
+			start_(clock::now())
+		{
+			// Probes aren't movable and are returned as prvalues, so the frame stays where it was constructed
+			this_thread_allocs.frame = &frame_;
+		}
+
+		probe(const probe&) = delete;
+		probe(probe&&)      = delete;
+
+		auto operator=(const probe&) -> probe& = delete;
+		auto operator=(probe&&) -> probe& = delete;
+
+		~probe()
+		{
+			const auto end    = clock::now();
+			const auto ns     = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start_).count();
+			auto* const block = this_thread_block();
+
+			record_span(*kind_, start_, end, { rows_, cols_, 0 });
+
+			// What a nested call allocated was also allocated by the calls around it
+			this_thread_allocs.frame = frame_.parent;
+
+			if (auto* const parent = frame_.parent; parent != nullptr)
+			{
+				parent->allocs += frame_.allocs;
+				parent->bytes += frame_.bytes;
+				parent->peak_live = std::max(parent->peak_live, frame_.peak_live);
+			}
+
+			if (op_ == max_ops || block == nullptr)
+			{
+				return;
+			}
+
+			const auto size_class = size_class_of(rows_, cols_);
+			auto& slot            = block->ops[op_][size_class];
+			const auto peak       = static_cast<std::uint64_t>(frame_.peak_live - frame_.start_live);
+
+			record_latency(*block, op_, size_class, static_cast<std::uint64_t>(ns));
+
+			slot.calls.fetch_add(1, std::memory_order_relaxed);
+			slot.ns.fetch_add(static_cast<std::uint64_t>(ns), std::memory_order_relaxed);
+			slot.flops.fetch_add(static_cast<std::uint64_t>(std::llround(flops_)), std::memory_order_relaxed);
+			slot.allocs.fetch_add(frame_.allocs, std::memory_order_relaxed);
+			slot.alloc_bytes.fetch_add(frame_.bytes, std::memory_order_relaxed);
+
+			// Only this thread raises it, a racing reset at worst leaves one stale peak
+			if (peak > slot.peak_bytes.load(std::memory_order_relaxed))
+			{
+				slot.peak_bytes.store(peak, std::memory_order_relaxed);
+			}
+		}
+	};
+
+	/**
+	 * Rows and columns of the first matrix-like argument, zeros if there's none
+	 */
+	template<typename... Args>
+	[[nodiscard]] auto shape_of(const Args&... args) noexcept -> std::pair<std::size_t, std::size_t>
+	{
+		auto shape = std::pair<std::size_t, std::size_t>{};
+		auto found = false;
+
+		const auto visit = [&](const auto& arg) {
+			if constexpr (requires { arg.rows(); arg.cols(); })
+			{
+				if (!found)
+				{
+					shape = { arg.rows(), arg.cols() };
+					found = true;
+				}
+			}
+		};
+
+		(visit(args), ...);
+		return shape;
+	}
+
+	template<typename CPO, typename... Args>
+	[[nodiscard]] auto cpo_probe(const Args&... args) noexcept -> probe
+	{
+		const auto [rows, cols] = shape_of(args...);
+
+		auto flops = 0.0;
+
+		if constexpr (requires { CPO::flops(args...); })
+		{
+			flops = CPO::flops(args...);
+		}
+
+		static constexpr auto kind = span_kind{ CPO::name, { "rows", "cols", {} } };
+
+		return { kind, op_id<CPO>(CPO::name), rows, cols, flops };
+	}
+
+	template<typename Expr>
+	[[nodiscard]] auto expr_probe(const Expr& expr) noexcept -> probe
+	{
+		auto flops = 0.0;
+
+		if constexpr (requires { expr.flops(); })
+		{
+			flops = expr.flops();
+		}
+
+		static constexpr auto kind = [] {
+			if constexpr (requires { Expr::op_name; })
+			{
+				return span_kind{ Expr::op_name, { "rows", "cols", {} } };
+			}
+			else
+			{
+				return span_kind{ "expression", { "rows", "cols", {} } };
+			}
+		}();
+
+		return { kind, op_id<Expr>(kind.name), expr.rows(), expr.cols(), flops };
+	}
+} // namespace mpp::detail::instrument
@@ -0,0 +1,104 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace mpp::detail
+{
+	/**
+	 * Background thread that runs I/O jobs one after another in the order they're submitted, so reads and writes of
+	 * files overlap with the computation of the thread that submits them
+	 */
+	class io_worker
+	{
+		std::mutex mtx_;
+		std::condition_variable cv_;
+		std::deque<std::packaged_task<void()>> jobs_;
+		bool stop_ = false;
+
+		// Last, so everything it uses is constructed before it starts
+		std::thread thread_;
+
+		void work()
+		{
+			while (true)
+			{
+				auto lock = std::unique_lock{ mtx_ };
+				cv_.wait(lock, [&]() {
+					return stop_ || !jobs_.empty();
+				});
+
+				// Jobs submitted before stopping still run, someone may be waiting for them
+				if (jobs_.empty())
+				{
+					return;
+				}
+
+				auto job = std::move(jobs_.front());
+				jobs_.pop_front();
+				lock.unlock();
+
+				// Exceptions end up in the future of the job
+				job();
+			}
+		}
+
+	public:
+		io_worker() : thread_(&io_worker::work, this) {}
+
+		io_worker(const io_worker&) = delete;
+		io_worker(io_worker&&)      = delete;
+
+		auto operator=(const io_worker&) -> io_worker& = delete;
+		auto operator=(io_worker&&) -> io_worker& = delete;
+
+		~io_worker()
+		{
+			{
+				auto lock = std::scoped_lock{ mtx_ };
+				stop_     = true;
+			}
+
+			cv_.notify_one();
+			thread_.join();
+		}
+
+		template<typename Fn>
+		[[nodiscard]] auto submit(Fn&& fn) -> std::future<void>
+		{
+			auto job    = std::packaged_task<void()>{ std::forward<Fn>(fn) };
+			auto result = job.get_future();
+
+			{
+				auto lock = std::scoped_lock{ mtx_ };
+				jobs_.push_back(std::move(job));
+			}
+
+			cv_.notify_one();
+			return result;
+		}
+	};
+} // namespace mpp::detail
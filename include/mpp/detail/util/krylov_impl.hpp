@@ -0,0 +1,416 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/thread_pool.hpp>
+#include <mpp/detail/util/util.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+
+namespace mpp::detail
+{
+	// Below this much work (elements touched, or multiply-adds for products), vector kernels don't wake up the pool
+	inline constexpr auto krylov_par_work = std::size_t{ 1 } << 16;
+
+	// Vectors are reduced in parts of at least this many elements, and in at most krylov_max_parts parts
+	inline constexpr auto krylov_part_elems = std::size_t{ 1 } << 12;
+	inline constexpr auto krylov_max_parts  = std::size_t{ 256 };
+
+	// Kernels over several vectors walk their parts in chunks of this many elements, so the chunk of the vector they
+	// share stays in L1 while every other vector streams past it
+	inline constexpr auto krylov_chunk_elems = std::size_t{ 512 };
+
+	/**
+	 * Number of parts a vector of n elements is reduced in. It only depends on n, so sums come out the same whatever
+	 * the number of threads
+	 */
+	[[nodiscard]] constexpr auto vector_parts(std::size_t n) noexcept -> std::size_t
+	{
+		return std::clamp(div_round_up(n, krylov_part_elems), std::size_t{ 1 }, krylov_max_parts);
+	}
+
+	/**
+	 * Calls fn(part, first, last) for every part of [0, n), in parallel if work is big enough
+	 */
+	template<typename Fn>
+	inline void for_each_vector_part(std::size_t n, std::size_t work, Fn&& fn)
+	{
+		const auto parts = vector_parts(n);
+		const auto body  = [&](std::size_t part) {
+			fn(part, n * part / parts, n * (part + 1) / parts);
+		};
+
+		if (work < krylov_par_work || max_threads() <= 1)
+		{
+			for (auto part = std::size_t{}; part < parts; ++part)
+			{
+				body(part);
+			}
+		}
+		else
+		{
+			parallel_for(parts, body);
+		}
+	}
+
+	/**
+	 * Sums of K values over [0, n), where fn(first, last) returns the sums of a part. Parts are added in order
+	 */
+	template<std::size_t K, typename T, typename Fn>
+	[[nodiscard]] inline auto reduce_vector_parts(std::size_t n, std::size_t work, Fn&& fn) -> std::array<T, K>
+	{
+		std::array<std::array<T, K>, krylov_max_parts> partials;
+
+		for_each_vector_part(n, work, [&](std::size_t part, std::size_t first, std::size_t last) {
+			partials[part] = fn(first, last);
+		});
+
+		auto sums = std::array<T, K>{};
+
+		for (auto part = std::size_t{}; part < vector_parts(n); ++part)
+		{
+			for (auto idx = std::size_t{}; idx < K; ++idx)
+			{
+				sums[idx] += partials[part][idx];
+			}
+		}
+
+		return sums;
+	}
+
+	/**
+	 * Calls fn(idx, acc) for every idx in [first, last), handing it four sets of K accumulators in turn so the
+	 * additions don't wait on each other, and returns their sums
+	 */
+	template<std::size_t K, typename T, typename Fn>
+	[[nodiscard]] inline auto accumulate4(std::size_t first, std::size_t last, Fn&& fn) -> std::array<T, K>
+	{
+		auto acc = std::array<std::array<T, K>, 4>{};
+		auto idx = first;
+
+		for (; idx + 4 <= last; idx += 4)
+		{
+			fn(idx, acc[0]);
+			fn(idx + 1, acc[1]);
+			fn(idx + 2, acc[2]);
+			fn(idx + 3, acc[3]);
+		}
+
+		for (; idx < last; ++idx)
+		{
+			fn(idx, acc[0]);
+		}
+
+		auto sums = std::array<T, K>{};
+
+		for (auto val = std::size_t{}; val < K; ++val)
+		{
+			sums[val] = (acc[0][val] + acc[1][val]) + (acc[2][val] + acc[3][val]);
+		}
+
+		return sums;
+	}
+
+	template<typename T>
+	[[nodiscard]] inline auto krylov_dot(std::size_t n, const T* x, const T* y) -> T
+	{
+		return reduce_vector_parts<1, T>(n, n, [&](std::size_t first, std::size_t last) {
+			return accumulate4<1, T>(first, last, [&](std::size_t idx, std::array<T, 1>& acc) {
+				acc[0] += x[idx] * y[idx];
+			});
+		})[0];
+	}
+
+	/**
+	 * r = b - ax (ax may be r), returns r . r
+	 */
+	template<typename T>
+	[[nodiscard]] inline auto krylov_residual(std::size_t n, const T* b, const T* ax, T* r) -> T
+	{
+		return reduce_vector_parts<1, T>(n, n, [&](std::size_t first, std::size_t last) {
+			return accumulate4<1, T>(first, last, [&](std::size_t idx, std::array<T, 1>& acc) {
+				r[idx] = b[idx] - ax[idx];
+				acc[0] += r[idx] * r[idx];
+			});
+		})[0];
+	}
+
+	/**
+	 * y = x (for x != y)
+	 */
+	template<typename T>
+	inline void krylov_copy(std::size_t n, const T* x, T* y)
+	{
+		for_each_vector_part(n, n, [&](std::size_t, std::size_t first, std::size_t last) {
+			std::copy(x + first, x + last, y + first);
+		});
+	}
+
+	/**
+	 * y = alpha * x (x may be y)
+	 */
+	template<typename T>
+	inline void krylov_scale(std::size_t n, T alpha, const T* x, T* y)
+	{
+		for_each_vector_part(n, n, [&](std::size_t, std::size_t first, std::size_t last) {
+			for (auto idx = first; idx < last; ++idx)
+			{
+				y[idx] = alpha * x[idx];
+			}
+		});
+	}
+
+	/**
+	 * y += alpha * x
+	 */
+	template<typename T>
+	inline void krylov_axpy(std::size_t n, T alpha, const T* x, T* y)
+	{
+		for_each_vector_part(n, n, [&](std::size_t, std::size_t first, std::size_t last) {
+			for (auto idx = first; idx < last; ++idx)
+			{
+				y[idx] += alpha * x[idx];
+			}
+		});
+	}
+
+	/**
+	 * p = r + beta * p
+	 */
+	template<typename T>
+	inline void krylov_xpby(std::size_t n, const T* r, T beta, T* p)
+	{
+		for_each_vector_part(n, n, [&](std::size_t, std::size_t first, std::size_t last) {
+			for (auto idx = first; idx < last; ++idx)
+			{
+				p[idx] = r[idx] + beta * p[idx];
+			}
+		});
+	}
+
+	/**
+	 * The update of a CG iteration in one pass: x += alpha * p, r -= alpha * q, returns r . r
+	 */
+	template<typename T>
+	[[nodiscard]] inline auto cg_update(std::size_t n, T alpha, const T* p, const T* q, T* x, T* r) -> T
+	{
+		return reduce_vector_parts<1, T>(n, n, [&](std::size_t first, std::size_t last) {
+			return accumulate4<1, T>(first, last, [&](std::size_t idx, std::array<T, 1>& acc) {
+				x[idx] += alpha * p[idx];
+				r[idx] -= alpha * q[idx];
+				acc[0] += r[idx] * r[idx];
+			});
+		})[0];
+	}
+
+	/**
+	 * r -= alpha * v, returns r . r
+	 */
+	template<typename T>
+	[[nodiscard]] inline auto krylov_axpy_norm(std::size_t n, T alpha, const T* v, T* r) -> T
+	{
+		return reduce_vector_parts<1, T>(n, n, [&](std::size_t first, std::size_t last) {
+			return accumulate4<1, T>(first, last, [&](std::size_t idx, std::array<T, 1>& acc) {
+				r[idx] -= alpha * v[idx];
+				acc[0] += r[idx] * r[idx];
+			});
+		})[0];
+	}
+
+	/**
+	 * t . s and t . t in one pass
+	 */
+	template<typename T>
+	[[nodiscard]] inline auto krylov_dot2(std::size_t n, const T* t, const T* s) -> std::array<T, 2>
+	{
+		return reduce_vector_parts<2, T>(n, n, [&](std::size_t first, std::size_t last) {
+			return accumulate4<2, T>(first, last, [&](std::size_t idx, std::array<T, 2>& acc) {
+				acc[0] += t[idx] * s[idx];
+				acc[1] += t[idx] * t[idx];
+			});
+		});
+	}
+
+	/**
+	 * The end of a BiCGSTAB iteration in one pass: x += alpha * p + omega * s, r -= omega * t, returns r . r and
+	 * r0 . r. s is r itself without a preconditioner, so it's read before r is updated
+	 */
+	template<typename T>
+	[[nodiscard]] inline auto bicgstab_update(std::size_t n,
+		T alpha,
+		T omega,
+		const T* p,
+		const T* s,
+		const T* t,
+		const T* r0,
+		T* x,
+		T* r) -> std::array<T, 2>
+	{
+		return reduce_vector_parts<2, T>(n, n, [&](std::size_t first, std::size_t last) {
+			return accumulate4<2, T>(first, last, [&](std::size_t idx, std::array<T, 2>& acc) {
+				x[idx] += alpha * p[idx] + omega * s[idx];
+				r[idx] -= omega * t[idx];
+				acc[0] += r[idx] * r[idx];
+				acc[1] += r0[idx] * r[idx];
+			});
+		});
+	}
+
+	/**
+	 * p = r + beta * (p - omega * v)
+	 */
+	template<typename T>
+	inline void bicgstab_direction(std::size_t n, T beta, T omega, const T* r, const T* v, T* p)
+	{
+		for_each_vector_part(n, n, [&](std::size_t, std::size_t first, std::size_t last) {
+			for (auto idx = first; idx < last; ++idx)
+			{
+				p[idx] = r[idx] + beta * (p[idx] - omega * v[idx]);
+			}
+		});
+	}
+
+	/**
+	 * h[j] = basis_j . w for the k vectors of the basis (each n long, one after the other) and h[k] = w . w, in one
+	 * pass over w. partials needs (k + 1) * krylov_max_parts elements
+	 */
+	template<typename T>
+	inline void krylov_multi_dot(std::size_t n, const T* basis, std::size_t k, const T* w, T* h, std::span<T> partials)
+	{
+		const auto parts = vector_parts(n);
+
+		assert(partials.size() >= (k + 1) * parts);
+
+		for_each_vector_part(n, n * (k + 1), [&](std::size_t part, std::size_t first, std::size_t last) {
+			auto* const sums = partials.data() + part * (k + 1);
+
+			std::fill_n(sums, k + 1, T{});
+
+			for (auto chunk = first; chunk < last; chunk += krylov_chunk_elems)
+			{
+				const auto chunk_last = std::min(last, chunk + krylov_chunk_elems);
+
+				for (auto vec = std::size_t{}; vec < k; ++vec)
+				{
+					const auto* const v = basis + vec * n;
+
+					sums[vec] += accumulate4<1, T>(chunk, chunk_last, [&](std::size_t idx, std::array<T, 1>& acc) {
+						acc[0] += v[idx] * w[idx];
+					})[0];
+				}
+
+				sums[k] += accumulate4<1, T>(chunk, chunk_last, [&](std::size_t idx, std::array<T, 1>& acc) {
+					acc[0] += w[idx] * w[idx];
+				})[0];
+			}
+		});
+
+		std::fill_n(h, k + 1, T{});
+
+		for (auto part = std::size_t{}; part < parts; ++part)
+		{
+			for (auto vec = std::size_t{}; vec <= k; ++vec)
+			{
+				h[vec] += partials[part * (k + 1) + vec];
+			}
+		}
+	}
+
+	/**
+	 * w -= sum of coeffs[j] * basis_j over the k vectors of the basis in one pass over w, returns w . w
+	 */
+	template<typename T>
+	[[nodiscard]] inline auto krylov_multi_axpy(std::size_t n, const T* basis, std::size_t k, const T* coeffs, T* w)
+		-> T
+	{
+		return reduce_vector_parts<1, T>(n, n * (k + 1), [&](std::size_t first, std::size_t last) {
+			auto sums = std::array<T, 1>{};
+
+			for (auto chunk = first; chunk < last; chunk += krylov_chunk_elems)
+			{
+				const auto chunk_last = std::min(last, chunk + krylov_chunk_elems);
+
+				for (auto vec = std::size_t{}; vec < k; ++vec)
+				{
+					const auto* const v = basis + vec * n;
+					const auto coeff    = coeffs[vec];
+
+					for (auto idx = chunk; idx < chunk_last; ++idx)
+					{
+						w[idx] -= coeff * v[idx];
+					}
+				}
+
+				sums[0] += accumulate4<1, T>(chunk, chunk_last, [&](std::size_t idx, std::array<T, 1>& acc) {
+					acc[0] += w[idx] * w[idx];
+				})[0];
+			}
+
+			return sums;
+		})[0];
+	}
+
+	/**
+	 * y = a * x for a rows x cols matrix a
+	 */
+	template<typename T>
+	inline void dense_matvec(strided_view<const T> a, std::size_t rows, std::size_t cols, const T* x, T* y)
+	{
+		for_each_vector_part(rows, rows * cols, [&](std::size_t, std::size_t first, std::size_t last) {
+			if (a.cs == 1)
+			{
+				// Rows are contiguous, so every element of y is a dot product
+				for (auto row = first; row < last; ++row)
+				{
+					const auto* const a_row = a.data + row * a.rs;
+
+					y[row] = accumulate4<1, T>(0, cols, [&](std::size_t col, std::array<T, 1>& acc) {
+						acc[0] += a_row[col] * x[col];
+					})[0];
+				}
+			}
+			else
+			{
+				// Otherwise y sums the columns of a, a chunk of rows at a time
+				for (auto chunk = first; chunk < last; chunk += krylov_chunk_elems)
+				{
+					const auto chunk_last = std::min(last, chunk + krylov_chunk_elems);
+
+					std::fill(y + chunk, y + chunk_last, T{});
+
+					for (auto col = std::size_t{}; col < cols; ++col)
+					{
+						const auto* const a_col = a.data + col * a.cs;
+						const auto x_col        = x[col];
+
+						for (auto row = chunk; row < chunk_last; ++row)
+						{
+							y[row] += a_col[row * a.rs] * x_col;
+						}
+					}
+				}
+			}
+		});
+	}
+} // namespace mpp::detail
@@ -0,0 +1,202 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace mpp::detail
+{
+	/**
+	 * Read-only mapping of a whole file, pages are read in by the OS as they're first touched
+	 */
+	class mapped_file
+	{
+		const std::byte* data_ = nullptr;
+		std::size_t size_      = 0;
+
+#ifdef _WIN32
+		HANDLE file_    = INVALID_HANDLE_VALUE;
+		HANDLE mapping_ = nullptr;
+#endif
+
+		[[noreturn]] static void fail(const std::filesystem::path& path, const char* what)
+		{
+			throw std::runtime_error(std::string{ "Failed to " } + what + " " + path.string());
+		}
+
+	public:
+		/**
+		 * Throws std::runtime_error if the file can't be opened or mapped
+		 */
+		explicit mapped_file(const std::filesystem::path& path)
+		{
+#ifdef _WIN32
+			file_ = CreateFileW(path.c_str(),
+				GENERIC_READ,
+				FILE_SHARE_READ,
+				nullptr,
+				OPEN_EXISTING,
+				FILE_ATTRIBUTE_NORMAL,
+				nullptr);
+
+			if (file_ == INVALID_HANDLE_VALUE)
+			{
+				fail(path, "open");
+			}
+
+			auto size = LARGE_INTEGER{};
+
+			if (GetFileSizeEx(file_, &size) == 0)
+			{
+				CloseHandle(file_);
+				fail(path, "get the size of");
+			}
+
+			size_ = static_cast<std::size_t>(size.QuadPart);
+
+			// Empty files can't be mapped, they're an empty range
+			if (size_ == 0)
+			{
+				return;
+			}
+
+			mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+			if (mapping_ == nullptr)
+			{
+				CloseHandle(file_);
+				fail(path, "map");
+			}
+
+			data_ = static_cast<const std::byte*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+
+			if (data_ == nullptr)
+			{
+				CloseHandle(mapping_);
+				CloseHandle(file_);
+				fail(path, "map");
+			}
+#else
+			const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+			if (fd == -1)
+			{
+				fail(path, "open");
+			}
+
+			struct stat info
+			{
+			};
+
+			if (::fstat(fd, &info) == -1)
+			{
+				::close(fd);
+				fail(path, "get the size of");
+			}
+
+			size_ = static_cast<std::size_t>(info.st_size);
+
+			// Empty files can't be mapped, they're an empty range
+			if (size_ == 0)
+			{
+				::close(fd);
+				return;
+			}
+
+			auto* const addr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+
+			// The mapping keeps the file alive on its own
+			::close(fd);
+
+			if (addr == MAP_FAILED)
+			{
+				fail(path, "map");
+			}
+
+			data_ = static_cast<const std::byte*>(addr);
+#endif
+		}
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file(mapped_file&&)      = delete;
+
+		auto operator=(const mapped_file&) -> mapped_file& = delete;
+		auto operator=(mapped_file&&) -> mapped_file& = delete;
+
+		~mapped_file()
+		{
+#ifdef _WIN32
+			if (data_ != nullptr)
+			{
+				UnmapViewOfFile(data_);
+			}
+
+			if (mapping_ != nullptr)
+			{
+				CloseHandle(mapping_);
+			}
+
+			CloseHandle(file_);
+#else
+			if (data_ != nullptr)
+			{
+				::munmap(const_cast<std::byte*>(data_), size_);
+			}
+#endif
+		}
+
+		[[nodiscard]] auto data() const noexcept -> const std::byte*
+		{
+			return data_;
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t
+		{
+			return size_;
+		}
+
+		/**
+		 * Shared so views into the mapping can keep it alive
+		 */
+		[[nodiscard]] static auto open(const std::filesystem::path& path) -> std::shared_ptr<const mapped_file>
+		{
+			return std::make_shared<const mapped_file>(path);
+		}
+	};
+} // namespace mpp::detail
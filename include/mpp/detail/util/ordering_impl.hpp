@@ -0,0 +1,463 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <set>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace mpp::detail
+{
+	inline constexpr auto no_index = std::numeric_limits<std::size_t>::max();
+
+	// Parts of a nested dissection at most this big are ordered by minimum degree instead of being split further
+	inline constexpr auto dissection_leaf_size = std::size_t{ 128 };
+
+	/**
+	 * Undirected graph in compressed rows, without self loops
+	 */
+	struct sym_graph
+	{
+		std::vector<std::size_t> offsets;
+		std::vector<std::size_t> indices;
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t
+		{
+			return offsets.size() - 1;
+		}
+
+		[[nodiscard]] auto adjacent(std::size_t vertex) const noexcept -> std::span<const std::size_t>
+		{
+			return { indices.data() + offsets[vertex], offsets[vertex + 1] - offsets[vertex] };
+		}
+	};
+
+	/**
+	 * Graph of the pattern of a + a^T for a n x n matrix a of compressed rows or columns (the graph is the same for
+	 * both)
+	 */
+	[[nodiscard]] inline auto symmetric_graph(std::size_t n,
+		std::span<const std::size_t> offsets,
+		std::span<const std::size_t> indices) -> sym_graph
+	{
+		auto graph = sym_graph{ std::vector<std::size_t>(n + 1), {} };
+
+		for (auto outer = std::size_t{}; outer < n; ++outer)
+		{
+			for (auto idx = offsets[outer]; idx < offsets[outer + 1]; ++idx)
+			{
+				if (indices[idx] != outer)
+				{
+					++graph.offsets[outer + 1];
+					++graph.offsets[indices[idx] + 1];
+				}
+			}
+		}
+
+		for (auto vertex = std::size_t{}; vertex < n; ++vertex)
+		{
+			graph.offsets[vertex + 1] += graph.offsets[vertex];
+		}
+
+		auto next = std::vector<std::size_t>(graph.offsets.begin(), graph.offsets.end() - 1);
+		graph.indices.resize(graph.offsets.back());
+
+		for (auto outer = std::size_t{}; outer < n; ++outer)
+		{
+			for (auto idx = offsets[outer]; idx < offsets[outer + 1]; ++idx)
+			{
+				if (indices[idx] != outer)
+				{
+					graph.indices[next[outer]++]        = indices[idx];
+					graph.indices[next[indices[idx]]++] = outer;
+				}
+			}
+		}
+
+		// Entries present on both sides of the diagonal were added twice
+		auto kept = std::size_t{};
+
+		for (auto vertex = std::size_t{}; vertex < n; ++vertex)
+		{
+			const auto first = graph.indices.begin() + static_cast<std::ptrdiff_t>(graph.offsets[vertex]);
+			const auto last  = graph.indices.begin() + static_cast<std::ptrdiff_t>(graph.offsets[vertex + 1]);
+
+			std::sort(first, last);
+
+			const auto unique_last = std::unique(first, last);
+			graph.offsets[vertex]  = kept;
+
+			std::copy(first, unique_last, graph.indices.begin() + static_cast<std::ptrdiff_t>(kept));
+			kept += static_cast<std::size_t>(unique_last - first);
+		}
+
+		graph.offsets[n] = kept;
+		graph.indices.resize(kept);
+
+		return graph;
+	}
+
+	/**
+	 * Approximate minimum degree ordering, returns the vertices in elimination order. Eliminated vertices become
+	 * elements of a quotient graph (so it never grows beyond the original graph), elements that a newer one covers are
+	 * absorbed into it, and degrees are the AMD upper bound |A_i| + |L_p \ i| + sum of |L_e \ L_p|. There's no
+	 * supervariable detection, which only makes it slower on graphs with many indistinguishable vertices
+	 */
+	[[nodiscard]] inline auto amd_order(const sym_graph& graph) -> std::vector<std::size_t>
+	{
+		enum class vertex_state : unsigned char
+		{
+			variable,
+			element,
+			absorbed
+		};
+
+		const auto n = graph.size();
+
+		auto variables = std::vector<std::vector<std::size_t>>(n); // Adjacent variables of every variable
+		auto elements  = std::vector<std::vector<std::size_t>>(n); // Adjacent elements of every variable
+		auto members   = std::vector<std::vector<std::size_t>>(n); // Variables of every element
+		auto states    = std::vector<vertex_state>(n, vertex_state::variable);
+		auto degrees   = std::vector<std::size_t>(n);
+		auto queue     = std::set<std::pair<std::size_t, std::size_t>>{};
+
+		for (auto vertex = std::size_t{}; vertex < n; ++vertex)
+		{
+			const auto adjacent = graph.adjacent(vertex);
+
+			variables[vertex].assign(adjacent.begin(), adjacent.end());
+			degrees[vertex] = adjacent.size();
+			queue.emplace(degrees[vertex], vertex);
+		}
+
+		auto in_pivot = std::vector<std::size_t>(n, no_index); // Step that put a variable in the pivot's element
+		auto seen     = std::vector<std::size_t>(n, no_index); // Step that last computed outside for an element
+		auto outside  = std::vector<std::size_t>(n);           // |L_e \ L_p| of elements next to the pivot's
+
+		auto order = std::vector<std::size_t>{};
+		order.reserve(n);
+
+		for (auto step = std::size_t{}; step < n; ++step)
+		{
+			const auto pivot = queue.begin()->second;
+			queue.erase(queue.begin());
+			order.push_back(pivot);
+
+			// The pivot's element joins its variables and those of its elements, which it absorbs
+			auto& pivot_members = members[pivot];
+			in_pivot[pivot]     = step;
+
+			const auto add_member = [&](std::size_t vertex) {
+				if (states[vertex] == vertex_state::variable && in_pivot[vertex] != step)
+				{
+					in_pivot[vertex] = step;
+					pivot_members.push_back(vertex);
+				}
+			};
+
+			std::ranges::for_each(variables[pivot], add_member);
+
+			for (const auto elem : elements[pivot])
+			{
+				if (states[elem] == vertex_state::element)
+				{
+					std::ranges::for_each(members[elem], add_member);
+
+					states[elem] = vertex_state::absorbed;
+					members[elem].clear();
+					members[elem].shrink_to_fit();
+				}
+			}
+
+			states[pivot] = vertex_state::element;
+			variables[pivot].clear();
+			variables[pivot].shrink_to_fit();
+			elements[pivot].clear();
+			elements[pivot].shrink_to_fit();
+
+			// Variables of the new element reach each other through it, so their direct edges are dropped
+			for (const auto vertex : pivot_members)
+			{
+				std::erase_if(variables[vertex], [&](std::size_t other) {
+					return in_pivot[other] == step;
+				});
+
+				std::erase_if(elements[vertex], [&](std::size_t elem) {
+					return states[elem] != vertex_state::element;
+				});
+
+				elements[vertex].push_back(pivot);
+			}
+
+			for (const auto vertex : pivot_members)
+			{
+				for (const auto elem : elements[vertex])
+				{
+					if (elem != pivot)
+					{
+						if (seen[elem] != step)
+						{
+							seen[elem]    = step;
+							outside[elem] = members[elem].size();
+						}
+
+						--outside[elem];
+					}
+				}
+			}
+
+			const auto remaining = n - step - 1;
+
+			for (const auto vertex : pivot_members)
+			{
+				auto degree = variables[vertex].size() + pivot_members.size() - 1;
+
+				for (const auto elem : elements[vertex])
+				{
+					if (elem == pivot || states[elem] != vertex_state::element)
+					{
+						continue;
+					}
+
+					// Covered by the new element, so it's absorbed
+					if (outside[elem] == 0)
+					{
+						states[elem] = vertex_state::absorbed;
+						members[elem].clear();
+						members[elem].shrink_to_fit();
+					}
+					else
+					{
+						degree += outside[elem];
+					}
+				}
+
+				degree = std::min(degree, remaining - 1);
+
+				if (degree != degrees[vertex])
+				{
+					queue.erase({ degrees[vertex], vertex });
+					degrees[vertex] = degree;
+					queue.emplace(degree, vertex);
+				}
+			}
+		}
+
+		return order;
+	}
+
+	/**
+	 * Nested dissection ordering, returns the vertices in elimination order. Every connected part is split by the
+	 * middle level of a breadth first search from a pseudo-peripheral vertex, the two sides are ordered first (and
+	 * split again) and the separator last. Small parts are ordered by amd_order
+	 */
+	[[nodiscard]] inline auto nested_dissection_order(const sym_graph& graph) -> std::vector<std::size_t>
+	{
+		const auto n = graph.size();
+
+		auto order = std::vector<std::size_t>{};
+		order.reserve(n);
+
+		auto owner    = std::vector<std::size_t>(n, no_index); // Call of dissect that a vertex currently belongs to
+		auto level_of = std::vector<std::size_t>(n, no_index);
+		auto local    = std::vector<std::size_t>(n, no_index);
+		auto calls    = std::size_t{};
+
+		// Breadth first search within the vertices owned by id, returns the vertices by level and where levels start
+		const auto levels_from =
+			[&](std::size_t root, std::size_t id, std::vector<std::size_t>& visited, std::vector<std::size_t>& starts) {
+			visited.assign(1, root);
+			starts.assign(1, 0);
+			level_of[root] = 0;
+
+			const auto mark = calls++;
+			owner[root]     = mark;
+
+			for (auto idx = std::size_t{}; idx < visited.size(); ++idx)
+			{
+				const auto vertex = visited[idx];
+
+				if (level_of[vertex] == starts.size())
+				{
+					starts.push_back(idx);
+				}
+
+				for (const auto other : graph.adjacent(vertex))
+				{
+					if (owner[other] == id)
+					{
+						owner[other]    = mark;
+						level_of[other] = level_of[vertex] + 1;
+						visited.push_back(other);
+					}
+				}
+			}
+
+			starts.push_back(visited.size());
+
+			// Hand the vertices back to the caller
+			for (const auto vertex : visited)
+			{
+				owner[vertex] = id;
+			}
+		};
+
+		const auto order_leaf = [&](std::span<const std::size_t> vertices, std::size_t id) {
+			for (auto idx = std::size_t{}; idx < vertices.size(); ++idx)
+			{
+				local[vertices[idx]] = idx;
+			}
+
+			auto leaf = sym_graph{ std::vector<std::size_t>(vertices.size() + 1), {} };
+
+			for (auto idx = std::size_t{}; idx < vertices.size(); ++idx)
+			{
+				for (const auto other : graph.adjacent(vertices[idx]))
+				{
+					if (owner[other] == id)
+					{
+						leaf.indices.push_back(local[other]);
+					}
+				}
+
+				leaf.offsets[idx + 1] = leaf.indices.size();
+			}
+
+			for (const auto idx : amd_order(leaf))
+			{
+				order.push_back(vertices[idx]);
+			}
+		};
+
+		const auto dissect = [&](const auto& self, std::vector<std::size_t> vertices) -> void {
+			const auto id = calls++;
+
+			for (const auto vertex : vertices)
+			{
+				owner[vertex] = id;
+			}
+
+			auto visited = std::vector<std::size_t>{};
+			auto starts  = std::vector<std::size_t>{};
+			auto parts   = std::vector<std::vector<std::size_t>>{};
+
+			// Connected parts first, each is a search away
+			for (const auto vertex : vertices)
+			{
+				if (owner[vertex] == id)
+				{
+					levels_from(vertex, id, visited, starts);
+
+					for (const auto found : visited)
+					{
+						owner[found] = no_index;
+					}
+
+					parts.push_back(visited);
+				}
+			}
+
+			for (auto& part : parts)
+			{
+				const auto part_id = calls++;
+
+				for (const auto vertex : part)
+				{
+					owner[vertex] = part_id;
+				}
+
+				if (part.size() <= dissection_leaf_size)
+				{
+					order_leaf(part, part_id);
+					continue;
+				}
+
+				// A vertex at the end of a longest search is (nearly) peripheral, which makes for many thin levels
+				levels_from(part.front(), part_id, visited, starts);
+
+				for (auto tries = 0; tries < 8; ++tries)
+				{
+					const auto last_level = std::span<const std::size_t>{ visited }.subspan(starts[starts.size() - 2]);
+					const auto root = *std::ranges::min_element(last_level, {}, [&](std::size_t vertex) {
+						return graph.adjacent(vertex).size();
+					});
+
+					const auto depth = starts.size();
+					auto next        = std::vector<std::size_t>{};
+					auto next_starts = std::vector<std::size_t>{};
+
+					levels_from(root, part_id, next, next_starts);
+
+					if (next_starts.size() <= depth)
+					{
+						break;
+					}
+
+					visited = std::move(next);
+					starts  = std::move(next_starts);
+				}
+
+				const auto levels = starts.size() - 1;
+
+				if (levels < 3)
+				{
+					order_leaf(part, part_id);
+					continue;
+				}
+
+				// The level that holds the middle vertex, kept away from both ends so neither side is empty
+				auto middle = std::size_t{ 1 };
+
+				while (middle + 2 < levels && starts[middle + 1] < part.size() / 2)
+				{
+					++middle;
+				}
+
+				const auto level_begin = [&](std::size_t level) {
+					return visited.begin() + static_cast<std::ptrdiff_t>(starts[level]);
+				};
+
+				auto before          = std::vector<std::size_t>(visited.begin(), level_begin(middle));
+				auto after           = std::vector<std::size_t>(level_begin(middle + 1), visited.end());
+				const auto separator = std::vector<std::size_t>(level_begin(middle), level_begin(middle + 1));
+
+				self(self, std::move(before));
+				self(self, std::move(after));
+
+				order.insert(order.end(), separator.begin(), separator.end());
+			}
+		};
+
+		auto all = std::vector<std::size_t>(n);
+
+		for (auto vertex = std::size_t{}; vertex < n; ++vertex)
+		{
+			all[vertex] = vertex;
+		}
+
+		dissect(dissect, std::move(all));
+
+		return order;
+	}
+} // namespace mpp::detail
@@ -0,0 +1,248 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/types.h>
+	#include <unistd.h>
+#endif
+
+namespace mpp::detail
+{
+	enum class file_mode
+	{
+		read,       // An existing file, read-only
+		read_write, // An existing file
+		create      // A new file, or an existing one truncated to nothing
+	};
+
+	/**
+	 * File read and written at explicit offsets, so different threads can read and write different parts of it at the
+	 * same time without sharing a file position
+	 */
+	class positional_file
+	{
+		std::filesystem::path path_;
+
+#ifdef _WIN32
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+#else
+		int fd_ = -1;
+#endif
+
+		// Bigger transfers are split, the size parameters of the OS calls are narrower than std::size_t
+		static constexpr auto max_transfer = std::size_t{ 1 } << 30;
+
+		[[noreturn]] void fail(const char* what) const
+		{
+			throw std::runtime_error(std::string{ "Failed to " } + what + " " + path_.string());
+		}
+
+	public:
+		/**
+		 * Throws std::runtime_error if the file can't be opened or created
+		 */
+		positional_file(const std::filesystem::path& path, file_mode mode) : path_(path)
+		{
+#ifdef _WIN32
+			const auto access      = mode == file_mode::read ? GENERIC_READ : GENERIC_READ | GENERIC_WRITE;
+			const auto disposition = mode == file_mode::create ? CREATE_ALWAYS : OPEN_EXISTING;
+
+			file_ = CreateFileW(path.c_str(),
+				access,
+				FILE_SHARE_READ,
+				nullptr,
+				disposition,
+				FILE_ATTRIBUTE_NORMAL,
+				nullptr);
+
+			if (file_ == INVALID_HANDLE_VALUE)
+			{
+				fail("open");
+			}
+#else
+			const auto flags = mode == file_mode::read ? O_RDONLY
+				: mode == file_mode::read_write        ? O_RDWR
+													   : O_RDWR | O_CREAT | O_TRUNC;
+
+			fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0666);
+
+			if (fd_ == -1)
+			{
+				fail("open");
+			}
+#endif
+		}
+
+		positional_file(const positional_file&) = delete;
+		positional_file(positional_file&&)      = delete;
+
+		auto operator=(const positional_file&) -> positional_file& = delete;
+		auto operator=(positional_file&&) -> positional_file& = delete;
+
+		~positional_file()
+		{
+#ifdef _WIN32
+			CloseHandle(file_);
+#else
+			::close(fd_);
+#endif
+		}
+
+		/**
+		 * Throws std::runtime_error if the file ends before offset + size
+		 */
+		void read_at(std::size_t offset, void* out, std::size_t size) const
+		{
+			auto* bytes = static_cast<char*>(out);
+
+			while (size > 0)
+			{
+				const auto chunk = std::min(size, max_transfer);
+
+#ifdef _WIN32
+				auto overlapped       = OVERLAPPED{};
+				overlapped.Offset     = static_cast<DWORD>(offset);
+				overlapped.OffsetHigh = static_cast<DWORD>(static_cast<unsigned long long>(offset) >> 32);
+
+				auto done = DWORD{};
+
+				if (ReadFile(file_, bytes, static_cast<DWORD>(chunk), &done, &overlapped) == 0)
+				{
+					fail("read");
+				}
+
+				const auto read = static_cast<std::size_t>(done);
+#else
+				const auto res = ::pread(fd_, bytes, chunk, static_cast<off_t>(offset));
+
+				if (res == -1)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+
+					fail("read");
+				}
+
+				const auto read = static_cast<std::size_t>(res);
+#endif
+
+				if (read == 0)
+				{
+					fail("read past the end of");
+				}
+
+				bytes += read;
+				offset += read;
+				size -= read;
+			}
+		}
+
+		/**
+		 * Throws std::runtime_error if the file can't be written
+		 */
+		void write_at(std::size_t offset, const void* in, std::size_t size) const
+		{
+			const auto* bytes = static_cast<const char*>(in);
+
+			while (size > 0)
+			{
+				const auto chunk = std::min(size, max_transfer);
+
+#ifdef _WIN32
+				auto overlapped       = OVERLAPPED{};
+				overlapped.Offset     = static_cast<DWORD>(offset);
+				overlapped.OffsetHigh = static_cast<DWORD>(static_cast<unsigned long long>(offset) >> 32);
+
+				auto done = DWORD{};
+
+				if (WriteFile(file_, bytes, static_cast<DWORD>(chunk), &done, &overlapped) == 0 || done == 0)
+				{
+					fail("write");
+				}
+
+				const auto written = static_cast<std::size_t>(done);
+#else
+				const auto res = ::pwrite(fd_, bytes, chunk, static_cast<off_t>(offset));
+
+				if (res == -1 && errno == EINTR)
+				{
+					continue;
+				}
+
+				if (res <= 0)
+				{
+					fail("write");
+				}
+
+				const auto written = static_cast<std::size_t>(res);
+#endif
+
+				bytes += written;
+				offset += written;
+				size -= written;
+			}
+		}
+
+		/**
+		 * Grows the file with zeros (sparsely where the file system can) or shrinks it
+		 */
+		void resize(std::size_t size) const
+		{
+#ifdef _WIN32
+			auto info               = FILE_END_OF_FILE_INFO{};
+			info.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+
+			if (SetFileInformationByHandle(file_, FileEndOfFileInfo, &info, sizeof(info)) == 0)
+			{
+				fail("resize");
+			}
+#else
+			if (::ftruncate(fd_, static_cast<off_t>(size)) == -1)
+			{
+				fail("resize");
+			}
+#endif
+		}
+
+		[[nodiscard]] auto path() const noexcept -> const std::filesystem::path&
+		{
+			return path_;
+		}
+	};
+} // namespace mpp::detail
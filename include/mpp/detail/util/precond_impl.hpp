@@ -0,0 +1,345 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/algo_impl.hpp>
+#include <mpp/detail/util/ordering_impl.hpp>
+#include <mpp/detail/util/sparse_impl.hpp>
+#include <mpp/detail/util/thread_pool.hpp>
+#include <mpp/detail/util/util.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace mpp::detail
+{
+	// Rows of a level are solved in chunks of this many, and levels with fewer than two chunks stay on the calling
+	// thread, since waking up the pool for every level costs more than solving a few rows
+	inline constexpr auto trsv_level_chunk = std::size_t{ 128 };
+
+	/**
+	 * Triangular matrix in compressed rows without its diagonal, whose rows are grouped in levels: rows only depend
+	 * on rows of earlier levels, so the rows of a level can be solved at the same time
+	 */
+	template<typename T>
+	struct level_scheduled_factor
+	{
+		std::vector<std::size_t> offsets = std::vector<std::size_t>(1);
+		std::vector<std::size_t> indices;
+		std::vector<T> values;
+
+		// Inverses of the diagonal, empty if it's all ones
+		std::vector<T> inv_diag;
+
+		std::vector<std::size_t> level_offsets;
+		std::vector<std::size_t> level_rows;
+	};
+
+	/**
+	 * Groups the rows of a lower (or upper) triangular pattern in levels, where the level of a row is one more than
+	 * the highest level among the rows it depends on
+	 */
+	template<typename T>
+	inline void schedule_levels(bool lower, level_scheduled_factor<T>& factor)
+	{
+		const auto n = factor.offsets.size() - 1;
+
+		auto level      = std::vector<std::size_t>(n);
+		auto levels     = std::size_t{};
+		const auto step = [&](std::size_t row) {
+			for (auto idx = factor.offsets[row]; idx < factor.offsets[row + 1]; ++idx)
+			{
+				level[row] = std::max(level[row], level[factor.indices[idx]] + 1);
+			}
+
+			levels = std::max(levels, level[row] + 1);
+		};
+
+		if (lower)
+		{
+			for (auto row = std::size_t{}; row < n; ++row)
+			{
+				step(row);
+			}
+		}
+		else
+		{
+			for (auto row = n; row-- > 0;)
+			{
+				step(row);
+			}
+		}
+
+		factor.level_offsets.assign(levels + 1, 0);
+
+		for (const auto row_level : level)
+		{
+			++factor.level_offsets[row_level + 1];
+		}
+
+		for (auto idx = std::size_t{}; idx < levels; ++idx)
+		{
+			factor.level_offsets[idx + 1] += factor.level_offsets[idx];
+		}
+
+		auto next = std::vector<std::size_t>(factor.level_offsets.begin(), factor.level_offsets.end() - 1);
+		factor.level_rows.resize(n);
+
+		for (auto row = std::size_t{}; row < n; ++row)
+		{
+			factor.level_rows[next[level[row]]++] = row;
+		}
+	}
+
+	/**
+	 * x = F^-1 * x, a level at a time
+	 */
+	template<typename T>
+	inline void level_scheduled_solve(const level_scheduled_factor<T>& factor, T* x)
+	{
+		const auto solve_rows = [&](std::size_t first, std::size_t last) {
+			for (auto pos = first; pos < last; ++pos)
+			{
+				const auto row = factor.level_rows[pos];
+				auto sum       = x[row];
+
+				for (auto idx = factor.offsets[row]; idx < factor.offsets[row + 1]; ++idx)
+				{
+					sum -= factor.values[idx] * x[factor.indices[idx]];
+				}
+
+				x[row] = factor.inv_diag.empty() ? sum : sum * factor.inv_diag[row];
+			}
+		};
+
+		const auto threads = max_threads();
+
+		for (auto level = std::size_t{}; level + 1 < factor.level_offsets.size(); ++level)
+		{
+			const auto first = factor.level_offsets[level];
+			const auto last  = factor.level_offsets[level + 1];
+
+			if (threads <= 1 || last - first < 2 * trsv_level_chunk)
+			{
+				solve_rows(first, last);
+				continue;
+			}
+
+			parallel_for(div_round_up(last - first, trsv_level_chunk), [&](std::size_t chunk) {
+				const auto chunk_first = first + chunk * trsv_level_chunk;
+				solve_rows(chunk_first, std::min(last, chunk_first + trsv_level_chunk));
+			});
+		}
+	}
+
+	/**
+	 * Position of the diagonal in every row of a square matrix of compressed rows, which must have all of them
+	 */
+	[[nodiscard]] inline auto diagonal_positions(std::span<const std::size_t> offsets,
+		std::span<const std::size_t> indices) -> std::vector<std::size_t>
+	{
+		const auto n = offsets.size() - 1;
+
+		auto diag = std::vector<std::size_t>(n);
+
+		for (auto row = std::size_t{}; row < n; ++row)
+		{
+			const auto first = indices.begin() + static_cast<std::ptrdiff_t>(offsets[row]);
+			const auto last  = indices.begin() + static_cast<std::ptrdiff_t>(offsets[row + 1]);
+			const auto found = std::lower_bound(first, last, row);
+
+			assert(found != last && *found == row);
+
+			diag[row] = static_cast<std::size_t>(found - indices.begin());
+		}
+
+		return diag;
+	}
+
+	/**
+	 * The entries of a row of compressed rows before (lower) or after (upper) its diagonal, into factor
+	 */
+	template<typename T>
+	inline void append_triangle(bool lower,
+		std::span<const std::size_t> offsets,
+		std::span<const std::size_t> indices,
+		std::span<const T> values,
+		std::span<const std::size_t> diag,
+		level_scheduled_factor<T>& factor)
+	{
+		for (auto row = std::size_t{}; row + 1 < offsets.size(); ++row)
+		{
+			const auto first = lower ? offsets[row] : diag[row] + 1;
+			const auto last  = lower ? diag[row] : offsets[row + 1];
+
+			factor.indices.insert(factor.indices.end(),
+				indices.begin() + static_cast<std::ptrdiff_t>(first),
+				indices.begin() + static_cast<std::ptrdiff_t>(last));
+			factor.values.insert(factor.values.end(),
+				values.begin() + static_cast<std::ptrdiff_t>(first),
+				values.begin() + static_cast<std::ptrdiff_t>(last));
+			factor.offsets.push_back(factor.indices.size());
+		}
+	}
+
+	/**
+	 * Incomplete LU without fill-in of a matrix of compressed rows: unit lower L and upper U with the pattern of the
+	 * matrix, such that L * U matches it on that pattern
+	 */
+	template<typename T>
+	inline void ilu0(std::span<const std::size_t> offsets,
+		std::span<const std::size_t> indices,
+		std::span<const T> values,
+		level_scheduled_factor<T>& l,
+		level_scheduled_factor<T>& u)
+	{
+		const auto n    = offsets.size() - 1;
+		const auto diag = diagonal_positions(offsets, indices);
+
+		auto lu       = std::vector<T>(values.begin(), values.end());
+		auto position = std::vector<std::size_t>(n, no_index);
+
+		for (auto row = std::size_t{}; row < n; ++row)
+		{
+			for (auto idx = offsets[row]; idx < offsets[row + 1]; ++idx)
+			{
+				position[indices[idx]] = idx;
+			}
+
+			// Eliminates the columns left of the diagonal in order, updating only entries that are in the pattern
+			for (auto idx = offsets[row]; idx < diag[row]; ++idx)
+			{
+				const auto pivot_row = indices[idx];
+				const auto pivot     = lu[diag[pivot_row]];
+
+				assert(!is_zero_or_nan(pivot));
+
+				lu[idx] /= pivot;
+
+				for (auto other = diag[pivot_row] + 1; other < offsets[pivot_row + 1]; ++other)
+				{
+					if (const auto pos = position[indices[other]]; pos != no_index)
+					{
+						lu[pos] -= lu[idx] * lu[other];
+					}
+				}
+			}
+
+			assert(!is_zero_or_nan(lu[diag[row]]));
+
+			for (auto idx = offsets[row]; idx < offsets[row + 1]; ++idx)
+			{
+				position[indices[idx]] = no_index;
+			}
+		}
+
+		append_triangle<T>(true, offsets, indices, lu, diag, l);
+		append_triangle<T>(false, offsets, indices, lu, diag, u);
+
+		u.inv_diag.resize(n);
+
+		for (auto row = std::size_t{}; row < n; ++row)
+		{
+			u.inv_diag[row] = T{ 1 } / lu[diag[row]];
+		}
+
+		schedule_levels(true, l);
+		schedule_levels(false, u);
+	}
+
+	/**
+	 * Incomplete Cholesky without fill-in of a symmetric matrix of compressed rows: lower L with the pattern of the
+	 * lower triangle, such that L * L^T matches the matrix on that pattern. upper gets L^T
+	 */
+	template<typename T>
+	inline void ic0(std::span<const std::size_t> offsets,
+		std::span<const std::size_t> indices,
+		std::span<const T> values,
+		level_scheduled_factor<T>& lower,
+		level_scheduled_factor<T>& upper)
+	{
+		const auto n    = offsets.size() - 1;
+		const auto diag = diagonal_positions(offsets, indices);
+
+		auto l        = std::vector<T>(values.begin(), values.end());
+		auto position = std::vector<std::size_t>(n, no_index);
+
+		lower.inv_diag.resize(n);
+
+		for (auto row = std::size_t{}; row < n; ++row)
+		{
+			for (auto idx = offsets[row]; idx < diag[row]; ++idx)
+			{
+				position[indices[idx]] = idx;
+			}
+
+			// L(row, col) = (A(row, col) - L(row, :col) . L(col, :col)) / L(col, col), over the pattern only
+			for (auto idx = offsets[row]; idx < diag[row]; ++idx)
+			{
+				const auto col = indices[idx];
+
+				for (auto other = offsets[col]; other < diag[col]; ++other)
+				{
+					if (const auto pos = position[indices[other]]; pos != no_index)
+					{
+						l[idx] -= l[pos] * l[other];
+					}
+				}
+
+				l[idx] *= lower.inv_diag[col];
+			}
+
+			auto pivot = l[diag[row]];
+
+			for (auto idx = offsets[row]; idx < diag[row]; ++idx)
+			{
+				pivot -= l[idx] * l[idx];
+				position[indices[idx]] = no_index;
+			}
+
+			// Incomplete Cholesky can break down on matrices that are positive definite but far from diagonally
+			// dominant
+			assert(pivot > T{});
+
+			l[diag[row]]        = std::sqrt(pivot);
+			lower.inv_diag[row] = T{ 1 } / l[diag[row]];
+		}
+
+		append_triangle<T>(true, offsets, indices, l, diag, lower);
+
+		// L^T in compressed rows is L in compressed columns
+		upper.inv_diag = lower.inv_diag;
+		transpose_compressed<T>(n,
+			n,
+			lower.offsets,
+			lower.indices,
+			lower.values,
+			upper.offsets,
+			upper.indices,
+			upper.values);
+
+		schedule_levels(true, lower);
+		schedule_levels(false, upper);
+	}
+} // namespace mpp::detail
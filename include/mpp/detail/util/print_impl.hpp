@@ -19,45 +19,66 @@
 
 #pragma once
 
+#include <mpp/detail/util/text_writer.hpp>
+
 #include <cstddef>
+#include <ios>
+#include <locale>
 
 namespace mpp::detail
 {
-	void append_expr_to_stream(auto& out, const auto& expr, const char* end)
+	/**
+	 * Whether numbers streamed into os would look like std::to_chars formats them, i.e. nothing but the precision of
+	 * os was changed
+	 */
+	[[nodiscard]] inline auto has_default_format(const std::ios_base& os) -> bool
+	{
+		const auto flags = os.flags() & ~(std::ios_base::skipws | std::ios_base::unitbuf);
+		return flags == std::ios_base::dec && os.width() == 0 && os.getloc() == std::locale::classic();
+	}
+
+	/**
+	 * Writes the elements of expr, each with put_elem(out, elem), separated by spaces with a row per line. If
+	 * edge_items is positive, only the first and last edge_items rows and columns of bigger dimensions are written,
+	 * with "..." in place of the rest
+	 */
+	void write_expr(text_writer& out, const auto& expr, auto&& put_elem, std::size_t edge_items, const char* end)
 	{
 		const auto rows = expr.rows();
 		const auto cols = expr.cols();
 
 		if (rows == 0 && cols == 0)
 		{
-			out << "[empty matrix]\n";
+			out.put("[empty matrix]\n");
+			return;
 		}
-		else
+
+		const auto elide_rows = edge_items > 0 && rows > 2 * edge_items;
+		const auto elide_cols = edge_items > 0 && cols > 2 * edge_items;
+
+		// Skips from the head to the tail of an elided dimension
+		const auto next = [edge_items](std::size_t idx, std::size_t size, bool elide) {
+			return elide && idx + 1 == edge_items ? size - edge_items : idx + 1;
+		};
+
+		for (auto row = std::size_t{}; row < rows; row = next(row, rows, elide_rows))
 		{
-			for (auto row = std::size_t{}; row < rows; ++row)
+			for (auto col = std::size_t{}; col < cols; col = next(col, cols, elide_cols))
 			{
-				for (auto col = std::size_t{}; col < cols; ++col)
+				put_elem(out, expr(row, col));
+
+				if (col + 1 < cols)
 				{
-					const auto value = expr(row, col);
-					out << value;
-
-					if (col == cols - 1)
-					{
-						if (row == rows - 1)
-						{
-							out << end;
-						}
-						else
-						{
-							out << '\n';
-						}
-					}
-					else
-					{
-						out << ' ';
-					}
+					out.put(elide_cols && col + 1 == edge_items ? " ... " : " ");
 				}
 			}
+
+			if (row + 1 < rows)
+			{
+				out.put(elide_rows && row + 1 == edge_items ? "\n...\n" : "\n");
+			}
 		}
+
+		out.put(end);
 	}
 } // namespace mpp::detail
@@ -22,6 +22,7 @@
 #include <array>
 #include <cstddef>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace mpp
@@ -37,9 +38,96 @@ namespace mpp
 	template<typename T, std::size_t N>
 	inline constexpr auto is_fixed_buf<std::array<T, N>> = true;
 
+	// Buffers that refer to read-only storage owned elsewhere (e.g. mapped_buf), they're never resized or written
+	template<typename>
+	inline constexpr auto is_view_buf = false;
+
+	/**
+	 * Buffer of the matrices algorithms return by default for matrices with a Buf, views can't hold results so they
+	 * get a std::vector
+	 */
+	template<typename Buf>
+	struct result_buf
+	{
+		using type = Buf;
+	};
+
+	template<typename Buf>
+	using result_buf_t = typename result_buf<Buf>::type;
+
+	/**
+	 * Storage layouts of matrices. Element (row, col) lives at buf[row * rs + col * cs], where (rs, cs) come from
+	 * strides()
+	 */
+
+	struct row_major
+	{
+		static constexpr auto padded = false;
+
+		[[nodiscard]] static constexpr auto buf_size(std::size_t rows, std::size_t cols) noexcept -> std::size_t
+		{
+			return rows * cols;
+		}
+
+		[[nodiscard]] static constexpr auto strides(std::size_t, std::size_t cols) noexcept
+			-> std::pair<std::size_t, std::size_t>
+		{
+			return { cols, 1 };
+		}
+	};
+
+	struct col_major
+	{
+		static constexpr auto padded = false;
+
+		[[nodiscard]] static constexpr auto buf_size(std::size_t rows, std::size_t cols) noexcept -> std::size_t
+		{
+			return rows * cols;
+		}
+
+		[[nodiscard]] static constexpr auto strides(std::size_t rows, std::size_t) noexcept
+			-> std::pair<std::size_t, std::size_t>
+		{
+			return { 1, rows };
+		}
+	};
+
+	/**
+	 * Row major, but every row is padded to a multiple of Align elements, so rows can start on an aligned boundary
+	 */
+	template<std::size_t Align>
+	struct padded_row_major
+	{
+		static_assert(Align != 0, "Alignment must be at least 1 element");
+
+		static constexpr auto padded = true;
+
+		[[nodiscard]] static constexpr auto ld(std::size_t cols) noexcept -> std::size_t
+		{
+			return (cols + Align - 1) / Align * Align;
+		}
+
+		[[nodiscard]] static constexpr auto buf_size(std::size_t rows, std::size_t cols) noexcept -> std::size_t
+		{
+			return rows * ld(cols);
+		}
+
+		[[nodiscard]] static constexpr auto strides(std::size_t, std::size_t cols) noexcept
+			-> std::pair<std::size_t, std::size_t>
+		{
+			return { ld(cols), 1 };
+		}
+	};
+
 	struct identity_tag
 	{
 	};
 
 	inline constexpr auto identity = identity_tag{};
+
+	struct lazy_tag
+	{
+	};
+
+	inline constexpr auto lazy = lazy_tag{};
 } // namespace mpp
@@ -0,0 +1,711 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/gemm_impl.hpp>
+#include <mpp/detail/util/ordering_impl.hpp>
+#include <mpp/detail/util/sparse_impl.hpp>
+#include <mpp/detail/util/tiled_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace mpp::detail
+{
+	// Widest relaxed supernodes with any share of explicit zeros, with less than 80% of them and with less than 10%
+	inline constexpr auto relax_small_cols  = std::size_t{ 4 };
+	inline constexpr auto relax_medium_cols = std::size_t{ 16 };
+	inline constexpr auto relax_large_cols  = std::size_t{ 48 };
+
+	// Pivots of a front factored at once before the rest of it is updated with a GEMM
+	inline constexpr auto front_block_cols = std::size_t{ 64 };
+
+	/**
+	 * Everything about a sparse factorization that only depends on the pattern of the matrix. Columns are numbered in
+	 * elimination order, and consecutive columns with the same structure below the diagonal block are grouped into
+	 * supernodes, which are factored as dense fronts
+	 */
+	struct symbolic_data
+	{
+		std::size_t size = 0;
+		bool compresses_rows = true;
+
+		// Pattern that was analyzed, numeric phases must be given the same one
+		std::vector<std::size_t> pattern_offsets;
+		std::vector<std::size_t> pattern_indices;
+
+		// Elimination order: the original index of every column
+		std::vector<std::size_t> perm;
+
+		// First column of every supernode, plus the size at the end
+		std::vector<std::size_t> super_first;
+
+		// Rows below the diagonal block of every supernode, increasing
+		std::vector<std::size_t> row_offsets;
+		std::vector<std::size_t> rows;
+
+		// Supernodes whose fronts are added into each supernode's front
+		std::vector<std::size_t> children;
+
+		// Where every nonzero of the pattern goes in the front of its supernode (row * front size + column)
+		std::vector<std::size_t> assembly_offsets;
+		std::vector<std::pair<std::size_t, std::size_t>> assembly;
+
+		// Where the values of every supernode start: L is front size x supernode size, and U (for LU only) is supernode
+		// size x rows below the diagonal block
+		std::vector<std::size_t> l_offsets;
+		std::vector<std::size_t> u_offsets;
+
+		std::size_t max_front = 0;
+		std::size_t factor_nnz = 0;
+		double cholesky_flops = 0.0;
+
+		[[nodiscard]] auto supernodes() const noexcept -> std::size_t
+		{
+			return super_first.size() - 1;
+		}
+
+		[[nodiscard]] auto cols_of(std::size_t super) const noexcept -> std::size_t
+		{
+			return super_first[super + 1] - super_first[super];
+		}
+
+		[[nodiscard]] auto rows_of(std::size_t super) const noexcept -> std::span<const std::size_t>
+		{
+			return { rows.data() + row_offsets[super], row_offsets[super + 1] - row_offsets[super] };
+		}
+
+		[[nodiscard]] auto front_of(std::size_t super) const noexcept -> std::size_t
+		{
+			return cols_of(super) + row_offsets[super + 1] - row_offsets[super];
+		}
+	};
+
+	/**
+	 * Elimination tree, postorder, column counts and supernodes of the pattern of a + a^T in the given elimination
+	 * order, all in time about linear in the nonzeros of the factor
+	 */
+	[[nodiscard]] inline auto analyze_pattern(bool compresses_rows,
+		std::span<const std::size_t> offsets,
+		std::span<const std::size_t> indices,
+		const sym_graph& graph,
+		std::vector<std::size_t> order) -> symbolic_data
+	{
+		const auto n = graph.size();
+
+		auto sym            = symbolic_data{};
+		sym.size            = n;
+		sym.compresses_rows = compresses_rows;
+		sym.pattern_offsets.assign(offsets.begin(), offsets.end());
+		sym.pattern_indices.assign(indices.begin(), indices.end());
+
+		auto position = std::vector<std::size_t>(n);
+
+		const auto invert = [&]() {
+			for (auto col = std::size_t{}; col < n; ++col)
+			{
+				position[order[col]] = col;
+			}
+		};
+
+		invert();
+
+		// Elimination tree, climbing from every earlier neighbour with path compression
+		auto parent   = std::vector<std::size_t>(n, no_index);
+		auto ancestor = std::vector<std::size_t>(n, no_index);
+
+		for (auto col = std::size_t{}; col < n; ++col)
+		{
+			for (const auto other : graph.adjacent(order[col]))
+			{
+				for (auto node = position[other]; node < col;)
+				{
+					const auto next = ancestor[node];
+					ancestor[node]  = col;
+
+					if (next == no_index)
+					{
+						parent[node] = col;
+						break;
+					}
+
+					node = next;
+				}
+			}
+		}
+
+		// Postorder, so every subtree is a range of columns that ends with its root
+		auto first_child  = std::vector<std::size_t>(n, no_index);
+		auto next_sibling = std::vector<std::size_t>(n, no_index);
+
+		for (auto col = n; col-- > 0;)
+		{
+			if (parent[col] != no_index)
+			{
+				next_sibling[col]        = first_child[parent[col]];
+				first_child[parent[col]] = col;
+			}
+		}
+
+		auto post  = std::vector<std::size_t>{};
+		auto stack = std::vector<std::size_t>{};
+		post.reserve(n);
+
+		for (auto root = std::size_t{}; root < n; ++root)
+		{
+			if (parent[root] != no_index)
+			{
+				continue;
+			}
+
+			stack.push_back(root);
+
+			while (!stack.empty())
+			{
+				const auto node = stack.back();
+
+				if (first_child[node] != no_index)
+				{
+					const auto child  = first_child[node];
+					first_child[node] = next_sibling[child];
+					stack.push_back(child);
+				}
+				else
+				{
+					stack.pop_back();
+					post.push_back(node);
+				}
+			}
+		}
+
+		auto relabel = std::vector<std::size_t>(n);
+
+		for (auto col = std::size_t{}; col < n; ++col)
+		{
+			relabel[post[col]] = col;
+		}
+
+		sym.perm.resize(n);
+		auto post_parent = std::vector<std::size_t>(n, no_index);
+
+		for (auto col = std::size_t{}; col < n; ++col)
+		{
+			sym.perm[col]    = order[post[col]];
+			post_parent[col] = parent[post[col]] == no_index ? no_index : relabel[parent[post[col]]];
+		}
+
+		order  = sym.perm;
+		parent = std::move(post_parent);
+		invert();
+
+		// Off-diagonal nonzeros of every column of the factor: row k has a nonzero in every column on the paths from
+		// its earlier neighbours up to k
+		auto counts   = std::vector<std::size_t>(n);
+		auto children = std::vector<std::size_t>(n);
+		auto mark     = std::vector<std::size_t>(n, no_index);
+
+		for (auto col = std::size_t{}; col < n; ++col)
+		{
+			mark[col] = col;
+
+			if (parent[col] != no_index)
+			{
+				++children[parent[col]];
+			}
+
+			for (const auto other : graph.adjacent(order[col]))
+			{
+				if (position[other] > col)
+				{
+					continue;
+				}
+
+				for (auto node = position[other]; mark[node] != col; node = parent[node])
+				{
+					++counts[node];
+					mark[node] = col;
+				}
+			}
+		}
+
+		// Fundamental supernodes: a column continues the previous one's supernode if it's its only child and has the
+		// same structure below. A supernode also takes in the one right before it when that's its child and the
+		// explicit zeros this adds are few (relaxed supernodes), so more of the work happens in big GEMMs
+		struct relaxed_super
+		{
+			std::size_t first;
+			std::size_t cols;
+			std::size_t nnz;
+		};
+
+		auto relaxed = std::vector<relaxed_super>{};
+
+		for (auto first = std::size_t{}; first < n;)
+		{
+			auto last = first + 1;
+
+			while (last < n && parent[last - 1] == last && counts[last - 1] == counts[last] + 1 && children[last] == 1)
+			{
+				++last;
+			}
+
+			const auto cols  = last - first;
+			const auto below = counts[first] + 1 - cols;
+			const auto nnz   = cols * (cols + 1) / 2 + cols * below;
+
+			if (!relaxed.empty() && parent[first - 1] != no_index && parent[first - 1] < last)
+			{
+				auto& prev = relaxed.back();
+
+				const auto merged = prev.cols + cols;
+				const auto total  = merged * (merged + 1) / 2 + merged * below;
+				const auto zeros  = total - prev.nnz - nnz;
+
+				if (merged <= relax_small_cols || (merged <= relax_medium_cols && zeros * 10 < total * 8) ||
+					(merged <= relax_large_cols && zeros * 10 < total))
+				{
+					prev.cols = merged;
+					prev.nnz += nnz;
+					first = last;
+					continue;
+				}
+			}
+
+			relaxed.push_back({ first, cols, nnz });
+			first = last;
+		}
+
+		auto super_of = std::vector<std::size_t>(n);
+
+		for (auto super = std::size_t{}; super < relaxed.size(); ++super)
+		{
+			sym.super_first.push_back(relaxed[super].first);
+			std::fill_n(super_of.begin() + static_cast<std::ptrdiff_t>(relaxed[super].first),
+				relaxed[super].cols,
+				super);
+		}
+
+		sym.super_first.push_back(n);
+
+		const auto supers = sym.supernodes();
+
+		auto super_parent = std::vector<std::size_t>(supers, no_index);
+		sym.children.assign(supers, 0);
+
+		for (auto super = std::size_t{}; super < supers; ++super)
+		{
+			const auto root = parent[sym.super_first[super + 1] - 1];
+
+			if (root != no_index)
+			{
+				super_parent[super] = super_of[root];
+				++sym.children[super_of[root]];
+			}
+		}
+
+		// Rows below every supernode are its own columns' neighbours below it, plus those of its children
+		auto child_first = std::vector<std::size_t>(supers, no_index);
+		auto child_next  = std::vector<std::size_t>(supers, no_index);
+
+		for (auto super = supers; super-- > 0;)
+		{
+			if (super_parent[super] != no_index)
+			{
+				child_next[super]                = child_first[super_parent[super]];
+				child_first[super_parent[super]] = super;
+			}
+		}
+
+		std::ranges::fill(mark, no_index);
+		sym.row_offsets.assign(1, 0);
+
+		for (auto super = std::size_t{}; super < supers; ++super)
+		{
+			const auto first = sym.super_first[super];
+			const auto last  = sym.super_first[super + 1];
+			const auto begin = sym.rows.size();
+
+			const auto add_row = [&](std::size_t row) {
+				if (row >= last && mark[row] != super)
+				{
+					mark[row] = super;
+					sym.rows.push_back(row);
+				}
+			};
+
+			for (auto col = first; col < last; ++col)
+			{
+				for (const auto other : graph.adjacent(order[col]))
+				{
+					add_row(position[other]);
+				}
+			}
+
+			for (auto child = child_first[super]; child != no_index; child = child_next[child])
+			{
+				for (auto idx = sym.row_offsets[child]; idx < sym.row_offsets[child + 1]; ++idx)
+				{
+					add_row(sym.rows[idx]);
+				}
+			}
+
+			std::sort(sym.rows.begin() + static_cast<std::ptrdiff_t>(begin), sym.rows.end());
+			sym.row_offsets.push_back(sym.rows.size());
+		}
+
+		// Values of the factors, and the flops of a Cholesky factorization (LU takes twice as many)
+		sym.l_offsets.assign(1, 0);
+		sym.u_offsets.assign(1, 0);
+
+		for (auto super = std::size_t{}; super < supers; ++super)
+		{
+			const auto cols  = sym.cols_of(super);
+			const auto front = sym.front_of(super);
+
+			sym.l_offsets.push_back(sym.l_offsets.back() + front * cols);
+			sym.u_offsets.push_back(sym.u_offsets.back() + cols * (front - cols));
+			sym.max_front = std::max(sym.max_front, front);
+		}
+
+		for (auto col = std::size_t{}; col < n; ++col)
+		{
+			const auto count = static_cast<double>(counts[col]);
+
+			sym.factor_nnz += counts[col] + 1;
+			sym.cholesky_flops += count * count + 2.0 * count + 1.0;
+		}
+
+		// Front positions of the nonzeros, by supernode
+		const auto front_position = [&](std::size_t super, std::size_t idx) {
+			const auto first = sym.super_first[super];
+
+			if (idx < sym.super_first[super + 1])
+			{
+				return idx - first;
+			}
+
+			const auto rows = sym.rows_of(super);
+			return sym.cols_of(super) + static_cast<std::size_t>(std::ranges::lower_bound(rows, idx) - rows.begin());
+		};
+
+		const auto nnz = indices.size();
+		auto targets   = std::vector<std::pair<std::size_t, std::size_t>>(nnz);
+
+		sym.assembly_offsets.assign(supers + 1, 0);
+
+		for (auto outer = std::size_t{}; outer < n; ++outer)
+		{
+			for (auto idx = offsets[outer]; idx < offsets[outer + 1]; ++idx)
+			{
+				const auto row   = position[compresses_rows ? outer : indices[idx]];
+				const auto col   = position[compresses_rows ? indices[idx] : outer];
+				const auto super = super_of[std::min(row, col)];
+
+				targets[idx] = { super, front_position(super, row) * sym.front_of(super) + front_position(super, col) };
+				++sym.assembly_offsets[super + 1];
+			}
+		}
+
+		for (auto super = std::size_t{}; super < supers; ++super)
+		{
+			sym.assembly_offsets[super + 1] += sym.assembly_offsets[super];
+		}
+
+		auto next = std::vector<std::size_t>(sym.assembly_offsets.begin(), sym.assembly_offsets.end() - 1);
+		sym.assembly.resize(nnz);
+
+		for (auto idx = std::size_t{}; idx < nnz; ++idx)
+		{
+			sym.assembly[next[targets[idx].first]++] = { idx, targets[idx].second };
+		}
+
+		return sym;
+	}
+
+	/**
+	 * Factors the first cols pivots of a front x front matrix in place (unpivoted LU, or Cholesky in the lower
+	 * triangle), a block of pivots at a time, and updates the rest of the front with what they contribute
+	 */
+	template<typename T>
+	inline void factor_front(bool cholesky, strided_view<T> front, std::size_t size, std::size_t cols)
+	{
+		auto neg_panel = scratch_vector<T>(size * std::min(cols, front_block_cols));
+
+		for (auto first = std::size_t{}; first < cols; first += front_block_cols)
+		{
+			const auto last  = std::min(cols, first + front_block_cols);
+			const auto width = last - first;
+			const auto rest  = size - last;
+			const auto diag  = front.sub(first, first);
+
+			if (cholesky)
+			{
+				cholesky_tile(diag, width);
+			}
+			else
+			{
+				lu_tile(diag, width);
+			}
+
+			if (rest == 0)
+			{
+				continue;
+			}
+
+			const auto below = front.sub(last, first);
+			const auto right = front.sub(first, last);
+
+			if (cholesky)
+			{
+				trsm_lower(false, diag.as_const(), below.trps(), width, rest);
+			}
+			else
+			{
+				trsm_lower(false, diag.as_const().trps(), below.trps(), width, rest);
+				trsm_lower(true, diag.as_const(), right, width, rest);
+			}
+
+			// front[last:, last:] -= below * right (or below * below^T), with below negated into a copy
+			for (auto row = std::size_t{}; row < rest; ++row)
+			{
+				for (auto col = std::size_t{}; col < width; ++col)
+				{
+					neg_panel[row * width + col] = -below(row, col);
+				}
+			}
+
+			const auto neg_view = strided_view<const T>{ neg_panel.data(), width, 1 };
+
+			gemm(rest,
+				rest,
+				width,
+				neg_view,
+				cholesky ? below.as_const().trps() : right.as_const(),
+				front.sub(last, last),
+				true);
+		}
+	}
+
+	/**
+	 * Multifrontal factorization: supernodes are visited in postorder, each assembles its front from the nonzeros of
+	 * its columns and the update matrices its children left on the stack, factors its pivots and leaves its own update
+	 * matrix for its parent
+	 */
+	template<typename T>
+	inline void factor_multifrontal(const symbolic_data& sym,
+		std::span<const T> values,
+		bool cholesky,
+		std::vector<T>& l_values,
+		std::vector<T>& u_values)
+	{
+		struct update_matrix
+		{
+			std::size_t super;
+			scratch_vector<T> values;
+		};
+
+		l_values.assign(sym.l_offsets.back(), T{});
+		u_values.assign(cholesky ? 0 : sym.u_offsets.back(), T{});
+
+		auto front     = scratch_vector<T>(sym.max_front * sym.max_front);
+		auto positions = std::vector<std::size_t>(sym.size);
+		auto updates   = std::vector<update_matrix>{};
+
+		for (auto super = std::size_t{}; super < sym.supernodes(); ++super)
+		{
+			const auto first = sym.super_first[super];
+			const auto cols  = sym.cols_of(super);
+			const auto rows  = sym.rows_of(super);
+			const auto size  = sym.front_of(super);
+			const auto view  = strided_view<T>{ front.data(), size, 1 };
+
+			std::fill_n(front.begin(), size * size, T{});
+
+			for (auto col = std::size_t{}; col < cols; ++col)
+			{
+				positions[first + col] = col;
+			}
+
+			for (auto idx = std::size_t{}; idx < rows.size(); ++idx)
+			{
+				positions[rows[idx]] = cols + idx;
+			}
+
+			// Only the lower triangle of a symmetric matrix is read
+			for (auto idx = sym.assembly_offsets[super]; idx < sym.assembly_offsets[super + 1]; ++idx)
+			{
+				const auto [nz, pos] = sym.assembly[idx];
+
+				if (!cholesky || pos / size >= pos % size)
+				{
+					front[pos] += values[nz];
+				}
+			}
+
+			// Children were the last supernodes to leave update matrices, so theirs are on top of the stack
+			for (auto child = std::size_t{}; child < sym.children[super]; ++child)
+			{
+				const auto& update     = updates.back();
+				const auto update_rows = sym.rows_of(update.super);
+				const auto update_size = update_rows.size();
+
+				for (auto row = std::size_t{}; row < update_size; ++row)
+				{
+					auto* const front_row = front.data() + positions[update_rows[row]] * size;
+
+					for (auto col = std::size_t{}; col < update_size; ++col)
+					{
+						front_row[positions[update_rows[col]]] += update.values[row * update_size + col];
+					}
+				}
+
+				updates.pop_back();
+			}
+
+			factor_front(cholesky, view, size, cols);
+
+			auto* const l_panel = l_values.data() + sym.l_offsets[super];
+
+			for (auto row = std::size_t{}; row < size; ++row)
+			{
+				std::copy_n(front.data() + row * size, cols, l_panel + row * cols);
+			}
+
+			if (!cholesky)
+			{
+				auto* const u_panel = u_values.data() + sym.u_offsets[super];
+
+				for (auto row = std::size_t{}; row < cols; ++row)
+				{
+					std::copy_n(front.data() + row * size + cols, rows.size(), u_panel + row * rows.size());
+				}
+			}
+
+			if (!rows.empty())
+			{
+				auto update = update_matrix{ super, scratch_vector<T>(rows.size() * rows.size()) };
+
+				for (auto row = std::size_t{}; row < rows.size(); ++row)
+				{
+					std::copy_n(front.data() + (cols + row) * size + cols,
+						rows.size(),
+						update.values.data() + row * rows.size());
+				}
+
+				updates.push_back(std::move(update));
+			}
+		}
+	}
+
+	/**
+	 * x = (L * U)^-1 * x (or (L * L^T)^-1 * x) in place, for n x m x in elimination order and row major
+	 */
+	template<typename T>
+	inline void solve_supernodal(const symbolic_data& sym,
+		bool cholesky,
+		std::span<const T> l_values,
+		std::span<const T> u_values,
+		T* x,
+		std::size_t m)
+	{
+		const auto x_row = [&](std::size_t row) {
+			return x + row * m;
+		};
+
+		for (auto super = std::size_t{}; super < sym.supernodes(); ++super)
+		{
+			const auto first    = sym.super_first[super];
+			const auto cols     = sym.cols_of(super);
+			const auto rows     = sym.rows_of(super);
+			const auto* l_panel = l_values.data() + sym.l_offsets[super];
+
+			for (auto row = std::size_t{}; row < cols; ++row)
+			{
+				for (auto col = std::size_t{}; col < row; ++col)
+				{
+					sparse_axpy(m, -l_panel[row * cols + col], x_row(first + col), 1, x_row(first + row), 1);
+				}
+
+				if (cholesky)
+				{
+					const auto diag = l_panel[row * cols + row];
+
+					for (auto idx = std::size_t{}; idx < m; ++idx)
+					{
+						x_row(first + row)[idx] /= diag;
+					}
+				}
+			}
+
+			for (auto idx = std::size_t{}; idx < rows.size(); ++idx)
+			{
+				for (auto col = std::size_t{}; col < cols; ++col)
+				{
+					sparse_axpy(m, -l_panel[(cols + idx) * cols + col], x_row(first + col), 1, x_row(rows[idx]), 1);
+				}
+			}
+		}
+
+		for (auto super = sym.supernodes(); super-- > 0;)
+		{
+			const auto first    = sym.super_first[super];
+			const auto cols     = sym.cols_of(super);
+			const auto rows     = sym.rows_of(super);
+			const auto* l_panel = l_values.data() + sym.l_offsets[super];
+			const auto* u_panel = u_values.data() + sym.u_offsets[super];
+
+			// U is L^T for Cholesky, and the upper triangle of the diagonal block with the U panel on its right for LU
+			const auto upper = [&](std::size_t row, std::size_t col) {
+				return cholesky ? l_panel[col * cols + row] : l_panel[row * cols + col];
+			};
+
+			const auto upper_right = [&](std::size_t row, std::size_t idx) {
+				return cholesky ? l_panel[(cols + idx) * cols + row] : u_panel[row * rows.size() + idx];
+			};
+
+			for (auto row = cols; row-- > 0;)
+			{
+				auto* const target = x_row(first + row);
+
+				for (auto idx = std::size_t{}; idx < rows.size(); ++idx)
+				{
+					sparse_axpy(m, -upper_right(row, idx), x_row(rows[idx]), 1, target, 1);
+				}
+
+				for (auto col = row + 1; col < cols; ++col)
+				{
+					sparse_axpy(m, -upper(row, col), x_row(first + col), 1, target, 1);
+				}
+
+				const auto diag = upper(row, row);
+
+				for (auto idx = std::size_t{}; idx < m; ++idx)
+				{
+					target[idx] /= diag;
+				}
+			}
+		}
+	}
+} // namespace mpp::detail
@@ -0,0 +1,627 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/thread_pool.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/util/cfg.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace mpp::detail
+{
+	// Below this many multiply-adds, sparse kernels don't wake up the thread pool
+	inline constexpr auto sparse_par_madds = std::size_t{ 1 } << 16;
+
+	// Parts per thread, so the dynamic scheduling evens out rows (or columns) that are denser than the estimate
+	inline constexpr auto sparse_parts_per_thread = std::size_t{ 4 };
+
+	/**
+	 * Nonzeros of a compressed row (csr) or column (csc) matrix
+	 */
+	template<typename T>
+	struct compressed_view
+	{
+		std::span<const std::size_t> offsets;
+		std::span<const std::size_t> indices;
+		std::span<const T> values;
+
+		[[nodiscard]] auto outer_size() const noexcept -> std::size_t
+		{
+			return offsets.size() - 1;
+		}
+	};
+
+	template<typename T>
+	inline void fill_strided(strided_view<T> out, std::size_t rows, std::size_t cols, T val)
+	{
+		for (auto row = std::size_t{}; row < rows; ++row)
+		{
+			for (auto col = std::size_t{}; col < cols; ++col)
+			{
+				out(row, col) = val;
+			}
+		}
+	}
+
+	/**
+	 * Splits [0, outer_size) into up to `parts` ranges with about the same number of nonzeros, counting every row (or
+	 * column) as one more so long runs of empty ones are split too. Returns the bounds of the ranges
+	 */
+	[[nodiscard]] inline auto balanced_parts(std::span<const std::size_t> offsets, std::size_t parts)
+		-> std::vector<std::size_t>
+	{
+		const auto outer_size = offsets.size() - 1;
+		const auto total      = offsets.back() + outer_size;
+
+		parts = std::clamp(parts, std::size_t{ 1 }, std::max(outer_size, std::size_t{ 1 }));
+
+		auto bounds = std::vector<std::size_t>{ 0 };
+		bounds.reserve(parts + 1);
+
+		for (auto part = std::size_t{ 1 }; part < parts; ++part)
+		{
+			const auto target = total * part / parts;
+
+			// First outer index whose work before it reaches the target
+			auto first = bounds.back();
+			auto last  = outer_size;
+
+			while (first < last)
+			{
+				const auto mid = first + (last - first) / 2;
+
+				if (offsets[mid] + mid < target)
+				{
+					first = mid + 1;
+				}
+				else
+				{
+					last = mid;
+				}
+			}
+
+			if (first > bounds.back())
+			{
+				bounds.push_back(first);
+			}
+		}
+
+		bounds.push_back(outer_size);
+		return bounds;
+	}
+
+	/**
+	 * Calls fn(first, last) on ranges of outer indices with balanced nonzeros, in parallel if madds is big enough
+	 */
+	template<typename Fn>
+	inline void for_each_compressed_part(std::span<const std::size_t> offsets, std::size_t madds, Fn&& fn)
+	{
+		const auto threads = max_threads();
+
+		if (threads <= 1 || madds < sparse_par_madds)
+		{
+			fn(std::size_t{}, offsets.size() - 1);
+			return;
+		}
+
+		const auto bounds = balanced_parts(offsets, threads * sparse_parts_per_thread);
+
+		parallel_for(bounds.size() - 1, [&](std::size_t part) {
+			fn(bounds[part], bounds[part + 1]);
+		});
+	}
+
+	/**
+	 * y += alpha * x for n elements, contiguous operands are written so the compiler vectorizes them
+	 */
+	template<typename T>
+	inline void sparse_axpy(std::size_t n, T alpha, const T* x, std::size_t x_stride, T* y, std::size_t y_stride)
+	{
+		if (x_stride == 1 && y_stride == 1)
+		{
+			for (auto idx = std::size_t{}; idx < n; ++idx)
+			{
+				y[idx] += alpha * x[idx];
+			}
+		}
+		else
+		{
+			for (auto idx = std::size_t{}; idx < n; ++idx)
+			{
+				y[idx * y_stride] += alpha * x[idx * x_stride];
+			}
+		}
+	}
+
+	/**
+	 * Sum of values[i] * x[indices[i] * x_stride] over [first, last), with independent accumulators so the additions
+	 * don't wait on each other
+	 */
+	template<typename T>
+	[[nodiscard]] inline auto sparse_dot(const compressed_view<T>& a,
+		std::size_t first,
+		std::size_t last,
+		const T* x,
+		std::size_t x_stride) -> T
+	{
+		auto acc = std::array<T, 4>{};
+		auto idx = first;
+
+		for (; idx + 4 <= last; idx += 4)
+		{
+			acc[0] += a.values[idx] * x[a.indices[idx] * x_stride];
+			acc[1] += a.values[idx + 1] * x[a.indices[idx + 1] * x_stride];
+			acc[2] += a.values[idx + 2] * x[a.indices[idx + 2] * x_stride];
+			acc[3] += a.values[idx + 3] * x[a.indices[idx + 3] * x_stride];
+		}
+
+		for (; idx < last; ++idx)
+		{
+			acc[0] += a.values[idx] * x[a.indices[idx] * x_stride];
+		}
+
+		return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+	}
+
+	/**
+	 * out += a (or out -= a) for a compressed matrix a
+	 */
+	template<typename T>
+	inline void scatter_compressed(bool compresses_rows,
+		std::span<const std::size_t> offsets,
+		std::span<const std::size_t> indices,
+		std::span<const T> values,
+		strided_view<T> out,
+		bool subtract)
+	{
+		const auto outer_stride = compresses_rows ? out.rs : out.cs;
+		const auto inner_stride = compresses_rows ? out.cs : out.rs;
+
+		for_each_compressed_part(offsets, offsets.back(), [&](std::size_t first, std::size_t last) {
+			for (auto outer = first; outer < last; ++outer)
+			{
+				auto* const line = out.data + outer * outer_stride;
+
+				for (auto idx = offsets[outer]; idx < offsets[outer + 1]; ++idx)
+				{
+					if (subtract)
+					{
+						line[indices[idx] * inner_stride] -= values[idx];
+					}
+					else
+					{
+						line[indices[idx] * inner_stride] += values[idx];
+					}
+				}
+			}
+		});
+	}
+
+	/**
+	 * Compressed rows to compressed columns or the other way around, with a counting sort that keeps the indices of
+	 * every new row (or column) increasing
+	 */
+	template<typename T>
+	inline void transpose_compressed(std::size_t outer_size,
+		std::size_t inner_size,
+		std::span<const std::size_t> offsets,
+		std::span<const std::size_t> indices,
+		std::span<const T> values,
+		std::vector<std::size_t>& out_offsets,
+		std::vector<std::size_t>& out_indices,
+		std::vector<T>& out_values)
+	{
+		const auto nnz = values.size();
+
+		out_offsets.assign(inner_size + 1, 0);
+		out_indices.resize(nnz);
+		out_values.resize(nnz);
+
+		for (const auto inner : indices)
+		{
+			++out_offsets[inner + 1];
+		}
+
+		for (auto inner = std::size_t{}; inner < inner_size; ++inner)
+		{
+			out_offsets[inner + 1] += out_offsets[inner];
+		}
+
+		auto next = std::vector<std::size_t>(out_offsets.begin(), out_offsets.end() - 1);
+
+		for (auto outer = std::size_t{}; outer < outer_size; ++outer)
+		{
+			for (auto idx = offsets[outer]; idx < offsets[outer + 1]; ++idx)
+			{
+				const auto pos   = next[indices[idx]]++;
+				out_indices[pos] = outer;
+				out_values[pos]  = values[idx];
+			}
+		}
+	}
+
+	/**
+	 * Compressed arrays from (outer, inner, value) entries in any order, summing the values of duplicates in the order
+	 * of the entries. Every step is parallel and linear in the entries, apart from sorting each row (or column):
+	 * counting the entries of each, placing the entries into their row, sorting and merging every row, and compacting
+	 */
+	template<typename T, typename Entry>
+	inline void build_compressed(std::size_t outer_size,
+		std::span<const Entry> entries,
+		const auto& outer_of,
+		const auto& inner_of,
+		const auto& value_of,
+		std::vector<std::size_t>& offsets,
+		std::vector<std::size_t>& indices,
+		std::vector<T>& values)
+	{
+		const auto size    = entries.size();
+		const auto threads = size < sparse_par_madds ? std::size_t{ 1 } : max_threads();
+		const auto chunks  = std::max(threads * sparse_parts_per_thread, std::size_t{ 1 });
+		const auto chunk   = div_round_up(std::max(size, std::size_t{ 1 }), chunks);
+
+		const auto for_each_chunk = [&](const auto& fn) {
+			parallel_for(
+				div_round_up(size, chunk),
+				[&](std::size_t task) {
+					fn(task * chunk, std::min(size, (task + 1) * chunk));
+				},
+				threads);
+		};
+
+		// Entries of every row, then where each row starts
+		auto counts = std::vector<std::atomic<std::size_t>>(outer_size);
+
+		for_each_chunk([&](std::size_t first, std::size_t last) {
+			for (auto idx = first; idx < last; ++idx)
+			{
+				counts[outer_of(entries[idx])].fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+
+		auto starts = std::vector<std::size_t>(outer_size + 1);
+
+		for (auto outer = std::size_t{}; outer < outer_size; ++outer)
+		{
+			starts[outer + 1] = starts[outer] + counts[outer].load(std::memory_order_relaxed);
+			counts[outer].store(starts[outer], std::memory_order_relaxed);
+		}
+
+		// (inner, position in entries) of every entry, grouped by row in any order
+		struct placed
+		{
+			std::size_t inner;
+			std::size_t entry;
+
+			auto operator<=>(const placed&) const = default;
+		};
+
+		auto grouped = std::vector<placed>(size);
+
+		for_each_chunk([&](std::size_t first, std::size_t last) {
+			for (auto idx = first; idx < last; ++idx)
+			{
+				const auto pos = counts[outer_of(entries[idx])].fetch_add(1, std::memory_order_relaxed);
+				grouped[pos]   = { inner_of(entries[idx]), idx };
+			}
+		});
+
+		// Rows are sorted by (inner, entry) so duplicates are next to each other and summed in a fixed order, then
+		// merged in place at the start of their part of grouped
+		auto merged_values = std::vector<T>(size);
+		auto merged_counts = std::vector<std::size_t>(outer_size);
+
+		const auto merge_rows = [&](std::size_t first, std::size_t last) {
+			for (auto outer = first; outer < last; ++outer)
+			{
+				const auto row_first = grouped.begin() + static_cast<std::ptrdiff_t>(starts[outer]);
+				const auto row_last  = grouped.begin() + static_cast<std::ptrdiff_t>(starts[outer + 1]);
+
+				std::sort(row_first, row_last);
+
+				auto out = starts[outer];
+
+				for (auto idx = starts[outer]; idx < starts[outer + 1]; ++idx)
+				{
+					const auto& [inner, entry] = grouped[idx];
+
+					if (out > starts[outer] && grouped[out - 1].inner == inner)
+					{
+						merged_values[out - 1] += value_of(entries[entry]);
+					}
+					else
+					{
+						grouped[out].inner   = inner;
+						merged_values[out++] = value_of(entries[entry]);
+					}
+				}
+
+				merged_counts[outer] = out - starts[outer];
+			}
+		};
+
+		if (threads <= 1)
+		{
+			merge_rows(0, outer_size);
+		}
+		else
+		{
+			const auto bounds = balanced_parts(starts, threads * sparse_parts_per_thread);
+
+			parallel_for(
+				bounds.size() - 1,
+				[&](std::size_t part) {
+					merge_rows(bounds[part], bounds[part + 1]);
+				},
+				threads);
+		}
+
+		offsets.assign(outer_size + 1, 0);
+
+		for (auto outer = std::size_t{}; outer < outer_size; ++outer)
+		{
+			offsets[outer + 1] = offsets[outer] + merged_counts[outer];
+		}
+
+		indices.resize(offsets.back());
+		values.resize(offsets.back());
+
+		const auto rows_per_task = std::max(div_round_up(outer_size, chunks), std::size_t{ 1 });
+
+		parallel_for(
+			div_round_up(outer_size, rows_per_task),
+			[&](std::size_t task) {
+				const auto last = std::min(outer_size, (task + 1) * rows_per_task);
+
+				for (auto outer = task * rows_per_task; outer < last; ++outer)
+				{
+					for (auto idx = std::size_t{}; idx < merged_counts[outer]; ++idx)
+					{
+						indices[offsets[outer] + idx] = grouped[starts[outer] + idx].inner;
+						values[offsets[outer] + idx]  = merged_values[starts[outer] + idx];
+					}
+				}
+			},
+			threads);
+	}
+
+	/**
+	 * out = a * b, for a rows x k matrix a of compressed rows and a k x n dense b
+	 */
+	template<typename T>
+	inline void csr_mul(const compressed_view<T>& a, strided_view<const T> b, strided_view<T> out, std::size_t n)
+	{
+		for_each_compressed_part(a.offsets, a.offsets.back() * n, [&](std::size_t first, std::size_t last) {
+			for (auto row = first; row < last; ++row)
+			{
+				const auto nz_first = a.offsets[row];
+				const auto nz_last  = a.offsets[row + 1];
+
+				if (n == 1)
+				{
+					out(row, 0) = sparse_dot(a, nz_first, nz_last, b.data, b.rs);
+					continue;
+				}
+
+				auto* const out_row = out.data + row * out.rs;
+
+				for (auto col = std::size_t{}; col < n; ++col)
+				{
+					out_row[col * out.cs] = T{};
+				}
+
+				for (auto idx = nz_first; idx < nz_last; ++idx)
+				{
+					sparse_axpy(n, a.values[idx], b.data + a.indices[idx] * b.rs, b.cs, out_row, out.cs);
+				}
+			}
+		});
+	}
+
+	template<typename T>
+	[[nodiscard]] inline auto csc_mul_threads(const compressed_view<T>& a, std::size_t n) -> std::size_t
+	{
+		return a.offsets.back() * n < sparse_par_madds ? std::size_t{ 1 } : max_threads();
+	}
+
+	/**
+	 * Elements of the partial sums csc_mul needs with the current number of threads, 0 if it doesn't need any
+	 */
+	template<typename T>
+	[[nodiscard]] inline auto csc_mul_scratch_size(const compressed_view<T>& a, std::size_t rows, std::size_t n)
+		-> std::size_t
+	{
+		const auto threads = csc_mul_threads(a, n);
+		return threads <= 1 || n >= threads ? 0 : threads * rows * n;
+	}
+
+	/**
+	 * out = a * b, for a rows x k matrix a of compressed columns and a k x n dense b. Columns of a scatter into every
+	 * row of out, so threads either take different columns of out, or sum into buffers of their own when out has too
+	 * few columns to go around. Those buffers come from scratch if it holds csc_mul_scratch_size elements, and are
+	 * allocated otherwise
+	 */
+	template<typename T>
+	inline void csc_mul(const compressed_view<T>& a,
+		std::size_t rows,
+		strided_view<const T> b,
+		strided_view<T> out,
+		std::size_t n,
+		std::span<T> scratch = {})
+	{
+		const auto k       = a.outer_size();
+		const auto threads = csc_mul_threads(a, n);
+
+		const auto accumulate = [&](std::size_t first, std::size_t last, std::size_t col_first, std::size_t col_last,
+									strided_view<T> to) {
+			for (auto inner = first; inner < last; ++inner)
+			{
+				for (auto idx = a.offsets[inner]; idx < a.offsets[inner + 1]; ++idx)
+				{
+					sparse_axpy(col_last - col_first,
+						a.values[idx],
+						b.data + inner * b.rs + col_first * b.cs,
+						b.cs,
+						to.data + a.indices[idx] * to.rs + col_first * to.cs,
+						to.cs);
+				}
+			}
+		};
+
+		fill_strided(out, rows, n, T{});
+
+		if (threads <= 1)
+		{
+			accumulate(0, k, 0, n, out);
+		}
+		else if (n >= threads)
+		{
+			const auto cols_per_task = div_round_up(n, threads * sparse_parts_per_thread);
+
+			parallel_for(div_round_up(n, cols_per_task), [&](std::size_t task) {
+				const auto col_first = task * cols_per_task;
+				accumulate(0, k, col_first, std::min(n, col_first + cols_per_task), out);
+			});
+		}
+		else
+		{
+			const auto bounds = balanced_parts(a.offsets, threads);
+			const auto parts  = bounds.size() - 1;
+
+			auto owned = scratch_vector<T>{};
+
+			if (scratch.size() < parts * rows * n)
+			{
+				owned.resize(parts * rows * n);
+				scratch = owned;
+			}
+
+			const auto partials = scratch.first(parts * rows * n);
+
+			parallel_for(parts, [&](std::size_t part) {
+				accumulate(bounds[part],
+					bounds[part + 1],
+					0,
+					n,
+					strided_view<T>{ partials.data() + part * rows * n, n, 1 });
+			});
+
+			const auto rows_per_task = div_round_up(rows, threads * sparse_parts_per_thread);
+
+			parallel_for(div_round_up(rows, rows_per_task), [&](std::size_t task) {
+				const auto row_last = std::min(rows, (task + 1) * rows_per_task);
+
+				for (auto part = std::size_t{}; part < parts; ++part)
+				{
+					const auto* const partial = partials.data() + part * rows * n;
+
+					for (auto row = task * rows_per_task; row < row_last; ++row)
+					{
+						sparse_axpy(n, T{ 1 }, partial + row * n, 1, out.data + row * out.rs, out.cs);
+					}
+				}
+			});
+		}
+	}
+
+	/**
+	 * out = a * s, for a dense m x k matrix a and a k x n matrix s of compressed rows: every row of out sums the rows
+	 * of s weighted by the row of a
+	 */
+	template<typename T>
+	inline void dense_csr_mul(strided_view<const T> a,
+		std::size_t m,
+		std::size_t k,
+		const compressed_view<T>& s,
+		strided_view<T> out,
+		std::size_t n)
+	{
+		const auto mul_rows = [&](std::size_t first, std::size_t last) {
+			for (auto row = first; row < last; ++row)
+			{
+				auto* const out_row = out.data + row * out.rs;
+
+				for (auto col = std::size_t{}; col < n; ++col)
+				{
+					out_row[col * out.cs] = T{};
+				}
+
+				for (auto inner = std::size_t{}; inner < k; ++inner)
+				{
+					const auto weight = a(row, inner);
+
+					if (weight == T{})
+					{
+						continue;
+					}
+
+					for (auto idx = s.offsets[inner]; idx < s.offsets[inner + 1]; ++idx)
+					{
+						out_row[s.indices[idx] * out.cs] += weight * s.values[idx];
+					}
+				}
+			}
+		};
+
+		if (max_threads() <= 1 || s.offsets.back() * m < sparse_par_madds)
+		{
+			mul_rows(0, m);
+			return;
+		}
+
+		const auto rows_per_task = div_round_up(m, max_threads() * sparse_parts_per_thread);
+
+		parallel_for(div_round_up(m, rows_per_task), [&](std::size_t task) {
+			mul_rows(task * rows_per_task, std::min(m, (task + 1) * rows_per_task));
+		});
+	}
+
+	/**
+	 * out = a * s, for a dense m x k matrix a and a k x n matrix s of compressed columns: every column of out sums the
+	 * columns of a weighted by the column of s
+	 */
+	template<typename T>
+	inline void dense_csc_mul(strided_view<const T> a, std::size_t m, const compressed_view<T>& s, strided_view<T> out)
+	{
+		for_each_compressed_part(s.offsets, s.offsets.back() * m, [&](std::size_t first, std::size_t last) {
+			for (auto col = first; col < last; ++col)
+			{
+				auto* const out_col = out.data + col * out.cs;
+
+				for (auto row = std::size_t{}; row < m; ++row)
+				{
+					out_col[row * out.rs] = T{};
+				}
+
+				for (auto idx = s.offsets[col]; idx < s.offsets[col + 1]; ++idx)
+				{
+					sparse_axpy(m, s.values[idx], a.data + s.indices[idx] * a.cs, a.rs, out_col, out.rs);
+				}
+			}
+		});
+	}
+} // namespace mpp::detail
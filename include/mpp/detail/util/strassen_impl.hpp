@@ -0,0 +1,210 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/gemm_impl.hpp>
+#include <mpp/detail/util/thread_pool.hpp>
+#include <mpp/detail/util/util.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace mpp::detail
+{
+	// Rows per task of the elementwise passes, big enough to amortize waking up the thread pool
+	inline constexpr auto strassen_add_rows = std::size_t{ 64 };
+
+	/**
+	 * out = a + b (Negate = false) or out = a - b (Negate = true)
+	 */
+	template<bool Negate, typename T>
+	inline void strassen_add(std::size_t rows,
+		std::size_t cols,
+		strided_view<const T> a,
+		strided_view<const T> b,
+		strided_view<T> out)
+	{
+		parallel_for(div_round_up(rows, strassen_add_rows), [&](std::size_t task) {
+			const auto row_end = std::min(rows, (task + 1) * strassen_add_rows);
+
+			for (auto row = task * strassen_add_rows; row < row_end; ++row)
+			{
+				for (auto col = std::size_t{}; col < cols; ++col)
+				{
+					if constexpr (Negate)
+					{
+						out(row, col) = a(row, col) - b(row, col);
+					}
+					else
+					{
+						out(row, col) = a(row, col) + b(row, col);
+					}
+				}
+			}
+		});
+	}
+
+	[[nodiscard]] constexpr auto strassen_recurses(std::size_t m,
+		std::size_t n,
+		std::size_t k,
+		std::size_t crossover) noexcept -> bool
+	{
+		return crossover != 0 && std::min({ m, n, k }) >= std::max(crossover, std::size_t{ 2 });
+	}
+
+	/**
+	 * Number of elements of scratch space needed by every level of the recursion together
+	 */
+	[[nodiscard]] constexpr auto strassen_workspace_size(std::size_t m,
+		std::size_t n,
+		std::size_t k,
+		std::size_t crossover) noexcept -> std::size_t
+	{
+		auto size = std::size_t{};
+
+		while (strassen_recurses(m, n, k, crossover))
+		{
+			m /= 2;
+			n /= 2;
+			k /= 2;
+
+			size += m * k + k * n + m * n;
+		}
+
+		return size;
+	}
+
+	template<typename T>
+	inline void strassen_rec(std::size_t m,
+		std::size_t n,
+		std::size_t k,
+		strided_view<const T> a,
+		strided_view<const T> b,
+		strided_view<T> c,
+		std::size_t crossover,
+		T* ws)
+	{
+		if (!strassen_recurses(m, n, k, crossover))
+		{
+			gemm(m, n, k, a, b, c);
+			return;
+		}
+
+		const auto m2 = m / 2;
+		const auto n2 = n / 2;
+		const auto k2 = k / 2;
+
+		const auto a11 = a;
+		const auto a12 = a.sub(0, k2);
+		const auto a21 = a.sub(m2, 0);
+		const auto a22 = a.sub(m2, k2);
+
+		const auto b11 = b;
+		const auto b12 = b.sub(0, n2);
+		const auto b21 = b.sub(k2, 0);
+		const auto b22 = b.sub(k2, n2);
+
+		const auto c11 = c;
+		const auto c12 = c.sub(0, n2);
+		const auto c21 = c.sub(m2, 0);
+		const auto c22 = c.sub(m2, n2);
+
+		// Scratch of this level, deeper levels use what comes after it
+		const auto x = strided_view<T>{ ws, k2, 1 };
+		const auto y = strided_view<T>{ x.data + m2 * k2, n2, 1 };
+		const auto z = strided_view<T>{ y.data + k2 * n2, n2, 1 };
+		auto* next_ws = z.data + m2 * n2;
+
+		const auto mul = [&](strided_view<const T> lhs, strided_view<const T> rhs, strided_view<T> out) {
+			strassen_rec(m2, n2, k2, lhs, rhs, out, crossover, next_ws);
+		};
+
+		// Winograd's variant (7 products, 15 additions) scheduled to need only 3 temporaries, see
+		// "Memory efficient scheduling of Strassen-Winograd's matrix multiplication algorithm" by Boyer et al.
+		// S1 = A21 + A22, S2 = S1 - A11, S3 = A11 - A21, S4 = A12 - S2
+		// T1 = B12 - B11, T2 = B22 - T1, T3 = B22 - B12, T4 = T2 - B21
+		// P1 = A11 * B11, P2 = A12 * B21, P3 = S4 * B22, P4 = A22 * T4, P5 = S1 * T1, P6 = S2 * T2, P7 = S3 * T3
+		// C11 = P1 + P2, C12 = P1 + P6 + P5 + P3, C21 = P1 + P6 + P7 - P4, C22 = P1 + P6 + P7 + P5
+
+		strassen_add<true>(m2, k2, a11, a21, x);                          // X = S3
+		strassen_add<true>(k2, n2, b22, b12, y);                          // Y = T3
+		mul(x.as_const(), y.as_const(), c21);                             // C21 = P7
+		strassen_add<false>(m2, k2, a21, a22, x);                         // X = S1
+		strassen_add<true>(k2, n2, b12, b11, y);                          // Y = T1
+		mul(x.as_const(), y.as_const(), c22);                             // C22 = P5
+		strassen_add<true>(m2, k2, x.as_const(), a11, x);                 // X = S2
+		strassen_add<true>(k2, n2, b22, y.as_const(), y);                 // Y = T2
+		mul(x.as_const(), y.as_const(), c12);                             // C12 = P6
+		strassen_add<true>(m2, k2, a12, x.as_const(), x);                 // X = S4
+		mul(a11, b11, z);                                                 // Z = P1
+		strassen_add<false>(m2, n2, c12.as_const(), z.as_const(), c12);   // C12 = P1 + P6
+		strassen_add<false>(m2, n2, c21.as_const(), c12.as_const(), c21); // C21 = P1 + P6 + P7
+		strassen_add<false>(m2, n2, c12.as_const(), c22.as_const(), c12); // C12 = P1 + P6 + P5
+		strassen_add<false>(m2, n2, c22.as_const(), c21.as_const(), c22); // C22 = P1 + P6 + P7 + P5 (done)
+		mul(a12, b21, c11);                                               // C11 = P2
+		strassen_add<false>(m2, n2, c11.as_const(), z.as_const(), c11);   // C11 = P1 + P2 (done)
+		mul(x.as_const(), b22, z);                                        // Z = P3
+		strassen_add<false>(m2, n2, c12.as_const(), z.as_const(), c12);   // C12 += P3 (done)
+		strassen_add<true>(k2, n2, y.as_const(), b21, y);                 // Y = T4
+		mul(a22, y.as_const(), z);                                        // Z = P4
+		strassen_add<true>(m2, n2, c21.as_const(), z.as_const(), c21);    // C21 -= P4 (done)
+
+		// Odd dimensions are peeled off and fixed up with plain GEMMs
+		const auto m_even = m2 * 2;
+		const auto n_even = n2 * 2;
+		const auto k_even = k2 * 2;
+
+		if (k_even != k)
+		{
+			gemm(m_even, n_even, 1, a.sub(0, k_even), b.sub(k_even, 0), c, true);
+		}
+
+		if (n_even != n)
+		{
+			gemm(m_even, 1, k, a, b.sub(0, n_even), c.sub(0, n_even));
+		}
+
+		if (m_even != m)
+		{
+			gemm(1, n, k, a.sub(m_even, 0), b, c.sub(m_even, 0));
+		}
+	}
+
+	/**
+	 * C = A * B with Strassen-Winograd recursion down to the crossover, then blocked GEMM
+	 *
+	 * The scratch space of every level is allocated once up front. Note that the error bound is only norm-wise
+	 * (it grows like n^log2(12) instead of n for the classical algorithm), which is why it's opt-in
+	 */
+	template<typename T>
+	inline void strassen(std::size_t m,
+		std::size_t n,
+		std::size_t k,
+		strided_view<const T> a,
+		strided_view<const T> b,
+		strided_view<T> c,
+		std::size_t crossover)
+	{
+		auto ws = scratch_vector<T>(strassen_workspace_size(m, n, k, crossover));
+
+		strassen_rec(m, n, k, a, b, c, crossover, ws.data());
+	}
+} // namespace mpp::detail
@@ -0,0 +1,145 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace mpp::detail
+{
+	/**
+	 * Formats numbers with std::to_chars into a fixed buffer that's written to a stream whenever it fills up, so big
+	 * outputs are streamed without allocating or building them in memory first
+	 */
+	class text_writer
+	{
+		// Room for any number to_chars can produce, with the precision capped at max_precision
+		static constexpr auto max_number_size = std::size_t{ 128 };
+
+		std::ostream* os_;
+		std::array<char, std::size_t{ 1 } << 16> buf_{};
+		std::size_t used_ = 0;
+
+		void reserve(std::size_t size)
+		{
+			if (buf_.size() - used_ < size)
+			{
+				flush();
+			}
+		}
+
+	public:
+		static constexpr auto max_precision = 64;
+
+		explicit text_writer(std::ostream& os) noexcept : os_(&os) {}
+
+		text_writer(const text_writer&) = delete;
+		text_writer(text_writer&&)      = delete;
+
+		auto operator=(const text_writer&) -> text_writer& = delete;
+		auto operator=(text_writer&&) -> text_writer& = delete;
+
+		~text_writer()
+		{
+			flush();
+		}
+
+		void put(char chr)
+		{
+			reserve(1);
+			buf_[used_++] = chr;
+		}
+
+		void put(std::string_view str)
+		{
+			if (str.size() > buf_.size())
+			{
+				flush();
+				os_->write(str.data(), static_cast<std::streamsize>(str.size()));
+				return;
+			}
+
+			reserve(str.size());
+			std::memcpy(buf_.data() + used_, str.data(), str.size());
+			used_ += str.size();
+		}
+
+		/**
+		 * Integers exactly, floating points in the shortest form that reads back to the same value, or with precision
+		 * significant digits if it's positive
+		 */
+		template<typename T>
+		void put_number(const T& val, int precision = 0)
+		{
+			if constexpr (!std::is_arithmetic_v<T>)
+			{
+				// Other element types are only known to be streamable
+				flush();
+				*os_ << val;
+			}
+			else
+			{
+				put_arithmetic(val, precision);
+			}
+		}
+
+		void flush()
+		{
+			os_->write(buf_.data(), static_cast<std::streamsize>(used_));
+			used_ = 0;
+		}
+
+	private:
+		template<typename T>
+		void put_arithmetic(T val, int precision)
+		{
+			reserve(max_number_size);
+
+			auto* const first = buf_.data() + used_;
+			auto* const last  = first + max_number_size;
+
+			auto res = std::to_chars_result{};
+
+			if constexpr (std::is_floating_point_v<T>)
+			{
+				res = precision > 0
+					? std::to_chars(first, last, val, std::chars_format::general, std::min(precision, max_precision))
+					: std::to_chars(first, last, val);
+			}
+			else if constexpr (std::is_same_v<T, bool>)
+			{
+				res = std::to_chars(first, last, static_cast<int>(val));
+			}
+			else
+			{
+				res = std::to_chars(first, last, val);
+			}
+
+			used_ += static_cast<std::size_t>(res.ptr - first);
+		}
+	};
+} // namespace mpp::detail
@@ -0,0 +1,268 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/util/cfg.hpp>
+
+#ifdef MPP_INSTRUMENT
+	#include <mpp/detail/util/instrument.hpp>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mpp::detail
+{
+	inline thread_local auto in_parallel_region = false;
+
+	/**
+	 * Persistent pool of worker threads that runs one indexed job at a time
+	 *
+	 * The calling thread always participates in the job, so a pool with no workers degrades to a serial loop
+	 */
+	class thread_pool
+	{
+		using task_fn_t = void (*)(const void*, std::size_t);
+
+		std::vector<std::thread> workers_;
+
+		std::mutex run_mtx_; // serializes jobs from different callers
+		std::mutex mtx_;
+		std::condition_variable wake_cv_;
+		std::condition_variable done_cv_;
+
+		// Current job
+		task_fn_t fn_      = nullptr;
+		const void* ctx_   = nullptr;
+		std::size_t tasks_ = 0;
+		std::atomic<std::size_t> next_task_{};
+
+		std::size_t generation_ = 0;
+		std::size_t wanted_     = 0; // workers allowed to join the current job
+		std::size_t joined_     = 0;
+		std::size_t finished_   = 0;
+		bool stop_              = false;
+
+		// First exception a task of the current job threw, which run rethrows on the caller
+		std::exception_ptr error_;
+
+		void drain(task_fn_t fn, const void* ctx, std::size_t tasks)
+		{
+			try
+			{
+				for (auto task = next_task_.fetch_add(1, std::memory_order_relaxed); task < tasks;
+					 task      = next_task_.fetch_add(1, std::memory_order_relaxed))
+				{
+#ifdef MPP_INSTRUMENT
+					const auto task_span = instrument::span{ instrument::pool_task_span, task, tasks };
+#endif
+
+					fn(ctx, task);
+				}
+			}
+			catch (...)
+			{
+				// Tasks that haven't started are skipped, the ones in progress on other threads still finish
+				next_task_.store(tasks, std::memory_order_relaxed);
+
+				auto lock = std::scoped_lock{ mtx_ };
+
+				if (!error_)
+				{
+					error_ = std::current_exception();
+				}
+			}
+		}
+
+		void work()
+		{
+			in_parallel_region = true;
+
+			auto seen_generation = std::size_t{};
+
+			while (true)
+			{
+				auto lock = std::unique_lock{ mtx_ };
+				wake_cv_.wait(lock, [&]() {
+					return stop_ || (generation_ != seen_generation && joined_ < wanted_);
+				});
+
+				if (stop_)
+				{
+					return;
+				}
+
+				seen_generation = generation_;
+				++joined_;
+
+				const auto fn    = fn_;
+				const auto ctx   = ctx_;
+				const auto tasks = tasks_;
+				lock.unlock();
+
+				drain(fn, ctx, tasks);
+
+				lock.lock();
+				if (++finished_ == joined_)
+				{
+					done_cv_.notify_one();
+				}
+			}
+		}
+
+	public:
+		explicit thread_pool(std::size_t workers)
+		{
+			workers_.reserve(workers);
+
+			for (auto i = std::size_t{}; i < workers; ++i)
+			{
+				workers_.emplace_back(&thread_pool::work, this);
+			}
+		}
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool(thread_pool&&)      = delete;
+
+		auto operator=(const thread_pool&) -> thread_pool& = delete;
+		auto operator=(thread_pool&&) -> thread_pool& = delete;
+
+		~thread_pool()
+		{
+			{
+				auto lock = std::scoped_lock{ mtx_ };
+				stop_     = true;
+			}
+
+			wake_cv_.notify_all();
+
+			for (auto& worker : workers_)
+			{
+				worker.join();
+			}
+		}
+
+		[[nodiscard]] auto workers() const noexcept -> std::size_t
+		{
+			return workers_.size();
+		}
+
+		/**
+		 * Runs fn(ctx, task) for every task in [0, tasks) using at most `threads` threads (including the caller). If
+		 * tasks throw, the remaining ones are skipped and the first exception is rethrown once every thread is done
+		 * with the job (and so with ctx)
+		 */
+		void run(std::size_t tasks, std::size_t threads, task_fn_t fn, const void* ctx)
+		{
+			auto run_lock = std::unique_lock{ run_mtx_, std::try_to_lock };
+
+			// Another caller owns the pool, so doing the work here is faster than waiting for it
+			if (!run_lock.owns_lock())
+			{
+				for (auto task = std::size_t{}; task < tasks; ++task)
+				{
+					fn(ctx, task);
+				}
+
+				return;
+			}
+
+			{
+				auto lock = std::scoped_lock{ mtx_ };
+
+				fn_    = fn;
+				ctx_   = ctx;
+				tasks_ = tasks;
+				next_task_.store(0, std::memory_order_relaxed);
+
+				wanted_   = std::min(threads - 1, workers_.size());
+				joined_   = 0;
+				finished_ = 0;
+				error_    = nullptr;
+				++generation_;
+			}
+
+			wake_cv_.notify_all();
+
+			in_parallel_region = true;
+			drain(fn, ctx, tasks);
+			in_parallel_region = false;
+
+			auto lock = std::unique_lock{ mtx_ };
+
+			// Workers that haven't woken up yet would find nothing left to do, so stop recruiting them
+			wanted_ = joined_;
+			done_cv_.wait(lock, [&]() {
+				return finished_ == joined_;
+			});
+
+			if (error_)
+			{
+				std::rethrow_exception(std::exchange(error_, nullptr));
+			}
+		}
+	};
+
+	[[nodiscard]] inline auto global_thread_pool() -> thread_pool&
+	{
+		static auto pool = thread_pool{ hardware_threads() - 1 };
+		return pool;
+	}
+
+	/**
+	 * Calls fn(task) for every task in [0, tasks), spreading the tasks across the global thread pool. Tasks are
+	 * handed out dynamically in increasing order, so callers should put the most expensive tasks first. If a task
+	 * throws, the tasks that haven't started are skipped and the first exception is rethrown here
+	 */
+	template<typename Fn>
+	void parallel_for(std::size_t tasks, Fn&& fn, std::size_t threads = max_threads())
+	{
+		threads = std::min(threads, tasks);
+
+		// Nested parallel regions run serially because the outer region already occupies the pool
+		if (threads <= 1 || in_parallel_region)
+		{
+			for (auto task = std::size_t{}; task < tasks; ++task)
+			{
+				fn(task);
+			}
+
+			return;
+		}
+
+		using fn_t = std::remove_reference_t<Fn>;
+
+		global_thread_pool().run(
+			tasks,
+			threads,
+			[](const void* ctx, std::size_t task) {
+				(*static_cast<fn_t*>(const_cast<void*>(ctx)))(task);
+			},
+			&fn);
+	}
+} // namespace mpp::detail
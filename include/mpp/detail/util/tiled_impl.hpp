@@ -0,0 +1,480 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/gemm_impl.hpp>
+#include <mpp/detail/util/io_worker.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/io/tiled.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <future>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mpp::detail
+{
+	// Rows solved one by one before the rest of a triangular solve is updated with a GEMM
+	inline constexpr auto trsm_block_rows = std::size_t{ 64 };
+
+	/**
+	 * b = l^-1 * b in place, for a n x n lower triangular l (only its lower triangle is read, and its diagonal is taken
+	 * as ones if unit) and a n x m b. Transposed views turn it into the other triangular solves
+	 */
+	template<typename T>
+	inline void trsm_lower(bool unit, strided_view<const T> l, strided_view<T> b, std::size_t n, std::size_t m)
+	{
+		auto update = scratch_vector<T>(std::min(n, trsm_block_rows) * m);
+
+		for (auto first = std::size_t{}; first < n; first += trsm_block_rows)
+		{
+			const auto last = std::min(n, first + trsm_block_rows);
+
+			// Everything solved so far at once, as update = l[first:last, :first] * b[:first, :]
+			if (first > 0)
+			{
+				const auto update_view = strided_view<T>{ update.data(), m, 1 };
+
+				gemm(last - first, m, first, l.sub(first, 0), b.as_const(), update_view);
+
+				for (auto row = first; row < last; ++row)
+				{
+					for (auto col = std::size_t{}; col < m; ++col)
+					{
+						b(row, col) -= update_view(row - first, col);
+					}
+				}
+			}
+
+			for (auto row = first; row < last; ++row)
+			{
+				for (auto prev = first; prev < row; ++prev)
+				{
+					const auto factor = l(row, prev);
+
+					for (auto col = std::size_t{}; col < m; ++col)
+					{
+						b(row, col) -= factor * b(prev, col);
+					}
+				}
+
+				if (!unit)
+				{
+					const auto diag = l(row, row);
+
+					for (auto col = std::size_t{}; col < m; ++col)
+					{
+						b(row, col) /= diag;
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * Unpivoted LU of a n x n tile in place, L (with an implicit unit diagonal) below the diagonal and U on and above
+	 */
+	template<typename T>
+	inline void lu_tile(strided_view<T> a, std::size_t n)
+	{
+		for (auto pivot = std::size_t{}; pivot < n; ++pivot)
+		{
+			const auto diag = a(pivot, pivot);
+
+			for (auto row = pivot + 1; row < n; ++row)
+			{
+				const auto factor = a(row, pivot) / diag;
+				a(row, pivot)     = factor;
+
+				for (auto col = pivot + 1; col < n; ++col)
+				{
+					a(row, col) -= factor * a(pivot, col);
+				}
+			}
+		}
+	}
+
+	/**
+	 * Cholesky factor of a n x n symmetric positive definite tile in place, in its lower triangle with zeros above it
+	 */
+	template<typename T>
+	inline void cholesky_tile(strided_view<T> a, std::size_t n)
+	{
+		for (auto col = std::size_t{}; col < n; ++col)
+		{
+			auto diag = a(col, col);
+
+			for (auto prev = std::size_t{}; prev < col; ++prev)
+			{
+				diag -= a(col, prev) * a(col, prev);
+			}
+
+			// Only positive for symmetric positive definite matrices
+			assert(diag > T{});
+
+			diag        = static_cast<T>(std::sqrt(diag));
+			a(col, col) = diag;
+
+			for (auto row = col + 1; row < n; ++row)
+			{
+				auto val = a(row, col);
+
+				for (auto prev = std::size_t{}; prev < col; ++prev)
+				{
+					val -= a(row, prev) * a(col, prev);
+				}
+
+				a(row, col) = val / diag;
+				a(col, row) = T{};
+			}
+		}
+	}
+
+	/**
+	 * Reads a known sequence of tiles one after another on a background thread, always one tile ahead of the one being
+	 * used. A tile handed out stays valid until the next one is asked for
+	 */
+	template<typename T>
+	class tile_stream
+	{
+		const tiled_file<T>* file_;
+		std::vector<std::pair<std::size_t, std::size_t>> tiles_;
+
+		// Tiles of this column are read only once it's written
+		std::size_t written_col_;
+		std::shared_future<void> written_;
+
+		std::array<scratch_vector<T>, 2> bufs_;
+		std::array<std::future<void>, 2> reads_;
+		std::size_t next_ = 0;
+
+		// Last, so reads still in flight finish before the buffers are freed
+		io_worker io_;
+
+		void read(std::size_t idx)
+		{
+			const auto [tile_row, tile_col] = tiles_[idx];
+
+			reads_[idx % 2] =
+				io_.submit([this, tile_row, tile_col, buf = bufs_[idx % 2].data(), wait = tile_col == written_col_]() {
+					if (wait && written_.valid())
+					{
+						written_.get();
+					}
+
+					file_->read_tile(tile_row, tile_col, buf);
+				});
+		}
+
+	public:
+		tile_stream(const tiled_file<T>& file,
+			std::vector<std::pair<std::size_t, std::size_t>> tiles,
+			std::size_t written_col,
+			std::shared_future<void> written) :
+			file_(&file),
+			tiles_(std::move(tiles)),
+			written_col_(written_col),
+			written_(std::move(written))
+		{
+			for (auto& buf : bufs_)
+			{
+				buf.resize(file.tile_elems());
+			}
+
+			if (!tiles_.empty())
+			{
+				read(0);
+			}
+		}
+
+		/**
+		 * Throws std::runtime_error if the tile couldn't be read
+		 */
+		[[nodiscard]] auto next() -> const T*
+		{
+			assert(next_ < tiles_.size());
+
+			const auto idx = next_++;
+			reads_[idx % 2].get();
+
+			if (next_ < tiles_.size())
+			{
+				read(next_);
+			}
+
+			return bufs_[idx % 2].data();
+		}
+	};
+
+	/**
+	 * Columns of tiles read into memory and written back on a background thread. The next column is read into a second
+	 * buffer while the current one is worked on, and the writes of a column overlap with the work on the next one
+	 */
+	template<typename T>
+	class tile_panels
+	{
+		tiled_file<T>* file_;
+		std::size_t first_row_of_diag_; // 1 for panels starting at the diagonal, 0 for whole columns
+
+		std::array<scratch_vector<T>, 2> bufs_;
+		std::array<std::future<void>, 2> reads_;
+		std::shared_future<void> written_;
+
+		io_worker io_;
+
+		[[nodiscard]] auto first_row(std::size_t col) const noexcept -> std::size_t
+		{
+			return first_row_of_diag_ * col;
+		}
+
+		void read(std::size_t col)
+		{
+			reads_[col % 2] = io_.submit([this, col, buf = bufs_[col % 2].data()]() {
+				for (auto row = first_row(col); row < file_->row_tiles(); ++row)
+				{
+					file_->read_tile(row, col, buf + row * file_->tile_elems());
+				}
+			});
+		}
+
+	public:
+		tile_panels(tiled_file<T>& file, bool from_diag) : file_(&file), first_row_of_diag_(from_diag ? 1 : 0)
+		{
+			for (auto& buf : bufs_)
+			{
+				buf.resize(file.row_tiles() * file.tile_elems());
+			}
+
+			if (file.col_tiles() > 0)
+			{
+				read(0);
+			}
+		}
+
+		/**
+		 * Tile column col, with tile row r at r * tile_elems(). Also starts reading column col + 1, so columns have to
+		 * be asked for in order. Throws std::runtime_error if the column couldn't be read
+		 */
+		[[nodiscard]] auto get(std::size_t col) -> T*
+		{
+			reads_[col % 2].get();
+
+			// Reads are queued after the writes of the column that used the buffer before
+			if (col + 1 < file_->col_tiles())
+			{
+				read(col + 1);
+			}
+
+			return bufs_[col % 2].data();
+		}
+
+		void write(std::size_t col)
+		{
+			written_ = io_.submit([this, col, buf = bufs_[col % 2].data()]() {
+						  for (auto row = first_row(col); row < file_->row_tiles(); ++row)
+						  {
+							  file_->write_tile(row, col, buf + row * file_->tile_elems());
+						  }
+					  }).share();
+		}
+
+		/**
+		 * The writes of the last column written, which is invalid before the first one
+		 */
+		[[nodiscard]] auto written() const -> std::shared_future<void>
+		{
+			return written_;
+		}
+
+		/**
+		 * Throws std::runtime_error if the last column couldn't be written
+		 */
+		void finish()
+		{
+			if (written_.valid())
+			{
+				written_.get();
+			}
+		}
+	};
+
+	template<typename T>
+	inline void tiled_lu_impl(tiled_file<T>& a) // @TODO: ISSUE #20
+	{
+		assert(a.rows() == a.cols());
+
+		const auto tiles      = a.row_tiles();
+		const auto tile_size  = a.tile_size();
+		const auto tile_elems = a.tile_elems();
+
+		const auto view = [&](auto* data) {
+			return strided_view<std::remove_pointer_t<decltype(data)>>{ data, tile_size, 1 };
+		};
+
+		auto neg_u  = scratch_vector<T>(tile_elems);
+		auto panels = tile_panels<T>{ a, false };
+
+		for (auto col = std::size_t{}; col < tiles; ++col)
+		{
+			auto* const panel = panels.get(col);
+			const auto cols   = a.tile_cols(col);
+
+			const auto panel_tile = [&](std::size_t row) {
+				return view(panel + row * tile_elems);
+			};
+
+			/**
+			 * Left looking: the factored columns on the left are streamed in to update this one. For each of them,
+			 * U(k, col) = L(k, k)^-1 * A(k, col), then A(i, col) -= L(i, k) * U(k, col) below it
+			 */
+			auto order = std::vector<std::pair<std::size_t, std::size_t>>{};
+
+			for (auto k = std::size_t{}; k < col; ++k)
+			{
+				for (auto row = k; row < tiles; ++row)
+				{
+					order.emplace_back(row, k);
+				}
+			}
+
+			auto stream = tile_stream<T>{ a, std::move(order), col == 0 ? 0 : col - 1, panels.written() };
+
+			for (auto k = std::size_t{}; k < col; ++k)
+			{
+				const auto k_size = a.tile_rows(k);
+
+				trsm_lower(true, view(stream.next()), panel_tile(k), k_size, cols);
+
+				for (auto row = std::size_t{}; row < k_size; ++row)
+				{
+					for (auto inner = std::size_t{}; inner < cols; ++inner)
+					{
+						neg_u[row * tile_size + inner] = -panel_tile(k)(row, inner);
+					}
+				}
+
+				const auto neg_u_view = view(neg_u.data()).as_const();
+
+				for (auto row = k + 1; row < tiles; ++row)
+				{
+					gemm(a.tile_rows(row), cols, k_size, view(stream.next()), neg_u_view, panel_tile(row), true);
+				}
+			}
+
+			// Then the diagonal tile is factored, and L(i, col) = A(i, col) * U(col, col)^-1 below it
+			lu_tile(panel_tile(col), cols);
+
+			const auto u = panel_tile(col).as_const();
+
+			for (auto row = col + 1; row < tiles; ++row)
+			{
+				trsm_lower(false, u.trps(), panel_tile(row).trps(), cols, a.tile_rows(row));
+			}
+
+			panels.write(col);
+		}
+
+		panels.finish();
+	}
+
+	template<typename T>
+	inline void tiled_cholesky_impl(tiled_file<T>& a) // @TODO: ISSUE #20
+	{
+		assert(a.rows() == a.cols());
+
+		const auto tiles      = a.row_tiles();
+		const auto tile_size  = a.tile_size();
+		const auto tile_elems = a.tile_elems();
+
+		const auto view = [&](auto* data) {
+			return strided_view<std::remove_pointer_t<decltype(data)>>{ data, tile_size, 1 };
+		};
+
+		auto neg_l  = scratch_vector<T>(tile_elems);
+		auto panels = tile_panels<T>{ a, true };
+
+		for (auto col = std::size_t{}; col < tiles; ++col)
+		{
+			auto* const panel = panels.get(col);
+			const auto cols   = a.tile_cols(col);
+
+			const auto panel_tile = [&](std::size_t row) {
+				return view(panel + row * tile_elems);
+			};
+
+			// Left looking: A(i, col) -= L(i, k) * L(col, k)^T for the factored columns k on the left, on and below the
+			// diagonal
+			auto order = std::vector<std::pair<std::size_t, std::size_t>>{};
+
+			for (auto k = std::size_t{}; k < col; ++k)
+			{
+				for (auto row = col; row < tiles; ++row)
+				{
+					order.emplace_back(row, k);
+				}
+			}
+
+			auto stream = tile_stream<T>{ a, std::move(order), col == 0 ? 0 : col - 1, panels.written() };
+
+			for (auto k = std::size_t{}; k < col; ++k)
+			{
+				const auto k_size = a.tile_cols(k);
+				const auto* diag  = stream.next();
+
+				// -L(col, k), whose transpose multiplies every tile of the column
+				for (auto row = std::size_t{}; row < cols; ++row)
+				{
+					for (auto inner = std::size_t{}; inner < k_size; ++inner)
+					{
+						neg_l[row * tile_size + inner] = -diag[row * tile_size + inner];
+					}
+				}
+
+				const auto neg_l_trps = view(neg_l.data()).as_const().trps();
+
+				gemm(cols, cols, k_size, view(diag), neg_l_trps, panel_tile(col), true);
+
+				for (auto row = col + 1; row < tiles; ++row)
+				{
+					gemm(a.tile_rows(row), cols, k_size, view(stream.next()), neg_l_trps, panel_tile(row), true);
+				}
+			}
+
+			// Then the diagonal tile is factored, and L(i, col) = A(i, col) * L(col, col)^-T below it
+			cholesky_tile(panel_tile(col), cols);
+
+			const auto l = panel_tile(col).as_const();
+
+			for (auto row = col + 1; row < tiles; ++row)
+			{
+				trsm_lower(false, l, panel_tile(row).trps(), cols, a.tile_rows(row));
+			}
+
+			panels.write(col);
+		}
+
+		panels.finish();
+	}
+} // namespace mpp::detail
@@ -0,0 +1,393 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/thread_pool.hpp>
+#include <mpp/detail/util/util.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#include <xmmintrin.h>
+#endif
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace mpp::detail
+{
+	// Square tiles that keep both the source and the destination tile in L1
+	template<typename T>
+	inline constexpr auto trps_tile = std::size_t{ sizeof(T) <= 4 ? 64 : 32 };
+
+	// Below this many elements, waking up the thread pool costs more than it saves
+	inline constexpr auto trps_par_elems = std::size_t{ 256 * 256 };
+
+	// Side of the square block transposed in registers, 0 if there is no SIMD kernel for the type
+	template<typename T>
+	inline constexpr auto trps_simd_width = std::size_t{};
+
+#if defined(__AVX__)
+	template<>
+	inline constexpr auto trps_simd_width<float> = std::size_t{ 8 };
+
+	template<>
+	inline constexpr auto trps_simd_width<double> = std::size_t{ 4 };
+
+	inline void trps_simd_block(const float* src, std::size_t src_ld, float* dst, std::size_t dst_ld) noexcept
+	{
+		auto r0 = _mm256_loadu_ps(src);
+		auto r1 = _mm256_loadu_ps(src + src_ld);
+		auto r2 = _mm256_loadu_ps(src + 2 * src_ld);
+		auto r3 = _mm256_loadu_ps(src + 3 * src_ld);
+		auto r4 = _mm256_loadu_ps(src + 4 * src_ld);
+		auto r5 = _mm256_loadu_ps(src + 5 * src_ld);
+		auto r6 = _mm256_loadu_ps(src + 6 * src_ld);
+		auto r7 = _mm256_loadu_ps(src + 7 * src_ld);
+
+		const auto t0 = _mm256_unpacklo_ps(r0, r1);
+		const auto t1 = _mm256_unpackhi_ps(r0, r1);
+		const auto t2 = _mm256_unpacklo_ps(r2, r3);
+		const auto t3 = _mm256_unpackhi_ps(r2, r3);
+		const auto t4 = _mm256_unpacklo_ps(r4, r5);
+		const auto t5 = _mm256_unpackhi_ps(r4, r5);
+		const auto t6 = _mm256_unpacklo_ps(r6, r7);
+		const auto t7 = _mm256_unpackhi_ps(r6, r7);
+
+		const auto s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+		const auto s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+		const auto s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		const auto s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		const auto s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+		const auto s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+		const auto s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+		const auto s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+		r0 = _mm256_permute2f128_ps(s0, s4, 0x20);
+		r1 = _mm256_permute2f128_ps(s1, s5, 0x20);
+		r2 = _mm256_permute2f128_ps(s2, s6, 0x20);
+		r3 = _mm256_permute2f128_ps(s3, s7, 0x20);
+		r4 = _mm256_permute2f128_ps(s0, s4, 0x31);
+		r5 = _mm256_permute2f128_ps(s1, s5, 0x31);
+		r6 = _mm256_permute2f128_ps(s2, s6, 0x31);
+		r7 = _mm256_permute2f128_ps(s3, s7, 0x31);
+
+		_mm256_storeu_ps(dst, r0);
+		_mm256_storeu_ps(dst + dst_ld, r1);
+		_mm256_storeu_ps(dst + 2 * dst_ld, r2);
+		_mm256_storeu_ps(dst + 3 * dst_ld, r3);
+		_mm256_storeu_ps(dst + 4 * dst_ld, r4);
+		_mm256_storeu_ps(dst + 5 * dst_ld, r5);
+		_mm256_storeu_ps(dst + 6 * dst_ld, r6);
+		_mm256_storeu_ps(dst + 7 * dst_ld, r7);
+	}
+
+	inline void trps_simd_block(const double* src, std::size_t src_ld, double* dst, std::size_t dst_ld) noexcept
+	{
+		const auto r0 = _mm256_loadu_pd(src);
+		const auto r1 = _mm256_loadu_pd(src + src_ld);
+		const auto r2 = _mm256_loadu_pd(src + 2 * src_ld);
+		const auto r3 = _mm256_loadu_pd(src + 3 * src_ld);
+
+		const auto t0 = _mm256_unpacklo_pd(r0, r1);
+		const auto t1 = _mm256_unpackhi_pd(r0, r1);
+		const auto t2 = _mm256_unpacklo_pd(r2, r3);
+		const auto t3 = _mm256_unpackhi_pd(r2, r3);
+
+		_mm256_storeu_pd(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+		_mm256_storeu_pd(dst + dst_ld, _mm256_permute2f128_pd(t1, t3, 0x20));
+		_mm256_storeu_pd(dst + 2 * dst_ld, _mm256_permute2f128_pd(t0, t2, 0x31));
+		_mm256_storeu_pd(dst + 3 * dst_ld, _mm256_permute2f128_pd(t1, t3, 0x31));
+	}
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	template<>
+	inline constexpr auto trps_simd_width<float> = std::size_t{ 4 };
+
+	template<>
+	inline constexpr auto trps_simd_width<double> = std::size_t{ 2 };
+
+	inline void trps_simd_block(const float* src, std::size_t src_ld, float* dst, std::size_t dst_ld) noexcept
+	{
+		auto r0 = _mm_loadu_ps(src);
+		auto r1 = _mm_loadu_ps(src + src_ld);
+		auto r2 = _mm_loadu_ps(src + 2 * src_ld);
+		auto r3 = _mm_loadu_ps(src + 3 * src_ld);
+
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+		_mm_storeu_ps(dst, r0);
+		_mm_storeu_ps(dst + dst_ld, r1);
+		_mm_storeu_ps(dst + 2 * dst_ld, r2);
+		_mm_storeu_ps(dst + 3 * dst_ld, r3);
+	}
+
+	inline void trps_simd_block(const double* src, std::size_t src_ld, double* dst, std::size_t dst_ld) noexcept
+	{
+		const auto r0 = _mm_loadu_pd(src);
+		const auto r1 = _mm_loadu_pd(src + src_ld);
+
+		_mm_storeu_pd(dst, _mm_unpacklo_pd(r0, r1));
+		_mm_storeu_pd(dst + dst_ld, _mm_unpackhi_pd(r0, r1));
+	}
+#endif
+
+	template<typename Src, typename Dst>
+	inline void trps_scalar_block(std::size_t rows,
+		std::size_t cols,
+		const Src* src,
+		std::size_t src_ld,
+		Dst* dst,
+		std::size_t dst_ld) noexcept
+	{
+		for (auto col = std::size_t{}; col < cols; ++col)
+		{
+			for (auto row = std::size_t{}; row < rows; ++row)
+			{
+				dst[col * dst_ld + row] = static_cast<Dst>(src[row * src_ld + col]);
+			}
+		}
+	}
+
+	/**
+	 * Transposes one cache tile, using in-register transposes of SIMD-width blocks when available
+	 */
+	template<typename Src, typename Dst>
+	inline void trps_tile_block(std::size_t rows,
+		std::size_t cols,
+		const Src* src,
+		std::size_t src_ld,
+		Dst* dst,
+		std::size_t dst_ld) noexcept
+	{
+		auto row = std::size_t{};
+
+		if constexpr (std::is_same_v<Src, Dst> && trps_simd_width<Src> != 0)
+		{
+			constexpr auto width = trps_simd_width<Src>;
+
+			for (; row + width <= rows; row += width)
+			{
+				auto col = std::size_t{};
+
+				for (; col + width <= cols; col += width)
+				{
+					trps_simd_block(src + row * src_ld + col, src_ld, dst + col * dst_ld + row, dst_ld);
+				}
+
+				trps_scalar_block(width, cols - col, src + row * src_ld + col, src_ld, dst + col * dst_ld + row, dst_ld);
+			}
+		}
+
+		trps_scalar_block(rows - row, cols, src + row * src_ld, src_ld, dst + row, dst_ld);
+	}
+
+	/**
+	 * dst = transpose(src), where src is rows x cols with leading dimension src_ld, and dst is cols x rows with
+	 * leading dimension dst_ld
+	 *
+	 * The matrix is walked in square tiles so both the strided reads and the strided writes of a tile stay in cache,
+	 * and rows of tiles are spread across the thread pool for big matrices
+	 */
+	template<typename Src, typename Dst>
+	inline void trps_buf(std::size_t rows,
+		std::size_t cols,
+		const Src* src,
+		std::size_t src_ld,
+		Dst* dst,
+		std::size_t dst_ld)
+	{
+		constexpr auto tile = trps_tile<Src>;
+
+		const auto trps_row_of_tiles = [&](std::size_t tile_row) {
+			const auto row       = tile_row * tile;
+			const auto tile_rows = std::min(tile, rows - row);
+
+			for (auto col = std::size_t{}; col < cols; col += tile)
+			{
+				trps_tile_block(tile_rows,
+					std::min(tile, cols - col),
+					src + row * src_ld + col,
+					src_ld,
+					dst + col * dst_ld + row,
+					dst_ld);
+			}
+		};
+
+		const auto tile_rows = div_round_up(rows, tile);
+
+		if (rows * cols >= trps_par_elems)
+		{
+			parallel_for(tile_rows, trps_row_of_tiles);
+		}
+		else
+		{
+			for (auto tile_row = std::size_t{}; tile_row < tile_rows; ++tile_row)
+			{
+				trps_row_of_tiles(tile_row);
+			}
+		}
+	}
+
+	/**
+	 * Transposes a square matrix with leading dimension ld in place by swapping tiles across the diagonal
+	 */
+	template<typename T>
+	inline void trps_inplace_square(std::size_t n, T* data, std::size_t ld)
+	{
+		constexpr auto tile = trps_tile<T>;
+
+		const auto swap_row_of_tiles = [&](std::size_t tile_row) {
+			using std::swap;
+
+			const auto row     = tile_row * tile;
+			const auto row_end = std::min(row + tile, n);
+
+			// Diagonal tile
+			for (auto i = row; i < row_end; ++i)
+			{
+				for (auto j = i + 1; j < row_end; ++j)
+				{
+					swap(data[i * ld + j], data[j * ld + i]);
+				}
+			}
+
+			// Tiles right of the diagonal swap with their mirror below it
+			for (auto col = row_end; col < n; col += tile)
+			{
+				const auto col_end = std::min(col + tile, n);
+
+				for (auto i = row; i < row_end; ++i)
+				{
+					for (auto j = col; j < col_end; ++j)
+					{
+						swap(data[i * ld + j], data[j * ld + i]);
+					}
+				}
+			}
+		};
+
+		const auto tile_rows = div_round_up(n, tile);
+
+		if (n * n >= trps_par_elems)
+		{
+			parallel_for(tile_rows, swap_row_of_tiles);
+		}
+		else
+		{
+			for (auto tile_row = std::size_t{}; tile_row < tile_rows; ++tile_row)
+			{
+				swap_row_of_tiles(tile_row);
+			}
+		}
+	}
+
+	/**
+	 * Transposes a rectangular matrix in place by following the cycles of the permutation. The element at index
+	 * row * cols + col moves to col * rows + row, and a bit per element remembers which ones were already moved
+	 */
+	template<typename T>
+	inline void trps_inplace_cycles(std::size_t rows, std::size_t cols, T* data)
+	{
+		const auto size = rows * cols;
+
+		if (rows <= 1 || cols <= 1)
+		{
+			return;
+		}
+
+		const auto dest_idx = [&](std::size_t idx) {
+			return (idx % cols) * rows + idx / cols;
+		};
+
+		auto moved = scratch_vector<bool>(size);
+
+		// The first and last elements never move
+		for (auto start = std::size_t{ 1 }; start < size - 1; ++start)
+		{
+			if (moved[start])
+			{
+				continue;
+			}
+
+			auto idx = start;
+			auto val = std::move(data[start]);
+
+			do
+			{
+				using std::swap;
+
+				idx = dest_idx(idx);
+				swap(val, data[idx]);
+				moved[idx] = true;
+			} while (idx != start);
+		}
+	}
+
+	/**
+	 * dst = src for two rows x cols views with any strides. Matching storage orders copy whole rows (or columns),
+	 * opposite storage orders go through the tiled transpose, and anything else falls back to an element by element
+	 * copy
+	 */
+	template<typename Src, typename Dst>
+	inline void copy_strided(std::size_t rows, std::size_t cols, strided_view<const Src> src, strided_view<Dst> dst)
+	{
+		if (src.cs == 1 && dst.cs == 1)
+		{
+			for (auto row = std::size_t{}; row < rows; ++row)
+			{
+				const auto* src_row = src.data + row * src.rs;
+				auto* dst_row       = dst.data + row * dst.rs;
+
+				for (auto col = std::size_t{}; col < cols; ++col)
+				{
+					dst_row[col] = static_cast<Dst>(src_row[col]);
+				}
+			}
+		}
+		else if (src.rs == 1 && dst.rs == 1)
+		{
+			copy_strided(cols, rows, src.trps(), dst.trps());
+		}
+		else if (src.cs == 1 && dst.rs == 1)
+		{
+			trps_buf(rows, cols, src.data, src.rs, dst.data, dst.cs);
+		}
+		else if (src.rs == 1 && dst.cs == 1)
+		{
+			trps_buf(cols, rows, src.data, src.cs, dst.data, dst.rs);
+		}
+		else
+		{
+			for (auto row = std::size_t{}; row < rows; ++row)
+			{
+				for (auto col = std::size_t{}; col < cols; ++col)
+				{
+					dst(row, col) = static_cast<Dst>(src(row, col));
+				}
+			}
+		}
+	}
+} // namespace mpp::detail
@@ -21,7 +21,12 @@
 
 #include <mpp/detail/util/public.hpp>
 
+#ifdef MPP_INSTRUMENT
+	#include <mpp/detail/util/instrument.hpp>
+#endif
+
 #include <algorithm>
+#include <cassert>
 #include <compare>
 #include <cstddef>
 #include <limits>
@@ -46,7 +51,7 @@ namespace mpp
 		};
 	} // namespace detail
 
-	template<detail::arithmetic, typename>
+	template<detail::arithmetic, typename, typename>
 	class mat;
 
 	namespace detail
@@ -72,8 +77,8 @@ namespace mpp
 		{
 		};
 
-		template<arithmetic T, typename Buf>
-		struct is_mat<mat<T, Buf>> : std::true_type
+		template<arithmetic T, typename Buf, typename Layout>
+		struct is_mat<mat<T, Buf, Layout>> : std::true_type
 		{
 		};
 
@@ -97,6 +102,41 @@ namespace mpp
 			return row * cols + col;
 		}
 
+		template<typename Layout>
+		[[nodiscard]] constexpr auto idx_1d(std::size_t rows,
+			std::size_t cols,
+			std::size_t row,
+			std::size_t col) noexcept -> std::size_t
+		{
+			const auto [rs, cs] = Layout::strides(rows, cols);
+			return row * rs + col * cs;
+		}
+
+		[[nodiscard]] constexpr auto round_up(std::size_t n, std::size_t multiple) noexcept -> std::size_t
+		{
+			return (n + multiple - 1) / multiple * multiple;
+		}
+
+		[[nodiscard]] constexpr auto div_round_up(std::size_t n, std::size_t d) noexcept -> std::size_t
+		{
+			return (n + d - 1) / d;
+		}
+
+		// Whether left * right wraps around, for sizes read from files
+		[[nodiscard]] constexpr auto mul_overflows(std::size_t left, std::size_t right) noexcept -> bool
+		{
+			return left != 0 && right > std::numeric_limits<std::size_t>::max() / left;
+		}
+
+		// Temporary buffers of the algorithms, counted in mpp::stats when instrumented
+#ifdef MPP_INSTRUMENT
+		template<typename T>
+		using scratch_vector = std::vector<T, instrument::accounting_allocator<T>>;
+#else
+		template<typename T>
+		using scratch_vector = std::vector<T>;
+#endif
+
 		[[nodiscard]] constexpr auto rng2d_dims(const auto& rng) -> std::pair<std::size_t, std::size_t>
 		{
 			// Preconditions:
@@ -105,55 +145,89 @@ namespace mpp
 				std::ranges::size(rng) == 0 ? 0 : std::ranges::size(*std::ranges::begin(rng)) };
 		}
 
-		template<typename Buf>
+		template<typename Layout = row_major, typename Buf>
 		void resize_buf_if_dyn(Buf& buf,
-			std::size_t rows,
-			std::size_t cols,
-			auto val) // @TODO: ISSUE #20
+			[[maybe_unused]] std::size_t rows,
+			[[maybe_unused]] std::size_t cols,
+			[[maybe_unused]] auto val) // @TODO: ISSUE #20
 		{
 			if constexpr (is_dyn_buf<Buf>)
 			{
-				buf.resize(rows * cols, val);
+				buf.resize(Layout::buf_size(rows, cols), val);
+			}
+			else
+			{
+				// Fixed buffers can't grow, so they have to hold the elements (and padding) of the layout already
+				assert(std::ranges::size(buf) >= Layout::buf_size(rows, cols));
 			}
 		}
 
-		template<typename Buf>
-		void resize_or_fill_buf(Buf& buf, std::size_t rows, std::size_t cols, auto val) // @TODO: ISSUE #20
+		template<typename Layout = row_major, typename Buf>
+		void resize_or_fill_buf(Buf& buf,
+			[[maybe_unused]] std::size_t rows,
+			[[maybe_unused]] std::size_t cols,
+			auto val) // @TODO: ISSUE #20
 		{
 			if constexpr (is_dyn_buf<Buf>)
 			{
-				buf.resize(rows * cols, val);
+				buf.resize(Layout::buf_size(rows, cols), val);
 			}
 			else
 			{
+				assert(std::ranges::size(buf) >= Layout::buf_size(rows, cols));
 				std::ranges::fill(buf, val);
 			}
 		}
 
-		template<typename Buf>
-		auto copy_into_new_buf(const auto& obj, std::size_t rows, std::size_t cols) -> Buf // @TODO: ISSUE #20
-		{
-			auto buf = Buf{};
-			resize_buf_if_dyn(buf, rows, cols, typename Buf::value_type{});
-			std::ranges::copy(obj, std::ranges::begin(buf));
-
-			return buf;
-		}
-
+		template<typename Layout = row_major>
 		void init_identity_buf(auto& buf,
 			std::size_t rows,
 			std::size_t cols,
 			auto zero_val,
 			auto one_val) // @TODO: ISSUE #20
 		{
-			resize_or_fill_buf(buf, rows, cols, zero_val);
+			resize_or_fill_buf<Layout>(buf, rows, cols, zero_val);
 
 			for (auto i = std::size_t{}; i < rows; ++i)
 			{
-				buf[idx_1d(cols, i, i)] = one_val;
+				buf[idx_1d<Layout>(rows, cols, i, i)] = one_val;
 			}
 		}
 
+		/**
+		 * Non-owning view of a matrix with arbitrary strides, element (row, col) lives at data[row * rs + col * cs]
+		 *
+		 * Swapping the strides gives the transpose without touching the data, which lets kernels consume any
+		 * storage order
+		 */
+		template<typename T>
+		struct strided_view
+		{
+			T* data;
+			std::size_t rs;
+			std::size_t cs;
+
+			[[nodiscard]] auto operator()(std::size_t row, std::size_t col) const noexcept -> T&
+			{
+				return data[row * rs + col * cs];
+			}
+
+			[[nodiscard]] auto sub(std::size_t row, std::size_t col) const noexcept -> strided_view
+			{
+				return { data + row * rs + col * cs, rs, cs };
+			}
+
+			[[nodiscard]] auto trps() const noexcept -> strided_view
+			{
+				return { data, cs, rs };
+			}
+
+			[[nodiscard]] auto as_const() const noexcept -> strided_view<const T>
+			{
+				return { data, rs, cs };
+			}
+		};
+
 		template<typename T>
 		constexpr auto constexpr_abs(T t) noexcept -> T
 		{
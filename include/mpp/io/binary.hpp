@@ -0,0 +1,439 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/mapped_file.hpp>
+#include <mpp/detail/util/public.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/io/mapped_buf.hpp>
+#include <mpp/mat.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace mpp
+{
+	namespace detail
+	{
+		/**
+		 * Header of the binary format, all integers in the byte order of the machine that wrote it:
+		 *
+		 * [0, 6)   "MPPMAT"
+		 * [6]      version
+		 * [8]      kind of the elements: 'f' (floating point), 'i' (signed) or 'u' (unsigned integer)
+		 * [9]      size of an element in bytes
+		 * [10]     layout of the data: 0 for row major, 1 for column major, 2 for square tiles
+		 * [12, 16) 0x01020304, to detect a file from a machine of the other byte order
+		 * [16, 24) rows
+		 * [24, 32) columns
+		 * [32, 40) offset of the data, a multiple of binary_alignment
+		 * [40, 48) size of the tiles for tiled data, 0 otherwise
+		 *
+		 * The rest is zeros, the data follows without padding between rows or columns. Tiled data is a row major grid
+		 * of row major tiles, the tiles on the bottom and right edges are padded with zeros to the full tile size
+		 */
+		inline constexpr auto binary_magic      = std::string_view{ "MPPMAT" };
+		inline constexpr auto binary_version    = std::uint8_t{ 1 };
+		inline constexpr auto binary_byte_order = std::uint32_t{ 0x01020304 };
+
+		// Enough for any SIMD load of mapped data to be aligned
+		inline constexpr auto binary_alignment = std::size_t{ 64 };
+
+		inline constexpr auto binary_header_size = binary_alignment;
+
+		enum class binary_layout : std::uint8_t
+		{
+			row_major = 0,
+			col_major = 1,
+			tiled     = 2
+		};
+
+		struct binary_header
+		{
+			char kind;
+			std::uint8_t elem_size;
+			binary_layout layout;
+			std::uint64_t rows;
+			std::uint64_t cols;
+			std::uint64_t data_offset;
+			std::uint64_t tile_size = 0;
+		};
+
+		template<typename T>
+		[[nodiscard]] constexpr auto binary_kind_of() noexcept -> char
+		{
+			static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+				"Only floating point and integer elements can be stored in binary files");
+
+			if constexpr (std::is_floating_point_v<T>)
+			{
+				return 'f';
+			}
+			else if constexpr (std::is_signed_v<T>)
+			{
+				return 'i';
+			}
+			else
+			{
+				return 'u';
+			}
+		}
+
+		template<typename Layout>
+		[[nodiscard]] constexpr auto binary_layout_of() noexcept -> binary_layout
+		{
+			// Padded rows are written without their padding
+			return std::is_same_v<Layout, col_major> ? binary_layout::col_major : binary_layout::row_major;
+		}
+
+		[[nodiscard]] inline auto encode_binary_header(const binary_header& header)
+			-> std::array<std::byte, binary_header_size>
+		{
+			auto bytes = std::array<std::byte, binary_header_size>{};
+
+			const auto put = [&](std::size_t offset, const auto& value) {
+				std::memcpy(bytes.data() + offset, &value, sizeof(value));
+			};
+
+			std::memcpy(bytes.data(), binary_magic.data(), binary_magic.size());
+			put(6, binary_version);
+			put(8, header.kind);
+			put(9, header.elem_size);
+			put(10, header.layout);
+			put(12, binary_byte_order);
+			put(16, header.rows);
+			put(24, header.cols);
+			put(32, header.data_offset);
+			put(40, header.tile_size);
+
+			return bytes;
+		}
+
+		/**
+		 * Bytes from the start of the file to the end of its elements (padding of tiles included), or std::nullopt if
+		 * they don't fit in std::size_t. The sizes come from the file, so they can't be multiplied unchecked
+		 */
+		[[nodiscard]] inline auto binary_file_size(const binary_header& header) -> std::optional<std::size_t>
+		{
+			const auto padded = [&](std::size_t extent) -> std::optional<std::size_t> {
+				if (header.tile_size == 0)
+				{
+					return extent;
+				}
+
+				const auto tile_size = static_cast<std::size_t>(header.tile_size);
+				const auto tiles     = extent / tile_size + (extent % tile_size != 0 ? 1 : 0);
+
+				if (mul_overflows(tiles, tile_size))
+				{
+					return std::nullopt;
+				}
+
+				return tiles * tile_size;
+			};
+
+			const auto rows = padded(static_cast<std::size_t>(header.rows));
+			const auto cols = padded(static_cast<std::size_t>(header.cols));
+
+			if (!rows || !cols || mul_overflows(*rows, *cols) || mul_overflows(*rows * *cols, header.elem_size))
+			{
+				return std::nullopt;
+			}
+
+			const auto bytes  = *rows * *cols * header.elem_size;
+			const auto offset = static_cast<std::size_t>(header.data_offset);
+
+			if (bytes > std::numeric_limits<std::size_t>::max() - offset)
+			{
+				return std::nullopt;
+			}
+
+			return offset + bytes;
+		}
+
+		/**
+		 * Throws std::runtime_error if the bytes aren't the header of a binary file this build can read
+		 */
+		[[nodiscard]] inline auto decode_binary_header(const std::byte* bytes,
+			std::size_t size,
+			const std::filesystem::path& path) -> binary_header
+		{
+			const auto fail = [&](const char* what) {
+				throw std::runtime_error(path.string() + " isn't a readable mpp binary matrix: " + what);
+			};
+
+			if (size < binary_header_size || std::memcmp(bytes, binary_magic.data(), binary_magic.size()) != 0)
+			{
+				fail("no header");
+			}
+
+			const auto get = [&]<typename U>(std::size_t offset, U value) {
+				std::memcpy(&value, bytes + offset, sizeof(value));
+				return value;
+			};
+
+			if (get(6, std::uint8_t{}) != binary_version)
+			{
+				fail("unknown version");
+			}
+
+			if (get(12, std::uint32_t{}) != binary_byte_order)
+			{
+				fail("written on a machine of the other byte order");
+			}
+
+			const auto header = binary_header{ get(8, char{}),
+				get(9, std::uint8_t{}),
+				get(10, binary_layout{}),
+				get(16, std::uint64_t{}),
+				get(24, std::uint64_t{}),
+				get(32, std::uint64_t{}),
+				get(40, std::uint64_t{}) };
+
+			if (header.layout != binary_layout::row_major && header.layout != binary_layout::col_major &&
+				header.layout != binary_layout::tiled)
+			{
+				fail("unknown layout");
+			}
+
+			if ((header.layout == binary_layout::tiled) != (header.tile_size != 0))
+			{
+				fail("bad tile size");
+			}
+
+			if (header.data_offset < binary_header_size || header.data_offset % binary_alignment != 0)
+			{
+				fail("misaligned data");
+			}
+
+			if (!binary_file_size(header))
+			{
+				fail("too many elements");
+			}
+
+			return header;
+		}
+
+		template<typename T>
+		void check_binary_elems(const binary_header& header, const std::filesystem::path& path)
+		{
+			if (header.kind != binary_kind_of<T>() || header.elem_size != sizeof(T))
+			{
+				throw std::runtime_error(path.string() + " holds elements of kind '" + std::string(1, header.kind) +
+					"' and size " + std::to_string(header.elem_size) + ", not of the requested type");
+			}
+		}
+
+		[[nodiscard]] inline auto read_binary_header(std::ifstream& file, const std::filesystem::path& path)
+			-> binary_header
+		{
+			auto bytes = std::array<std::byte, binary_header_size>{};
+
+			if (!file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())))
+			{
+				throw std::runtime_error("Failed to read the header of " + path.string());
+			}
+
+			return decode_binary_header(bytes.data(), bytes.size(), path);
+		}
+
+		inline void check_binary_untiled(const binary_header& header, const std::filesystem::path& path)
+		{
+			if (header.layout == binary_layout::tiled)
+			{
+				throw std::runtime_error(path.string() + " is stored in tiles, open it with tiled_file instead");
+			}
+		}
+	} // namespace detail
+
+	/**
+	 * Element type and shape of a matrix in a binary file, without reading its data
+	 */
+	struct binary_info
+	{
+		char kind; // 'f' for floating point, 'i' for signed and 'u' for unsigned integers
+		std::size_t elem_size;
+		std::size_t rows;
+		std::size_t cols;
+		bool col_major;
+		std::size_t tile_size; // Of files written by tiled_file, 0 for others
+	};
+
+	/**
+	 * Reads the header of a binary file, throws std::runtime_error if it isn't one
+	 */
+	[[nodiscard]] inline auto read_binary_info(const std::filesystem::path& path) -> binary_info // @TODO: ISSUE #20
+	{
+		auto file         = std::ifstream{ path, std::ios::binary };
+		const auto header = detail::read_binary_header(file, path);
+
+		return { header.kind,
+			header.elem_size,
+			static_cast<std::size_t>(header.rows),
+			static_cast<std::size_t>(header.cols),
+			header.layout == detail::binary_layout::col_major,
+			static_cast<std::size_t>(header.tile_size) };
+	}
+
+	/**
+	 * Writes a matrix as a header followed by its raw elements, in its own layout for row and column major matrices
+	 * (padded rows are written without their padding). Throws std::runtime_error if the file can't be written
+	 */
+	template<typename T, typename Buf, typename Layout>
+	void save_binary(const std::filesystem::path& path, const mat<T, Buf, Layout>& obj) // @TODO: ISSUE #20
+	{
+		const auto rows = obj.rows();
+		const auto cols = obj.cols();
+
+		const auto header = detail::encode_binary_header({ detail::binary_kind_of<T>(),
+			static_cast<std::uint8_t>(sizeof(T)),
+			detail::binary_layout_of<Layout>(),
+			rows,
+			cols,
+			detail::binary_header_size });
+
+		auto file = std::ofstream{ path, std::ios::binary | std::ios::trunc };
+
+		if (!file)
+		{
+			throw std::runtime_error("Failed to open " + path.string() + " for writing a matrix");
+		}
+
+		file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+
+		if constexpr (Layout::padded)
+		{
+			const auto [row_stride, col_stride] = Layout::strides(rows, cols);
+
+			for (auto row = std::size_t{}; row < rows; ++row)
+			{
+				file.write(reinterpret_cast<const char*>(obj.data() + row * row_stride),
+					static_cast<std::streamsize>(cols * sizeof(T)));
+			}
+		}
+		else
+		{
+			const auto bytes = rows * cols * sizeof(T);
+			file.write(reinterpret_cast<const char*>(obj.data()), static_cast<std::streamsize>(bytes));
+		}
+
+		if (!file.flush())
+		{
+			throw std::runtime_error("Failed to write a matrix to " + path.string());
+		}
+	}
+
+	/**
+	 * Reads a matrix from a binary file into memory of its own, converting it from the layout of the file if needed.
+	 * Throws std::runtime_error if the file can't be read, or holds elements of another type than T
+	 */
+	template<typename T, typename Layout = row_major>
+	[[nodiscard]] auto load_binary(const std::filesystem::path& path)
+		-> mat<T, std::vector<T>, Layout> // @TODO: ISSUE #20
+	{
+		using to_t = mat<T, std::vector<T>, Layout>;
+
+		auto file         = std::ifstream{ path, std::ios::binary };
+		const auto header = detail::read_binary_header(file, path);
+
+		detail::check_binary_elems<T>(header, path);
+		detail::check_binary_untiled(header, path);
+
+		// Checked before allocating, so a corrupt header can't ask for more memory than the file could fill
+		if (std::filesystem::file_size(path) < *detail::binary_file_size(header))
+		{
+			throw std::runtime_error("Failed to read the elements of " + path.string() + ", it's truncated");
+		}
+
+		const auto rows = static_cast<std::size_t>(header.rows);
+		const auto cols = static_cast<std::size_t>(header.cols);
+		auto buf        = std::vector<T>(rows * cols);
+
+		// A single read of all the elements, straight into the buffer of the matrix
+		file.seekg(static_cast<std::streamoff>(header.data_offset));
+
+		if (!file.read(reinterpret_cast<char*>(buf.data()), static_cast<std::streamsize>(buf.size() * sizeof(T))))
+		{
+			throw std::runtime_error("Failed to read the elements of " + path.string() + ", it's truncated");
+		}
+
+		if constexpr (!Layout::padded)
+		{
+			if (header.layout == detail::binary_layout_of<Layout>())
+			{
+				return to_t{ rows, cols, std::move(buf) };
+			}
+		}
+
+		if (header.layout == detail::binary_layout::col_major)
+		{
+			return to_t{ mat<T, std::vector<T>, col_major>{ rows, cols, std::move(buf) } };
+		}
+
+		return to_t{ mat<T, std::vector<T>, row_major>{ rows, cols, std::move(buf) } };
+	}
+
+	/**
+	 * Maps a binary file into memory and returns a read-only matrix over it, without parsing or copying anything. Pages
+	 * are read as they're first touched, and the mapping lives as long as the matrix or any copy of it does. Throws
+	 * std::runtime_error if the file can't be mapped, holds elements of another type than T, or is in the other
+	 * layout than Layout
+	 */
+	template<typename T, typename Layout = row_major>
+	requires(!Layout::padded) [[nodiscard]] auto map_binary(const std::filesystem::path& path)
+		-> mat<T, mapped_buf<T>, Layout> // @TODO: ISSUE #20
+	{
+		const auto file   = detail::mapped_file::open(path);
+		const auto header = detail::decode_binary_header(file->data(), file->size(), path);
+
+		detail::check_binary_elems<T>(header, path);
+		detail::check_binary_untiled(header, path);
+
+		if (header.layout != detail::binary_layout_of<Layout>())
+		{
+			throw std::runtime_error(path.string() + " is stored in the other layout than requested, load it instead");
+		}
+
+		const auto rows = static_cast<std::size_t>(header.rows);
+		const auto cols = static_cast<std::size_t>(header.cols);
+
+		if (file->size() < *detail::binary_file_size(header))
+		{
+			throw std::runtime_error("Failed to map the elements of " + path.string() + ", it's truncated");
+		}
+
+		const auto* const data = reinterpret_cast<const T*>(file->data() + header.data_offset);
+
+		return { rows, cols, mapped_buf<T>{ file, data, rows * cols } };
+	}
+} // namespace mpp
@@ -0,0 +1,161 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/public.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace mpp
+{
+	/**
+	 * Read-only buffer over memory owned by something else, typically a mapped file (see map_binary). Copies share the
+	 * memory, and the owner lives as long as any of them does. Matrices with it can be read and used in expressions and
+	 * algorithms, whose results get a std::vector<T> by default
+	 */
+	template<typename T>
+	class mapped_buf
+	{
+		std::shared_ptr<const void> owner_;
+		const T* data_    = nullptr;
+		std::size_t size_ = 0;
+
+	public:
+		using value_type             = T;
+		using size_type              = std::size_t;
+		using difference_type        = std::ptrdiff_t;
+		using reference              = const T&;
+		using const_reference        = const T&;
+		using pointer                = const T*;
+		using const_pointer          = const T*;
+		using iterator               = const T*;
+		using const_iterator         = const T*;
+		using reverse_iterator       = std::reverse_iterator<const T*>;
+		using const_reverse_iterator = std::reverse_iterator<const T*>;
+
+		mapped_buf() noexcept = default; // @TODO: ISSUE #20
+
+		mapped_buf(std::shared_ptr<const void> owner, const T* data, std::size_t size) noexcept :
+			owner_(std::move(owner)),
+			data_(data),
+			size_(size) // @TODO: ISSUE #20
+		{
+		}
+
+		[[nodiscard]] auto data() const noexcept -> const T* // @TODO: ISSUE #20
+		{
+			return data_;
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return size_;
+		}
+
+		[[nodiscard]] auto max_size() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return std::numeric_limits<std::size_t>::max() / sizeof(T);
+		}
+
+		[[nodiscard]] auto empty() const noexcept -> bool // @TODO: ISSUE #20
+		{
+			return size_ == 0;
+		}
+
+		[[nodiscard]] auto operator[](std::size_t idx) const noexcept -> const T& // @TODO: ISSUE #20
+		{
+			return data_[idx];
+		}
+
+		[[nodiscard]] auto front() const noexcept -> const T& // @TODO: ISSUE #20
+		{
+			return data_[0];
+		}
+
+		[[nodiscard]] auto back() const noexcept -> const T& // @TODO: ISSUE #20
+		{
+			return data_[size_ - 1];
+		}
+
+		[[nodiscard]] auto begin() const noexcept -> const T* // @TODO: ISSUE #20
+		{
+			return data_;
+		}
+
+		[[nodiscard]] auto cbegin() const noexcept -> const T* // @TODO: ISSUE #20
+		{
+			return data_;
+		}
+
+		[[nodiscard]] auto end() const noexcept -> const T* // @TODO: ISSUE #20
+		{
+			return data_ + size_;
+		}
+
+		[[nodiscard]] auto cend() const noexcept -> const T* // @TODO: ISSUE #20
+		{
+			return data_ + size_;
+		}
+
+		[[nodiscard]] auto rbegin() const noexcept -> const_reverse_iterator // @TODO: ISSUE #20
+		{
+			return const_reverse_iterator{ end() };
+		}
+
+		[[nodiscard]] auto crbegin() const noexcept -> const_reverse_iterator // @TODO: ISSUE #20
+		{
+			return const_reverse_iterator{ end() };
+		}
+
+		[[nodiscard]] auto rend() const noexcept -> const_reverse_iterator // @TODO: ISSUE #20
+		{
+			return const_reverse_iterator{ begin() };
+		}
+
+		[[nodiscard]] auto crend() const noexcept -> const_reverse_iterator // @TODO: ISSUE #20
+		{
+			return const_reverse_iterator{ begin() };
+		}
+
+		/**
+		 * Drops the reference to the memory, the owner goes away with the last buffer referring to it
+		 */
+		void clear() noexcept // @TODO: ISSUE #20
+		{
+			owner_.reset();
+			data_ = nullptr;
+			size_ = 0;
+		}
+	};
+
+	template<typename T>
+	inline constexpr auto is_view_buf<mapped_buf<T>> = true;
+
+	template<typename T>
+	struct result_buf<mapped_buf<T>>
+	{
+		using type = std::vector<T>;
+	};
+} // namespace mpp
@@ -0,0 +1,453 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/mapped_file.hpp>
+#include <mpp/detail/util/text_writer.hpp>
+#include <mpp/io/text.hpp>
+#include <mpp/mat.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace mpp
+{
+	enum class matrix_market_format
+	{
+		array,     // Every element, column by column
+		coordinate // Only the nonzero elements, as 1-based row, column and value
+	};
+
+	namespace detail
+	{
+		enum class mm_symmetry
+		{
+			general,
+			symmetric,
+			skew_symmetric
+		};
+
+		struct mm_banner
+		{
+			matrix_market_format format;
+			bool pattern; // Coordinates without values, which are all 1
+			mm_symmetry symmetry;
+		};
+
+		/**
+		 * Reads whitespace separated numbers off the front of a line
+		 */
+		class mm_line
+		{
+			const char* begin_;
+			const char* end_;
+
+		public:
+			mm_line(const char* begin, const char* end) noexcept : begin_(begin), end_(end) {}
+
+			template<typename T>
+			[[nodiscard]] auto next(T& val) noexcept -> bool
+			{
+				while (begin_ < end_ && is_text_space(*begin_))
+				{
+					++begin_;
+				}
+
+				if (begin_ < end_ && *begin_ == '+')
+				{
+					++begin_;
+				}
+
+				const auto [ptr, err] = std::from_chars(begin_, end_, val);
+
+				if (err != std::errc{} || (ptr < end_ && !is_text_space(*ptr)))
+				{
+					return false;
+				}
+
+				begin_ = ptr;
+				return true;
+			}
+		};
+
+		/**
+		 * Row of the first entry of a column in the array format, symmetric arrays only hold the lower triangle and
+		 * skew-symmetric ones the part under the diagonal
+		 */
+		[[nodiscard]] constexpr auto mm_first_row(mm_symmetry symmetry, std::size_t col) noexcept -> std::size_t
+		{
+			switch (symmetry)
+			{
+			case mm_symmetry::general:
+				return 0;
+			case mm_symmetry::symmetric:
+				return col;
+			case mm_symmetry::skew_symmetric:
+				return col + 1;
+			}
+
+			return 0;
+		}
+
+		[[nodiscard]] constexpr auto mm_array_entries(mm_symmetry symmetry, std::size_t rows, std::size_t cols) noexcept
+			-> std::size_t
+		{
+			switch (symmetry)
+			{
+			case mm_symmetry::general:
+				return rows * cols;
+			case mm_symmetry::symmetric:
+				return rows * (rows + 1) / 2;
+			case mm_symmetry::skew_symmetric:
+				return rows * (rows - std::min(rows, std::size_t{ 1 })) / 2;
+			}
+
+			return 0;
+		}
+
+		[[nodiscard]] inline auto parse_mm_banner(std::string_view line, const std::filesystem::path& path) -> mm_banner
+		{
+			auto words = std::vector<std::string>{};
+
+			for (auto pos = std::size_t{}; pos < line.size();)
+			{
+				const auto begin = line.find_first_not_of(" \t\r", pos);
+
+				if (begin == std::string_view::npos)
+				{
+					break;
+				}
+
+				const auto end = std::min(line.find_first_of(" \t\r", begin), line.size());
+				auto& word     = words.emplace_back(line.substr(begin, end - begin));
+
+				std::ranges::transform(word, word.begin(), [](char chr) {
+					return static_cast<char>(std::tolower(static_cast<unsigned char>(chr)));
+				});
+
+				pos = end;
+			}
+
+			const auto fail = [&](const std::string& what) {
+				throw std::runtime_error(path.string() + " isn't a readable Matrix Market matrix: " + what);
+			};
+
+			if (words.size() != 5 || words[0] != "%%matrixmarket" || words[1] != "matrix")
+			{
+				fail("no banner");
+			}
+
+			auto banner = mm_banner{ matrix_market_format::array, false, mm_symmetry::general };
+
+			if (words[2] == "coordinate")
+			{
+				banner.format = matrix_market_format::coordinate;
+			}
+			else if (words[2] != "array")
+			{
+				fail("unknown format " + words[2]);
+			}
+
+			if (words[3] == "pattern" && banner.format == matrix_market_format::coordinate)
+			{
+				banner.pattern = true;
+			}
+			else if (words[3] != "real" && words[3] != "double" && words[3] != "integer")
+			{
+				fail("unsupported field " + words[3]);
+			}
+
+			// Real hermitian matrices are symmetric
+			if (words[4] == "symmetric" || words[4] == "hermitian")
+			{
+				banner.symmetry = mm_symmetry::symmetric;
+			}
+			else if (words[4] == "skew-symmetric")
+			{
+				banner.symmetry = mm_symmetry::skew_symmetric;
+			}
+			else if (words[4] != "general")
+			{
+				fail("unknown symmetry " + words[4]);
+			}
+
+			return banner;
+		}
+	} // namespace detail
+
+	/**
+	 * Writes a matrix or an expression as a Matrix Market file, real for floating point elements and integer for
+	 * integers, always general. Values are formatted with std::to_chars in their shortest form that reads back
+	 * exactly, and streamed through a fixed buffer. The coordinate format goes over the elements twice, to count the
+	 * nonzeros of the size line first. Throws std::runtime_error if the file can't be written
+	 */
+	template<typename Derived, typename T>
+	void save_matrix_market(const std::filesystem::path& path,
+		const detail::expr_base<Derived, T>& obj,
+		matrix_market_format format = matrix_market_format::array) // @TODO: ISSUE #20
+	{
+		static_assert(std::is_arithmetic_v<T>, "Only floating point and integer elements can be written");
+
+		const auto rows = obj.rows();
+		const auto cols = obj.cols();
+
+		auto file = std::ofstream{ path, std::ios::binary | std::ios::trunc };
+
+		if (!file)
+		{
+			throw std::runtime_error("Failed to open " + path.string() + " for writing a matrix");
+		}
+
+		{
+			auto out = detail::text_writer{ file };
+
+			const auto coordinate = format == matrix_market_format::coordinate;
+
+			out.put("%%MatrixMarket matrix ");
+			out.put(coordinate ? "coordinate " : "array ");
+			out.put(std::is_floating_point_v<T> ? "real general\n" : "integer general\n");
+			out.put_number(rows);
+			out.put(' ');
+			out.put_number(cols);
+
+			if (coordinate)
+			{
+				auto nonzeros = std::size_t{};
+
+				for (auto col = std::size_t{}; col < cols; ++col)
+				{
+					for (auto row = std::size_t{}; row < rows; ++row)
+					{
+						nonzeros += obj(row, col) != T{} ? 1U : 0U;
+					}
+				}
+
+				out.put(' ');
+				out.put_number(nonzeros);
+			}
+
+			out.put('\n');
+
+			// Both formats go column by column
+			for (auto col = std::size_t{}; col < cols; ++col)
+			{
+				for (auto row = std::size_t{}; row < rows; ++row)
+				{
+					const auto val = static_cast<T>(obj(row, col));
+
+					if (coordinate)
+					{
+						if (val == T{})
+						{
+							continue;
+						}
+
+						out.put_number(row + 1);
+						out.put(' ');
+						out.put_number(col + 1);
+						out.put(' ');
+					}
+
+					out.put_number(val);
+					out.put('\n');
+				}
+			}
+		}
+
+		if (!file.flush())
+		{
+			throw std::runtime_error("Failed to write a matrix to " + path.string());
+		}
+	}
+
+	/**
+	 * Reads a Matrix Market file in the array or coordinate format, of real, integer or pattern values, with general,
+	 * symmetric or skew-symmetric symmetry, into a dense matrix. Symmetric halves are mirrored. Throws
+	 * std::runtime_error if the file can't be read, isn't in a supported variant of the format, or has a value that
+	 * isn't a T (e.g. a real value read into integers)
+	 */
+	template<typename T, typename Layout = row_major>
+	[[nodiscard]] auto load_matrix_market(const std::filesystem::path& path)
+		-> mat<T, std::vector<T>, Layout> // @TODO: ISSUE #20
+	{
+		static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+			"Only floating point and integer elements can be read");
+
+		using to_t = mat<T, std::vector<T>, Layout>;
+
+		const auto file        = detail::mapped_file::open(path);
+		const auto* const data = reinterpret_cast<const char*>(file->data());
+
+		auto banner   = detail::mm_banner{};
+		auto out      = to_t{};
+		auto line_no  = std::size_t{};
+		auto state    = 0; // 0 before the banner, 1 before the size line, 2 in the entries
+		auto expected = std::size_t{};
+		auto entries  = std::size_t{};
+
+		// Position of the next entry of the array format, column by column
+		auto next_row = std::size_t{};
+		auto next_col = std::size_t{};
+
+		const auto fail = [&](const std::string& what) {
+			throw std::runtime_error("Failed to read line " + std::to_string(line_no) + " of " + path.string() + ": " +
+				what);
+		};
+
+		const auto set = [&](std::size_t row, std::size_t col, T val) {
+			const auto dst = detail::strided_of_mut(out);
+			dst(row, col)  = val;
+
+			if (row != col && banner.symmetry == detail::mm_symmetry::symmetric)
+			{
+				dst(col, row) = val;
+			}
+			else if (row != col && banner.symmetry == detail::mm_symmetry::skew_symmetric)
+			{
+				dst(col, row) = static_cast<T>(-val);
+			}
+		};
+
+		detail::for_each_text_line(data, data + file->size(), [&](const char* begin, const char* end) {
+			++line_no;
+
+			if (state == 0)
+			{
+				const auto banner_line = std::string_view{ begin, static_cast<std::size_t>(end - begin) };
+
+				banner = detail::parse_mm_banner(banner_line, path);
+				state  = 1;
+				return true;
+			}
+
+			const auto comment = begin < end && *begin == '%';
+
+			if (comment || detail::classify_text_line(begin, end) == detail::text_line_kind::blank)
+			{
+				return true;
+			}
+
+			auto line = detail::mm_line{ begin, end };
+
+			if (state == 1)
+			{
+				auto rows = std::size_t{};
+				auto cols = std::size_t{};
+
+				if (!line.next(rows) || !line.next(cols))
+				{
+					fail("no size");
+				}
+
+				if (banner.format == matrix_market_format::coordinate)
+				{
+					if (!line.next(expected))
+					{
+						fail("no number of entries");
+					}
+				}
+				else
+				{
+					expected = detail::mm_array_entries(banner.symmetry, rows, cols);
+				}
+
+				if (banner.symmetry != detail::mm_symmetry::general && rows != cols)
+				{
+					fail("symmetric matrices have to be square");
+				}
+
+				out   = to_t(rows, cols, T{});
+				state = 2;
+
+				next_row = detail::mm_first_row(banner.symmetry, 0);
+				return true;
+			}
+
+			if (entries == expected)
+			{
+				fail("more entries than the size line announced");
+			}
+
+			if (banner.format == matrix_market_format::coordinate)
+			{
+				auto row = std::size_t{};
+				auto col = std::size_t{};
+				auto val = T{ 1 };
+
+				if (!line.next(row) || !line.next(col) || (!banner.pattern && !line.next(val)))
+				{
+					fail("not a row, a column and a value of the requested type");
+				}
+
+				if (row == 0 || col == 0 || row > out.rows() || col > out.cols())
+				{
+					fail("position out of the matrix");
+				}
+
+				set(row - 1, col - 1, val);
+			}
+			else
+			{
+				auto val = T{};
+
+				if (!line.next(val))
+				{
+					fail("not a value of the requested type");
+				}
+
+				set(next_row, next_col, val);
+
+				if (++next_row == out.rows())
+				{
+					++next_col;
+					next_row = detail::mm_first_row(banner.symmetry, next_col);
+				}
+			}
+
+			++entries;
+			return true;
+		});
+
+		if (state < 2)
+		{
+			throw std::runtime_error(path.string() + " isn't a readable Matrix Market matrix: no size line");
+		}
+
+		if (entries != expected)
+		{
+			throw std::runtime_error(path.string() + " has " + std::to_string(entries) +
+				" entries, its size line announced " + std::to_string(expected));
+		}
+
+		return out;
+	}
+} // namespace mpp
@@ -0,0 +1,428 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/algo_impl.hpp>
+#include <mpp/detail/util/mapped_file.hpp>
+#include <mpp/detail/util/trps_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/io/binary.hpp>
+#include <mpp/io/mapped_buf.hpp>
+#include <mpp/mat.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace mpp
+{
+	namespace detail
+	{
+		inline constexpr auto npy_magic = std::string_view{ "\x93NUMPY" };
+
+		// numpy pads headers so the data starts on a multiple of 64 bytes (older versions used 16)
+		inline constexpr auto npy_alignment = std::size_t{ 64 };
+
+		// Elements written at once when a matrix can't be written straight from its buffer
+		inline constexpr auto npy_block_elems = std::size_t{ 1 } << 14;
+
+		struct npy_header
+		{
+			char kind;
+			std::size_t elem_size;
+			bool fortran_order;
+			std::size_t rows;
+			std::size_t cols;
+			std::size_t data_offset;
+		};
+
+		template<typename T>
+		[[nodiscard]] auto npy_descr_of() -> std::string
+		{
+			const auto order = sizeof(T) == 1 ? '|' : std::endian::native == std::endian::little ? '<' : '>';
+			return std::string{ order, binary_kind_of<T>() } + std::to_string(sizeof(T));
+		}
+
+		/**
+		 * Value of a key of the Python dict literal of a header, e.g. "'<f8'" for 'descr'
+		 */
+		[[nodiscard]] inline auto npy_dict_value(std::string_view dict, std::string_view key) -> std::string_view
+		{
+			const auto quoted = std::string{ "'" } + std::string{ key } + "'";
+			auto pos          = dict.find(quoted);
+
+			if (pos == std::string_view::npos)
+			{
+				return {};
+			}
+
+			pos = dict.find(':', pos + quoted.size());
+
+			if (pos == std::string_view::npos)
+			{
+				return {};
+			}
+
+			auto value = dict.substr(pos + 1);
+			value.remove_prefix(std::min(value.find_first_not_of(' '), value.size()));
+
+			// Tuples end at their parenthesis, anything else at the next comma
+			const auto end = value.starts_with('(') ? value.find(')') + 1 : value.find_first_of(",}");
+			return value.substr(0, end);
+		}
+
+		[[nodiscard]] inline auto parse_npy_header(const std::byte* bytes,
+			std::size_t size,
+			const std::filesystem::path& path) -> npy_header
+		{
+			const auto fail = [&](const std::string& what) {
+				throw std::runtime_error(path.string() + " isn't a readable NPY matrix: " + what);
+			};
+
+			const auto byte_at = [&](std::size_t idx) {
+				return std::to_integer<std::size_t>(bytes[idx]);
+			};
+
+			if (size < 10 || std::memcmp(bytes, npy_magic.data(), npy_magic.size()) != 0)
+			{
+				fail("no header");
+			}
+
+			// Version 1 has a 2 byte header length, versions 2 and 3 a 4 byte one, always little endian
+			const auto major      = byte_at(6);
+			const auto len_size   = major == 1 ? std::size_t{ 2 } : std::size_t{ 4 };
+			const auto dict_begin = 8 + len_size;
+
+			if (major < 1 || major > 3 || size < dict_begin)
+			{
+				fail("unknown version");
+			}
+
+			auto dict_size = std::size_t{};
+
+			for (auto idx = len_size; idx > 0; --idx)
+			{
+				dict_size = dict_size << 8 | byte_at(8 + idx - 1);
+			}
+
+			if (size < dict_begin + dict_size)
+			{
+				fail("truncated header");
+			}
+
+			const auto dict = std::string_view{ reinterpret_cast<const char*>(bytes + dict_begin), dict_size };
+
+			auto descr = npy_dict_value(dict, "descr");
+
+			if (descr.size() < 5 || (descr.front() != '\'' && descr.front() != '"'))
+			{
+				fail("no element type");
+			}
+
+			descr = descr.substr(1, descr.size() - 2);
+
+			const auto native = std::endian::native == std::endian::little ? '<' : '>';
+
+			if (descr[0] != '|' && descr[0] != '=' && descr[0] != native)
+			{
+				fail("elements aren't in the byte order of this machine");
+			}
+
+			auto header = npy_header{ descr[1], 0, false, 1, 1, dict_begin + dict_size };
+
+			if (std::from_chars(descr.data() + 2, descr.data() + descr.size(), header.elem_size).ec != std::errc{})
+			{
+				fail("unknown element type " + std::string{ descr });
+			}
+
+			header.fortran_order = npy_dict_value(dict, "fortran_order").starts_with("True");
+
+			// () is a scalar, (n,) a column vector and (rows, cols) a matrix
+			const auto shape = npy_dict_value(dict, "shape");
+
+			if (!shape.starts_with('(') || !shape.ends_with(')'))
+			{
+				fail("no shape");
+			}
+
+			auto dims = std::vector<std::size_t>{};
+
+			for (const auto* ptr = shape.data() + 1; ptr < shape.data() + shape.size() - 1;)
+			{
+				if (*ptr == ' ' || *ptr == ',')
+				{
+					++ptr;
+					continue;
+				}
+
+				auto dim              = std::size_t{};
+				const auto [end, err] = std::from_chars(ptr, shape.data() + shape.size() - 1, dim);
+
+				if (err != std::errc{})
+				{
+					fail("bad shape " + std::string{ shape });
+				}
+
+				dims.push_back(dim);
+				ptr = end;
+			}
+
+			if (dims.size() > 2)
+			{
+				fail("only matrices and vectors are supported, not " + std::to_string(dims.size()) + " dimensions");
+			}
+
+			header.rows = dims.empty() ? 1 : dims[0];
+			header.cols = dims.size() < 2 ? 1 : dims[1];
+
+			// The shape comes from the file, so a product that wraps around mustn't pass for a small one
+			if (mul_overflows(header.rows, header.cols) || mul_overflows(header.rows * header.cols, header.elem_size))
+			{
+				fail("too many elements");
+			}
+
+			if (size - header.data_offset < header.rows * header.cols * header.elem_size)
+			{
+				fail("truncated elements");
+			}
+
+			return header;
+		}
+
+		/**
+		 * Calls fn(std::type_identity<Src>{}) with the element type of a header, false if mpp doesn't support it
+		 */
+		template<typename Fn>
+		[[nodiscard]] auto visit_npy_type(const npy_header& header, Fn&& fn) -> bool
+		{
+			const auto visit_size = [&]<typename... Types>(std::type_identity<Types>...) {
+				return ((sizeof(Types) == header.elem_size ? (fn(std::type_identity<Types>{}), true) : false) || ...);
+			};
+
+			switch (header.kind)
+			{
+			case 'f':
+				return visit_size(std::type_identity<float>{}, std::type_identity<double>{});
+			case 'i':
+				return visit_size(std::type_identity<std::int8_t>{},
+					std::type_identity<std::int16_t>{},
+					std::type_identity<std::int32_t>{},
+					std::type_identity<std::int64_t>{});
+			case 'u':
+				return visit_size(std::type_identity<std::uint8_t>{},
+					std::type_identity<std::uint16_t>{},
+					std::type_identity<std::uint32_t>{},
+					std::type_identity<std::uint64_t>{});
+			default:
+				return false;
+			}
+		}
+
+		/**
+		 * Writes the elements of any matrix or expression in row (or column) major order, straight from the buffer of
+		 * unpadded matrices in that order, and otherwise a block of rows at a time
+		 */
+		template<typename T, typename Derived, typename U>
+		void write_raw_elems(std::ostream& os, const expr_base<Derived, U>& obj, bool col_order)
+		{
+			const auto rows = obj.rows();
+			const auto cols = obj.cols();
+
+			if constexpr (is_mat<Derived>::value && std::is_same_v<typename Derived::value_type, T>)
+			{
+				using layout_t = typename Derived::layout_type;
+
+				const auto& mat_obj = static_cast<const Derived&>(obj);
+				const auto in_order =
+					col_order ? std::is_same_v<layout_t, col_major> : std::is_same_v<layout_t, row_major>;
+
+				if (in_order)
+				{
+					const auto bytes = rows * cols * sizeof(T);
+					os.write(reinterpret_cast<const char*>(mat_obj.data()), static_cast<std::streamsize>(bytes));
+					return;
+				}
+			}
+
+			const auto outer = col_order ? cols : rows;
+			const auto inner = col_order ? rows : cols;
+			const auto step  = std::max(std::size_t{ 1 }, npy_block_elems / std::max(inner, std::size_t{ 1 }));
+
+			auto block = std::vector<T>(std::min(outer, step) * inner);
+
+			for (auto first = std::size_t{}; first < outer; first += step)
+			{
+				const auto last = std::min(outer, first + step);
+				auto* out       = block.data();
+
+				for (auto idx = first; idx < last; ++idx)
+				{
+					for (auto other = std::size_t{}; other < inner; ++other)
+					{
+						*out++ = static_cast<T>(col_order ? obj(other, idx) : obj(idx, other));
+					}
+				}
+
+				const auto bytes = (last - first) * inner * sizeof(T);
+				os.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(bytes));
+			}
+		}
+	} // namespace detail
+
+	/**
+	 * Writes a matrix or an expression as a NumPy .npy file of its value type. Column major matrices are written in
+	 * Fortran order, everything else in C order. Matrices in that order are written straight from their buffer, other
+	 * matrices and expressions are streamed a block of rows at a time. Throws std::runtime_error if the file can't be
+	 * written
+	 */
+	template<typename Derived, typename T>
+	void save_npy(const std::filesystem::path& path, const detail::expr_base<Derived, T>& obj) // @TODO: ISSUE #20
+	{
+		auto col_order = false;
+
+		if constexpr (detail::is_mat<Derived>::value)
+		{
+			col_order = std::is_same_v<typename Derived::layout_type, col_major>;
+		}
+
+		auto dict = std::string{ "{'descr': '" } + detail::npy_descr_of<T>() +
+			"', 'fortran_order': " + (col_order ? "True" : "False") + ", 'shape': (" + std::to_string(obj.rows()) +
+			", " + std::to_string(obj.cols()) + "), }";
+
+		// Pads with spaces and a line feed up to the alignment, after the 10 bytes before the dict
+		const auto padded = detail::round_up(10 + dict.size() + 1, detail::npy_alignment);
+		dict.append(padded - 10 - dict.size() - 1, ' ');
+		dict.push_back('\n');
+
+		auto file = std::ofstream{ path, std::ios::binary | std::ios::trunc };
+
+		if (!file)
+		{
+			throw std::runtime_error("Failed to open " + path.string() + " for writing a matrix");
+		}
+
+		// Version 1, whose header length is 2 little endian bytes
+		const auto dict_size = dict.size();
+		const auto prefix    = std::string{ detail::npy_magic } + '\x01' + '\x00' +
+			static_cast<char>(dict_size & 0xFF) + static_cast<char>(dict_size >> 8);
+
+		file.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+		file.write(dict.data(), static_cast<std::streamsize>(dict.size()));
+		detail::write_raw_elems<T>(file, obj, col_order);
+
+		if (!file.flush())
+		{
+			throw std::runtime_error("Failed to write a matrix to " + path.string());
+		}
+	}
+
+	/**
+	 * Reads a .npy file of floating point or integer elements into a matrix of T, converting the elements and the
+	 * order as needed. A 1D array is read as a column vector. Throws std::runtime_error if the file can't be read or
+	 * isn't a 2D (or smaller) array of elements in the byte order of the machine
+	 */
+	template<typename T, typename Layout = row_major>
+	[[nodiscard]] auto load_npy(const std::filesystem::path& path)
+		-> mat<T, std::vector<T>, Layout> // @TODO: ISSUE #20
+	{
+		using to_t = mat<T, std::vector<T>, Layout>;
+
+		const auto file   = detail::mapped_file::open(path);
+		const auto header = detail::parse_npy_header(file->data(), file->size(), path);
+
+		auto out = to_t{};
+
+		const auto supported = detail::visit_npy_type(header, [&]<typename Src>(std::type_identity<Src>) {
+			const auto* const bytes = file->data() + header.data_offset;
+			const auto count        = header.rows * header.cols;
+
+			// The mapping can be read in place unless old headers left the elements misaligned
+			auto copy       = std::vector<Src>{};
+			const auto* src = reinterpret_cast<const Src*>(bytes);
+
+			if (reinterpret_cast<std::uintptr_t>(bytes) % alignof(Src) != 0)
+			{
+				copy.resize(count);
+				std::memcpy(copy.data(), bytes, count * sizeof(Src));
+				src = copy.data();
+			}
+
+			const auto view = header.fortran_order ? detail::strided_view<const Src>{ src, 1, header.rows }
+												   : detail::strided_view<const Src>{ src, header.cols, 1 };
+
+			out = detail::make_mat_with<to_t>(header.rows, header.cols, [&](detail::strided_view<T> dst) {
+				detail::copy_strided(header.rows, header.cols, view, dst);
+			});
+		});
+
+		if (!supported)
+		{
+			throw std::runtime_error(path.string() + " holds elements of an unsupported type");
+		}
+
+		return out;
+	}
+
+	/**
+	 * Maps a .npy file and returns a read-only matrix over its elements without copying them, see map_binary. Throws
+	 * std::runtime_error if the file can't be mapped, holds elements of another type than T, or is in the other order
+	 * than Layout (Fortran order for column major)
+	 */
+	template<typename T, typename Layout = row_major>
+	requires(!Layout::padded) [[nodiscard]] auto map_npy(const std::filesystem::path& path)
+		-> mat<T, mapped_buf<T>, Layout> // @TODO: ISSUE #20
+	{
+		const auto file   = detail::mapped_file::open(path);
+		const auto header = detail::parse_npy_header(file->data(), file->size(), path);
+
+		if (header.kind != detail::binary_kind_of<T>() || header.elem_size != sizeof(T))
+		{
+			throw std::runtime_error(path.string() + " holds elements of another type than requested, load it instead");
+		}
+
+		if (header.fortran_order != std::is_same_v<Layout, col_major>)
+		{
+			throw std::runtime_error(path.string() + " is stored in the other order than requested, load it instead");
+		}
+
+		const auto* const bytes = file->data() + header.data_offset;
+
+		if (reinterpret_cast<std::uintptr_t>(bytes) % alignof(T) != 0)
+		{
+			throw std::runtime_error(path.string() + " has misaligned elements, load it instead");
+		}
+
+		const auto count = header.rows * header.cols;
+		return { header.rows, header.cols, mapped_buf<T>{ file, reinterpret_cast<const T*>(bytes), count } };
+	}
+} // namespace mpp
@@ -0,0 +1,383 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/mapped_file.hpp>
+#include <mpp/detail/util/thread_pool.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/util/cfg.hpp>
+#include <mpp/mat.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace mpp
+{
+	namespace detail
+	{
+		// Smallest piece of a file parsed by one task, smaller files are parsed on one thread
+		inline constexpr auto text_chunk_bytes = std::size_t{ 1 } << 20;
+
+		inline constexpr auto text_no_cols = std::numeric_limits<std::size_t>::max();
+
+		enum class text_line_kind
+		{
+			blank,
+			separator,
+			row
+		};
+
+		[[nodiscard]] constexpr auto is_text_space(char chr) noexcept -> bool
+		{
+			return chr == ' ' || chr == '\t' || chr == '\r';
+		}
+
+		[[nodiscard]] inline auto find_line_feed(const char* begin, const char* end) noexcept -> const char*
+		{
+			const auto* const found = std::memchr(begin, '\n', static_cast<std::size_t>(end - begin));
+			return found == nullptr ? end : static_cast<const char*>(found);
+		}
+
+		/**
+		 * Calls fn(begin, end) for every line of [begin, end), without its line feed, until it returns false
+		 */
+		template<typename Fn>
+		inline void for_each_text_line(const char* begin, const char* end, Fn&& fn)
+		{
+			while (begin < end)
+			{
+				const auto* const line_end = find_line_feed(begin, end);
+
+				if (!fn(begin, line_end))
+				{
+					return;
+				}
+
+				begin = line_end + 1;
+			}
+		}
+
+		[[nodiscard]] inline auto classify_text_line(const char* begin, const char* end) noexcept -> text_line_kind
+		{
+			while (begin < end && is_text_space(*begin))
+			{
+				++begin;
+			}
+
+			while (end > begin && is_text_space(*(end - 1)))
+			{
+				--end;
+			}
+
+			if (begin == end)
+			{
+				return text_line_kind::blank;
+			}
+
+			return end - begin == 1 && *begin == '=' ? text_line_kind::separator : text_line_kind::row;
+		}
+
+		[[nodiscard]] inline auto count_text_values(const char* begin, const char* end) noexcept -> std::size_t
+		{
+			auto count    = std::size_t{};
+			auto in_value = false;
+
+			for (; begin < end; ++begin)
+			{
+				const auto space = is_text_space(*begin);
+				count += !space && !in_value ? 1 : 0;
+				in_value = !space;
+			}
+
+			return count;
+		}
+
+		/**
+		 * Parses exactly cols values of a line into row, false if the line has another number of them or something
+		 * that isn't a T
+		 */
+		template<typename T>
+		[[nodiscard]] inline auto parse_text_row(const char* begin,
+			const char* end,
+			T* row,
+			std::size_t stride,
+			std::size_t cols) noexcept -> bool
+		{
+			for (auto col = std::size_t{}; col < cols; ++col)
+			{
+				while (begin < end && is_text_space(*begin))
+				{
+					++begin;
+				}
+
+				// from_chars doesn't take the plus sign that streams accept
+				if (begin < end && *begin == '+')
+				{
+					++begin;
+				}
+
+				const auto [ptr, err] = std::from_chars(begin, end, row[col * stride]);
+
+				if (err != std::errc{} || (ptr < end && !is_text_space(*ptr)))
+				{
+					return false;
+				}
+
+				begin = ptr;
+			}
+
+			while (begin < end && is_text_space(*begin))
+			{
+				++begin;
+			}
+
+			return begin == end;
+		}
+
+		/**
+		 * What the first pass finds in a chunk. Its separators split it into segments, which belong to consecutive
+		 * sections
+		 */
+		struct text_chunk
+		{
+			const char* begin = nullptr;
+			const char* end   = nullptr;
+			std::vector<std::size_t> segment_rows;
+			std::vector<std::size_t> segment_cols; // Values on the first row of each segment, text_no_cols if none
+
+			// Where the chunk starts, filled in between the passes
+			std::size_t section = 0;
+			std::size_t row     = 0;
+
+			const char* bad_line = nullptr; // First line the second pass couldn't parse
+		};
+
+		[[nodiscard]] inline auto split_text_chunks(const char* data, std::size_t size, std::size_t threads)
+			-> std::vector<text_chunk>
+		{
+			// A few chunks per thread even out lines of different lengths
+			const auto max_pieces = std::max(threads, std::size_t{ 1 }) * 4;
+			const auto pieces     = std::clamp(size / text_chunk_bytes, std::size_t{ 1 }, max_pieces);
+
+			auto chunks       = std::vector<text_chunk>{};
+			const auto* end   = data + size;
+			const auto* begin = data;
+
+			for (auto piece = std::size_t{ 1 }; piece <= pieces; ++piece)
+			{
+				// Every chunk but the first starts right after a line feed, long lines can leave some pieces empty
+				auto split = end;
+
+				if (piece < pieces)
+				{
+					const auto* const nominal = std::max(begin, data + size / pieces * piece);
+					split                     = std::min(end, find_line_feed(nominal, end) + 1);
+				}
+
+				if (split > begin || chunks.empty())
+				{
+					auto& chunk = chunks.emplace_back();
+					chunk.begin = begin;
+					chunk.end   = split;
+					begin       = split;
+				}
+			}
+
+			return chunks;
+		}
+
+		inline void scan_text_chunk(text_chunk& chunk)
+		{
+			chunk.segment_rows.push_back(0);
+			chunk.segment_cols.push_back(text_no_cols);
+
+			for_each_text_line(chunk.begin, chunk.end, [&](const char* begin, const char* end) {
+				switch (classify_text_line(begin, end))
+				{
+				case text_line_kind::blank:
+					break;
+				case text_line_kind::separator:
+					chunk.segment_rows.push_back(0);
+					chunk.segment_cols.push_back(text_no_cols);
+					break;
+				case text_line_kind::row:
+					if (chunk.segment_rows.back()++ == 0)
+					{
+						chunk.segment_cols.back() = count_text_values(begin, end);
+					}
+
+					break;
+				}
+
+				return true;
+			});
+		}
+
+		template<typename T>
+		inline void parse_text_chunk(text_chunk& chunk,
+			const std::vector<strided_view<T>>& outs,
+			const std::vector<std::size_t>& cols)
+		{
+			auto section = chunk.section;
+			auto row     = chunk.row;
+
+			for_each_text_line(chunk.begin, chunk.end, [&](const char* begin, const char* end) {
+				switch (classify_text_line(begin, end))
+				{
+				case text_line_kind::blank:
+					return true;
+				case text_line_kind::separator:
+					++section;
+					row = 0;
+					return true;
+				case text_line_kind::row:
+					break;
+				}
+
+				const auto out = outs[section];
+
+				if (!parse_text_row(begin, end, out.data + row * out.rs, out.cs, cols[section]))
+				{
+					chunk.bad_line = begin;
+					return false;
+				}
+
+				++row;
+				return true;
+			});
+		}
+
+		[[nodiscard]] inline auto text_line_number(const char* data, const char* line) noexcept -> std::size_t
+		{
+			return static_cast<std::size_t>(std::count(data, line, '\n')) + 1;
+		}
+	} // namespace detail
+
+	/**
+	 * Reads every matrix of a text file: whitespace separated values, a row per line, and matrices separated by lines
+	 * holding only "=". Blank lines are skipped. The file is mapped and split on line boundaries into chunks that are
+	 * parsed in parallel with std::from_chars, straight into the buffers of the matrices. Throws std::runtime_error if
+	 * the file can't be read, a value isn't a T, or the rows of a matrix have different numbers of values
+	 */
+	template<typename T, typename Layout = row_major>
+	[[nodiscard]] auto read_text_sections(const std::filesystem::path& path)
+		-> std::vector<mat<T, std::vector<T>, Layout>> // @TODO: ISSUE #20
+	{
+		static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>,
+			"Only floating point and integer elements can be read from text files");
+
+		using to_t = mat<T, std::vector<T>, Layout>;
+
+		const auto file        = detail::mapped_file::open(path);
+		const auto* const data = reinterpret_cast<const char*>(file->data());
+
+		auto chunks = detail::split_text_chunks(data, file->size(), max_threads());
+
+		detail::parallel_for(chunks.size(), [&](std::size_t idx) {
+			detail::scan_text_chunk(chunks[idx]);
+		});
+
+		// Stitches the segments of the chunks into sections, and finds where each chunk starts in them
+		auto rows = std::vector<std::size_t>{ 0 };
+		auto cols = std::vector<std::size_t>{ detail::text_no_cols };
+
+		for (auto& chunk : chunks)
+		{
+			chunk.section = rows.size() - 1;
+			chunk.row     = rows.back();
+
+			for (auto segment = std::size_t{}; segment < chunk.segment_rows.size(); ++segment)
+			{
+				if (segment > 0)
+				{
+					rows.push_back(0);
+					cols.push_back(detail::text_no_cols);
+				}
+
+				rows.back() += chunk.segment_rows[segment];
+
+				if (cols.back() == detail::text_no_cols)
+				{
+					cols.back() = chunk.segment_cols[segment];
+				}
+			}
+		}
+
+		auto out   = std::vector<to_t>{};
+		auto views = std::vector<detail::strided_view<T>>{};
+
+		out.reserve(rows.size());
+		views.reserve(rows.size());
+
+		for (auto section = std::size_t{}; section < rows.size(); ++section)
+		{
+			const auto section_cols = rows[section] == 0 ? 0 : cols[section];
+
+			cols[section] = section_cols;
+			views.push_back(detail::strided_of_mut(out.emplace_back(rows[section], section_cols, T{})));
+		}
+
+		detail::parallel_for(chunks.size(), [&](std::size_t idx) {
+			detail::parse_text_chunk(chunks[idx], views, cols);
+		});
+
+		for (const auto& chunk : chunks)
+		{
+			if (chunk.bad_line != nullptr)
+			{
+				const auto line = detail::text_line_number(data, chunk.bad_line);
+
+				throw std::runtime_error("Failed to parse line " + std::to_string(line) + " of " + path.string() +
+					", it has a value that isn't a number of the requested type, or another number of values than the "
+					"first row of its matrix");
+			}
+		}
+
+		return out;
+	}
+
+	/**
+	 * Reads a text file holding a single matrix, see read_text_sections. Throws std::runtime_error if it holds several
+	 */
+	template<typename T, typename Layout = row_major>
+	[[nodiscard]] auto read_text(const std::filesystem::path& path)
+		-> mat<T, std::vector<T>, Layout> // @TODO: ISSUE #20
+	{
+		auto sections = read_text_sections<T, Layout>(path);
+
+		if (sections.size() != 1)
+		{
+			throw std::runtime_error(path.string() + " holds " + std::to_string(sections.size()) +
+				" matrices, read them with read_text_sections");
+		}
+
+		return std::move(sections.front());
+	}
+} // namespace mpp
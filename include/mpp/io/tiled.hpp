@@ -0,0 +1,303 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/positional_file.hpp>
+#include <mpp/detail/util/trps_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/io/binary.hpp>
+#include <mpp/mat.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mpp
+{
+	/**
+	 * How much memory out-of-core algorithms keep resident by default
+	 */
+	inline constexpr auto default_tiled_memory = std::size_t{ 1 } << 30;
+
+	enum class file_access
+	{
+		read,
+		read_write
+	};
+
+	/**
+	 * Matrix stored on disk as square tiles, read and written a tile at a time so it can be far bigger than memory.
+	 * Files use the binary format of save_binary with a tiled layout, each tile is tile_size x tile_size row major
+	 * elements (zero padded on the bottom and right edges) at its own offset. Reads and writes of different tiles can
+	 * run on different threads at the same time. Copies share the open file
+	 */
+	template<typename T>
+	class tiled_file
+	{
+		std::shared_ptr<const detail::positional_file> file_;
+		std::size_t rows_      = 0;
+		std::size_t cols_      = 0;
+		std::size_t tile_size_ = 0;
+		file_access access_    = file_access::read;
+
+		tiled_file(std::shared_ptr<const detail::positional_file> file,
+			std::size_t rows,
+			std::size_t cols,
+			std::size_t tile_size,
+			file_access access) :
+			file_(std::move(file)),
+			rows_(rows),
+			cols_(cols),
+			tile_size_(tile_size),
+			access_(access)
+		{
+		}
+
+		[[nodiscard]] auto tile_offset(std::size_t tile_row, std::size_t tile_col) const noexcept -> std::size_t
+		{
+			assert(tile_row < row_tiles() && tile_col < col_tiles());
+
+			return detail::binary_header_size + (tile_row * col_tiles() + tile_col) * tile_elems() * sizeof(T);
+		}
+
+		[[nodiscard]] auto file_size() const noexcept -> std::size_t
+		{
+			return detail::binary_header_size + row_tiles() * col_tiles() * tile_elems() * sizeof(T);
+		}
+
+	public:
+		using value_type = T;
+
+		/**
+		 * Creates (or overwrites) a file for a rows x cols matrix of zeros, without writing the zeros where the file
+		 * system supports sparse files. Throws std::runtime_error if it can't be created
+		 */
+		[[nodiscard]] static auto create(const std::filesystem::path& path,
+			std::size_t rows,
+			std::size_t cols,
+			std::size_t tile_size) -> tiled_file // @TODO: ISSUE #20
+		{
+			assert(tile_size > 0);
+
+			auto file = std::make_shared<const detail::positional_file>(path, detail::file_mode::create);
+			auto out  = tiled_file{ std::move(file), rows, cols, tile_size, file_access::read_write };
+
+			const auto header = detail::encode_binary_header({ detail::binary_kind_of<T>(),
+				static_cast<std::uint8_t>(sizeof(T)),
+				detail::binary_layout::tiled,
+				rows,
+				cols,
+				detail::binary_header_size,
+				tile_size });
+
+			out.file_->write_at(0, header.data(), header.size());
+			out.file_->resize(out.file_size());
+
+			return out;
+		}
+
+		/**
+		 * Throws std::runtime_error if the file can't be opened, isn't tiled, holds elements of another type than T or
+		 * is truncated
+		 */
+		[[nodiscard]] static auto open(const std::filesystem::path& path, file_access access = file_access::read)
+			-> tiled_file // @TODO: ISSUE #20
+		{
+			auto file = std::make_shared<const detail::positional_file>(path,
+				access == file_access::read ? detail::file_mode::read : detail::file_mode::read_write);
+
+			auto bytes = std::array<std::byte, detail::binary_header_size>{};
+			file->read_at(0, bytes.data(), bytes.size());
+
+			const auto header = detail::decode_binary_header(bytes.data(), bytes.size(), path);
+			detail::check_binary_elems<T>(header, path);
+
+			if (header.layout != detail::binary_layout::tiled || header.data_offset != detail::binary_header_size)
+			{
+				throw std::runtime_error(path.string() + " isn't stored in tiles, save it with save_tiled first");
+			}
+
+			auto out = tiled_file{ std::move(file),
+				static_cast<std::size_t>(header.rows),
+				static_cast<std::size_t>(header.cols),
+				static_cast<std::size_t>(header.tile_size),
+				access };
+
+			if (std::filesystem::file_size(path) < out.file_size())
+			{
+				throw std::runtime_error("Failed to open the tiles of " + path.string() + ", it's truncated");
+			}
+
+			return out;
+		}
+
+		[[nodiscard]] auto rows() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return rows_;
+		}
+
+		[[nodiscard]] auto cols() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return cols_;
+		}
+
+		[[nodiscard]] auto tile_size() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return tile_size_;
+		}
+
+		/**
+		 * Elements in the buffer of a tile, padding included
+		 */
+		[[nodiscard]] auto tile_elems() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return tile_size_ * tile_size_;
+		}
+
+		[[nodiscard]] auto row_tiles() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return detail::div_round_up(rows_, tile_size_);
+		}
+
+		[[nodiscard]] auto col_tiles() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return detail::div_round_up(cols_, tile_size_);
+		}
+
+		/**
+		 * Rows of the matrix in the tiles of a tile row, less than tile_size on the bottom edge
+		 */
+		[[nodiscard]] auto tile_rows(std::size_t tile_row) const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return std::min(tile_size_, rows_ - tile_row * tile_size_);
+		}
+
+		/**
+		 * Columns of the matrix in the tiles of a tile column, less than tile_size on the right edge
+		 */
+		[[nodiscard]] auto tile_cols(std::size_t tile_col) const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return std::min(tile_size_, cols_ - tile_col * tile_size_);
+		}
+
+		[[nodiscard]] auto path() const noexcept -> const std::filesystem::path& // @TODO: ISSUE #20
+		{
+			return file_->path();
+		}
+
+		/**
+		 * Reads tile_elems() elements into out, throws std::runtime_error if they can't be read
+		 */
+		void read_tile(std::size_t tile_row, std::size_t tile_col, T* out) const // @TODO: ISSUE #20
+		{
+			file_->read_at(tile_offset(tile_row, tile_col), out, tile_elems() * sizeof(T));
+		}
+
+		[[nodiscard]] auto access() const noexcept -> file_access // @TODO: ISSUE #20
+		{
+			return access_;
+		}
+
+		/**
+		 * Writes tile_elems() elements from in, whose padding should be zeros. Throws std::runtime_error if they can't
+		 * be written or the file was opened for reading only
+		 */
+		void write_tile(std::size_t tile_row, std::size_t tile_col, const T* in) // @TODO: ISSUE #20
+		{
+			if (access_ == file_access::read)
+			{
+				throw std::runtime_error("Failed to write a tile of " + path().string() + ", it's opened read only");
+			}
+
+			file_->write_at(tile_offset(tile_row, tile_col), in, tile_elems() * sizeof(T));
+		}
+	};
+
+	/**
+	 * Writes a matrix into a new tiled file, throws std::runtime_error if it can't be written
+	 */
+	template<typename T, typename Buf, typename Layout>
+	auto save_tiled(const std::filesystem::path& path, const mat<T, Buf, Layout>& obj, std::size_t tile_size)
+		-> tiled_file<T> // @TODO: ISSUE #20
+	{
+		auto out  = tiled_file<T>::create(path, obj.rows(), obj.cols(), tile_size);
+		auto tile = std::vector<T>(out.tile_elems());
+
+		const auto from = detail::strided_of(obj);
+
+		for (auto tile_row = std::size_t{}; tile_row < out.row_tiles(); ++tile_row)
+		{
+			for (auto tile_col = std::size_t{}; tile_col < out.col_tiles(); ++tile_col)
+			{
+				// Edge tiles are padded with zeros
+				if (out.tile_rows(tile_row) < tile_size || out.tile_cols(tile_col) < tile_size)
+				{
+					std::ranges::fill(tile, T{});
+				}
+
+				detail::copy_strided(out.tile_rows(tile_row),
+					out.tile_cols(tile_col),
+					from.sub(tile_row * tile_size, tile_col * tile_size),
+					detail::strided_view<T>{ tile.data(), tile_size, 1 });
+
+				out.write_tile(tile_row, tile_col, tile.data());
+			}
+		}
+
+		return out;
+	}
+
+	/**
+	 * Reads a whole tiled file into memory, throws std::runtime_error if it can't be read
+	 */
+	template<typename T, typename Layout = row_major>
+	[[nodiscard]] auto load_tiled(const tiled_file<T>& file) -> mat<T, std::vector<T>, Layout> // @TODO: ISSUE #20
+	{
+		auto out  = mat<T, std::vector<T>, Layout>{ file.rows(), file.cols() };
+		auto tile = std::vector<T>(file.tile_elems());
+
+		const auto to        = detail::strided_of_mut(out);
+		const auto tile_size = file.tile_size();
+
+		for (auto tile_row = std::size_t{}; tile_row < file.row_tiles(); ++tile_row)
+		{
+			for (auto tile_col = std::size_t{}; tile_col < file.col_tiles(); ++tile_col)
+			{
+				file.read_tile(tile_row, tile_col, tile.data());
+
+				detail::copy_strided(file.tile_rows(tile_row),
+					file.tile_cols(tile_col),
+					detail::strided_view<const T>{ tile.data(), tile_size, 1 },
+					to.sub(tile_row * tile_size, tile_col * tile_size));
+			}
+		}
+
+		return out;
+	}
+} // namespace mpp
@@ -0,0 +1,260 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/cpo_base.hpp>
+#include <mpp/detail/util/krylov_impl.hpp>
+#include <mpp/iterative/krylov.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace mpp
+{
+	namespace detail
+	{
+		template<typename T, typename Op, typename Precond, typename Callback>
+		[[nodiscard]] inline auto bicgstab_impl(const Op& a,
+			std::span<const T> b,
+			std::span<T> x,
+			std::span<T> vectors,
+			[[maybe_unused]] const Precond& precond,
+			const krylov_options& options,
+			Callback& callback) -> krylov_result
+		{
+			const auto n = b.size();
+
+			assert(x.size() == n && vectors.size() >= 7 * n);
+			assert_operator_size(a, n);
+
+			// The preconditioner is applied on the right, to the directions p and s (which is r half way through an
+			// iteration), so without one p_hat is p and s_hat is r
+			auto* const r     = vectors.data();
+			auto* const r0    = r + n;
+			auto* const p     = r0 + n;
+			auto* const v     = p + n;
+			auto* const t     = v + n;
+			auto* const p_hat = is_preconditioned<Precond> ? t + n : p;
+			auto* const s_hat = is_preconditioned<Precond> ? t + 2 * n : r;
+
+			const auto op_scratch = vectors.subspan(7 * n);
+
+			auto result       = krylov_result{};
+			const auto b_norm = krylov_norm(krylov_dot(n, b.data(), b.data()));
+
+			// x = 0 solves it exactly, and the relative residual doesn't exist
+			if (b_norm == 0.0)
+			{
+				std::ranges::fill(x, T{});
+				result.converged = true;
+				return result;
+			}
+
+			const auto finished = [&](T rr) {
+				result.residual  = krylov_norm(rr) / b_norm;
+				result.converged = result.residual <= options.tolerance;
+
+				return result.converged || result.iterations >= options.max_iterations;
+			};
+
+			apply_operator(a, n, x.data(), v, op_scratch);
+
+			const auto rr = krylov_residual(n, b.data(), v, r);
+			krylov_copy(n, r, r0);
+			krylov_copy(n, r, p);
+
+			if (finished(rr))
+			{
+				return result;
+			}
+
+			auto rho = rr;
+
+			while (true)
+			{
+				if constexpr (is_preconditioned<Precond>)
+				{
+					apply_preconditioner(precond, n, p, p_hat);
+				}
+
+				apply_operator(a, n, p_hat, v, op_scratch);
+
+				// The shadow residual r0 became orthogonal to the search space, so the method breaks down
+				const auto r0v = krylov_dot(n, r0, v);
+
+				if (r0v == T{} || rho == T{})
+				{
+					break;
+				}
+
+				// r becomes s = r - alpha * v, which may already be small enough to stop half way
+				const auto alpha = rho / r0v;
+				const auto ss    = krylov_axpy_norm(n, alpha, v, r);
+
+				if (krylov_norm(ss) <= options.tolerance * b_norm)
+				{
+					krylov_axpy(n, alpha, p_hat, x.data());
+
+					++result.iterations;
+
+					static_cast<void>(finished(ss));
+					static_cast<void>(report_iteration(callback, result));
+					break;
+				}
+
+				if constexpr (is_preconditioned<Precond>)
+				{
+					apply_preconditioner(precond, n, r, s_hat);
+				}
+
+				apply_operator(a, n, s_hat, t, op_scratch);
+
+				const auto [ts, tt] = krylov_dot2(n, t, r);
+
+				if (tt == T{})
+				{
+					break;
+				}
+
+				const auto omega               = ts / tt;
+				const auto [rr_next, rho_next] = bicgstab_update(n, alpha, omega, p_hat, s_hat, t, r0, x.data(), r);
+
+				++result.iterations;
+
+				const auto stop = finished(rr_next);
+
+				if (!report_iteration(callback, result) || stop || omega == T{})
+				{
+					break;
+				}
+
+				bicgstab_direction(n, (rho_next / rho) * (alpha / omega), omega, r, v, p);
+				rho = rho_next;
+			}
+
+			return result;
+		}
+	} // namespace detail
+
+	struct bicgstab_t : public detail::cpo_base<bicgstab_t>
+	{
+		static constexpr auto name = std::string_view{ "bicgstab" };
+
+		/**
+		 * Elements of krylov_workspace a system of n unknowns needs, with or without a preconditioner
+		 */
+		[[nodiscard]] static constexpr auto workspace_size(std::size_t n, const krylov_options& = {}) noexcept
+			-> std::size_t // @TODO: ISSUE #20
+		{
+			return 7 * n;
+		}
+
+		/**
+		 * Elements of krylov_workspace solving with a needs, the vectors along with the scratch of multiplying by a
+		 */
+		template<typename Op>
+		[[nodiscard]] static auto workspace_size(const Op& a, std::size_t n, const krylov_options& options = {})
+			-> std::size_t // @TODO: ISSUE #20
+		{
+			return workspace_size(n, options) + detail::operator_scratch_size(a);
+		}
+
+		/**
+		 * Solves A * x = b for a square A with BiCGSTAB, starting from the values in x. Every iteration applies A
+		 * twice and makes five passes over the vectors: a dot product, the half step of r along with its norm, both dot
+		 * products of the stabilizing step, the updates of x and r along with the norms they need, and the new
+		 * direction
+		 */
+		template<typename Op,
+			std::ranges::contiguous_range B,
+			std::ranges::contiguous_range X,
+			typename Callback = detail::no_callback>
+		requires linear_operator<Op, std::ranges::range_value_t<X>> &&
+			std::same_as<std::ranges::range_value_t<B>, std::ranges::range_value_t<X>> && krylov_callback<Callback>
+		friend inline auto tag_invoke(bicgstab_t,
+			const Op& a,
+			const B& b,
+			X&& x,
+			krylov_workspace<std::ranges::range_value_t<X>>& workspace,
+			const krylov_options& options = {},
+			Callback callback             = {}) -> krylov_result // @TODO: ISSUE #20
+		{
+			return tag_invoke(bicgstab_t{},
+				a,
+				b,
+				std::forward<X>(x),
+				workspace,
+				detail::no_preconditioner{},
+				options,
+				std::move(callback));
+		}
+
+		/**
+		 * BiCGSTAB preconditioned on the right, so the residual it stops on is the one of the original system.
+		 * Every iteration also applies the preconditioner twice
+		 */
+		template<typename Op,
+			std::ranges::contiguous_range B,
+			std::ranges::contiguous_range X,
+			typename Precond,
+			typename Callback = detail::no_callback>
+		requires linear_operator<Op, std::ranges::range_value_t<X>> &&
+			std::same_as<std::ranges::range_value_t<B>, std::ranges::range_value_t<X>> &&
+			preconditioner<Precond, std::ranges::range_value_t<X>> && krylov_callback<Callback>
+		friend inline auto tag_invoke(bicgstab_t,
+			const Op& a,
+			const B& b,
+			X&& x,
+			krylov_workspace<std::ranges::range_value_t<X>>& workspace,
+			[[maybe_unused]] const Precond& precond,
+			const krylov_options& options = {},
+			Callback callback             = {}) -> krylov_result // @TODO: ISSUE #20
+		{
+			using value_type = std::ranges::range_value_t<X>;
+
+			const auto n = std::ranges::size(b);
+
+			return detail::bicgstab_impl<value_type>(a,
+				std::span<const value_type>{ std::ranges::data(b), n },
+				std::span<value_type>{ std::ranges::data(x), std::ranges::size(x) },
+				workspace.take(workspace_size(a, n)),
+				precond,
+				options,
+				callback);
+		}
+
+		template<typename Op, std::ranges::contiguous_range B, std::ranges::contiguous_range X>
+		requires linear_operator<Op, std::ranges::range_value_t<X>> &&
+			std::same_as<std::ranges::range_value_t<B>, std::ranges::range_value_t<X>>
+		friend inline auto tag_invoke(bicgstab_t, const Op& a, const B& b, X&& x, const krylov_options& options = {})
+			-> krylov_result // @TODO: ISSUE #20
+		{
+			auto workspace = krylov_workspace<std::ranges::range_value_t<X>>{};
+			return tag_invoke(bicgstab_t{}, a, b, std::forward<X>(x), workspace, options);
+		}
+	};
+
+	inline constexpr auto bicgstab = bicgstab_t{};
+} // namespace mpp
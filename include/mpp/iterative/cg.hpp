@@ -0,0 +1,232 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/cpo_base.hpp>
+#include <mpp/detail/util/krylov_impl.hpp>
+#include <mpp/iterative/krylov.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace mpp
+{
+	namespace detail
+	{
+		template<typename T, typename Op, typename Precond, typename Callback>
+		[[nodiscard]] inline auto cg_impl(const Op& a,
+			std::span<const T> b,
+			std::span<T> x,
+			std::span<T> vectors,
+			[[maybe_unused]] const Precond& precond,
+			const krylov_options& options,
+			Callback& callback) -> krylov_result
+		{
+			const auto n = b.size();
+
+			assert(x.size() == n && vectors.size() >= 4 * n);
+			assert_operator_size(a, n);
+
+			// Without a preconditioner, the preconditioned residual z is r
+			auto* const r = vectors.data();
+			auto* const p = r + n;
+			auto* const q = p + n;
+			auto* const z = is_preconditioned<Precond> ? q + n : r;
+
+			const auto op_scratch = vectors.subspan(4 * n);
+
+			auto result       = krylov_result{};
+			const auto b_norm = krylov_norm(krylov_dot(n, b.data(), b.data()));
+
+			// x = 0 solves it exactly, and the relative residual doesn't exist
+			if (b_norm == 0.0)
+			{
+				std::ranges::fill(x, T{});
+				result.converged = true;
+				return result;
+			}
+
+			const auto finished = [&](T rr) {
+				result.residual  = krylov_norm(rr) / b_norm;
+				result.converged = result.residual <= options.tolerance;
+
+				return result.converged || result.iterations >= options.max_iterations;
+			};
+
+			apply_operator(a, n, x.data(), q, op_scratch);
+
+			auto rz = krylov_residual(n, b.data(), q, r);
+
+			if (finished(rz))
+			{
+				return result;
+			}
+
+			if constexpr (is_preconditioned<Precond>)
+			{
+				apply_preconditioner(precond, n, r, z);
+				rz = krylov_dot(n, r, z);
+			}
+
+			krylov_copy(n, z, p);
+
+			while (true)
+			{
+				apply_operator(a, n, p, q, op_scratch);
+
+				// A isn't positive definite when the curvature along p isn't positive
+				const auto pq = krylov_dot(n, p, q);
+
+				if (!(pq > T{}))
+				{
+					break;
+				}
+
+				const auto rr = cg_update(n, rz / pq, p, q, x.data(), r);
+
+				++result.iterations;
+
+				const auto stop = finished(rr);
+
+				if (!report_iteration(callback, result) || stop)
+				{
+					break;
+				}
+
+				auto rz_next = rr;
+
+				if constexpr (is_preconditioned<Precond>)
+				{
+					apply_preconditioner(precond, n, r, z);
+					rz_next = krylov_dot(n, r, z);
+				}
+
+				krylov_xpby(n, z, rz_next / rz, p);
+				rz = rz_next;
+			}
+
+			return result;
+		}
+	} // namespace detail
+
+	struct cg_t : public detail::cpo_base<cg_t>
+	{
+		static constexpr auto name = std::string_view{ "cg" };
+
+		/**
+		 * Elements of krylov_workspace a system of n unknowns needs, with or without a preconditioner
+		 */
+		[[nodiscard]] static constexpr auto workspace_size(std::size_t n, const krylov_options& = {}) noexcept
+			-> std::size_t // @TODO: ISSUE #20
+		{
+			return 4 * n;
+		}
+
+		/**
+		 * Elements of krylov_workspace solving with a needs, the vectors along with the scratch of multiplying by a
+		 */
+		template<typename Op>
+		[[nodiscard]] static auto workspace_size(const Op& a, std::size_t n, const krylov_options& options = {})
+			-> std::size_t // @TODO: ISSUE #20
+		{
+			return workspace_size(n, options) + detail::operator_scratch_size(a);
+		}
+
+		/**
+		 * Solves A * x = b for a symmetric positive definite A with conjugate gradients, starting from the values in
+		 * x. Every iteration applies A once and makes three passes over the vectors: a dot product, the updates of x
+		 * and r along with the norm of r, and the new direction
+		 */
+		template<typename Op,
+			std::ranges::contiguous_range B,
+			std::ranges::contiguous_range X,
+			typename Callback = detail::no_callback>
+		requires linear_operator<Op, std::ranges::range_value_t<X>> &&
+			std::same_as<std::ranges::range_value_t<B>, std::ranges::range_value_t<X>> && krylov_callback<Callback>
+		friend inline auto tag_invoke(cg_t,
+			const Op& a,
+			const B& b,
+			X&& x,
+			krylov_workspace<std::ranges::range_value_t<X>>& workspace,
+			const krylov_options& options = {},
+			Callback callback             = {}) -> krylov_result // @TODO: ISSUE #20
+		{
+			return tag_invoke(cg_t{},
+				a,
+				b,
+				std::forward<X>(x),
+				workspace,
+				detail::no_preconditioner{},
+				options,
+				std::move(callback));
+		}
+
+		/**
+		 * Preconditioned conjugate gradients, for a symmetric positive definite preconditioner. Every iteration
+		 * also applies the preconditioner and takes one more dot product
+		 */
+		template<typename Op,
+			std::ranges::contiguous_range B,
+			std::ranges::contiguous_range X,
+			typename Precond,
+			typename Callback = detail::no_callback>
+		requires linear_operator<Op, std::ranges::range_value_t<X>> &&
+			std::same_as<std::ranges::range_value_t<B>, std::ranges::range_value_t<X>> &&
+			preconditioner<Precond, std::ranges::range_value_t<X>> && krylov_callback<Callback>
+		friend inline auto tag_invoke(cg_t,
+			const Op& a,
+			const B& b,
+			X&& x,
+			krylov_workspace<std::ranges::range_value_t<X>>& workspace,
+			[[maybe_unused]] const Precond& precond,
+			const krylov_options& options = {},
+			Callback callback             = {}) -> krylov_result // @TODO: ISSUE #20
+		{
+			using value_type = std::ranges::range_value_t<X>;
+
+			const auto n = std::ranges::size(b);
+
+			return detail::cg_impl<value_type>(a,
+				std::span<const value_type>{ std::ranges::data(b), n },
+				std::span<value_type>{ std::ranges::data(x), std::ranges::size(x) },
+				workspace.take(workspace_size(a, n)),
+				precond,
+				options,
+				callback);
+		}
+
+		template<typename Op, std::ranges::contiguous_range B, std::ranges::contiguous_range X>
+		requires linear_operator<Op, std::ranges::range_value_t<X>> &&
+			std::same_as<std::ranges::range_value_t<B>, std::ranges::range_value_t<X>>
+		friend inline auto tag_invoke(cg_t, const Op& a, const B& b, X&& x, const krylov_options& options = {})
+			-> krylov_result // @TODO: ISSUE #20
+		{
+			auto workspace = krylov_workspace<std::ranges::range_value_t<X>>{};
+			return tag_invoke(cg_t{}, a, b, std::forward<X>(x), workspace, options);
+		}
+	};
+
+	inline constexpr auto cg = cg_t{};
+} // namespace mpp
@@ -0,0 +1,342 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/cpo_base.hpp>
+#include <mpp/detail/util/krylov_impl.hpp>
+#include <mpp/iterative/krylov.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <utility>
+
+namespace mpp
+{
+	namespace detail
+	{
+		// GMRES orthogonalizes twice when the first pass cancels more than this share of the norm
+		inline constexpr auto gmres_reorth_ratio = 0.7071;
+
+		[[nodiscard]] constexpr auto gmres_restart(std::size_t n, const krylov_options& options) noexcept -> std::size_t
+		{
+			return std::clamp(options.restart, std::size_t{ 1 }, std::max(n, std::size_t{ 1 }));
+		}
+
+		[[nodiscard]] constexpr auto gmres_workspace_size(std::size_t n, const krylov_options& options) noexcept
+			-> std::size_t
+		{
+			const auto m = gmres_restart(n, options);
+
+			// Basis, preconditioned vector, Hessenberg matrix, rotations, right hand side, projections and their
+			// partial sums
+			return (m + 2) * n + (m + 1) * m + 2 * m + (m + 1) + 2 * (m + 2) + (m + 2) * krylov_max_parts;
+		}
+
+		template<typename T, typename Op, typename Precond, typename Callback>
+		[[nodiscard]] inline auto gmres_impl(const Op& a,
+			std::span<const T> b,
+			std::span<T> x,
+			std::span<T> workspace,
+			[[maybe_unused]] const Precond& precond,
+			const krylov_options& options,
+			Callback& callback) -> krylov_result
+		{
+			const auto n = b.size();
+			const auto m = gmres_restart(n, options);
+
+			assert(x.size() == n && workspace.size() >= gmres_workspace_size(n, options));
+			assert_operator_size(a, n);
+
+			// basis holds m + 1 vectors one after the other, and hessenberg m columns of m + 1 elements
+			auto* const basis      = workspace.data();
+			auto* const z          = basis + (m + 1) * n;
+			auto* const hessenberg = z + n;
+			auto* const cosines    = hessenberg + (m + 1) * m;
+			auto* const sines      = cosines + m;
+			auto* const rhs        = sines + m;
+			auto* const proj       = rhs + (m + 1);
+			auto* const reproj     = proj + (m + 2);
+			const auto partials    = std::span<T>{ reproj + (m + 2), (m + 2) * krylov_max_parts };
+			const auto op_scratch  = workspace.subspan(gmres_workspace_size(n, options));
+
+			auto result       = krylov_result{};
+			const auto b_norm = krylov_norm(krylov_dot(n, b.data(), b.data()));
+
+			// x = 0 solves it exactly, and the relative residual doesn't exist
+			if (b_norm == 0.0)
+			{
+				std::ranges::fill(x, T{});
+				result.converged = true;
+				return result;
+			}
+
+			const auto finished = [&](T rr) {
+				result.residual  = krylov_norm(rr) / b_norm;
+				result.converged = result.residual <= options.tolerance;
+
+				return result.converged || result.iterations >= options.max_iterations;
+			};
+
+			// The first basis vector is the residual, which every restart computes anew from x
+			apply_operator(a, n, x.data(), basis, op_scratch);
+
+			if (finished(krylov_residual(n, b.data(), basis, basis)))
+			{
+				return result;
+			}
+
+			auto stop = false;
+
+			while (!stop)
+			{
+				const auto beta = static_cast<T>(result.residual * b_norm);
+
+				krylov_scale(n, T{ 1 } / beta, basis, basis);
+				std::fill_n(rhs, m + 1, T{});
+				rhs[0] = beta;
+
+				auto cols = std::size_t{};
+
+				while (cols < m)
+				{
+					const auto* const v = basis + cols * n;
+					auto* const w       = basis + (cols + 1) * n;
+					auto* const h       = hessenberg + cols * (m + 1);
+
+					// Preconditioning on the right multiplies by A * M^-1, so the residual stays the one of A
+					if constexpr (is_preconditioned<Precond>)
+					{
+						apply_preconditioner(precond, n, v, z);
+						apply_operator(a, n, z, w, op_scratch);
+					}
+					else
+					{
+						apply_operator(a, n, v, w, op_scratch);
+					}
+
+					// Classical Gram-Schmidt projects onto the whole basis in one pass, and again if that pass
+					// cancelled most of w, which is as accurate as modified Gram-Schmidt with fewer passes over memory
+					krylov_multi_dot(n, basis, cols + 1, w, proj, partials);
+
+					auto ww = krylov_multi_axpy(n, basis, cols + 1, proj, w);
+					std::copy_n(proj, cols + 1, h);
+
+					if (krylov_norm(ww) < gmres_reorth_ratio * krylov_norm(proj[cols + 1]))
+					{
+						krylov_multi_dot(n, basis, cols + 1, w, reproj, partials);
+						ww = krylov_multi_axpy(n, basis, cols + 1, reproj, w);
+
+						for (auto row = std::size_t{}; row <= cols; ++row)
+						{
+							h[row] += reproj[row];
+						}
+					}
+
+					const auto w_norm = static_cast<T>(krylov_norm(ww));
+					h[cols + 1]       = w_norm;
+
+					// Givens rotations keep the Hessenberg matrix upper triangular, and the last element of the
+					// rotated right hand side is the residual norm
+					for (auto row = std::size_t{}; row < cols; ++row)
+					{
+						const auto upper = h[row];
+
+						h[row]     = cosines[row] * upper + sines[row] * h[row + 1];
+						h[row + 1] = cosines[row] * h[row + 1] - sines[row] * upper;
+					}
+
+					const auto radius = std::hypot(h[cols], h[cols + 1]);
+
+					cosines[cols] = radius == T{} ? T{ 1 } : h[cols] / radius;
+					sines[cols]   = radius == T{} ? T{} : h[cols + 1] / radius;
+					h[cols]       = radius;
+					h[cols + 1]   = T{};
+
+					rhs[cols + 1] = -sines[cols] * rhs[cols];
+					rhs[cols]     = cosines[cols] * rhs[cols];
+
+					++cols;
+					++result.iterations;
+
+					stop = finished(rhs[cols] * rhs[cols]);
+					stop = !report_iteration(callback, result) || stop;
+
+					// w_norm is zero when the basis spans the solution already
+					if (stop || w_norm == T{})
+					{
+						break;
+					}
+
+					krylov_scale(n, T{ 1 } / w_norm, w, w);
+				}
+
+				// The least squares solution is H^-1 * rhs, up to the first zero pivot if A is singular
+				for (auto col = std::size_t{}; col < cols; ++col)
+				{
+					if (hessenberg[col * (m + 1) + col] == T{})
+					{
+						cols = col;
+					}
+				}
+
+				for (auto row = cols; row-- > 0;)
+				{
+					for (auto col = row + 1; col < cols; ++col)
+					{
+						rhs[row] -= hessenberg[col * (m + 1) + row] * rhs[col];
+					}
+
+					rhs[row] /= hessenberg[row * (m + 1) + row];
+				}
+
+				// x += M^-1 * basis * y, written as x -= basis * -y to share the projection kernel
+				for (auto row = std::size_t{}; row < cols; ++row)
+				{
+					rhs[row] = -rhs[row];
+				}
+
+				if constexpr (is_preconditioned<Precond>)
+				{
+					std::fill_n(z, n, T{});
+					static_cast<void>(krylov_multi_axpy(n, basis, cols, rhs, z));
+
+					// The basis is rebuilt from the new residual anyway
+					apply_preconditioner(precond, n, z, basis);
+					krylov_axpy(n, T{ 1 }, basis, x.data());
+				}
+				else
+				{
+					static_cast<void>(krylov_multi_axpy(n, basis, cols, rhs, x.data()));
+				}
+
+				// The rotated right hand side only estimates the residual, the true one decides whether to restart
+				apply_operator(a, n, x.data(), basis, op_scratch);
+				stop = finished(krylov_residual(n, b.data(), basis, basis)) || stop || cols == 0;
+			}
+
+			return result;
+		}
+	} // namespace detail
+
+	struct gmres_t : public detail::cpo_base<gmres_t>
+	{
+		static constexpr auto name = std::string_view{ "gmres" };
+
+		/**
+		 * Elements of krylov_workspace a system of n unknowns needs, with or without a preconditioner
+		 */
+		[[nodiscard]] static constexpr auto workspace_size(std::size_t n, const krylov_options& options = {}) noexcept
+			-> std::size_t // @TODO: ISSUE #20
+		{
+			return detail::gmres_workspace_size(n, options);
+		}
+
+		/**
+		 * Elements of krylov_workspace solving with a needs, the vectors along with the scratch of multiplying by a
+		 */
+		template<typename Op>
+		[[nodiscard]] static auto workspace_size(const Op& a, std::size_t n, const krylov_options& options = {})
+			-> std::size_t // @TODO: ISSUE #20
+		{
+			return workspace_size(n, options) + detail::operator_scratch_size(a);
+		}
+
+		/**
+		 * Solves A * x = b for a square A with GMRES, restarted every options.restart iterations, starting from the
+		 * values in x. Every iteration applies A once and makes three passes over the basis (projecting onto it,
+		 * subtracting the projections along with the norm of what's left, and normalizing), plus two more when the
+		 * projections need to be repeated
+		 */
+		template<typename Op,
+			std::ranges::contiguous_range B,
+			std::ranges::contiguous_range X,
+			typename Callback = detail::no_callback>
+		requires linear_operator<Op, std::ranges::range_value_t<X>> &&
+			std::same_as<std::ranges::range_value_t<B>, std::ranges::range_value_t<X>> && krylov_callback<Callback>
+		friend inline auto tag_invoke(gmres_t,
+			const Op& a,
+			const B& b,
+			X&& x,
+			krylov_workspace<std::ranges::range_value_t<X>>& workspace,
+			const krylov_options& options = {},
+			Callback callback             = {}) -> krylov_result // @TODO: ISSUE #20
+		{
+			return tag_invoke(gmres_t{},
+				a,
+				b,
+				std::forward<X>(x),
+				workspace,
+				detail::no_preconditioner{},
+				options,
+				std::move(callback));
+		}
+
+		/**
+		 * GMRES preconditioned on the right, so the residual it stops on is the one of the original system. Every
+		 * iteration also applies the preconditioner, and so does every restart
+		 */
+		template<typename Op,
+			std::ranges::contiguous_range B,
+			std::ranges::contiguous_range X,
+			typename Precond,
+			typename Callback = detail::no_callback>
+		requires linear_operator<Op, std::ranges::range_value_t<X>> &&
+			std::same_as<std::ranges::range_value_t<B>, std::ranges::range_value_t<X>> &&
+			preconditioner<Precond, std::ranges::range_value_t<X>> && krylov_callback<Callback>
+		friend inline auto tag_invoke(gmres_t,
+			const Op& a,
+			const B& b,
+			X&& x,
+			krylov_workspace<std::ranges::range_value_t<X>>& workspace,
+			[[maybe_unused]] const Precond& precond,
+			const krylov_options& options = {},
+			Callback callback             = {}) -> krylov_result // @TODO: ISSUE #20
+		{
+			using value_type = std::ranges::range_value_t<X>;
+
+			const auto n = std::ranges::size(b);
+
+			return detail::gmres_impl<value_type>(a,
+				std::span<const value_type>{ std::ranges::data(b), n },
+				std::span<value_type>{ std::ranges::data(x), std::ranges::size(x) },
+				workspace.take(workspace_size(a, n, options)),
+				precond,
+				options,
+				callback);
+		}
+
+		template<typename Op, std::ranges::contiguous_range B, std::ranges::contiguous_range X>
+		requires linear_operator<Op, std::ranges::range_value_t<X>> &&
+			std::same_as<std::ranges::range_value_t<B>, std::ranges::range_value_t<X>>
+		friend inline auto tag_invoke(gmres_t, const Op& a, const B& b, X&& x, const krylov_options& options = {})
+			-> krylov_result // @TODO: ISSUE #20
+		{
+			auto workspace = krylov_workspace<std::ranges::range_value_t<X>>{};
+			return tag_invoke(gmres_t{}, a, b, std::forward<X>(x), workspace, options);
+		}
+	};
+
+	inline constexpr auto gmres = gmres_t{};
+} // namespace mpp
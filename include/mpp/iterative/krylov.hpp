@@ -0,0 +1,230 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/krylov_impl.hpp>
+#include <mpp/detail/util/sparse_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/sparse/sparse_mat.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace mpp
+{
+	/**
+	 * When the iterative solvers stop: once ||b - A * x|| <= tolerance * ||b||, or after max_iterations
+	 */
+	struct krylov_options
+	{
+		double tolerance           = 1e-10;
+		std::size_t max_iterations = 1000;
+
+		// Basis vectors GMRES builds before it restarts
+		std::size_t restart = 30;
+	};
+
+	struct krylov_result
+	{
+		bool converged         = false;
+		std::size_t iterations = 0;
+
+		// ||b - A * x|| / ||b|| when the solver stopped
+		double residual = 0.0;
+	};
+
+	/**
+	 * Memory of the iterative solvers. It grows to what a solve needs and is kept for the next ones, so solves
+	 * reusing a workspace don't allocate
+	 */
+	template<typename T>
+	class krylov_workspace
+	{
+		detail::scratch_vector<T> buf_;
+
+	public:
+		krylov_workspace() = default;
+
+		explicit krylov_workspace(std::size_t size) :
+			buf_(size) // @TODO: ISSUE #20
+		{
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return buf_.size();
+		}
+
+		/**
+		 * The first `size` elements, after growing if there are fewer
+		 */
+		[[nodiscard]] auto take(std::size_t size) -> std::span<T> // @TODO: ISSUE #20
+		{
+			if (buf_.size() < size)
+			{
+				buf_.resize(size);
+			}
+
+			return { buf_.data(), size };
+		}
+	};
+
+	/**
+	 * What the iterative solvers can multiply vectors with: dense matrices (and other expressions with strides),
+	 * sparse matrices, and callables writing y = A * x when called as op(std::span<const T> x, std::span<T> y)
+	 */
+	template<typename Op, typename T>
+	concept linear_operator = detail::strided_expr<Op> || detail::is_sparse<Op>::value ||
+		std::invocable<const Op&, std::span<const T>, std::span<T>>;
+
+	/**
+	 * Approximate inverse of A that the solvers apply to residuals, as z = M^-1 * r with p.apply(r, z). Solvers that
+	 * aren't given one use the identity
+	 */
+	template<typename P, typename T>
+	concept preconditioner = requires(const P& precond, std::span<const T> r, std::span<T> z)
+	{
+		precond.apply(r, z);
+	};
+
+	/**
+	 * Called after every iteration with the number of iterations so far and the relative residual. Returning false
+	 * (if it returns anything) stops the solver
+	 */
+	template<typename Callback>
+	concept krylov_callback = std::invocable<Callback&, std::size_t, double>;
+
+	namespace detail
+	{
+		struct no_callback
+		{
+			void operator()(std::size_t, double) const noexcept {}
+		};
+
+		// The identity, which the solvers skip
+		struct no_preconditioner
+		{
+			template<typename T>
+			void apply(std::span<const T> r, std::span<T> z) const
+			{
+				std::ranges::copy(r, z.begin());
+			}
+		};
+
+		template<typename Precond>
+		inline constexpr bool is_preconditioned = !std::is_same_v<Precond, no_preconditioner>;
+
+		/**
+		 * z = M^-1 * r for vectors of n elements
+		 */
+		template<typename T, typename Precond>
+		inline void apply_preconditioner(const Precond& precond, std::size_t n, const T* r, T* z)
+		{
+			precond.apply(std::span<const T>{ r, n }, std::span<T>{ z, n });
+		}
+
+		template<typename Op>
+		inline void assert_operator_size([[maybe_unused]] const Op& a, [[maybe_unused]] std::size_t n)
+		{
+			if constexpr (strided_expr<Op> || is_sparse<Op>::value)
+			{
+				assert(a.rows() == n && a.cols() == n);
+			}
+		}
+
+		/**
+		 * Elements of scratch apply_operator needs to not allocate, which only sparse matrices in compressed columns do
+		 * when they're multiplied on several threads
+		 */
+		template<typename Op>
+		[[nodiscard]] inline auto operator_scratch_size([[maybe_unused]] const Op& a) -> std::size_t
+		{
+			if constexpr (is_sparse<Op>::value)
+			{
+				if constexpr (!Op::format_type::compresses_rows)
+				{
+					return csc_mul_scratch_size(compressed_of(a), a.rows(), 1);
+				}
+			}
+
+			return 0;
+		}
+
+		/**
+		 * y = a * x for vectors of n elements, with scratch of operator_scratch_size(a) elements
+		 */
+		template<typename T, typename Op>
+		inline void apply_operator(const Op& a,
+			[[maybe_unused]] std::size_t n,
+			const T* x,
+			T* y,
+			[[maybe_unused]] std::span<T> scratch)
+		{
+			if constexpr (is_sparse<Op>::value)
+			{
+				const auto x_view = strided_view<const T>{ x, 1, 1 };
+				const auto y_view = strided_view<T>{ y, 1, 1 };
+
+				if constexpr (Op::format_type::compresses_rows)
+				{
+					csr_mul(compressed_of(a), x_view, y_view, 1);
+				}
+				else
+				{
+					csc_mul(compressed_of(a), a.rows(), x_view, y_view, 1, scratch);
+				}
+			}
+			else if constexpr (strided_expr<Op>)
+			{
+				dense_matvec(strided_of(a), a.rows(), a.cols(), x, y);
+			}
+			else
+			{
+				a(std::span<const T>{ x, n }, std::span<T>{ y, n });
+			}
+		}
+
+		template<typename Callback>
+		[[nodiscard]] inline auto report_iteration(Callback& callback, const krylov_result& result) -> bool
+		{
+			if constexpr (std::is_same_v<std::invoke_result_t<Callback&, std::size_t, double>, bool>)
+			{
+				return callback(result.iterations, result.residual);
+			}
+			else
+			{
+				callback(result.iterations, result.residual);
+				return true;
+			}
+		}
+
+		template<typename T>
+		[[nodiscard]] inline auto krylov_norm(T squared) -> double
+		{
+			return std::sqrt(static_cast<double>(squared));
+		}
+	} // namespace detail
+} // namespace mpp
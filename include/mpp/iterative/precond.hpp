@@ -0,0 +1,294 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/algo/inv.hpp>
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/krylov_impl.hpp>
+#include <mpp/detail/util/precond_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/iterative/krylov.hpp>
+#include <mpp/sparse/sparse_mat.hpp>
+#include <mpp/mat.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace mpp
+{
+	/**
+	 * Preconditioners for the iterative solvers. They do all their work and allocations when they're built, so
+	 * applying them every iteration doesn't allocate
+	 */
+
+	/**
+	 * M = diag(A)
+	 */
+	template<typename T>
+	class jacobi_preconditioner
+	{
+		std::vector<T> inv_diag_;
+
+	public:
+		jacobi_preconditioner() = default;
+
+		template<typename Derived>
+		explicit jacobi_preconditioner(const detail::expr_base<Derived, T>& obj) :
+			inv_diag_(obj.rows()) // @TODO: ISSUE #20
+		{
+			assert(obj.rows() == obj.cols());
+
+			for (auto idx = std::size_t{}; idx < obj.rows(); ++idx)
+			{
+				const auto diag = obj(idx, idx);
+
+				assert(!detail::is_zero_or_nan(diag));
+
+				inv_diag_[idx] = T{ 1 } / diag;
+			}
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return inv_diag_.size();
+		}
+
+		void apply(std::span<const T> r, std::span<T> z) const // @TODO: ISSUE #20
+		{
+			assert(r.size() == size() && z.size() == size());
+
+			detail::for_each_vector_part(size(), size(), [&](std::size_t, std::size_t first, std::size_t last) {
+				for (auto idx = first; idx < last; ++idx)
+				{
+					z[idx] = inv_diag_[idx] * r[idx];
+				}
+			});
+		}
+	};
+
+	/**
+	 * M = the blocks of block_size x block_size on the diagonal of A (the last one smaller if block_size doesn't
+	 * divide the size), which are inverted with inv when it's built
+	 */
+	template<typename T>
+	class block_jacobi_preconditioner
+	{
+		std::size_t size_       = 0;
+		std::size_t block_size_ = 1;
+
+		// Row major inverses of the blocks, one after the other
+		std::vector<T> inverses_;
+
+	public:
+		block_jacobi_preconditioner() = default;
+
+		template<typename Derived>
+		block_jacobi_preconditioner(const detail::expr_base<Derived, T>& obj, std::size_t block_size) :
+			size_(obj.rows()),
+			block_size_(block_size) // @TODO: ISSUE #20
+		{
+			assert(obj.rows() == obj.cols() && block_size > 0);
+
+			inverses_.reserve(size_ * block_size_);
+
+			for (auto first = std::size_t{}; first < size_; first += block_size_)
+			{
+				const auto cols  = std::min(block_size_, size_ - first);
+				const auto block = mat<T>(cols, cols, [&, idx = std::size_t{}]() mutable {
+					const auto row = idx / cols;
+					const auto col = idx++ % cols;
+
+					return obj(first + row, first + col);
+				});
+
+				const auto inverse = inv(block);
+
+				for (auto row = std::size_t{}; row < cols; ++row)
+				{
+					for (auto col = std::size_t{}; col < cols; ++col)
+					{
+						inverses_.push_back(inverse(row, col));
+					}
+				}
+			}
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return size_;
+		}
+
+		[[nodiscard]] auto block_size() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return block_size_;
+		}
+
+		void apply(std::span<const T> r, std::span<T> z) const // @TODO: ISSUE #20
+		{
+			assert(r.size() == size_ && z.size() == size_);
+
+			const auto blocks = detail::div_round_up(size_, block_size_);
+
+			const auto apply_blocks = [&](std::size_t, std::size_t first, std::size_t last) {
+				for (auto block = first; block < last; ++block)
+				{
+					const auto offset         = block * block_size_;
+					const auto cols           = std::min(block_size_, size_ - offset);
+					const auto* const inverse = inverses_.data() + offset * block_size_;
+
+					for (auto row = std::size_t{}; row < cols; ++row)
+					{
+						auto sum = T{};
+
+						for (auto col = std::size_t{}; col < cols; ++col)
+						{
+							sum += inverse[row * cols + col] * r[offset + col];
+						}
+
+						z[offset + row] = sum;
+					}
+				}
+			};
+
+			detail::for_each_vector_part(blocks, size_ * block_size_, apply_blocks);
+		}
+	};
+
+	/**
+	 * M = L * U, the incomplete LU factorization of a sparse A without fill-in: L and U only have nonzeros where A
+	 * does. Their triangular solves are level scheduled, so rows that don't depend on each other are solved in
+	 * parallel
+	 */
+	template<typename T>
+	class ilu0_preconditioner
+	{
+		detail::level_scheduled_factor<T> l_;
+		detail::level_scheduled_factor<T> u_;
+
+	public:
+		ilu0_preconditioner() = default;
+
+		/**
+		 * A must have all of its diagonal, and no pivots may turn out zero
+		 */
+		template<typename Format>
+		explicit ilu0_preconditioner(const sparse_mat<T, Format>& obj) // @TODO: ISSUE #20
+		{
+			assert(obj.rows() == obj.cols());
+
+			if constexpr (Format::compresses_rows)
+			{
+				detail::ilu0<T>(obj.offsets(), obj.indices(), obj.values(), l_, u_);
+			}
+			else
+			{
+				const auto rows = sparse_mat<T, csr>{ obj };
+				detail::ilu0<T>(rows.offsets(), rows.indices(), rows.values(), l_, u_);
+			}
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return l_.offsets.size() - 1;
+		}
+
+		/**
+		 * Levels of the solves with L and with U, every level waits for the one before it
+		 */
+		[[nodiscard]] auto levels() const noexcept -> std::pair<std::size_t, std::size_t> // @TODO: ISSUE #20
+		{
+			return { l_.level_offsets.size() - 1, u_.level_offsets.size() - 1 };
+		}
+
+		void apply(std::span<const T> r, std::span<T> z) const // @TODO: ISSUE #20
+		{
+			assert(r.size() == size() && z.size() == size());
+
+			if (r.data() != z.data())
+			{
+				detail::krylov_copy(size(), r.data(), z.data());
+			}
+
+			detail::level_scheduled_solve(l_, z.data());
+			detail::level_scheduled_solve(u_, z.data());
+		}
+	};
+
+	/**
+	 * M = L * L^T, the incomplete Cholesky factorization of a symmetric positive definite sparse A without fill-in,
+	 * from its lower triangle. The triangular solves are level scheduled like those of ilu0_preconditioner
+	 */
+	template<typename T>
+	class ic0_preconditioner
+	{
+		detail::level_scheduled_factor<T> l_;
+		detail::level_scheduled_factor<T> lt_;
+
+	public:
+		ic0_preconditioner() = default;
+
+		/**
+		 * A must have all of its diagonal, and the factorization must not break down, which it can for matrices
+		 * that are far from diagonally dominant
+		 */
+		template<typename Format>
+		explicit ic0_preconditioner(const sparse_mat<T, Format>& obj) // @TODO: ISSUE #20
+		{
+			assert(obj.rows() == obj.cols());
+
+			if constexpr (Format::compresses_rows)
+			{
+				detail::ic0<T>(obj.offsets(), obj.indices(), obj.values(), l_, lt_);
+			}
+			else
+			{
+				const auto rows = sparse_mat<T, csr>{ obj };
+				detail::ic0<T>(rows.offsets(), rows.indices(), rows.values(), l_, lt_);
+			}
+		}
+
+		[[nodiscard]] auto size() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return l_.offsets.size() - 1;
+		}
+
+		[[nodiscard]] auto levels() const noexcept -> std::pair<std::size_t, std::size_t> // @TODO: ISSUE #20
+		{
+			return { l_.level_offsets.size() - 1, lt_.level_offsets.size() - 1 };
+		}
+
+		void apply(std::span<const T> r, std::span<T> z) const // @TODO: ISSUE #20
+		{
+			assert(r.size() == size() && z.size() == size());
+
+			if (r.data() != z.data())
+			{
+				detail::krylov_copy(size(), r.data(), z.data());
+			}
+
+			detail::level_scheduled_solve(l_, z.data());
+			detail::level_scheduled_solve(lt_, z.data());
+		}
+	};
+} // namespace mpp
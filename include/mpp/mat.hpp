@@ -22,26 +22,46 @@
 #include <mpp/detail/expr/expr_base.hpp>
 #include <mpp/detail/mat/mat_iter.hpp>
 #include <mpp/detail/util/public.hpp>
+#include <mpp/detail/util/trps_impl.hpp>
 #include <mpp/detail/util/util.hpp>
 
+#ifdef MPP_INSTRUMENT
+	#include <mpp/detail/util/instrument.hpp>
+#endif
+
 #include <algorithm>
+#include <cassert>
 #include <concepts>
 #include <cstddef>
 #include <initializer_list>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace mpp
 {
-	template<detail::arithmetic T, typename Buf = std::vector<T>>
-	class mat : public detail::expr_base<mat<T, Buf>, T>
+	template<detail::arithmetic T, typename Buf = std::vector<T>, typename Layout = row_major>
+	class mat : public detail::expr_base<mat<T, Buf, Layout>, T>
 	{
-		static_assert(is_dyn_buf<Buf> || is_fixed_buf<Buf>, "Buffer not supported");
+		static_assert(is_dyn_buf<Buf> || is_fixed_buf<Buf> || is_view_buf<Buf>, "Buffer not supported");
 		static_assert(!(is_dyn_buf<Buf> && is_fixed_buf<Buf>), "Buffer can't be both dynamic and fixed");
 
-		Buf buf_; // stores flattened data in row major
+		Buf buf_; // stores flattened data in the order given by Layout
 		std::size_t rows_;
 		std::size_t cols_;
 
+		[[nodiscard]] auto idx(std::size_t row, std::size_t col) const noexcept -> std::size_t
+		{
+			return detail::idx_1d<Layout>(rows_, cols_, row, col);
+		}
+
+		template<typename Iter>
+		[[nodiscard]] auto make_iter(auto it) const noexcept -> Iter
+		{
+			const auto [rs, cs] = Layout::strides(rows_, cols_);
+			return Iter(it, rs, cs);
+		}
+
 		template<bool Moved>
 		void assign_rng_2d(auto&& rng)
 		{
@@ -53,25 +73,45 @@ namespace mpp
 			auto rng_end                    = std::ranges::end(rng);
 			const auto [rng_rows, rng_cols] = detail::rng2d_dims(rng);
 
-			detail::resize_buf_if_dyn(buf_, rng_rows, rng_cols, T{});
-			auto buf_begin = std::ranges::begin(buf_);
-
-			using difference_type = typename Buf::difference_type;
+			detail::resize_buf_if_dyn<Layout>(buf_, rng_rows, rng_cols, T{});
+			rows_ = rng_rows;
+			cols_ = rng_cols;
 
-			for (; rng_begin != rng_end; ++rng_begin, buf_begin += static_cast<difference_type>(rng_cols))
+			if constexpr (std::is_same_v<Layout, row_major>)
 			{
-				if constexpr (Moved)
+				auto buf_begin = std::ranges::begin(buf_);
+
+				using difference_type = typename Buf::difference_type;
+
+				for (; rng_begin != rng_end; ++rng_begin, buf_begin += static_cast<difference_type>(rng_cols))
 				{
-					std::ranges::move(*rng_begin, buf_begin);
+					if constexpr (Moved)
+					{
+						std::ranges::move(*rng_begin, buf_begin);
+					}
+					else
+					{
+						std::ranges::copy(*rng_begin, buf_begin);
+					}
 				}
-				else
+			}
+			else
+			{
+				for (auto row = std::size_t{}; rng_begin != rng_end; ++rng_begin, ++row)
 				{
-					std::ranges::copy(*rng_begin, buf_begin);
+					for (auto col = std::size_t{}; auto&& val : *rng_begin)
+					{
+						if constexpr (Moved)
+						{
+							buf_[idx(row, col++)] = static_cast<T>(std::move(val));
+						}
+						else
+						{
+							buf_[idx(row, col++)] = static_cast<T>(val);
+						}
+					}
 				}
 			}
-
-			rows_ = rng_rows;
-			cols_ = rng_cols;
 		}
 
 		template<bool Moved>
@@ -80,19 +120,63 @@ namespace mpp
 			// Preconditions:
 			// rng is the same size as the specified matrix size (fixed matrices only)
 
-			detail::resize_buf_if_dyn(buf_, rows, cols, T{});
+			// The range is read in storage order, padded layouts only skip over their padding
+
+			detail::resize_buf_if_dyn<Layout>(buf_, rows, cols, T{});
+			rows_ = rows;
+			cols_ = cols;
 
-			if constexpr (Moved)
+			if constexpr (!Layout::padded)
 			{
-				std::ranges::move(rng, std::ranges::begin(buf_));
+				if constexpr (Moved)
+				{
+					std::ranges::move(rng, std::ranges::begin(buf_));
+				}
+				else
+				{
+					std::ranges::copy(rng, std::ranges::begin(buf_));
+				}
 			}
 			else
 			{
-				std::ranges::copy(rng, std::ranges::begin(buf_));
+				auto rng_begin = std::ranges::begin(rng);
+
+				for (auto row = std::size_t{}; row < rows; ++row)
+				{
+					for (auto col = std::size_t{}; col < cols; ++col, ++rng_begin)
+					{
+						if constexpr (Moved)
+						{
+							buf_[idx(row, col)] = static_cast<T>(std::ranges::iter_move(rng_begin));
+						}
+						else
+						{
+							buf_[idx(row, col)] = static_cast<T>(*rng_begin);
+						}
+					}
+				}
 			}
+		}
 
-			rows_ = rows;
-			cols_ = cols;
+		template<bool Moved, typename Mat>
+		void assign_mat(Mat&& obj)
+		{
+			const auto rows = obj.rows();
+			const auto cols = obj.cols();
+
+			if constexpr (std::is_same_v<typename std::remove_cvref_t<Mat>::layout_type, Layout> && !Layout::padded)
+			{
+				assign_rng_1d<Moved>(rows, cols, std::forward<Mat>(obj));
+			}
+			else
+			{
+				// Different storage orders have to be reordered, which the strided copy does a tile at a time
+				detail::resize_buf_if_dyn<Layout>(buf_, rows, cols, T{});
+				rows_ = rows;
+				cols_ = cols;
+
+				detail::copy_strided(rows, cols, detail::strided_of(obj), detail::strided_of_mut(*this));
+			}
 		}
 
 		template<typename Expr>
@@ -103,8 +187,10 @@ namespace mpp
 	public:
 		using value_type  = T;
 		using buffer_type = Buf;
+		using layout_type = Layout;
 
-		using reference       = value_type&;
+		// Read-only buffers (such as mapped files) hand out const references even from non-const matrices
+		using reference       = std::conditional_t<is_view_buf<Buf>, const value_type&, value_type&>;
 		using const_reference = const value_type&;
 		using pointer         = typename Buf::pointer;
 		using const_pointer   = typename Buf::const_pointer;
@@ -122,12 +208,10 @@ namespace mpp
 		mat(mat&&) noexcept(std::is_nothrow_move_constructible_v<Buf>)      = default;       // @TODO: ISSUE #20
 
 		template<detail::mat_with_value_convertible_to<T> Mat>
-		requires(!std::same_as<std::remove_cvref_t<Mat>, mat<T, Buf>>) explicit mat(Mat&& obj) // @TODO: ISSUE #20
+		requires(!std::same_as<std::remove_cvref_t<Mat>, mat<T, Buf, Layout>>) explicit mat(
+			Mat&& obj) // @TODO: ISSUE #20
 		{
-			const auto rows = std::forward<Mat>(obj).rows();
-			const auto cols = std::forward<Mat>(obj).cols();
-
-			assign_rng_1d<detail::is_moved<decltype(obj)>>(rows, cols, std::forward<Mat>(obj));
+			assign_mat<detail::is_moved<decltype(obj)>>(std::forward<Mat>(obj));
 		}
 
 		template<detail::rng_1d_with_value_convertible_to<T> Rng>
@@ -136,6 +220,23 @@ namespace mpp
 			assign_rng_1d<detail::is_moved<decltype(rng)>>(rows, cols, std::forward<Rng>(rng));
 		}
 
+		mat(size_type rows, size_type cols, Buf&& buf) noexcept(std::is_nothrow_move_constructible_v<Buf>) requires(
+			!Layout::padded) :
+			buf_(std::move(buf)),
+			rows_(rows),
+			cols_(cols) // @TODO: ISSUE #20
+		{
+			// Preconditions:
+			// buf holds the rows x cols elements in the order given by Layout
+
+			assert(std::ranges::size(buf_) >= Layout::buf_size(rows, cols));
+
+			// Padded layouts don't adopt buffers, so a buffer passed to them is read as a range like any other
+
+			// Taking over the buffer avoids copying it element by element, which is what algorithms rely on to return
+			// their results without an extra pass
+		}
+
 
 		template<std::convertible_to<T> T2>
 		explicit mat(std::initializer_list<std::initializer_list<T2>> init) // @TODO: ISSUE #20
@@ -151,29 +252,35 @@ namespace mpp
 
 		mat(size_type rows, size_type cols, const T& val = T{ 0 }) : rows_(rows), cols_(cols)
 		{
-			if constexpr (is_dyn_buf<Buf>)
-			{
-				buf_.resize(rows * cols, val);
-			}
-			else
-			{
-				std::ranges::fill(buf_, val);
-			}
+			detail::resize_or_fill_buf<Layout>(buf_, rows, cols, val);
 		}
 
 		mat(size_type rows, size_type cols, identity_tag, const T& zero_val = T{}, const T& one_val = T{ 1 }) :
 			rows_(rows),
 			cols_(cols) // @TODO: ISSUE #20
 		{
-			detail::init_identity_buf(buf_, rows, cols, zero_val, one_val);
+			detail::init_identity_buf<Layout>(buf_, rows, cols, zero_val, one_val);
 		}
 
 		template<detail::fn_with_return_type_convertible_to<T> Fn>
 		mat(size_type rows, size_type cols, Fn&& fn) : rows_(rows), cols_(cols) // @TODO: ISSUE #20
 		{
-			detail::resize_buf_if_dyn(buf_, rows, cols, T{});
+			detail::resize_buf_if_dyn<Layout>(buf_, rows, cols, T{});
 
-			std::ranges::generate(buf_, std::forward<Fn>(fn));
+			if constexpr (!Layout::padded)
+			{
+				std::ranges::generate(buf_, std::forward<Fn>(fn));
+			}
+			else
+			{
+				for (auto row = std::size_t{}; row < rows; ++row)
+				{
+					for (auto col = std::size_t{}; col < cols; ++col)
+					{
+						buf_[idx(row, col)] = fn();
+					}
+				}
+			}
 		}
 
 		template<typename Derived, std::convertible_to<T> T2>
@@ -181,14 +288,36 @@ namespace mpp
 			rows_(expr.rows()),
 			cols_(expr.cols()) // @TODO: ISSUE #20
 		{
-			detail::resize_buf_if_dyn(buf_, rows_, cols_, T{});
+#ifdef MPP_INSTRUMENT
+			const auto probe = detail::instrument::expr_probe(static_cast<const Derived&>(expr));
+#endif
+
+			detail::resize_buf_if_dyn<Layout>(buf_, rows_, cols_, T{});
 
-			auto buf_begin = std::ranges::begin(buf_);
-			for (auto row = std::size_t{}; row < rows_; ++row)
+			const auto out = detail::strided_of_mut(*this);
+
+			if constexpr (detail::evaluable_into<Derived, T>)
+			{
+				static_cast<const Derived&>(expr).eval_into(out);
+			}
+			else if (out.cs == 1)
+			{
+				for (auto row = std::size_t{}; row < rows_; ++row)
+				{
+					for (auto col = std::size_t{}; col < cols_; ++col)
+					{
+						out(row, col) = expr(row, col);
+					}
+				}
+			}
+			else
 			{
-				for (auto col = std::size_t{}; col < cols_; ++col, ++buf_begin)
+				for (auto col = std::size_t{}; col < cols_; ++col)
 				{
-					*buf_begin = expr(row, col);
+					for (auto row = std::size_t{}; row < rows_; ++row)
+					{
+						out(row, col) = expr(row, col);
+					}
 				}
 			}
 		}
@@ -205,94 +334,94 @@ namespace mpp
 
 		[[nodiscard]] auto begin() noexcept -> iterator // @TODO: ISSUE #20
 		{
-			return iterator(buf_.begin(), cols_);
+			return make_iter<iterator>(buf_.begin());
 		}
 
 		[[nodiscard]] auto begin() const noexcept -> const_iterator // @TODO: ISSUE #20
 		{
-			return const_iterator(buf_.cbegin(), cols_);
+			return make_iter<const_iterator>(buf_.cbegin());
 		}
 
 		[[nodiscard]] auto end() noexcept -> iterator // @TODO: ISSUE #20
 		{
-			return iterator(buf_.end(), cols_);
+			return make_iter<iterator>(buf_.end());
 		}
 
 		[[nodiscard]] auto end() const noexcept -> const_iterator // @TODO: ISSUE #20
 		{
-			return const_iterator(buf_.cend(), cols_);
+			return make_iter<const_iterator>(buf_.cend());
 		}
 
 		[[nodiscard]] auto rbegin() noexcept -> reverse_iterator // @TODO: ISSUE #20
 		{
-			return reverse_iterator(buf_.rbegin(), cols_);
+			return make_iter<reverse_iterator>(buf_.rbegin());
 		}
 
 		[[nodiscard]] auto rbegin() const noexcept -> const_reverse_iterator // @TODO: ISSUE #20
 		{
-			return const_reverse_iterator(buf_.crbegin(), cols_);
+			return make_iter<const_reverse_iterator>(buf_.crbegin());
 		}
 
 		[[nodiscard]] auto rend() noexcept -> reverse_iterator // @TODO: ISSUE #20
 		{
-			return reverse_iterator(buf_.rend(), cols_);
+			return make_iter<reverse_iterator>(buf_.rend());
 		}
 
 		[[nodiscard]] auto rend() const noexcept -> const_reverse_iterator // @TODO: ISSUE #20
 		{
-			return const_reverse_iterator(buf_.crend(), cols_);
+			return make_iter<const_reverse_iterator>(buf_.crend());
 		}
 
 		[[nodiscard]] auto cbegin() noexcept -> const_iterator // @TODO: ISSUE #20
 		{
-			return const_iterator(buf_.cbegin(), cols_);
+			return make_iter<const_iterator>(buf_.cbegin());
 		}
 
 		[[nodiscard]] auto cbegin() const noexcept -> const_iterator // @TODO: ISSUE #20
 		{
-			return const_iterator(buf_.cbegin(), cols_);
+			return make_iter<const_iterator>(buf_.cbegin());
 		}
 
 		[[nodiscard]] auto cend() noexcept -> const_iterator // @TODO: ISSUE #20
 		{
-			return const_iterator(buf_.cend(), cols_);
+			return make_iter<const_iterator>(buf_.cend());
 		}
 
 		[[nodiscard]] auto cend() const noexcept -> const_iterator // @TODO: ISSUE #20
 		{
-			return const_iterator(buf_.cend(), cols_);
+			return make_iter<const_iterator>(buf_.cend());
 		}
 
 		[[nodiscard]] auto crbegin() noexcept -> const_reverse_iterator // @TODO: ISSUE #20
 		{
-			return const_reverse_iterator(buf_.crbegin(), cols_);
+			return make_iter<const_reverse_iterator>(buf_.crbegin());
 		}
 
 		[[nodiscard]] auto crbegin() const noexcept -> const_reverse_iterator // @TODO: ISSUE #20
 		{
-			return const_reverse_iterator(buf_.crbegin(), cols_);
+			return make_iter<const_reverse_iterator>(buf_.crbegin());
 		}
 
 		[[nodiscard]] auto crend() noexcept -> const_reverse_iterator // @TODO: ISSUE #20
 		{
-			return const_reverse_iterator(buf_.crend(), cols_);
+			return make_iter<const_reverse_iterator>(buf_.crend());
 		}
 
 		[[nodiscard]] auto crend() const noexcept -> const_reverse_iterator // @TODO: ISSUE #20
 		{
-			return const_reverse_iterator(buf_.crend(), cols_);
+			return make_iter<const_reverse_iterator>(buf_.crend());
 		}
 
-		[[nodiscard]] auto operator()(size_type row, size_type col) noexcept(
-			noexcept(buf_[detail::idx_1d(cols_, row, col)])) -> reference // @TODO: ISSUE #20
+		[[nodiscard]] auto operator()(size_type row, size_type col) noexcept(noexcept(buf_[idx(row, col)]))
+			-> reference // @TODO: ISSUE #20
 		{
-			return buf_[detail::idx_1d(cols_, row, col)];
+			return buf_[idx(row, col)];
 		}
 
-		[[nodiscard]] auto operator()(size_type row, size_type col) const
-			noexcept(noexcept(buf_[detail::idx_1d(cols_, row, col)])) -> const_reference // @TODO: ISSUE #20
+		[[nodiscard]] auto operator()(size_type row, size_type col) const noexcept(noexcept(buf_[idx(row, col)]))
+			-> const_reference // @TODO: ISSUE #20
 		{
-			return buf_[detail::idx_1d(cols_, row, col)];
+			return buf_[idx(row, col)];
 		}
 
 		[[nodiscard]] auto operator[](size_type i) noexcept(noexcept(buf_[i])) -> reference
@@ -360,6 +489,19 @@ namespace mpp
 			return buf_;
 		}
 
+		void reshape(size_type rows, size_type cols) noexcept requires(!Layout::padded) // @TODO: ISSUE #20
+		{
+			// Preconditions:
+			// rows * cols is the same as the current number of elements
+
+			// The elements stay where they are, they're just read with the new dimensions
+
+			assert(rows * cols == rows_ * cols_);
+
+			rows_ = rows;
+			cols_ = cols;
+		}
+
 		void clear() noexcept // @TODO: ISSUE #20
 		{
 			rows_ = 0;
@@ -401,10 +543,7 @@ namespace mpp
 		template<detail::mat_with_value_convertible_to<T> Mat>
 		void assign(Mat&& obj) // @TODO: ISSUE #20
 		{
-			const auto rows = std::forward<Mat>(obj).rows();
-			const auto cols = std::forward<Mat>(obj).cols();
-
-			assign_rng_1d<detail::is_moved<decltype(obj)>>(rows, cols, std::forward<Mat>(obj));
+			assign_mat<detail::is_moved<decltype(obj)>>(std::forward<Mat>(obj));
 		}
 
 		auto operator=(const mat&) noexcept(std::is_nothrow_copy_assignable_v<Buf>)
@@ -412,7 +551,7 @@ namespace mpp
 		auto operator=(mat&&) noexcept(std::is_nothrow_move_assignable_v<Buf>) -> mat& = default; // @TODO: ISSUE #20
 
 		template<detail::mat_with_value_convertible_to<T> Mat>
-		requires(!std::same_as<std::remove_cvref_t<Mat>, mat<T, Buf>>) auto operator=(Mat&& obj)
+		requires(!std::same_as<std::remove_cvref_t<Mat>, mat<T, Buf, Layout>>) auto operator=(Mat&& obj)
 			-> mat& // @TODO: ISSUE #20
 		{
 			assign(std::forward<Mat>(obj));
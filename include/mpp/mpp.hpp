@@ -21,5 +21,9 @@
 
 #include <mpp/algo.hpp>
 #include <mpp/arith.hpp>
+#include <mpp/banded.hpp>
+#include <mpp/io.hpp>
+#include <mpp/iterative.hpp>
 #include <mpp/mat.hpp>
+#include <mpp/sparse.hpp>
 #include <mpp/util.hpp>
\ No newline at end of file
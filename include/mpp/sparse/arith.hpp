@@ -0,0 +1,312 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/arith/multiply.hpp>
+#include <mpp/detail/expr/expr_binary_op.hpp>
+#include <mpp/detail/util/sparse_impl.hpp>
+#include <mpp/detail/util/trps_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/sparse/sparse_mat.hpp>
+#include <mpp/mat.hpp>
+
+#include <cstddef>
+#include <string_view>
+
+namespace mpp
+{
+	namespace detail
+	{
+		template<typename Derived, typename T>
+		inline void eval_dense_into(const expr_base<Derived, T>& obj, strided_view<T> out)
+		{
+			const auto rows = obj.rows();
+			const auto cols = obj.cols();
+
+			if constexpr (strided_expr<Derived>)
+			{
+				copy_strided(rows, cols, strided_of(static_cast<const Derived&>(obj)), out);
+			}
+			else if constexpr (evaluable_into<Derived, T>)
+			{
+				static_cast<const Derived&>(obj).eval_into(out);
+			}
+			else
+			{
+				for (auto row = std::size_t{}; row < rows; ++row)
+				{
+					for (auto col = std::size_t{}; col < cols; ++col)
+					{
+						out(row, col) = obj(row, col);
+					}
+				}
+			}
+		}
+
+		template<typename T, typename Format>
+		inline void scatter_sparse(const sparse_mat<T, Format>& obj, strided_view<T> out, bool subtract)
+		{
+			scatter_compressed(Format::compresses_rows, obj.offsets(), obj.indices(), obj.values(), out, subtract);
+		}
+
+		/**
+		 * Products with one sparse operand (the left one when both are), the other operand is read densely
+		 */
+		struct sparse_mul_op_t
+		{
+			template<typename A, typename B>
+			[[nodiscard]] static auto flops(const A& a, const B& b) noexcept -> double
+			{
+				if constexpr (is_sparse<A>::value)
+				{
+					return 2.0 * static_cast<double>(a.nnz()) * static_cast<double>(b.cols());
+				}
+				else
+				{
+					return 2.0 * static_cast<double>(b.nnz()) * static_cast<double>(a.rows());
+				}
+			}
+
+			template<typename A, typename B>
+			[[nodiscard]] auto operator()(const A& a, const B& b, std::size_t row, std::size_t col) const noexcept ->
+				typename A::value_type
+			{
+				auto res = typename A::value_type{};
+
+				if constexpr (is_sparse<A>::value && A::format_type::compresses_rows)
+				{
+					for (auto idx = a.offsets()[row]; idx < a.offsets()[row + 1]; ++idx)
+					{
+						res += a.values()[idx] * b(a.indices()[idx], col);
+					}
+				}
+				else if constexpr (is_sparse<B>::value && !B::format_type::compresses_rows)
+				{
+					for (auto idx = b.offsets()[col]; idx < b.offsets()[col + 1]; ++idx)
+					{
+						res += a(row, b.indices()[idx]) * b.values()[idx];
+					}
+				}
+				else
+				{
+					for (auto idx = std::size_t{}; idx < a.cols(); ++idx)
+					{
+						res += a(row, idx) * b(idx, col);
+					}
+				}
+
+				return res;
+			}
+
+			template<typename A, typename B, typename T>
+			void eval_into(const A& a, const B& b, strided_view<T> out) const // @TODO: ISSUE #20
+			{
+				auto storage = scratch_vector<T>{};
+
+				if constexpr (is_sparse<A>::value)
+				{
+					const auto b_view = gemm_operand(b, storage);
+
+					if constexpr (A::format_type::compresses_rows)
+					{
+						csr_mul(compressed_of(a), b_view, out, b.cols());
+					}
+					else
+					{
+						csc_mul(compressed_of(a), a.rows(), b_view, out, b.cols());
+					}
+				}
+				else
+				{
+					const auto a_view = gemm_operand(a, storage);
+
+					if constexpr (B::format_type::compresses_rows)
+					{
+						dense_csr_mul(a_view, a.rows(), a.cols(), compressed_of(b), out, b.cols());
+					}
+					else
+					{
+						dense_csc_mul(a_view, a.rows(), compressed_of(b), out);
+					}
+				}
+			}
+		};
+
+		inline constexpr auto sparse_mul_op = sparse_mul_op_t{};
+
+		template<>
+		inline constexpr std::string_view expr_op_name<decltype(sparse_mul_op)> = "operator* sparse";
+
+		/**
+		 * Sums and differences with a sparse operand write the other operand densely and scatter the nonzeros on top
+		 */
+		template<bool Subtract>
+		struct sparse_add_op_t
+		{
+			template<typename A, typename B>
+			[[nodiscard]] auto operator()(const A& a, const B& b, std::size_t row, std::size_t col) const noexcept ->
+				typename A::value_type
+			{
+				return Subtract ? a(row, col) - b(row, col) : a(row, col) + b(row, col);
+			}
+
+			template<typename A, typename B, typename T>
+			void eval_into(const A& a, const B& b, strided_view<T> out) const // @TODO: ISSUE #20
+			{
+				if constexpr (is_sparse<B>::value)
+				{
+					eval_dense_into(a, out);
+					scatter_sparse(b, out, Subtract);
+				}
+				else
+				{
+					eval_dense_into(b, out);
+
+					if constexpr (Subtract)
+					{
+						const auto rows = b.rows();
+						const auto cols = b.cols();
+
+						for (auto row = std::size_t{}; row < rows; ++row)
+						{
+							for (auto col = std::size_t{}; col < cols; ++col)
+							{
+								out(row, col) = -out(row, col);
+							}
+						}
+					}
+
+					scatter_sparse(a, out, false);
+				}
+			}
+		};
+
+		inline constexpr auto sparse_add_op = sparse_add_op_t<false>{};
+		inline constexpr auto sparse_sub_op = sparse_add_op_t<true>{};
+
+		template<>
+		inline constexpr std::string_view expr_op_name<decltype(sparse_add_op)> = "operator+ sparse";
+
+		template<>
+		inline constexpr std::string_view expr_op_name<decltype(sparse_sub_op)> = "operator- sparse";
+	} // namespace detail
+
+	template<typename T, typename Format, typename Derived>
+	[[nodiscard]] inline auto operator*(const sparse_mat<T, Format>& a, const detail::expr_base<Derived, T>& b) noexcept
+		-> detail::expr_binary_op<sparse_mat<T, Format>,
+			detail::expr_base<Derived, T>,
+			decltype(detail::sparse_mul_op)> // @TODO: ISSUE #20
+	{
+		return { a, b, a.rows(), b.cols(), detail::sparse_mul_op };
+	}
+
+	template<typename Derived, typename T, typename Format>
+	[[nodiscard]] inline auto operator*(const detail::expr_base<Derived, T>& a, const sparse_mat<T, Format>& b) noexcept
+		-> detail::expr_binary_op<detail::expr_base<Derived, T>,
+			sparse_mat<T, Format>,
+			decltype(detail::sparse_mul_op)> // @TODO: ISSUE #20
+	{
+		return { a, b, a.rows(), b.cols(), detail::sparse_mul_op };
+	}
+
+	/**
+	 * The right operand is written densely, the product of two sparse matrices isn't sparse in general
+	 */
+	template<typename T, typename AFormat, typename BFormat>
+	[[nodiscard]] inline auto operator*(const sparse_mat<T, AFormat>& a, const sparse_mat<T, BFormat>& b) noexcept
+		-> detail::expr_binary_op<sparse_mat<T, AFormat>,
+			sparse_mat<T, BFormat>,
+			decltype(detail::sparse_mul_op)> // @TODO: ISSUE #20
+	{
+		return { a, b, a.rows(), b.cols(), detail::sparse_mul_op };
+	}
+
+	template<typename T, typename Format, typename Derived>
+	[[nodiscard]] inline auto operator+(const sparse_mat<T, Format>& a, const detail::expr_base<Derived, T>& b) noexcept
+		-> detail::expr_binary_op<sparse_mat<T, Format>,
+			detail::expr_base<Derived, T>,
+			decltype(detail::sparse_add_op)> // @TODO: ISSUE #20
+	{
+		return { a, b, a.rows(), a.cols(), detail::sparse_add_op };
+	}
+
+	template<typename Derived, typename T, typename Format>
+	[[nodiscard]] inline auto operator+(const detail::expr_base<Derived, T>& a, const sparse_mat<T, Format>& b) noexcept
+		-> detail::expr_binary_op<detail::expr_base<Derived, T>,
+			sparse_mat<T, Format>,
+			decltype(detail::sparse_add_op)> // @TODO: ISSUE #20
+	{
+		return { a, b, a.rows(), a.cols(), detail::sparse_add_op };
+	}
+
+	template<typename T, typename AFormat, typename BFormat>
+	[[nodiscard]] inline auto operator+(const sparse_mat<T, AFormat>& a, const sparse_mat<T, BFormat>& b) noexcept
+		-> detail::expr_binary_op<sparse_mat<T, AFormat>,
+			sparse_mat<T, BFormat>,
+			decltype(detail::sparse_add_op)> // @TODO: ISSUE #20
+	{
+		return { a, b, a.rows(), a.cols(), detail::sparse_add_op };
+	}
+
+	template<typename T, typename Format, typename Derived>
+	[[nodiscard]] inline auto operator-(const sparse_mat<T, Format>& a, const detail::expr_base<Derived, T>& b) noexcept
+		-> detail::expr_binary_op<sparse_mat<T, Format>,
+			detail::expr_base<Derived, T>,
+			decltype(detail::sparse_sub_op)> // @TODO: ISSUE #20
+	{
+		return { a, b, a.rows(), a.cols(), detail::sparse_sub_op };
+	}
+
+	template<typename Derived, typename T, typename Format>
+	[[nodiscard]] inline auto operator-(const detail::expr_base<Derived, T>& a, const sparse_mat<T, Format>& b) noexcept
+		-> detail::expr_binary_op<detail::expr_base<Derived, T>,
+			sparse_mat<T, Format>,
+			decltype(detail::sparse_sub_op)> // @TODO: ISSUE #20
+	{
+		return { a, b, a.rows(), a.cols(), detail::sparse_sub_op };
+	}
+
+	template<typename T, typename AFormat, typename BFormat>
+	[[nodiscard]] inline auto operator-(const sparse_mat<T, AFormat>& a, const sparse_mat<T, BFormat>& b) noexcept
+		-> detail::expr_binary_op<sparse_mat<T, AFormat>,
+			sparse_mat<T, BFormat>,
+			decltype(detail::sparse_sub_op)> // @TODO: ISSUE #20
+	{
+		return { a, b, a.rows(), a.cols(), detail::sparse_sub_op };
+	}
+
+	template<typename T, typename Buf, typename Layout, typename Format>
+	inline auto operator+=(mat<T, Buf, Layout>& a, const sparse_mat<T, Format>& b)
+		-> mat<T, Buf, Layout>& // @TODO: ISSUE #20
+	{
+		detail::scatter_sparse(b, detail::strided_of_mut(a), false);
+
+		return a;
+	}
+
+	template<typename T, typename Buf, typename Layout, typename Format>
+	inline auto operator-=(mat<T, Buf, Layout>& a, const sparse_mat<T, Format>& b)
+		-> mat<T, Buf, Layout>& // @TODO: ISSUE #20
+	{
+		detail::scatter_sparse(b, detail::strided_of_mut(a), true);
+
+		return a;
+	}
+} // namespace mpp
@@ -0,0 +1,452 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/algo/inv.hpp>
+#include <mpp/algo/lu.hpp>
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/cpo_base.hpp>
+#include <mpp/detail/util/ordering_impl.hpp>
+#include <mpp/detail/util/sparse_factor_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+#include <mpp/sparse/sparse_mat.hpp>
+#include <mpp/mat.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mpp
+{
+	/**
+	 * Orders that sparse factorizations eliminate columns in, to keep the fill-in of the factors low
+	 */
+	enum class fill_ordering
+	{
+		natural,
+		amd,
+		nested_dissection
+	};
+
+	/**
+	 * Analysis of a sparse pattern (elimination order, elimination tree and supernodes), which sparse_lu and
+	 * sparse_cholesky reuse for every matrix with that pattern. Copies share the analysis
+	 */
+	class sparse_symbolic
+	{
+		std::shared_ptr<const detail::symbolic_data> data_;
+
+	public:
+		sparse_symbolic() = default;
+
+		explicit sparse_symbolic(detail::symbolic_data data) :
+			data_(std::make_shared<const detail::symbolic_data>(std::move(data))) // @TODO: ISSUE #20
+		{
+		}
+
+		[[nodiscard]] auto rows() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return data_ ? data_->size : 0;
+		}
+
+		[[nodiscard]] auto cols() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return rows();
+		}
+
+		/**
+		 * Original index of every column in elimination order. The span points into the analysis, so it's only valid
+		 * as long as this or a copy of it lives
+		 */
+		[[nodiscard]] auto perm() const noexcept -> std::span<const std::size_t> // @TODO: ISSUE #20
+		{
+			return data_ ? std::span<const std::size_t>{ data_->perm } : std::span<const std::size_t>{};
+		}
+
+		[[nodiscard]] auto supernodes() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return data_ ? data_->supernodes() : 0;
+		}
+
+		/**
+		 * Nonzeros of L, diagonal included
+		 */
+		[[nodiscard]] auto factor_nnz() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return data_ ? data_->factor_nnz : 0;
+		}
+
+		[[nodiscard]] auto data() const noexcept -> const detail::symbolic_data& // @TODO: ISSUE #20
+		{
+			assert(data_);
+			return *data_;
+		}
+	};
+
+	/**
+	 * Numeric factors of a sparse matrix, in the supernodes of its sparse_symbolic
+	 */
+	template<typename T>
+	class sparse_factors
+	{
+		sparse_symbolic symbolic_;
+		bool cholesky_ = false;
+
+		std::vector<T> l_values_;
+		std::vector<T> u_values_;
+
+	public:
+		using value_type = T;
+
+		sparse_factors() = default;
+
+		/**
+		 * Factors values, the nonzeros of a matrix with the analyzed pattern in the same order
+		 */
+		sparse_factors(sparse_symbolic symbolic, std::span<const T> values, bool cholesky) :
+			symbolic_(std::move(symbolic)),
+			cholesky_(cholesky) // @TODO: ISSUE #20
+		{
+			assert(values.size() == symbolic_.data().pattern_indices.size());
+
+			detail::factor_multifrontal(symbolic_.data(), values, cholesky_, l_values_, u_values_);
+		}
+
+		[[nodiscard]] auto rows() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return symbolic_.rows();
+		}
+
+		[[nodiscard]] auto cols() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return symbolic_.cols();
+		}
+
+		[[nodiscard]] auto symbolic() const noexcept -> const sparse_symbolic& // @TODO: ISSUE #20
+		{
+			return symbolic_;
+		}
+
+		[[nodiscard]] auto is_cholesky() const noexcept -> bool // @TODO: ISSUE #20
+		{
+			return cholesky_;
+		}
+
+		/**
+		 * Values of the supernodes, see detail::symbolic_data for their layout
+		 */
+		[[nodiscard]] auto l_values() const noexcept -> std::span<const T> // @TODO: ISSUE #20
+		{
+			return l_values_;
+		}
+
+		[[nodiscard]] auto u_values() const noexcept -> std::span<const T> // @TODO: ISSUE #20
+		{
+			return u_values_;
+		}
+
+		/**
+		 * x = A^-1 * x in place for one right hand side, with scratch of n elements
+		 */
+		void solve_inplace(std::span<T> x, std::span<T> scratch) const // @TODO: ISSUE #20
+		{
+			const auto& sym = symbolic_.data();
+
+			assert(x.size() == sym.size && scratch.size() >= sym.size);
+
+			for (auto idx = std::size_t{}; idx < sym.size; ++idx)
+			{
+				scratch[idx] = x[sym.perm[idx]];
+			}
+
+			detail::solve_supernodal<T>(sym, cholesky_, l_values_, u_values_, scratch.data(), 1);
+
+			for (auto idx = std::size_t{}; idx < sym.size; ++idx)
+			{
+				x[sym.perm[idx]] = scratch[idx];
+			}
+		}
+
+		/**
+		 * X = A^-1 * B for every column of B at once
+		 */
+		template<typename Derived>
+		[[nodiscard]] auto solve(const detail::expr_base<Derived, T>& b) const -> mat<T> // @TODO: ISSUE #20
+		{
+			const auto& sym = symbolic_.data();
+			const auto cols = b.cols();
+
+			assert(b.rows() == sym.size);
+
+			auto x = detail::scratch_vector<T>(sym.size * cols);
+
+			for (auto idx = std::size_t{}; idx < sym.size; ++idx)
+			{
+				for (auto col = std::size_t{}; col < cols; ++col)
+				{
+					x[idx * cols + col] = b(sym.perm[idx], col);
+				}
+			}
+
+			detail::solve_supernodal<T>(sym, cholesky_, l_values_, u_values_, x.data(), cols);
+
+			auto out = mat<T>(sym.size, cols);
+
+			for (auto idx = std::size_t{}; idx < sym.size; ++idx)
+			{
+				for (auto col = std::size_t{}; col < cols; ++col)
+				{
+					out(sym.perm[idx], col) = x[idx * cols + col];
+				}
+			}
+
+			return out;
+		}
+	};
+
+	namespace detail
+	{
+		template<typename T, typename Format>
+		[[nodiscard]] inline auto analyze_sparse(const sparse_mat<T, Format>& obj, fill_ordering ordering)
+			-> sparse_symbolic
+		{
+			assert(obj.rows() == obj.cols());
+
+			const auto n     = obj.rows();
+			const auto graph = symmetric_graph(n, obj.offsets(), obj.indices());
+
+			auto order = std::vector<std::size_t>{};
+
+			if (ordering == fill_ordering::amd)
+			{
+				order = amd_order(graph);
+			}
+			else if (ordering == fill_ordering::nested_dissection)
+			{
+				order = nested_dissection_order(graph);
+			}
+			else
+			{
+				order.resize(n);
+
+				for (auto idx = std::size_t{}; idx < n; ++idx)
+				{
+					order[idx] = idx;
+				}
+			}
+
+			return sparse_symbolic{ analyze_pattern(Format::compresses_rows,
+				obj.offsets(),
+				obj.indices(),
+				graph,
+				std::move(order)) };
+		}
+
+		template<typename T, typename Format>
+		[[nodiscard]] inline auto factor_sparse(const sparse_mat<T, Format>& obj,
+			const sparse_symbolic& symbolic,
+			bool cholesky) -> sparse_factors<T>
+		{
+			// The analysis only applies to the pattern it was made for
+			assert(Format::compresses_rows == symbolic.data().compresses_rows &&
+				std::ranges::equal(obj.offsets(), symbolic.data().pattern_offsets) &&
+				std::ranges::equal(obj.indices(), symbolic.data().pattern_indices));
+
+			return { symbolic, obj.values(), cholesky };
+		}
+
+		/**
+		 * Unit lower L in compressed columns and U in compressed rows, from the supernodes of a factorization in the
+		 * natural order. The analysis still postorders the elimination tree, so indices are mapped back through perm.
+		 * Only columns on a path of the tree depend on each other and the postorder keeps their order, which leaves L
+		 * lower and U upper triangular
+		 */
+		template<typename T>
+		[[nodiscard]] inline auto split_lu(const sparse_factors<T>& factors)
+			-> std::pair<sparse_mat<T, csc>, sparse_mat<T, csr>>
+		{
+			const auto& sym = factors.symbolic().data();
+			const auto n    = sym.size;
+
+			auto l_entries = std::vector<triplet<T>>{};
+			auto u_entries = std::vector<triplet<T>>{};
+
+			// Relaxed supernodes also hold explicit zeros between columns that don't depend on each other, which can
+			// end up on the other side of the diagonal
+			const auto add = [&](auto& entries, bool lower, std::size_t row, std::size_t col, T val) {
+				row = sym.perm[row];
+				col = sym.perm[col];
+
+				if (row != col && (row > col) != lower)
+				{
+					assert(val == T{});
+					return;
+				}
+
+				entries.push_back({ row, col, val });
+			};
+
+			for (auto super = std::size_t{}; super < sym.supernodes(); ++super)
+			{
+				const auto first    = sym.super_first[super];
+				const auto cols     = sym.cols_of(super);
+				const auto rows     = sym.rows_of(super);
+				const auto* l_panel = factors.l_values().data() + sym.l_offsets[super];
+				const auto* u_panel = factors.u_values().data() + sym.u_offsets[super];
+
+				for (auto col = std::size_t{}; col < cols; ++col)
+				{
+					add(l_entries, true, first + col, first + col, T{ 1 });
+
+					for (auto row = col + 1; row < cols + rows.size(); ++row)
+					{
+						const auto idx = row < cols ? first + row : rows[row - cols];
+						add(l_entries, true, idx, first + col, l_panel[row * cols + col]);
+					}
+				}
+
+				for (auto row = std::size_t{}; row < cols; ++row)
+				{
+					for (auto col = row; col < cols; ++col)
+					{
+						add(u_entries, false, first + row, first + col, l_panel[row * cols + col]);
+					}
+
+					for (auto idx = std::size_t{}; idx < rows.size(); ++idx)
+					{
+						add(u_entries, false, first + row, rows[idx], u_panel[row * rows.size() + idx]);
+					}
+				}
+			}
+
+			return { sparse_mat<T, csc>{ n, n, l_entries }, sparse_mat<T, csr>{ n, n, u_entries } };
+		}
+	} // namespace detail
+
+	struct sparse_analyze_t : public detail::cpo_base<sparse_analyze_t>
+	{
+		static constexpr auto name = std::string_view{ "sparse_analyze" };
+
+		/**
+		 * Elimination order and supernodes of a square sparse matrix, from the pattern of A + A^T
+		 */
+		template<typename T, typename Format>
+		[[nodiscard]] friend inline auto tag_invoke(sparse_analyze_t,
+			const sparse_mat<T, Format>& obj,
+			fill_ordering ordering = fill_ordering::amd) -> sparse_symbolic // @TODO: ISSUE #20
+		{
+			return detail::analyze_sparse(obj, ordering);
+		}
+	};
+
+	struct sparse_lu_t : public detail::cpo_base<sparse_lu_t>
+	{
+		static constexpr auto name = std::string_view{ "sparse_lu" };
+
+		[[nodiscard]] static auto flops(const auto&, const sparse_symbolic& symbolic) noexcept
+			-> double // @TODO: ISSUE #20
+		{
+			return 2.0 * symbolic.data().cholesky_flops;
+		}
+
+		/**
+		 * LU decomposition of a square sparse matrix without pivoting (like lu), in the elimination order of an
+		 * analysis of its pattern. Only the numeric phase runs, so matrices of the same pattern share one analysis
+		 */
+		template<typename T, typename Format>
+		[[nodiscard]] friend inline auto tag_invoke(sparse_lu_t,
+			const sparse_mat<T, Format>& obj,
+			const sparse_symbolic& symbolic) -> sparse_factors<T> // @TODO: ISSUE #20
+		{
+			return detail::factor_sparse(obj, symbolic, false);
+		}
+
+		template<typename T, typename Format>
+		[[nodiscard]] friend inline auto tag_invoke(sparse_lu_t,
+			const sparse_mat<T, Format>& obj,
+			fill_ordering ordering = fill_ordering::amd) -> sparse_factors<T> // @TODO: ISSUE #20
+		{
+			return detail::factor_sparse(obj, detail::analyze_sparse(obj, ordering), false);
+		}
+	};
+
+	struct sparse_cholesky_t : public detail::cpo_base<sparse_cholesky_t>
+	{
+		static constexpr auto name = std::string_view{ "sparse_cholesky" };
+
+		[[nodiscard]] static auto flops(const auto&, const sparse_symbolic& symbolic) noexcept
+			-> double // @TODO: ISSUE #20
+		{
+			return symbolic.data().cholesky_flops;
+		}
+
+		/**
+		 * Cholesky factor of a symmetric positive definite sparse matrix (with both of its triangles stored), in the
+		 * elimination order of an analysis of its pattern
+		 */
+		template<typename T, typename Format>
+		[[nodiscard]] friend inline auto tag_invoke(sparse_cholesky_t,
+			const sparse_mat<T, Format>& obj,
+			const sparse_symbolic& symbolic) -> sparse_factors<T> // @TODO: ISSUE #20
+		{
+			return detail::factor_sparse(obj, symbolic, true);
+		}
+
+		template<typename T, typename Format>
+		[[nodiscard]] friend inline auto tag_invoke(sparse_cholesky_t,
+			const sparse_mat<T, Format>& obj,
+			fill_ordering ordering = fill_ordering::amd) -> sparse_factors<T> // @TODO: ISSUE #20
+		{
+			return detail::factor_sparse(obj, detail::analyze_sparse(obj, ordering), true);
+		}
+	};
+
+	inline constexpr auto sparse_analyze  = sparse_analyze_t{};
+	inline constexpr auto sparse_lu       = sparse_lu_t{};
+	inline constexpr auto sparse_cholesky = sparse_cholesky_t{};
+
+	/**
+	 * L and U stay sparse: the factorization is in the natural order (so that A = L * U, without a permutation), with
+	 * the fill-in that brings
+	 */
+	template<typename T, typename Format>
+	[[nodiscard]] inline auto tag_invoke(lu_t, const sparse_mat<T, Format>& obj)
+		-> std::pair<sparse_mat<T, Format>, sparse_mat<T, Format>> // @TODO: ISSUE #20
+	{
+		auto [l, u] = detail::split_lu(sparse_lu(obj, fill_ordering::natural));
+
+		return { sparse_mat<T, Format>{ std::move(l) }, sparse_mat<T, Format>{ std::move(u) } };
+	}
+
+	/**
+	 * The inverse of a sparse matrix is dense in general, so only the result is: it's solved for the identity with
+	 * sparse_lu
+	 */
+	template<typename T, typename Format>
+	[[nodiscard]] inline auto tag_invoke(inv_t, const sparse_mat<T, Format>& obj) -> mat<T> // @TODO: ISSUE #20
+	{
+		return sparse_lu(obj).solve(mat<T>(obj.rows(), obj.cols(), identity));
+	}
+} // namespace mpp
@@ -0,0 +1,262 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/expr/expr_base.hpp>
+#include <mpp/detail/util/sparse_impl.hpp>
+#include <mpp/detail/util/util.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mpp
+{
+	/**
+	 * Storage formats of sparse matrices, which compress either rows or columns:
+	 *
+	 * offsets: where the nonzeros of each row (or column) start in indices and values, plus the total at the end
+	 * indices: the column (or row) of each nonzero, increasing within each row (or column)
+	 * values: the value of each nonzero
+	 */
+
+	struct csr
+	{
+		static constexpr auto compresses_rows = true;
+	};
+
+	struct csc
+	{
+		static constexpr auto compresses_rows = false;
+	};
+
+	/**
+	 * One nonzero of a sparse matrix under assembly
+	 */
+	template<typename T>
+	struct triplet
+	{
+		using value_type = T;
+
+		std::size_t row;
+		std::size_t col;
+		T value;
+	};
+
+	/**
+	 * Sparse matrix that only stores its nonzeros. It's an expression, so it can be used wherever a matrix expression
+	 * can (elements are found with a binary search), while products and sums with dense matrices have kernels of their
+	 * own
+	 */
+	template<typename T, typename Format = csr>
+	class sparse_mat : public detail::expr_base<sparse_mat<T, Format>, T>
+	{
+		std::size_t rows_ = 0;
+		std::size_t cols_ = 0;
+
+		std::vector<std::size_t> offsets_ = std::vector<std::size_t>(1);
+		std::vector<std::size_t> indices_;
+		std::vector<T> values_;
+
+	public:
+		using value_type  = T;
+		using format_type = Format;
+
+		sparse_mat() = default;
+
+		/**
+		 * rows x cols matrix of zeros
+		 */
+		sparse_mat(std::size_t rows, std::size_t cols) :
+			rows_(rows),
+			cols_(cols),
+			offsets_((Format::compresses_rows ? rows : cols) + 1) // @TODO: ISSUE #20
+		{
+		}
+
+		/**
+		 * Takes over arrays laid out as described for csr and csc
+		 */
+		sparse_mat(std::size_t rows,
+			std::size_t cols,
+			std::vector<std::size_t> offsets,
+			std::vector<std::size_t> indices,
+			std::vector<T> values) :
+			rows_(rows),
+			cols_(cols),
+			offsets_(std::move(offsets)),
+			indices_(std::move(indices)),
+			values_(std::move(values)) // @TODO: ISSUE #20
+		{
+			assert(offsets_.size() == outer_size() + 1 && offsets_.front() == 0);
+			assert(offsets_.back() == indices_.size() && indices_.size() == values_.size());
+		}
+
+		/**
+		 * Assembles the matrix from nonzeros in any order, values of the same element are summed
+		 */
+		template<std::ranges::contiguous_range Triplets>
+		requires std::same_as<std::ranges::range_value_t<Triplets>, triplet<T>>
+		sparse_mat(std::size_t rows, std::size_t cols, const Triplets& triplets) :
+			rows_(rows),
+			cols_(cols) // @TODO: ISSUE #20
+		{
+			const auto entries =
+				std::span<const triplet<T>>{ std::ranges::data(triplets), std::ranges::size(triplets) };
+
+			assert(std::ranges::all_of(entries, [&](const auto& entry) {
+				return entry.row < rows && entry.col < cols;
+			}));
+
+			detail::build_compressed(
+				outer_size(),
+				entries,
+				[](const triplet<T>& entry) {
+					return Format::compresses_rows ? entry.row : entry.col;
+				},
+				[](const triplet<T>& entry) {
+					return Format::compresses_rows ? entry.col : entry.row;
+				},
+				[](const triplet<T>& entry) {
+					return entry.value;
+				},
+				offsets_,
+				indices_,
+				values_);
+		}
+
+		/**
+		 * Converts between csr and csc
+		 */
+		template<typename Format2>
+		requires(!std::is_same_v<Format, Format2>) explicit sparse_mat(const sparse_mat<T, Format2>& other) :
+			rows_(other.rows()),
+			cols_(other.cols()) // @TODO: ISSUE #20
+		{
+			detail::transpose_compressed(other.outer_size(),
+				outer_size(),
+				other.offsets(),
+				other.indices(),
+				other.values(),
+				offsets_,
+				indices_,
+				values_);
+		}
+
+		[[nodiscard]] auto rows() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return rows_;
+		}
+
+		[[nodiscard]] auto cols() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return cols_;
+		}
+
+		/**
+		 * Rows for csr and columns for csc
+		 */
+		[[nodiscard]] auto outer_size() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return Format::compresses_rows ? rows_ : cols_;
+		}
+
+		[[nodiscard]] auto nnz() const noexcept -> std::size_t // @TODO: ISSUE #20
+		{
+			return values_.size();
+		}
+
+		[[nodiscard]] auto offsets() const noexcept -> std::span<const std::size_t> // @TODO: ISSUE #20
+		{
+			return offsets_;
+		}
+
+		[[nodiscard]] auto indices() const noexcept -> std::span<const std::size_t> // @TODO: ISSUE #20
+		{
+			return indices_;
+		}
+
+		[[nodiscard]] auto values() const noexcept -> std::span<const T> // @TODO: ISSUE #20
+		{
+			return values_;
+		}
+
+		/**
+		 * Values can be changed in place, the positions of the nonzeros can't
+		 */
+		[[nodiscard]] auto values() noexcept -> std::span<T> // @TODO: ISSUE #20
+		{
+			return values_;
+		}
+
+		[[nodiscard]] auto operator()(std::size_t row, std::size_t col) const noexcept -> T // @TODO: ISSUE #20
+		{
+			assert(row < rows_ && col < cols_);
+
+			const auto outer = Format::compresses_rows ? row : col;
+			const auto inner = Format::compresses_rows ? col : row;
+
+			const auto first = indices_.begin() + static_cast<std::ptrdiff_t>(offsets_[outer]);
+			const auto last  = indices_.begin() + static_cast<std::ptrdiff_t>(offsets_[outer + 1]);
+			const auto found = std::lower_bound(first, last, inner);
+
+			return found != last && *found == inner ? values_[static_cast<std::size_t>(found - indices_.begin())]
+													: T{};
+		}
+
+		/**
+		 * Writes the matrix densely, zeros included
+		 */
+		void eval_into(detail::strided_view<T> out) const // @TODO: ISSUE #20
+		{
+			detail::fill_strided(out, rows_, cols_, T{});
+			detail::scatter_compressed(Format::compresses_rows, offsets(), indices(), values(), out, false);
+		}
+	};
+
+	template<std::ranges::contiguous_range Triplets>
+	sparse_mat(std::size_t, std::size_t, const Triplets&)
+		-> sparse_mat<typename std::ranges::range_value_t<Triplets>::value_type>;
+
+	namespace detail
+	{
+		template<typename T>
+		struct is_sparse : std::false_type
+		{
+		};
+
+		template<typename T, typename Format>
+		struct is_sparse<sparse_mat<T, Format>> : std::true_type
+		{
+		};
+
+		template<typename T, typename Format>
+		[[nodiscard]] inline auto compressed_of(const sparse_mat<T, Format>& obj) noexcept -> compressed_view<T>
+		{
+			return { obj.offsets(), obj.indices(), obj.values() };
+		}
+	} // namespace detail
+} // namespace mpp
@@ -23,3 +23,5 @@
 
 #include <mpp/util/cmp.hpp>
 #include <mpp/util/print.hpp>
+#include <mpp/util/stats.hpp>
+#include <mpp/util/trace.hpp>
@@ -0,0 +1,79 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace mpp
+{
+	namespace detail
+	{
+		[[nodiscard]] inline auto hardware_threads() noexcept -> std::size_t
+		{
+			// hardware_concurrency is allowed to return 0 when it can't be computed
+			const auto threads = static_cast<std::size_t>(std::thread::hardware_concurrency());
+
+			return threads == 0 ? 1 : threads;
+		}
+
+		[[nodiscard]] inline auto max_threads_setting() noexcept -> std::atomic<std::size_t>&
+		{
+			static auto setting = std::atomic<std::size_t>{ hardware_threads() };
+			return setting;
+		}
+
+		[[nodiscard]] inline auto strassen_crossover_setting() noexcept -> std::atomic<std::size_t>&
+		{
+			static auto setting = std::atomic<std::size_t>{};
+			return setting;
+		}
+	} // namespace detail
+
+	/**
+	 * Runtime knobs for the library. These are process-wide and safe to change from any thread, but a change only
+	 * affects operations that start after it
+	 */
+
+	[[nodiscard]] inline auto max_threads() noexcept -> std::size_t
+	{
+		return detail::max_threads_setting().load(std::memory_order_relaxed);
+	}
+
+	inline void set_max_threads(std::size_t threads) noexcept
+	{
+		// 0 means "use every hardware thread"
+		detail::max_threads_setting().store(threads == 0 ? detail::hardware_threads() : threads,
+			std::memory_order_relaxed);
+	}
+
+	[[nodiscard]] inline auto strassen_crossover() noexcept -> std::size_t
+	{
+		return detail::strassen_crossover_setting().load(std::memory_order_relaxed);
+	}
+
+	inline void set_strassen_crossover(std::size_t crossover) noexcept
+	{
+		// Products with every dimension at least this big are multiplied with Strassen-Winograd recursion, which
+		// halves the dimensions until one of them drops below the crossover. 0 (the default) turns it off
+		detail::strassen_crossover_setting().store(crossover, std::memory_order_relaxed);
+	}
+} // namespace mpp
@@ -28,18 +28,54 @@
 #include <compare>
 #include <concepts>
 #include <cstddef>
+#include <string_view>
 #include <type_traits>
 
 namespace mpp
 {
 	struct cmp_t : public detail::cpo_base<cmp_t>
 	{
-		template<typename Val, typename Val2, typename Buf, typename Buf2, typename Fn = std::compare_three_way>
-		[[nodiscard]] friend inline auto
-		tag_invoke(cmp_t, const mat<Val, Buf>& a, const mat<Val2, Buf2>& b, Fn fn = {}) // @TODO: ISSUE #20
+		static constexpr auto name = std::string_view{ "cmp" };
+
+		template<typename Val,
+			typename Val2,
+			typename Buf,
+			typename Buf2,
+			typename Layout,
+			typename Layout2,
+			typename Fn = std::compare_three_way>
+		[[nodiscard]] friend inline auto tag_invoke(cmp_t,
+			const mat<Val, Buf, Layout>& a,
+			const mat<Val2, Buf2, Layout2>& b,
+			Fn fn = {}) // @TODO: ISSUE #20
 			noexcept(noexcept(std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end(), fn)))
 		{
-			return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end(), fn);
+			if constexpr (std::is_same_v<Layout, row_major> && std::is_same_v<Layout2, row_major>)
+			{
+				return std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end(), fn);
+			}
+			else
+			{
+				// Other layouts are compared in row major order, so the result doesn't depend on how they're stored
+				using result_t =
+					decltype(std::lexicographical_compare_three_way(a.begin(), a.end(), b.begin(), b.end(), fn));
+
+				const auto a_size = a.rows() * a.cols();
+				const auto b_size = b.rows() * b.cols();
+				const auto size   = std::min(a_size, b_size);
+
+				for (auto i = std::size_t{}; i < size; ++i)
+				{
+					const auto res = fn(a(i / a.cols(), i % a.cols()), b(i / b.cols(), i % b.cols()));
+
+					if (res != 0)
+					{
+						return result_t{ res };
+					}
+				}
+
+				return result_t{ a_size <=> b_size };
+			}
 		}
 	};
 
@@ -68,8 +104,9 @@ namespace mpp
 	};
 
 	// @TODO: This is an odd place, maybe look for somewhere else to put it?
-	template<typename T, typename T2, typename Buf, typename Buf2>
-	auto operator<=>(const mat<T, Buf>& a, const mat<T2, Buf2>& b) noexcept(noexcept(cmp(a, b))) -> bool
+	template<typename T, typename T2, typename Buf, typename Buf2, typename Layout, typename Layout2>
+	auto operator<=>(const mat<T, Buf, Layout>& a, const mat<T2, Buf2, Layout2>& b) noexcept(noexcept(cmp(a, b)))
+		-> bool
 	{
 		return cmp(a, b);
 	}
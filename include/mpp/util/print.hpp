@@ -21,30 +21,102 @@
 
 #include <mpp/detail/util/cpo_base.hpp>
 #include <mpp/detail/util/print_impl.hpp>
+#include <mpp/detail/util/text_writer.hpp>
 #include <mpp/mat.hpp>
 
+#include <algorithm>
 #include <cstddef>
+#include <ios>
 #include <iostream>
 #include <sstream>
+#include <string_view>
 
 namespace mpp
 {
+	struct print_options
+	{
+		// Significant digits of floating points (like the default of streams), or 0 for the shortest form that reads
+		// back to the same value
+		int precision = 6;
+
+		// If positive, only the first and last edge_items rows and columns of bigger matrices are printed
+		std::size_t edge_items = 0;
+	};
+
 	struct print_t : public detail::cpo_base<print_t>
 	{
-		template<typename T, typename Buf>
-		friend inline auto tag_invoke(print_t, const mat<T, Buf>& obj) -> void
+		static constexpr auto name = std::string_view{ "print" };
+
+		template<typename T, typename Buf, typename Layout>
+		friend inline auto tag_invoke(print_t,
+			std::ostream& os,
+			const mat<T, Buf, Layout>& obj,
+			const print_options& options = {}) -> void // @TODO: ISSUE #20
 		{
-			auto msg = std::stringstream{};
-			detail::append_expr_to_stream(msg, obj, "");
+			// Elements are formatted into the writer's buffer, which is written to os whenever it fills up
+			auto out = detail::text_writer{ os };
 
-			std::cout << msg.str();
+			detail::write_expr(
+				out,
+				obj,
+				[&options](detail::text_writer& writer, const auto& elem) {
+					writer.put_number(elem, options.precision);
+				},
+				options.edge_items,
+				"");
+		}
+
+		template<typename T, typename Buf, typename Layout>
+		friend inline auto tag_invoke(print_t, const mat<T, Buf, Layout>& obj, const print_options& options = {})
+			-> void // @TODO: ISSUE #20
+		{
+			tag_invoke(print_t{}, std::cout, obj, options);
 		}
 	};
 
-	template<typename T, typename Buf>
-	auto operator<<(std::ostream& os, const mat<T, Buf>& obj) -> std::ostream&
+	template<typename T, typename Buf, typename Layout>
+	auto operator<<(std::ostream& os, const mat<T, Buf, Layout>& obj) -> std::ostream&
 	{
-		detail::append_expr_to_stream(os, obj, "");
+		auto out = detail::text_writer{ os };
+
+		if (detail::has_default_format(os))
+		{
+			// Only the precision was changed, which std::to_chars can follow
+			const auto precision = static_cast<int>(std::max(os.precision(), std::streamsize{ 1 }));
+
+			detail::write_expr(
+				out,
+				obj,
+				[precision](detail::text_writer& writer, const auto& elem) {
+					writer.put_number(elem, precision);
+				},
+				0,
+				"");
+
+			return os;
+		}
+
+		// Anything else (std::fixed, std::showpos, std::setw, a locale...) is followed by streaming each element into a
+		// stream with the format of os. The width applies to every element, so columns line up
+		auto elem_stream = std::ostringstream{};
+		elem_stream.copyfmt(os);
+		elem_stream.tie(nullptr);
+
+		const auto width = os.width(0);
+
+		detail::write_expr(
+			out,
+			obj,
+			[&elem_stream, width](detail::text_writer& writer, const auto& elem) {
+				elem_stream.str({});
+				elem_stream.width(width);
+				elem_stream << elem;
+
+				writer.put(elem_stream.view());
+			},
+			0,
+			"");
+
 		return os;
 	}
 
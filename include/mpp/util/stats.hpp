@@ -0,0 +1,217 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/instrument.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace mpp::stats
+{
+	/**
+	 * Whether CPOs and the materialization of expressions are instrumented, define MPP_INSTRUMENT (or configure with
+	 * MPP_INSTRUMENT=ON) to turn it on. Without it the hooks compile to nothing and snapshots are empty
+	 */
+#ifdef MPP_INSTRUMENT
+	inline constexpr auto enabled = true;
+#else
+	inline constexpr auto enabled = false;
+#endif
+
+	/**
+	 * Latencies under which that share of the calls completed, from histograms with 16 buckets per power of 2, so they
+	 * are within about 3% of the exact values
+	 */
+	struct latency_stats
+	{
+		std::chrono::nanoseconds p50;
+		std::chrono::nanoseconds p99;
+		std::chrono::nanoseconds p999;
+	};
+
+	/**
+	 * Calls whose biggest dimension is in [min_dim, max_dim]
+	 */
+	struct shape_stats
+	{
+		std::size_t min_dim;
+		std::size_t max_dim;
+		std::uint64_t calls;
+		std::chrono::nanoseconds time;
+		double flops; // Estimated from the shapes, 0 for operations that only move memory
+		std::uint64_t allocs;
+		std::uint64_t alloc_bytes;
+		std::uint64_t peak_bytes; // Most bytes any one call had live on top of what was live when it started
+		latency_stats latency;
+	};
+
+	struct op_stats
+	{
+		std::string_view name; // e.g. "det" or "operator*"
+		std::uint64_t calls;
+		std::chrono::nanoseconds time;
+		double flops;
+		std::uint64_t allocs;
+		std::uint64_t alloc_bytes;
+		std::uint64_t peak_bytes;
+		latency_stats latency;
+		std::vector<shape_stats> shapes; // Only the size classes that were called, smallest first
+	};
+
+	/**
+	 * Allocator whose allocations are counted in the stats of the instrumented call in progress on the allocating
+	 * thread, use it for the buffers of matrices whose allocations should show up, e.g.
+	 * mpp::mat<double, std::vector<double, mpp::stats::accounting_allocator<double>>>. The scratch buffers of the
+	 * algorithms use it whenever MPP_INSTRUMENT is defined
+	 */
+	template<typename T>
+	using accounting_allocator = detail::instrument::accounting_allocator<T>;
+
+	/**
+	 * Totals of every thread since the start of the program or the last reset. Counters are read one at a time while
+	 * other threads may be updating them, so a snapshot taken during calls can be off by the calls in flight
+	 */
+	[[nodiscard]] inline auto snapshot() -> std::vector<op_stats> // @TODO: ISSUE #20
+	{
+		namespace instr = detail::instrument;
+
+		const auto names = instr::global_registry().op_names();
+		auto out         = std::vector<op_stats>{};
+
+		const auto latency_of = [](const std::vector<std::uint64_t>& counts) {
+			const auto at = [&](double q) {
+				return std::chrono::nanoseconds{ instr::latency_quantile(counts, q) };
+			};
+
+			return latency_stats{ at(0.5), at(0.99), at(0.999) };
+		};
+
+		for (auto op = std::size_t{}; op < names.size(); ++op)
+		{
+			auto stats      = op_stats{ names[op], 0, {}, 0.0, 0, 0, 0, {}, {} };
+			auto op_latency = std::vector<std::uint64_t>(instr::latency_buckets);
+
+			for (auto size_class = std::size_t{}; size_class < instr::size_classes; ++size_class)
+			{
+				auto shape = shape_stats{ size_class == 0 ? 0 : std::size_t{ 1 } << (size_class - 1),
+					size_class == 0 ? 0 : (std::size_t{ 1 } << size_class) - 1,
+					0,
+					{},
+					0.0,
+					0,
+					0,
+					0,
+					{} };
+
+				auto shape_latency = std::vector<std::uint64_t>(instr::latency_buckets);
+
+				instr::global_registry().for_each_block([&](const instr::thread_block& block) {
+					const auto& slot = block.ops[op][size_class];
+
+					shape.calls += slot.calls.load(std::memory_order_relaxed);
+					shape.time += std::chrono::nanoseconds{ slot.ns.load(std::memory_order_relaxed) };
+					shape.flops += static_cast<double>(slot.flops.load(std::memory_order_relaxed));
+					shape.allocs += slot.allocs.load(std::memory_order_relaxed);
+					shape.alloc_bytes += slot.alloc_bytes.load(std::memory_order_relaxed);
+					shape.peak_bytes = std::max(shape.peak_bytes, slot.peak_bytes.load(std::memory_order_relaxed));
+
+					if (const auto* histogram = block.latencies[op][size_class].load(std::memory_order_acquire))
+					{
+						for (auto bucket = std::size_t{}; bucket < instr::latency_buckets; ++bucket)
+						{
+							shape_latency[bucket] += histogram->counts[bucket].load(std::memory_order_relaxed);
+						}
+					}
+				});
+
+				if (shape.calls == 0)
+				{
+					continue;
+				}
+
+				stats.calls += shape.calls;
+				stats.time += shape.time;
+				stats.flops += shape.flops;
+				stats.allocs += shape.allocs;
+				stats.alloc_bytes += shape.alloc_bytes;
+				stats.peak_bytes = std::max(stats.peak_bytes, shape.peak_bytes);
+
+				for (auto bucket = std::size_t{}; bucket < instr::latency_buckets; ++bucket)
+				{
+					op_latency[bucket] += shape_latency[bucket];
+				}
+
+				shape.latency = latency_of(shape_latency);
+				stats.shapes.push_back(shape);
+			}
+
+			stats.latency = latency_of(op_latency);
+
+			if (stats.calls > 0)
+			{
+				out.push_back(std::move(stats));
+			}
+		}
+
+		return out;
+	}
+
+	/**
+	 * Zeroes the counters of every thread
+	 */
+	inline void reset() // @TODO: ISSUE #20
+	{
+		detail::instrument::global_registry().for_each_block([](detail::instrument::thread_block& block) {
+			for (auto& op : block.ops)
+			{
+				for (auto& slot : op)
+				{
+					slot.calls.store(0, std::memory_order_relaxed);
+					slot.ns.store(0, std::memory_order_relaxed);
+					slot.flops.store(0, std::memory_order_relaxed);
+					slot.allocs.store(0, std::memory_order_relaxed);
+					slot.alloc_bytes.store(0, std::memory_order_relaxed);
+					slot.peak_bytes.store(0, std::memory_order_relaxed);
+				}
+			}
+
+			// Histograms stay allocated, their threads may be recording into them
+			for (auto& op : block.latencies)
+			{
+				for (auto& slot : op)
+				{
+					if (auto* histogram = slot.load(std::memory_order_acquire))
+					{
+						for (auto& count : histogram->counts)
+						{
+							count.store(0, std::memory_order_relaxed);
+						}
+					}
+				}
+			}
+		});
+	}
+} // namespace mpp::stats
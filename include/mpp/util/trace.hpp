@@ -0,0 +1,141 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#pragma once
+
+#include <mpp/detail/util/instrument.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+namespace mpp::trace
+{
+	/**
+	 * Writes the spans every thread recorded (the last detail::instrument::trace_capacity per thread) as Chrome
+	 * trace-event JSON, open it in chrome://tracing or https://ui.perfetto.dev. Spans are only recorded when
+	 * MPP_INSTRUMENT is defined, see mpp::stats::enabled
+	 */
+	inline void write(std::ostream& os) // @TODO: ISSUE #20
+	{
+		namespace instr = detail::instrument;
+
+		const auto flags     = os.flags();
+		const auto precision = os.precision();
+
+		os << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+
+		auto first = true;
+
+		const auto separate = [&]() {
+			os << (first ? "\n" : ",\n");
+			first = false;
+		};
+
+		instr::global_registry().for_each_block([&](const instr::thread_block& block) {
+			const auto* const ring = block.ring.load(std::memory_order_acquire);
+
+			if (ring == nullptr)
+			{
+				return;
+			}
+
+			separate();
+			os << R"({"name": "thread_name", "ph": "M", "pid": 1, "tid": )" << block.index
+			   << R"(, "args": {"name": "mpp thread )" << block.index << "\"}}";
+
+			const auto head        = ring->head.load(std::memory_order_acquire);
+			const auto first_event = head - std::min<std::uint64_t>(head, instr::trace_capacity);
+
+			for (auto idx = first_event; idx < head; ++idx)
+			{
+				const auto& event = ring->events[idx % instr::trace_capacity];
+				const auto* kind  = event.kind.load(std::memory_order_relaxed);
+
+				if (kind == nullptr)
+				{
+					continue;
+				}
+
+				// Chrome wants microseconds
+				separate();
+				os << R"({"name": ")" << kind->name << R"(", "ph": "X", "pid": 1, "tid": )" << block.index
+				   << R"(, "ts": )" << static_cast<double>(event.start_ns.load(std::memory_order_relaxed)) / 1e3
+				   << R"(, "dur": )" << static_cast<double>(event.dur_ns.load(std::memory_order_relaxed)) / 1e3
+				   << R"(, "args": {)";
+
+				for (auto arg = std::size_t{}, written = std::size_t{}; arg < kind->args.size(); ++arg)
+				{
+					if (!kind->args[arg].empty())
+					{
+						os << (written++ == 0 ? "\"" : ", \"") << kind->args[arg]
+						   << "\": " << event.args[arg].load(std::memory_order_relaxed);
+					}
+				}
+
+				os << "}}";
+			}
+		});
+
+		os << "\n]}\n";
+
+		os.flags(flags);
+		os.precision(precision);
+	}
+
+	/**
+	 * Writes the trace into a file, throws std::runtime_error if it can't be written
+	 */
+	inline void write(const std::filesystem::path& path) // @TODO: ISSUE #20
+	{
+		auto file = std::ofstream{ path };
+
+		if (!file)
+		{
+			throw std::runtime_error("Failed to open " + path.string() + " for writing a trace");
+		}
+
+		write(static_cast<std::ostream&>(file));
+		file.close();
+
+		if (!file)
+		{
+			throw std::runtime_error("Failed to write a trace to " + path.string());
+		}
+	}
+
+	/**
+	 * Drops the spans recorded so far, call it while no operation is running
+	 */
+	inline void clear() // @TODO: ISSUE #20
+	{
+		detail::instrument::global_registry().for_each_block([](const detail::instrument::thread_block& block) {
+			if (auto* const ring = block.ring.load(std::memory_order_acquire); ring != nullptr)
+			{
+				ring->head.store(0, std::memory_order_relaxed);
+			}
+		});
+	}
+} // namespace mpp::trace
@@ -22,9 +22,12 @@
 #include <boost/ut.hpp>
 
 #include <mpp/detail/util/algo_impl.hpp>
+#include <mpp/sparse/sparse_mat.hpp>
 #include <mpp/util/cmp.hpp>
 #include <mpp/mat.hpp>
 
+#include <cmath>
+#include <compare>
 #include <cstddef>
 #include <filesystem>
 #include <fstream>
@@ -51,6 +54,15 @@ using all_mats = mats<T, std::vector<T>, std::array<T, Rows * Cols>>;
 template<typename T, std::size_t Rows, std::size_t Cols>
 using all_mats_reverse = mats<T, std::array<T, Rows * Cols>, std::vector<T>>;
 
+template<typename T, typename... Layouts>
+using layout_mats = std::tuple<std::type_identity<mpp::mat<T, std::vector<T>, Layouts>>...>;
+
+template<typename T>
+using other_layout_mats = layout_mats<T, mpp::col_major, mpp::padded_row_major<4>>;
+
+template<typename T>
+using other_layout_mats_reverse = layout_mats<T, mpp::padded_row_major<4>, mpp::col_major>;
+
 template<typename...>
 struct join_mats_impl;
 
@@ -453,3 +465,84 @@ auto parse_test(std::string_view filename, const Fns&... fns)
 
 	return std::tuple{ fns(file, line)... };
 }
+
+// Names are shared by every test, so each file needs names of its own
+[[nodiscard]] inline auto temp_path(const std::string& name) -> std::filesystem::path
+{
+	return std::filesystem::temp_directory_path() / ("mpp_test_" + name);
+}
+
+[[nodiscard]] auto same_elems(const auto& left, const auto& right) -> bool
+{
+	return left.rows() == right.rows() && left.cols() == right.cols() &&
+		mpp::cmp(left, right, mpp::cmp_fn) == std::partial_ordering::equivalent;
+}
+
+[[nodiscard]] auto near_elems(const auto& left, const auto& right, double tolerance) -> bool
+{
+	if (left.rows() != right.rows() || left.cols() != right.cols())
+	{
+		return false;
+	}
+
+	for (auto row = std::size_t{}; row < left.rows(); ++row)
+	{
+		for (auto col = std::size_t{}; col < left.cols(); ++col)
+		{
+			// Written so NaN fails too
+			if (!(std::abs(left(row, col) - right(row, col)) <= tolerance))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Fractions that tell every position apart and need every digit to be read back exactly, for round trips through files
+[[nodiscard]] inline auto reciprocals(std::size_t rows, std::size_t cols) -> mpp::mat<double>
+{
+	return mpp::mat<double>(rows, cols, [i = 0.0]() mutable {
+		return 1.0 / (i += 1.0);
+	});
+}
+
+// Small integers, so products are exact whatever order they're summed in
+[[nodiscard]] inline auto numbered(std::size_t rows, std::size_t cols, int seed) -> mpp::mat<double>
+{
+	return mpp::mat<double>(rows, cols, [i = seed]() mutable {
+		i = (i * 37 + 11) % 19;
+		return static_cast<double>(i - 9);
+	});
+}
+
+// 5-point stencil of a side x side grid, unsymmetric when skew isn't zero
+[[nodiscard]] inline auto laplacian(std::size_t side, double shift, double skew) -> mpp::sparse_mat<double>
+{
+	auto triplets = std::vector<mpp::triplet<double>>{};
+
+	for (auto y = std::size_t{}; y < side; ++y)
+	{
+		for (auto x = std::size_t{}; x < side; ++x)
+		{
+			const auto node = y * side + x;
+
+			triplets.push_back({ node, node, 4.0 + shift });
+
+			if (x > 0)
+			{
+				triplets.push_back({ node, node - 1, -1.0 - skew });
+				triplets.push_back({ node - 1, node, -1.0 + skew });
+			}
+
+			if (y > 0)
+			{
+				triplets.push_back({ node, node - side, -1.0 });
+				triplets.push_back({ node - side, node, -1.0 });
+			}
+		}
+	}
+
+	return { side * side, side * side, triplets };
+}
@@ -19,14 +19,19 @@
 
 #include <mpp/util/cmp.hpp>
 #include <mpp/algo.hpp>
+#include <mpp/arith.hpp>
 #include <mpp/mat.hpp>
 
 #include "../include/utils.hpp"
 
 #include <compare>
+#include <cstddef>
+#include <string>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 using namespace boost::ut::bdd;
 using namespace boost::ut;
@@ -34,6 +39,17 @@ using namespace mpp;
 
 namespace
 {
+	template<typename T>
+	auto trps_ref(const mat<T>& a)
+	{
+		return mat<T>(a.cols(), a.rows(), [&, idx = std::size_t{}]() mutable {
+			const auto row = idx / a.rows();
+			const auto col = idx++ % a.rows();
+
+			return a(col, row);
+		});
+	}
+
 	template<typename Mats, typename To>
 	void test_det(std::string_view test_name)
 	{
@@ -106,6 +122,133 @@ namespace
 			cmp_mat_to_expr_like(out, mat2);
 		} | Mats{};
 	}
+
+	template<typename T>
+	void test_trps_tiled(std::size_t rows, std::size_t cols)
+	{
+		// Sizes are picked to cross the tile and SIMD block boundaries of the transpose kernel
+		test(std::to_string(rows) + "x" + std::to_string(cols)) = [=]() {
+			const auto a = mat<T>(rows, cols, [i = 0]() mutable {
+				return static_cast<T>(i++);
+			});
+			const auto out = trps(a);
+
+			expect(out.rows() == cols);
+			expect(out.cols() == rows);
+			cmp_mat_to_expr_like(out, trps_ref(a));
+		};
+	}
+
+	template<typename Mats>
+	void test_trps_lazy(std::string_view test_name)
+	{
+		test(test_name.data()) = [test_name]<typename Mat, typename Mat2>(
+									 std::tuple<std::type_identity<Mat>, std::type_identity<Mat2>>) {
+			const auto [mat, mat2] = parse_test(test_name, parse_mat<Mat>, parse_mat<Mat2>);
+
+			cmp_mat_to_expr_like(mat2, trps(mat, lazy));
+			cmp_mat_to_expr_like(Mat2{ trps(mat, lazy) }, mat2);
+			cmp_mat_to_expr_like(Mat{ trps(trps(mat, lazy), lazy) }, mat);
+		} | Mats{};
+	}
+
+	template<typename Mats>
+	void test_trps_inplace(std::string_view test_name)
+	{
+		test(test_name.data()) = [test_name]<typename Mat, typename Mat2>(
+									 std::tuple<std::type_identity<Mat>, std::type_identity<Mat2>>) {
+			auto [mat, mat2] = parse_test(test_name, parse_mat<Mat>, parse_mat<Mat2>);
+			const auto data  = mat.data();
+
+			trps_inplace(mat);
+
+			expect(mat.data() == data);
+			cmp_mat_to_expr_like(mat, mat2);
+		} | Mats{};
+	}
+
+	template<typename T>
+	void test_trps_inplace_sizes(std::size_t rows, std::size_t cols)
+	{
+		test(std::to_string(rows) + "x" + std::to_string(cols) + " in place") = [=]() {
+			auto a = mat<T>(rows, cols, [i = 0]() mutable {
+				return static_cast<T>(i++);
+			});
+			const auto expected = trps_ref(a);
+
+			trps_inplace(a);
+
+			cmp_mat_to_expr_like(a, expected);
+		};
+	}
+
+	template<typename Mats>
+	void test_grouped_mul(std::string_view test_name)
+	{
+		test(test_name.data()) =
+			[test_name]<typename Mat, typename Mat2, typename Mat3>(
+				std::tuple<std::type_identity<Mat>, std::type_identity<Mat2>, std::type_identity<Mat3>>) {
+				const auto [mat, mat2, mat3] = parse_test(test_name, parse_mat<Mat>, parse_mat<Mat2>, parse_mat<Mat3>);
+
+				auto outs     = std::vector<Mat3>(4);
+				auto problems = std::vector<std::tuple<const Mat&, const Mat2&, Mat3&>>{};
+
+				for (auto& out : outs)
+				{
+					problems.emplace_back(mat, mat2, out);
+				}
+
+				grouped_mul(problems);
+
+				for (const auto& out : outs)
+				{
+					cmp_mat_to_expr_like(out, mat3);
+				}
+			} |
+			Mats{};
+	}
+
+	void test_grouped_mul_shapes()
+	{
+		test("Mixed shapes") = []() {
+			// Wildly different sizes exercise both the tiling of big problems and the batching of small ones
+			const auto dims = std::vector<std::tuple<std::size_t, std::size_t, std::size_t>>{ { 1, 1, 1 },
+				{ 3, 7, 2 },
+				{ 150, 90, 170 },
+				{ 16, 300, 5 },
+				{ 0, 4, 4 },
+				{ 64, 64, 64 },
+				{ 9, 1, 33 } };
+
+			auto as   = std::vector<mat<int>>{};
+			auto bs   = std::vector<mat<int>>{};
+			auto outs = std::vector<mat<int>>(dims.size());
+
+			for (const auto& [m, k, n] : dims)
+			{
+				as.emplace_back(m, k, [i = 0]() mutable {
+					return i++ % 9 - 4;
+				});
+				bs.emplace_back(k, n, [i = 0]() mutable {
+					return i++ % 4 - 1;
+				});
+			}
+
+			auto problems = std::vector<std::tuple<const mat<int>&, const mat<int>&, mat<int>&>>{};
+
+			for (auto idx = std::size_t{}; idx < dims.size(); ++idx)
+			{
+				problems.emplace_back(as[idx], bs[idx], outs[idx]);
+			}
+
+			grouped_mul(problems);
+
+			for (auto idx = std::size_t{}; idx < dims.size(); ++idx)
+			{
+				cmp_mat_to_expr_like(outs[idx], as[idx] * bs[idx]);
+			}
+		};
+	}
 } // namespace
 
 int main()
@@ -117,12 +260,36 @@ int main()
 		test_det<all_mats<float, 3, 3>, float>("algos/det/3x3.txt");
 		test_det<all_mats<double, 10, 10>, double>("algos/det/10x10.txt");
 		test_det<all_mats<double, 20, 20>, double>("algos/det/20x20.txt");
+		test_det<other_layout_mats<float>, float>("algos/det/3x3.txt");
+		test_det<other_layout_mats<double>, double>("algos/det/10x10.txt");
 	};
 
 	feature("Transpose") = []() {
 		test_fn<join_mats<all_mats<float, 25, 25>, all_mats<float, 25, 25>>>("algos/trps/25x25.txt", trps);
 		test_fn<join_mats<all_mats<float, 50, 2>, all_mats<float, 2, 50>>>("algos/trps/50x2.txt", trps);
 		test_fn<join_mats<all_mats<float, 3, 2>, all_mats<float, 2, 3>>>("algos/trps/3x2.txt", trps);
+		test_trps_tiled<float>(131, 77);
+		test_trps_tiled<double>(300, 300);
+		test_trps_tiled<int>(65, 190);
+		test_trps_tiled<float>(1, 1000);
+
+		test_trps_inplace<join_mats<all_mats<float, 25, 25>, all_mats<float, 25, 25>>>("algos/trps/25x25.txt");
+		test_trps_inplace<join_mats<all_mats<float, 50, 2>, all_mats<float, 2, 50>>>("algos/trps/50x2.txt");
+		test_trps_inplace<join_mats<all_mats<float, 3, 2>, all_mats<float, 2, 3>>>("algos/trps/3x2.txt");
+		test_trps_lazy<join_mats<all_mats<float, 25, 25>, all_mats<float, 25, 25>>>("algos/trps/25x25.txt");
+		test_trps_lazy<join_mats<all_mats<float, 50, 2>, all_mats<float, 2, 50>>>("algos/trps/50x2.txt");
+		test_trps_lazy<join_mats<all_mats<float, 3, 2>, all_mats<float, 2, 3>>>("algos/trps/3x2.txt");
+		test_trps_inplace_sizes<double>(300, 300);
+		test_trps_inplace_sizes<int>(131, 77);
+		test_trps_inplace_sizes<float>(1, 40);
+
+		test_fn<join_mats<other_layout_mats<float>, other_layout_mats<float>>>("algos/trps/25x25.txt", trps);
+		test_fn<join_mats<other_layout_mats<float>, other_layout_mats_reverse<float>>>("algos/trps/50x2.txt", trps);
+		test_fn<join_mats<all_mats<float, 3, 2>, other_layout_mats<float>>>("algos/trps/3x2.txt", trps);
+		test_trps_inplace<join_mats<other_layout_mats<float>, other_layout_mats<float>>>("algos/trps/25x25.txt");
+		test_trps_inplace<join_mats<layout_mats<float, col_major>, layout_mats<float, col_major>>>(
+			"algos/trps/50x2.txt");
+		test_trps_lazy<join_mats<other_layout_mats<float>, other_layout_mats_reverse<float>>>("algos/trps/50x2.txt");
 	};
 
 	feature("Inverse") = []() {
@@ -132,28 +299,49 @@ int main()
 		test_fn<join_mats<all_mats<float, 3, 3>, all_mats<float, 3, 3>>>("algos/inv/3x3_int.txt", inv);
 		test_fn<join_mats<all_mats<double, 3, 3>, all_mats<double, 3, 3>>>("algos/inv/3x3.txt", inv);
 		test_fn<join_mats<all_mats<float, 10, 10>, all_mats<float, 10, 10>>>("algos/inv/10x10.txt", inv);
+		test_fn<join_mats<other_layout_mats<float>, other_layout_mats_reverse<float>>>("algos/inv/2x2.txt", inv);
+		test_fn<join_mats<other_layout_mats<float>, other_layout_mats<float>>>("algos/inv/10x10.txt", inv);
 	};
 
 	feature("Forward substitution") = []() {
 		test_sub<join_mats<all_mats<double, 4, 4>, all_mats<double, 4, 1>, all_mats<double, 4, 1>>>(
 			"algos/fwd_sub/4x4_4x1.txt",
 			fwd_sub);
+		test_sub<join_mats<other_layout_mats<double>, other_layout_mats_reverse<double>, other_layout_mats<double>>>(
+			"algos/fwd_sub/4x4_4x1.txt",
+			fwd_sub);
 	};
 
 	feature("Backward substitution") = []() {
 		test_sub<join_mats<all_mats<double, 3, 3>, all_mats<double, 3, 1>, all_mats<double, 3, 1>>>(
 			"algos/back_sub/3x3_3x1.txt",
 			back_sub);
+		test_sub<join_mats<other_layout_mats<double>, other_layout_mats_reverse<double>, other_layout_mats<double>>>(
+			"algos/back_sub/3x3_3x1.txt",
+			back_sub);
 	};
 
 	feature("LU Decomposition") = []() {
 		test_lu<join_mats<all_mats<double, 2, 2>, all_mats<double, 2, 2>>>("algos/lu/2x2.txt");
 		test_lu<join_mats<all_mats<double, 3, 3>, all_mats<double, 3, 3>>>("algos/lu/3x3.txt");
+		test_lu<join_mats<other_layout_mats<double>, other_layout_mats_reverse<double>>>("algos/lu/3x3.txt");
 	};
 
 	feature("Block") = []() {
 		test_block<join_mats<all_mats<double, 3, 3>, all_mats<double, 1, 1>>>("algos/block/3x3_1x1_0_0_0_0.txt");
 		test_block<join_mats<all_mats<double, 4, 4>, all_mats<double, 2, 2>>>("algos/block/4x4_2x2_2_2_3_3.txt");
+		test_block<join_mats<other_layout_mats<double>, other_layout_mats<double>>>(
+			"algos/block/4x4_2x2_2_2_3_3.txt");
+		test_block<join_mats<other_layout_mats<double>, other_layout_mats_reverse<double>>>(
+			"algos/block/4x4_2x2_2_2_3_3.txt");
+	};
+
+	feature("Grouped multiplication") = []() {
+		test_grouped_mul<join_mats<all_mats<int, 2, 3>, all_mats<int, 3, 1>, all_mats<int, 2, 1>>>(
+			"algos/grouped_mul/2x3_3x1.txt");
+		test_grouped_mul<join_mats<other_layout_mats<int>, other_layout_mats_reverse<int>, other_layout_mats<int>>>(
+			"algos/grouped_mul/2x3_3x1.txt");
+		test_grouped_mul_shapes();
 	};
 
 	return 0;
@@ -19,11 +19,17 @@
 
 #include <boost/ut.hpp>
 
+#include <mpp/algo/trps.hpp>
+#include <mpp/util/cfg.hpp>
 #include <mpp/arith.hpp>
 #include <mpp/mat.hpp>
 
 #include "../include/utils.hpp"
 
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
 using namespace boost::ut;
 using namespace boost::ut::bdd;
 using namespace mpp;
@@ -85,6 +91,103 @@ namespace
 			cmp_mat_to_expr_like(out, expected_mat);
 		} | Mats{};
 	}
+
+	auto naive_mul(const auto& a, const auto& b)
+	{
+		using mat_t = std::remove_cvref_t<decltype(a)>;
+
+		auto out = mat_t(a.rows(), b.cols());
+
+		for (auto row = std::size_t{}; row < a.rows(); ++row)
+		{
+			for (auto col = std::size_t{}; col < b.cols(); ++col)
+			{
+				for (auto idx = std::size_t{}; idx < a.cols(); ++idx)
+				{
+					out(row, col) += a(row, idx) * b(idx, col);
+				}
+			}
+		}
+
+		return out;
+	}
+
+	void test_blocked_mul(std::size_t m, std::size_t k, std::size_t n)
+	{
+		// Sizes are picked to cross the blocking boundaries of the GEMM kernel, and integers keep the comparison exact
+		test(std::to_string(m) + "x" + std::to_string(k) + " * " + std::to_string(k) + "x" + std::to_string(n)) =
+			[=]() {
+				const auto a = mat<int>(m, k, [i = 0]() mutable {
+					return i++ % 7 - 3;
+				});
+				const auto b = mat<int>(k, n, [i = 0]() mutable {
+					return i++ % 5 - 2;
+				});
+
+				cmp_mat_to_expr_like(mat<int>{ a * b }, naive_mul(a, b));
+				cmp_mat_to_expr_like(mat<int>{ (a + a) * b }, naive_mul(mat<int>{ a + a }, b));
+			};
+	}
+
+	void test_trps_lazy_ops(std::size_t m, std::size_t k, std::size_t n)
+	{
+		test(std::to_string(m) + "x" + std::to_string(k) + " * " + std::to_string(k) + "x" + std::to_string(n) +
+			" (with lazy transposes)") = [=]() {
+			const auto a = mat<int>(k, m, [i = 0]() mutable {
+				return i++ % 7 - 3;
+			});
+			const auto b = mat<int>(n, k, [i = 0]() mutable {
+				return i++ % 5 - 2;
+			});
+			const auto a_trps = trps(a);
+			const auto b_trps = trps(b);
+
+			cmp_mat_to_expr_like(mat<int>{ trps(a, lazy) * b_trps }, naive_mul(a_trps, b_trps));
+			cmp_mat_to_expr_like(mat<int>{ a_trps * trps(b, lazy) }, naive_mul(a_trps, b_trps));
+			cmp_mat_to_expr_like(mat<int>{ trps(a, lazy) * trps(b, lazy) }, naive_mul(a_trps, b_trps));
+			cmp_mat_to_expr_like(mat<int>{ a_trps + trps(a, lazy) }, mat<int>{ a_trps + a_trps });
+		};
+	}
+
+	template<typename Layout, typename Layout2>
+	void test_layout_mul(std::size_t m, std::size_t k, std::size_t n)
+	{
+		test(std::to_string(m) + "x" + std::to_string(k) + " * " + std::to_string(k) + "x" + std::to_string(n) +
+			" (mixed layouts)") = [=]() {
+			const auto a = mat<int>(m, k, [i = 0]() mutable {
+				return i++ % 7 - 3;
+			});
+			const auto b = mat<int>(k, n, [i = 0]() mutable {
+				return i++ % 5 - 2;
+			});
+			const auto a2 = mat<int, std::vector<int>, Layout>{ a };
+			const auto b2 = mat<int, std::vector<int>, Layout2>{ b };
+			const auto expected = naive_mul(a, b);
+
+			cmp_mat_to_expr_like(mat<int>{ a2 * b2 }, expected);
+			cmp_mat_to_expr_like(mat<int, std::vector<int>, Layout>{ a2 * b2 }, expected);
+			cmp_mat_to_expr_like(mat<int, std::vector<int>, Layout2>{ a * b2 }, expected);
+		};
+	}
+
+	void test_strassen_mul(std::size_t m, std::size_t k, std::size_t n, std::size_t crossover)
+	{
+		test(std::to_string(m) + "x" + std::to_string(k) + " * " + std::to_string(k) + "x" + std::to_string(n) +
+			" (crossover " + std::to_string(crossover) + ")") = [=]() {
+			const auto a = mat<int>(m, k, [i = 0]() mutable {
+				return i++ % 11 - 5;
+			});
+			const auto b = mat<int>(k, n, [i = 0]() mutable {
+				return i++ % 3 - 1;
+			});
+
+			set_strassen_crossover(crossover);
+			const auto out = mat<int>{ a * b };
+			set_strassen_crossover(0);
+
+			cmp_mat_to_expr_like(out, naive_mul(a, b));
+		};
+	}
 } // namespace
 
 int main()
@@ -94,6 +197,9 @@ int main()
 			std::plus{});
 		test_op<join_mats<all_mats<int, 2, 3>, all_mats<int, 2, 3>, all_mats<int, 2, 3>>, true>("ariths/2x3_add.txt",
 			std::plus{});
+		test_op<join_mats<other_layout_mats<int>, other_layout_mats_reverse<int>, other_layout_mats<int>>, true>(
+			"ariths/2x3_add.txt",
+			std::plus{});
 	};
 
 	feature("Subtraction") = []() {
@@ -103,6 +209,9 @@ int main()
 		test_op<join_mats<all_mats<int, 2, 3>, all_mats<int, 2, 3>, all_mats<int, 2, 3>>, true>(
 			"ariths/2x3_subtract.txt",
 			std::minus{});
+		test_op<join_mats<other_layout_mats<int>, other_layout_mats_reverse<int>, other_layout_mats<int>>, true>(
+			"ariths/2x3_subtract.txt",
+			std::minus{});
 	};
 
 	feature("Multiplication (matrix multiplied with scalar)") = []() {
@@ -110,6 +219,8 @@ int main()
 			std::multiplies{});
 		test_num_op<join_mats<all_mats<int, 2, 3>, all_mats<int, 2, 3>>, true>("ariths/2x3_multiply.txt",
 			std::multiplies{});
+		test_num_op<join_mats<other_layout_mats<int>, other_layout_mats_reverse<int>>, true>("ariths/2x3_multiply.txt",
+			std::multiplies{});
 	};
 
 	feature("Multiplication (matrix multiplied with matrix)") = []() {
@@ -119,6 +230,28 @@ int main()
 		test_op<join_mats<all_mats<int, 2, 3>, all_mats<int, 3, 1>, all_mats<int, 2, 1>>, true>(
 			"ariths/2x3_3x1_multiply.txt",
 			std::multiplies{});
+		test_op<join_mats<other_layout_mats<int>, other_layout_mats_reverse<int>, other_layout_mats<int>>, true>(
+			"ariths/2x3_3x1_multiply.txt",
+			std::multiplies{});
+	};
+
+	feature("Multiplication (blocked matrix multiplication)") = []() {
+		test_blocked_mul(37, 300, 45);
+		test_blocked_mul(130, 517, 9);
+		test_blocked_mul(200, 64, 2100);
+		test_layout_mul<col_major, row_major>(37, 300, 45);
+		test_layout_mul<padded_row_major<8>, col_major>(130, 517, 9);
+	};
+
+	feature("Multiplication (lazy transposed operands)") = []() {
+		test_trps_lazy_ops(3, 2, 4);
+		test_trps_lazy_ops(70, 301, 33);
+	};
+
+	feature("Multiplication (Strassen-Winograd matrix multiplication)") = []() {
+		test_strassen_mul(128, 128, 128, 16);
+		test_strassen_mul(101, 75, 67, 8);
+		test_strassen_mul(64, 300, 40, 64);
 	};
 
 	feature("Division (matrix divided with scalar)") = []() {
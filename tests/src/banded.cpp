@@ -0,0 +1,327 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/ut.hpp>
+
+#include <mpp/algo.hpp>
+#include <mpp/arith.hpp>
+#include <mpp/banded.hpp>
+#include <mpp/mat.hpp>
+#include <mpp/util/cfg.hpp>
+#include <mpp/util/cmp.hpp>
+
+#include "../include/utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <compare>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// Small integers in a band, with a diagonal that dominates its row and column
+	[[nodiscard]] auto dominant_band(std::size_t n, std::size_t lower, std::size_t upper, int seed) -> mpp::mat<double>
+	{
+		auto obj = numbered(n, n, seed);
+
+		for (auto row = std::size_t{}; row < n; ++row)
+		{
+			for (auto col = std::size_t{}; col < n; ++col)
+			{
+				if (row > col + lower || col > row + upper)
+				{
+					obj(row, col) = 0.0;
+				}
+			}
+
+			obj(row, row) = 10.0 * static_cast<double>(lower + upper + 1);
+		}
+
+		return obj;
+	}
+
+	// Symmetric positive definite with `width` diagonals on each side
+	[[nodiscard]] auto spd_band(std::size_t n, std::size_t width) -> mpp::mat<double>
+	{
+		auto obj = dominant_band(n, width, width, 5);
+
+		for (auto row = std::size_t{}; row < n; ++row)
+		{
+			for (auto col = row + 1; col < n; ++col)
+			{
+				obj(col, row) = obj(row, col);
+			}
+		}
+
+		return obj;
+	}
+
+	// Diagonally dominant diagonals of a tridiagonal system
+	[[nodiscard]] auto tridiagonal(std::size_t n, double shift) -> mpp::tridiag_mat<double>
+	{
+		auto obj = mpp::tridiag_mat<double>(n);
+
+		for (auto idx = std::size_t{}; idx < n; ++idx)
+		{
+			obj.diag()[idx] = 4.0 + shift + static_cast<double>(idx % 3);
+
+			if (idx + 1 < n)
+			{
+				obj.lower()[idx] = -1.0 - static_cast<double>(idx % 2);
+				obj.upper()[idx] = 1.5 - shift;
+			}
+		}
+
+		return obj;
+	}
+} // namespace
+
+int main()
+{
+	using namespace boost::ut::bdd;
+	using namespace boost::ut;
+	using namespace mpp;
+
+	feature("Banded matrices") = []() {
+		const auto dense = dominant_band(6, 1, 2, 1);
+		const auto obj   = band_mat{ dense, 1, 2 };
+
+		expect(obj.rows() == 6_ul && obj.cols() == 6_ul && obj.lower() == 1_ul && obj.upper() == 2_ul);
+		expect(obj.ld() == 4_ul && obj.bands().size() == 24_ul);
+		expect(same_elems(mat<double>{ obj }, dense));
+
+		// The layout of LAPACK, with the slots outside the matrix left at zero
+		expect(obj.bands()[2 + 2 - 1 + 1 * 4] == dense(2, 1) && obj.bands()[2 + 0 - 2 + 2 * 4] == dense(0, 2));
+		expect(obj.bands()[0] == 0.0_d && obj.bands()[23] == 0.0_d);
+		expect(!obj.in_band(0, 3) && obj(0, 3) == 0.0_d && obj(5, 0) == 0.0_d);
+
+		auto changed     = obj;
+		changed.at(4, 3) = 7.0;
+
+		expect(changed(4, 3) == 7.0_d);
+
+		for (const auto n : { std::size_t{ 1 }, std::size_t{ 3 }, std::size_t{ 17 } })
+		{
+			const auto right = numbered(6, n, 2);
+
+			expect(same_elems(mat<double>{ obj * right }, mat<double>{ dense * right }));
+		}
+
+		const auto tri = tridiagonal(7, 0.0);
+
+		expect(tri.lower().size() == 6_ul && tri.diag().size() == 7_ul && tri.upper().size() == 6_ul);
+		expect(same_elems(mat<double>{ band_mat<double>{ tri } }, mat<double>{ tri }));
+
+		const auto tri_right = numbered(7, 3, 4);
+
+		expect(same_elems(mat<double>{ tri * tri_right }, mat<double>{ mat<double>{ tri } * tri_right }));
+
+		// Wider than tall and the other way around
+		const auto wide = band_mat{ numbered(3, 8, 6), 0, 5 };
+		const auto tall = band_mat{ numbered(8, 3, 7), 4, 1 };
+
+		const auto wide_right = numbered(8, 2, 8);
+		const auto tall_right = numbered(3, 2, 9);
+
+		expect(same_elems(mat<double>{ wide * wide_right }, mat<double>{ mat<double>{ wide } * wide_right }));
+		expect(same_elems(mat<double>{ tall * tall_right }, mat<double>{ mat<double>{ tall } * tall_right }));
+	};
+
+	feature("Banded LU and Cholesky") = []() {
+		const auto dense = dominant_band(40, 2, 3, 3);
+		const auto obj   = band_mat{ dense, 2, 3 };
+		const auto b     = numbered(40, 5, 4);
+
+		const auto factors = band_lu(obj);
+
+		expect(!factors.is_cholesky() && factors.rows() == 40_ul);
+		expect(near_elems(factors.solve(b), mat<double>{ inv(dense) * b }, 1e-12));
+
+		const auto [l, u]             = lu(obj);
+		const auto [dense_l, dense_u] = lu(dense);
+
+		expect(l.lower() == 2_ul && l.upper() == 0_ul && u.lower() == 0_ul && u.upper() == 3_ul);
+		expect(near_elems(l, dense_l, 1e-12) && near_elems(u, dense_u, 1e-12));
+		expect(near_elems(mat<double>{ l * mat<double>{ u } }, dense, 1e-12));
+
+		// Only the lower band of a symmetric matrix is read
+		const auto spd = spd_band(40, 2);
+		auto one_sided = band_mat{ spd, 2, 2 };
+
+		for (auto col = std::size_t{ 1 }; col < 40; ++col)
+		{
+			one_sided.at(col - 1, col) = 0.0;
+		}
+
+		const auto chol = band_cholesky(one_sided);
+		const auto x    = chol.solve(b);
+
+		expect(chol.is_cholesky() && chol.factors().upper() == 0_ul);
+		expect(near_elems(mat<double>{ spd * x }, b, 1e-10));
+
+		auto single = std::vector<double>(40);
+
+		for (auto idx = std::size_t{}; idx < 40; ++idx)
+		{
+			single[idx] = b(idx, 2);
+		}
+
+		chol.solve_inplace(single);
+
+		expect(std::ranges::all_of(std::vector<std::size_t>{ 0, 17, 39 }, [&](std::size_t idx) {
+			return std::abs(single[idx] - x(idx, 2)) < 1e-12;
+		}));
+	};
+
+	feature("Tridiagonal solves") = []() {
+		const auto obj = tridiagonal(50, 0.5);
+		const auto b   = numbered(50, 3, 1);
+		const auto x   = tridiag_solve(obj, b);
+
+		expect(near_elems(x, band_lu(band_mat<double>{ obj }).solve(b), 1e-12));
+		expect(near_elems(mat<double>{ obj * x }, b, 1e-12));
+
+		auto single  = std::vector<double>(50);
+		auto scratch = std::vector<double>(50);
+
+		for (auto idx = std::size_t{}; idx < 50; ++idx)
+		{
+			single[idx] = b(idx, 1);
+		}
+
+		tridiag_solve(obj, std::span{ single }, std::span{ scratch });
+
+		expect(std::abs(single[0] - x(0, 1)) < 1e-12 && std::abs(single[49] - x(49, 1)) < 1e-12);
+
+		// Systems of one row and of none
+		expect(tridiag_solve(tridiagonal(1, 0.0), mat<double>{ { 8.0 } })(0, 0) == 2.0_d);
+		expect(tridiag_solve(tridiag_mat<double>{}, mat<double>{}).rows() == 0_ul);
+
+		// Interleaved systems, each against a solve of its own
+		constexpr auto rows    = std::size_t{ 30 };
+		constexpr auto systems = std::size_t{ 7 };
+
+		auto lower = std::vector<double>(rows * systems);
+		auto diag  = std::vector<double>(rows * systems);
+		auto upper = std::vector<double>(rows * systems);
+		auto rhs   = std::vector<double>(rows * systems);
+		auto work  = std::vector<double>(rows * systems);
+		const auto sides = numbered(rows, 3, 2);
+
+		for (auto sys = std::size_t{}; sys < systems; ++sys)
+		{
+			const auto one = tridiagonal(rows, static_cast<double>(sys) / 4.0);
+
+			for (auto row = std::size_t{}; row < rows; ++row)
+			{
+				diag[row * systems + sys]  = one.diag()[row];
+				lower[row * systems + sys] = row > 0 ? one.lower()[row - 1] : 99.0;
+				upper[row * systems + sys] = row + 1 < rows ? one.upper()[row] : 99.0;
+				rhs[row * systems + sys]   = sides(row, sys % 3);
+			}
+		}
+
+		tridiag_solve_batch(std::span<const double>{ lower },
+			std::span<const double>{ diag },
+			std::span<const double>{ upper },
+			std::span{ rhs },
+			std::span{ work },
+			systems);
+
+		for (auto sys = std::size_t{}; sys < systems; ++sys)
+		{
+			const auto expected = tridiag_solve(tridiagonal(rows, static_cast<double>(sys) / 4.0), sides);
+			auto max_diff       = 0.0;
+
+			for (auto row = std::size_t{}; row < rows; ++row)
+			{
+				max_diff = std::max(max_diff, std::abs(rhs[row * systems + sys] - expected(row, sys % 3)));
+			}
+
+			expect(max_diff < 1e-12);
+		}
+	};
+
+	feature("Banded kernels on several threads") = []() {
+		constexpr auto n       = std::size_t{ 100000 };
+		constexpr auto systems = std::size_t{ 300 };
+		constexpr auto rows    = std::size_t{ 500 };
+
+		const auto obj   = band_mat{ dominant_band(200, 2, 2, 6), 2, 2 };
+		const auto large = [&]() {
+			auto out = band_mat<double>(n, n, 2, 2);
+
+			for (auto idx = std::size_t{}; idx < out.bands().size(); ++idx)
+			{
+				out.bands()[idx] = obj.bands()[idx % obj.bands().size()];
+			}
+
+			return out;
+		}();
+
+		const auto right = numbered(n, 2, 3);
+		const auto tri   = tridiagonal(n, 0.0);
+
+		auto lower = std::vector<double>(rows * systems, -1.0);
+		auto diag  = std::vector<double>(rows * systems);
+		auto upper = std::vector<double>(rows * systems, -1.0);
+
+		for (auto idx = std::size_t{}; idx < diag.size(); ++idx)
+		{
+			diag[idx] = 3.0 + static_cast<double>(idx % 5);
+		}
+
+		const auto run = [&]() {
+			auto rhs     = std::vector<double>(rows * systems, 1.0);
+			auto scratch = std::vector<double>(rows * systems);
+
+			tridiag_solve_batch(std::span<const double>{ lower },
+				std::span<const double>{ diag },
+				std::span<const double>{ upper },
+				std::span{ rhs },
+				std::span{ scratch },
+				systems);
+
+			return std::make_pair(std::make_pair(mat<double>{ large * right }, mat<double>{ tri * right }), rhs);
+		};
+
+		const auto threads = max_threads();
+
+		set_max_threads(1);
+		const auto serial = run();
+
+		set_max_threads(4);
+		const auto parallel = run();
+
+		set_max_threads(threads);
+
+		expect(same_elems(serial.first.first, parallel.first.first));
+		expect(same_elems(serial.first.second, parallel.first.second));
+		expect(serial.second == parallel.second);
+
+		// A million rows in O(n)
+		const auto huge = tridiagonal(1000000, 0.0);
+		const auto x    = tridiag_solve(huge, numbered(1000000, 1, 5));
+
+		expect(near_elems(mat<double>{ huge * x }, numbered(1000000, 1, 5), 1e-10));
+	};
+}
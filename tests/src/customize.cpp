@@ -76,6 +76,11 @@ namespace ns
 		return dumb_class2{};
 	}
 
+	[[nodiscard]] constexpr auto tag_invoke(trps_inplace_t, dumb_class) -> dumb_class2
+	{
+		return dumb_class2{};
+	}
+
 	[[nodiscard]] constexpr auto tag_invoke(cmp_t, dumb_class) -> dumb_class2
 	{
 		return dumb_class2{};
@@ -95,6 +100,11 @@ namespace ns
 	{
 		return dumb_class2{};
 	}
+
+	[[nodiscard]] constexpr auto tag_invoke(grouped_mul_t, dumb_class) -> dumb_class2
+	{
+		return dumb_class2{};
+	}
 } // namespace ns
 
 template<typename CPO>
@@ -107,10 +117,13 @@ int main()
 		expect(type<invoke_result_t<det_t>> == type<ns::dumb_class2>);
 		expect(type<invoke_result_t<inv_t>> == type<ns::dumb_class2>);
 		expect(type<invoke_result_t<trps_t>> == type<ns::dumb_class2>);
+		expect(type<invoke_result_t<trps_inplace_t>> == type<ns::dumb_class2>);
 		expect(type<invoke_result_t<cmp_t>> == type<ns::dumb_class2>);
 		expect(type<invoke_result_t<lu_t>> == type<ns::dumb_class2>);
 		expect(type<invoke_result_t<fwd_sub_t>> == type<ns::dumb_class2>);
 		expect(type<invoke_result_t<back_sub_t>> == type<ns::dumb_class2>);
+
+		expect(type<invoke_result_t<grouped_mul_t>> == type<ns::dumb_class2>);
 	};
 
 	when("I check the properties of the matrix with customized buffer") = []() {
@@ -137,10 +150,13 @@ int main()
 		expect(constant<std::semiregular<det_t>>);
 		expect(constant<std::semiregular<inv_t>>);
 		expect(constant<std::semiregular<trps_t>>);
+		expect(constant<std::semiregular<trps_inplace_t>>);
 		expect(constant<std::semiregular<cmp_t>>);
 		expect(constant<std::semiregular<lu_t>>);
 		expect(constant<std::semiregular<fwd_sub_t>>);
 		expect(constant<std::semiregular<back_sub_t>>);
+
+		expect(constant<std::semiregular<grouped_mul_t>>);
 	};
 
 	return 0;
@@ -137,5 +137,25 @@ int main()
 		test_init<all_mats<int, 3, 3>>("init/3x3_identity.txt", parse_mat_construct_args, 3ull, 3ull, identity);
 	};
 
+	feature("Initialization with other layouts") = []() {
+		test_init_copy_move_ctor<join_mats<all_mats<int, 2, 3>, other_layout_mats<int>>, false>(
+			"init/2x3_init_copy_and_move.txt");
+		test_init_copy_move_ctor<join_mats<other_layout_mats<int>, other_layout_mats_reverse<int>>, true>(
+			"init/2x3_init_copy_and_move.txt");
+		test_init<other_layout_mats<int>>("init/2x3_rng_2d.txt", parse_mat_construct_rng2d<false>);
+		test_init<other_layout_mats<int>>("init/2x3_val.txt", parse_mat_construct_args, 2ull, 3ull, 2);
+		test_init<other_layout_mats<int>>("init/3x3_identity.txt", parse_mat_construct_args, 3ull, 3ull, identity);
+
+		// 1D ranges are read in storage order
+		test_init<layout_mats<int, col_major>>("init/2x3_rng_1d_col_major.txt", parse_mat_construct_rng1d<false>);
+		test_init<layout_mats<int, padded_row_major<4>>>("init/2x3_rng_1d.txt", parse_mat_construct_rng1d<true>);
+
+		// Fixed buffers of padded layouts hold the padding too, smaller ones trip an assert
+		auto padded = mat<float, std::array<float, 2 * 8>, padded_row_major<8>>{ 2, 3, 1.0f };
+		padded(1, 2) = 5.0f;
+
+		expect(padded(0, 0) == 1.0_f && padded(1, 2) == 5.0_f);
+	};
+
 	return 0;
 }
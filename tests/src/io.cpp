@@ -0,0 +1,466 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/ut.hpp>
+
+#include <mpp/algo.hpp>
+#include <mpp/arith.hpp>
+#include <mpp/io.hpp>
+#include <mpp/mat.hpp>
+#include <mpp/util/cmp.hpp>
+
+#include "../include/utils.hpp"
+
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+	void write_file(const std::filesystem::path& path, const std::string& contents)
+	{
+		auto file = std::ofstream{ path, std::ios::binary | std::ios::trunc };
+		file << contents;
+	}
+} // namespace
+
+int main()
+{
+	using namespace boost::ut::bdd;
+	using namespace boost::ut;
+	using namespace mpp;
+
+	feature("Binary round trips") = []() {
+		const auto path     = temp_path("round_trip.bin");
+		const auto expected = reciprocals(5, 7);
+
+		const auto check_layouts = [&]() {
+			expect(same_elems(load_binary<double>(path), expected));
+			expect(same_elems(load_binary<double, col_major>(path), expected));
+			expect(same_elems(load_binary<double, padded_row_major<4>>(path), expected));
+		};
+
+		save_binary(path, expected);
+		check_layouts();
+
+		save_binary(path, mat<double, std::vector<double>, col_major>{ expected });
+		check_layouts();
+
+		save_binary(path, mat<double, std::vector<double>, padded_row_major<4>>{ expected });
+		check_layouts();
+
+		const auto info = read_binary_info(path);
+
+		expect(info.kind == 'f');
+		expect(info.elem_size == 8_ul);
+		expect(info.rows == 5_ul);
+		expect(info.cols == 7_ul);
+		expect(!info.col_major);
+
+		// Integers keep their exact values, and empty matrices stay empty
+		const auto ints = mat<std::int64_t>{ { -1, 2 }, { 3, -4 } };
+		save_binary(path, ints);
+		expect(same_elems(load_binary<std::int64_t>(path), ints));
+
+		save_binary(path, mat<double>{});
+		expect(load_binary<double>(path).empty());
+
+		std::filesystem::remove(path);
+	};
+
+	feature("Mapped binary matrices") = []() {
+		const auto path     = temp_path("mapped.bin");
+		const auto expected = reciprocals(6, 6);
+
+		save_binary(path, expected);
+
+		const auto view = map_binary<double>(path);
+
+		expect(same_elems(view, expected));
+		expect(reinterpret_cast<std::uintptr_t>(view.data()) % 64 == 0_ul);
+
+		// Non-const views can be read through the usual accessors
+		auto mutable_view = map_binary<double>(path);
+		expect(mutable_view(0, 0) == expected(0, 0));
+		expect(mutable_view(5, 4) == expected(5, 4));
+		expect(mutable_view[7] == expected[7]);
+		expect(mutable_view.front() == expected.front() and mutable_view.back() == expected.back());
+		expect(constant<std::same_as<decltype(mutable_view(0, 0)), const double&>>);
+
+		// Copies share the mapping, which outlives the file
+		const auto copy = view;
+		expect(copy.data() == view.data());
+
+		std::filesystem::remove(path);
+		expect(same_elems(copy, expected));
+
+		// Results of algorithms and expressions get buffers of their own
+		const auto transposed = trps(view);
+		expect(constant<std::same_as<std::remove_cvref_t<decltype(transposed)>, mat<double>>>);
+		expect(same_elems(transposed, trps(expected)));
+
+		const auto product = mat<double>{ view * view };
+		expect(same_elems(product, mat<double>{ expected * expected }));
+
+		expect(det(view) == det(expected));
+
+		const auto col_path = temp_path("mapped_col.bin");
+		save_binary(col_path, mat<double, std::vector<double>, col_major>{ expected });
+
+		expect(same_elems(map_binary<double, col_major>(col_path), expected));
+
+		std::filesystem::remove(col_path);
+	};
+
+	feature("Binary errors") = []() {
+		const auto path = temp_path("errors.bin");
+
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = load_binary<double>(temp_path("missing.bin"));
+		}));
+
+		save_binary(path, reciprocals(4, 4));
+
+		// The element type has to match exactly, and views can't change the layout
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = load_binary<float>(path);
+		}));
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = map_binary<double, col_major>(path);
+		}));
+
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = load_binary<double>(path);
+		}));
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = map_binary<double>(path);
+		}));
+
+		// Headers whose element count overflows instead of claiming a huge file
+		{
+			const auto header = mpp::detail::encode_binary_header({ mpp::detail::binary_kind_of<double>(),
+				static_cast<std::uint8_t>(sizeof(double)),
+				mpp::detail::binary_layout_of<row_major>(),
+				std::uint64_t{ 1 } << 61,
+				8,
+				mpp::detail::binary_header_size });
+
+			auto file = std::ofstream{ path, std::ios::binary | std::ios::trunc };
+			file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+			file << std::string(64, '\0');
+		}
+
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = read_binary_info(path);
+		}));
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = load_binary<double>(path);
+		}));
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = map_binary<double>(path);
+		}));
+
+		{
+			auto file = std::ofstream{ path, std::ios::trunc };
+			file << "1 2\n3 4\n";
+		}
+
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = map_binary<double>(path);
+		}));
+
+		std::filesystem::remove(path);
+	};
+
+	feature("Text files") = []() {
+		const auto path = temp_path("text.txt");
+
+		// Sections of the test data: a 2x3 matrix, a scalar and the 2x3 product
+		const auto data_path = std::filesystem::path(TEST_DATA_PATH) / "ariths/2x3_multiply.txt";
+		const auto sections  = read_text_sections<double>(data_path);
+
+		if (!expect(sections.size() == 3_ul))
+		{
+			return;
+		}
+
+		expect(same_elems(sections[0], mat<double>{ { 1, 2, 3 }, { 4, 5, 6 } }));
+		expect(same_elems(sections[1], mat<double>{ { 2 } }));
+		expect(same_elems(sections[2], mat<double>{ { 2, 4, 6 }, { 8, 10, 12 } }));
+
+		// Tabs, carriage returns, plus signs, exponents, blank lines and no final line feed
+		write_file(path, "\n 1\t+2  3 \r\n\n-4 5e0 6\r\n\n");
+		expect(same_elems(read_text<double>(path), mat<double>{ { 1, 2, 3 }, { -4, 5, 6 } }));
+
+		write_file(path, "\n 1\t+2  3 \r\n\n-4 5 6");
+
+		const auto expected = mat<int>{ { 1, 2, 3 }, { -4, 5, 6 } };
+
+		expect(same_elems(read_text<int>(path), expected));
+		expect(same_elems(read_text<int, col_major>(path), expected));
+		expect(same_elems(read_text<int, padded_row_major<4>>(path), expected));
+
+		// Empty sections are empty matrices
+		write_file(path, "=\n=\n");
+
+		const auto empty_sections = read_text_sections<double>(path);
+
+		expect(empty_sections.size() == 3_ul);
+		expect(std::ranges::all_of(empty_sections, [](const auto& obj) {
+			return obj.rows() == 0 && obj.cols() == 0;
+		}));
+
+		std::filesystem::remove(path);
+	};
+
+	feature("Big text files") = []() {
+		const auto path = temp_path("big_text.txt");
+
+		// Several MB, so the file is split into chunks, with a separator somewhere in the middle of one
+		const auto first  = reciprocals(3000, 60);
+		const auto second = reciprocals(1000, 7);
+
+		{
+			auto file = std::ofstream{ path };
+			file << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+			const auto write = [&](const mat<double>& obj) {
+				for (auto row = std::size_t{}; row < obj.rows(); ++row)
+				{
+					for (auto col = std::size_t{}; col < obj.cols(); ++col)
+					{
+						file << obj(row, col) << (col + 1 == obj.cols() ? '\n' : ' ');
+					}
+				}
+			};
+
+			write(first);
+			file << "=\n";
+			write(second);
+		}
+
+		const auto sections = read_text_sections<double>(path);
+
+		if (!expect(sections.size() == 2_ul))
+		{
+			return;
+		}
+
+		expect(same_elems(sections[0], first));
+		expect(same_elems(sections[1], second));
+
+		std::filesystem::remove(path);
+	};
+
+	feature("Text errors") = []() {
+		const auto path = temp_path("text_errors.txt");
+
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = read_text<double>(temp_path("missing.txt"));
+		}));
+
+		// Ragged rows, values that aren't numbers, and fractions where integers are expected
+		for (const auto* contents : { "1 2 3\n4 5\n", "1 2\n3 four\n", "1 2\n3 4.5\n" })
+		{
+			write_file(path, contents);
+
+			expect(throws<std::runtime_error>([&]() {
+				std::ignore = read_text<int>(path);
+			}));
+		}
+
+		// Several matrices can't be read as one
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = read_text<double>(std::filesystem::path(TEST_DATA_PATH) / "ariths/2x3_multiply.txt");
+		}));
+
+		std::filesystem::remove(path);
+	};
+
+	feature("NPY files") = []() {
+		const auto path     = temp_path("mat.npy");
+		const auto expected = reciprocals(4, 5);
+
+		save_npy(path, expected);
+
+		expect(same_elems(load_npy<double>(path), expected));
+		expect(same_elems(load_npy<double, col_major>(path), expected));
+		expect(same_elems(map_npy<double>(path), expected));
+
+		auto view = map_npy<double>(path);
+		expect(view(0, 0) == expected(0, 0) and view(3, 4) == expected(3, 4));
+
+		// Column major matrices are written in Fortran order, which views have to be mapped with
+		save_npy(path, mat<double, std::vector<double>, col_major>{ expected });
+
+		expect(same_elems(load_npy<double>(path), expected));
+		expect(same_elems(map_npy<double, col_major>(path), expected));
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = map_npy<double>(path);
+		}));
+
+		// Expressions and padded matrices are streamed, loads convert the element type
+		save_npy(path, expected * 2.0);
+		expect(same_elems(load_npy<double>(path), mat<double>{ expected * 2.0 }));
+
+		save_npy(path, mat<float>{ { 0.5F, -1.25F } });
+		expect(same_elems(load_npy<double>(path), mat<double>{ { 0.5, -1.25 } }));
+
+		save_npy(path, mat<std::int32_t, std::vector<std::int32_t>, padded_row_major<4>>{ { 1, -2, 3 }, { 4, 5, -6 } });
+		expect(same_elems(load_npy<double>(path), mat<double>{ { 1, -2, 3 }, { 4, 5, -6 } }));
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = map_npy<std::int64_t>(path);
+		}));
+
+		// numpy pads the header so the elements start on a multiple of 64 bytes
+		expect(std::filesystem::file_size(path) == 128 + 6 * 4);
+
+		std::filesystem::remove(path);
+	};
+
+	feature("Handwritten NPY files") = []() {
+		const auto path = temp_path("handwritten.npy");
+
+		// Headers of older numpy versions are padded to 16 bytes, and 1D arrays are column vectors
+		const auto write_npy = [&](std::string dict, const std::string& elems) {
+			dict.append(15 - (10 + dict.size()) % 16, ' ');
+			dict.push_back('\n');
+
+			const auto size = static_cast<char>(dict.size());
+			write_file(path, std::string{ "\x93NUMPY\x01\x00", 8 } + size + '\x00' + dict + elems);
+		};
+
+		const auto le_bytes = [](std::initializer_list<std::int16_t> vals) {
+			auto out = std::string{};
+
+			for (const auto val : vals)
+			{
+				out.push_back(static_cast<char>(val & 0xFF));
+				out.push_back(static_cast<char>((val >> 8) & 0xFF));
+			}
+
+			return out;
+		};
+
+		write_npy("{'descr': '<i2', 'fortran_order': True, 'shape': (2, 2), }", le_bytes({ 1, 2, 3, -4 }));
+		expect(same_elems(load_npy<int>(path), mat<int>{ { 1, 3 }, { 2, -4 } }));
+
+		write_npy("{'descr': '<i2', 'fortran_order': False, 'shape': (3,), }", le_bytes({ 7, 8, 9 }));
+		expect(same_elems(load_npy<int>(path), mat<int>{ { 7 }, { 8 }, { 9 } }));
+
+		// Other byte orders, more dimensions, truncated elements and shapes whose size overflows
+		for (const auto* dict : { "{'descr': '>i2', 'fortran_order': False, 'shape': (1,), }",
+				 "{'descr': '<i2', 'fortran_order': False, 'shape': (1, 1, 1), }",
+				 "{'descr': '<i2', 'fortran_order': False, 'shape': (4,), }",
+				 "{'descr': '<i2', 'fortran_order': False, 'shape': (4611686018427387904, 4), }",
+				 "{'descr': '<f8', 'fortran_order': False, 'shape': (2305843009213693952, 8), }",
+				 "{'descr': '<c16', 'fortran_order': False, 'shape': (1,), }" })
+		{
+			write_npy(dict, le_bytes({ 1, 2, 3 }));
+
+			expect(throws<std::runtime_error>([&]() {
+				std::ignore = load_npy<int>(path);
+			}));
+			expect(throws<std::runtime_error>([&]() {
+				std::ignore = map_npy<std::int16_t>(path);
+			}));
+		}
+
+		std::filesystem::remove(path);
+	};
+
+	feature("Matrix Market files") = []() {
+		const auto path     = temp_path("mat.mtx");
+		const auto expected = mat<double>{ { 0.0, 1.5, 0.0 }, { -2.25, 0.0, 1e-300 } };
+
+		save_matrix_market(path, expected);
+		expect(same_elems(load_matrix_market<double>(path), expected));
+
+		save_matrix_market(path, expected, matrix_market_format::coordinate);
+		expect(same_elems(load_matrix_market<double, col_major>(path), expected));
+
+		// Only the 3 nonzeros are written
+		auto count = 0;
+		auto file  = std::ifstream{ path };
+
+		for (auto line = std::string{}; std::getline(file, line);)
+		{
+			++count;
+		}
+
+		expect(count == 5_i);
+
+		const auto numbers = reciprocals(20, 30);
+		save_matrix_market(path, numbers * 3.0);
+		expect(same_elems(load_matrix_market<double>(path), mat<double>{ numbers * 3.0 }));
+
+		std::filesystem::remove(path);
+	};
+
+	feature("Handwritten Matrix Market files") = []() {
+		const auto path = temp_path("handwritten.mtx");
+
+		write_file(path,
+			"%%MatrixMarket matrix coordinate pattern symmetric\n"
+			"% a comment\n"
+			"\n"
+			"3 3 3\n"
+			"1 1\n"
+			"3 1\n"
+			"3 2\n");
+
+		expect(same_elems(load_matrix_market<int>(path), mat<int>{ { 1, 0, 1 }, { 0, 0, 1 }, { 1, 1, 0 } }));
+
+		// Lower triangles under the diagonal, column by column
+		write_file(path, "%%MatrixMarket MATRIX array integer skew-symmetric\r\n3 3\r\n1\r\n2\r\n3\r\n");
+		expect(same_elems(load_matrix_market<int>(path), mat<int>{ { 0, -1, -2 }, { 1, 0, -3 }, { 2, 3, 0 } }));
+
+		write_file(path, "%%MatrixMarket matrix array real symmetric\n2 2\n1\n2\n3\n");
+		expect(same_elems(load_matrix_market<double>(path), mat<double>{ { 1, 2 }, { 2, 3 } }));
+
+		// Real values into integers, missing or extra entries, positions out of the matrix and unknown banners
+		for (const auto* contents : { "%%MatrixMarket matrix array real general\n1 1\n1.5\n",
+				 "%%MatrixMarket matrix array integer general\n2 1\n1\n",
+				 "%%MatrixMarket matrix array integer general\n1 1\n1\n2\n",
+				 "%%MatrixMarket matrix coordinate integer general\n2 2 1\n3 1 1\n",
+				 "%%MatrixMarket matrix coordinate complex general\n1 1 1\n1 1 1 0\n",
+				 "1 1\n1\n" })
+		{
+			write_file(path, contents);
+
+			expect(throws<std::runtime_error>([&]() {
+				std::ignore = load_matrix_market<int>(path);
+			}));
+		}
+
+		std::filesystem::remove(path);
+	};
+
+	return 0;
+}
@@ -151,5 +151,24 @@ int main()
 		} | mats;
 	};
 
+	feature("Iterators of other layouts") = [&]() {
+		given("(row, col) offsets should follow the storage order") = [&]() {
+			const auto col_mat    = mat<int, std::vector<int>, col_major>{ range_2d };
+			const auto padded_mat = mat<int, std::vector<int>, padded_row_major<4>>{ range_2d };
+
+			expect(*(col_mat.begin() + std::pair{ 1, 2 }) == 6_i);
+			expect(*(col_mat.begin() + std::pair{ 0, 1 }) == 2_i);
+			expect(*(padded_mat.begin() + std::pair{ 1, 2 }) == 6_i);
+
+			auto col_begin = col_mat.begin();
+			col_begin.advance_fwd_rows(1);
+			expect(*col_begin == 4_i);
+
+			auto padded_begin = padded_mat.begin();
+			padded_begin.advance_fwd_rows(1);
+			expect(*padded_begin == 4_i);
+		};
+	};
+
 	return 0;
 }
@@ -0,0 +1,354 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/ut.hpp>
+
+#include <mpp/arith.hpp>
+#include <mpp/iterative.hpp>
+#include <mpp/mat.hpp>
+#include <mpp/sparse.hpp>
+#include <mpp/util/cfg.hpp>
+
+#include "../include/utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// Same as laplacian, with rows and columns scaled by very different factors
+	[[nodiscard]] auto badly_scaled(std::size_t side) -> mpp::sparse_mat<double>
+	{
+		auto obj = laplacian(side, 0.0, 0.0);
+
+		for (auto row = std::size_t{}; row < obj.rows(); ++row)
+		{
+			for (auto idx = obj.offsets()[row]; idx < obj.offsets()[row + 1]; ++idx)
+			{
+				const auto col = obj.indices()[idx];
+				obj.values()[idx] *= static_cast<double>((row % 7 + 1) * (col % 7 + 1));
+			}
+		}
+
+		return obj;
+	}
+
+	// ||b - A * x|| / ||b||, computed independently of the solvers
+	[[nodiscard]] auto relative_residual(const auto& a, const mpp::mat<double>& x, const mpp::mat<double>& b) -> double
+	{
+		const auto ax = mpp::mat<double>{ a * x };
+
+		auto rr = 0.0;
+		auto bb = 0.0;
+
+		for (auto row = std::size_t{}; row < b.rows(); ++row)
+		{
+			rr += (b(row, 0) - ax(row, 0)) * (b(row, 0) - ax(row, 0));
+			bb += b(row, 0) * b(row, 0);
+		}
+
+		return std::sqrt(rr / bb);
+	}
+} // namespace
+
+int main()
+{
+	using namespace boost::ut::bdd;
+	using namespace boost::ut;
+	using namespace mpp;
+
+	feature("Conjugate gradients") = []() {
+		const auto a = laplacian(20, 0.0, 0.0);
+		const auto b = numbered(400, 1, 1);
+
+		auto x            = mat<double>(400, 1, 0.0);
+		const auto result = cg(a, b, x);
+
+		expect(result.converged && result.iterations > 0_ul && result.iterations < 400_ul);
+		expect(result.residual <= 1e-10 && relative_residual(a, x, b) < 1e-9);
+
+		// The same iterations through a dense matrix and through a callable
+		const auto dense = mat<double>{ a };
+
+		auto dense_x            = mat<double>(400, 1, 0.0);
+		const auto dense_result = cg(dense, b, dense_x);
+
+		auto calls          = std::size_t{};
+		const auto callable = [&](std::span<const double> in, std::span<double> out) {
+			++calls;
+
+			for (auto row = std::size_t{}; row < 400; ++row)
+			{
+				out[row] = 0.0;
+
+				for (auto idx = a.offsets()[row]; idx < a.offsets()[row + 1]; ++idx)
+				{
+					out[row] += a.values()[idx] * in[a.indices()[idx]];
+				}
+			}
+		};
+
+		auto callable_x            = std::vector<double>(400);
+		const auto callable_result = cg(callable, b, callable_x);
+
+		expect(dense_result.iterations == result.iterations && callable_result.iterations == result.iterations);
+		expect(calls == result.iterations + 1);
+		expect(std::abs(dense_x(7, 0) - x(7, 0)) < 1e-9 && std::abs(callable_x[7] - x(7, 0)) < 1e-9);
+
+		// Starting from the solution takes no iterations, and a zero right hand side has the zero solution
+		expect(cg(a, b, x).iterations == 0_ul);
+
+		auto zero_x = mat<double>(400, 1, 1.0);
+		expect(cg(a, mat<double>(400, 1, 0.0), zero_x).converged && zero_x(5, 0) == 0.0_d);
+	};
+
+	feature("BiCGSTAB and GMRES") = []() {
+		const auto a   = laplacian(20, 0.5, 0.3);
+		const auto csc = sparse_mat<double, mpp::csc>{ a };
+		const auto b   = numbered(400, 1, 2);
+
+		auto x          = mat<double>(400, 1, 0.0);
+		const auto stab = bicgstab(a, b, x);
+
+		expect(stab.converged && stab.residual <= 1e-10 && relative_residual(a, x, b) < 1e-9);
+
+		auto csc_x = mat<double>(400, 1, 0.0);
+		expect(bicgstab(csc, b, csc_x).iterations == stab.iterations);
+
+		for (const auto restart : { std::size_t{ 5 }, std::size_t{ 30 }, std::size_t{ 400 } })
+		{
+			auto gmres_x      = mat<double>(400, 1, 0.0);
+			const auto result = gmres(a, b, gmres_x, krylov_options{ .restart = restart });
+
+			expect(result.converged && relative_residual(a, gmres_x, b) < 1e-9);
+		}
+
+		// Without restarts GMRES finds the exact solution of n unknowns in at most n iterations
+		const auto small = laplacian(4, 0.0, 0.7);
+		const auto rhs   = numbered(16, 1, 3);
+
+		auto small_x      = mat<double>(16, 1, 0.0);
+		const auto result = gmres(mat<double>{ small }, rhs, small_x, krylov_options{ .tolerance = 1e-13 });
+
+		expect(result.converged && result.iterations <= 16_ul);
+	};
+
+	feature("Workspaces and callbacks") = []() {
+		const auto a = laplacian(20, 0.0, 0.2);
+		const auto b = numbered(400, 1, 4);
+
+		const auto options = krylov_options{ .restart = 400 };
+
+		auto workspace  = krylov_workspace<double>(gmres_t::workspace_size(400, options));
+		const auto size = workspace.size();
+
+		// Without restarts, the residual of GMRES never grows
+		auto residuals    = std::vector<double>{};
+		auto x            = mat<double>(400, 1, 0.0);
+		const auto result = gmres(a, b, x, workspace, options, [&](std::size_t iteration, double residual) {
+			expect(iteration == residuals.size() + 1);
+			residuals.push_back(residual);
+		});
+
+		expect(result.converged && residuals.size() == result.iterations && workspace.size() == size);
+		expect(std::ranges::is_sorted(residuals, std::ranges::greater{}));
+
+		// Returning false stops the solver, and so does running out of iterations
+		std::ranges::fill(x, 0.0);
+
+		const auto stopped = bicgstab(a, b, x, workspace, krylov_options{}, [](std::size_t iteration, double) {
+			return iteration < 3;
+		});
+
+		expect(!stopped.converged && stopped.iterations == 3_ul);
+
+		std::ranges::fill(x, 0.0);
+
+		const auto capped = cg(laplacian(20, 0.0, 0.0), b, x, workspace, krylov_options{ .max_iterations = 5 });
+
+		expect(!capped.converged && capped.iterations == 5_ul && workspace.size() == size);
+	};
+
+	feature("Iterative solvers on several threads") = []() {
+		const auto a = laplacian(300, 1.0, 0.1);
+		const auto b = numbered(90000, 1, 5);
+
+		const auto solve_all = [&]() {
+			auto xs = std::vector<mat<double>>(3, mat<double>(90000, 1, 0.0));
+
+			static_cast<void>(cg(laplacian(300, 1.0, 0.0), b, xs[0]));
+			static_cast<void>(bicgstab(a, b, xs[1]));
+			static_cast<void>(gmres(a, b, xs[2]));
+
+			return xs;
+		};
+
+		const auto threads = max_threads();
+
+		set_max_threads(1);
+		const auto serial = solve_all();
+
+		set_max_threads(4);
+		const auto parallel = solve_all();
+
+		set_max_threads(threads);
+
+		// Reductions are split the same way whatever the number of threads, so the results are identical
+		for (auto idx = std::size_t{}; idx < 3; ++idx)
+		{
+			expect(std::ranges::equal(serial[idx], parallel[idx]));
+			expect(relative_residual(idx == 0 ? laplacian(300, 1.0, 0.0) : a, parallel[idx], b) < 1e-9);
+		}
+	};
+
+	feature("Preconditioners") = []() {
+		// Incomplete factorizations of a tridiagonal matrix have no fill-in to drop, so they're exact
+		auto triplets = std::vector<triplet<double>>{};
+
+		for (auto idx = std::size_t{}; idx < 50; ++idx)
+		{
+			triplets.push_back({ idx, idx, 2.5 });
+
+			if (idx > 0)
+			{
+				triplets.push_back({ idx, idx - 1, -1.0 });
+				triplets.push_back({ idx - 1, idx, -1.0 });
+			}
+		}
+
+		const auto tridiagonal = sparse_mat{ 50, 50, triplets };
+		const auto rhs         = numbered(50, 1, 6);
+
+		auto workspace = krylov_workspace<double>{};
+		auto x         = mat<double>(50, 1, 0.0);
+
+		auto z = mat<double>(50, 1);
+		ilu0_preconditioner{ tridiagonal }.apply(rhs, z);
+
+		expect(relative_residual(tridiagonal, z, rhs) < 1e-14);
+		expect(cg(tridiagonal, rhs, x, workspace, ic0_preconditioner{ tridiagonal }).iterations == 1_ul);
+
+		std::ranges::fill(x, 0.0);
+		expect(gmres(tridiagonal, rhs, x, workspace, ilu0_preconditioner{ tridiagonal }).iterations == 1_ul);
+
+		// And so is block Jacobi with a single block, or with blocks as big as those of a block diagonal matrix
+		std::ranges::fill(x, 0.0);
+		expect(gmres(tridiagonal, rhs, x, workspace, block_jacobi_preconditioner{ tridiagonal, 50 }).iterations ==
+			1_ul);
+
+		const auto blocks = mat<double>(18, 18, [idx = std::size_t{}]() mutable {
+			const auto row = idx / 18;
+			const auto col = idx++ % 18;
+
+			return row / 4 != col / 4 ? 0.0 : row == col ? 5.0 : static_cast<double>((row + 2 * col) % 5) - 2.0;
+		});
+
+		auto block_x = mat<double>(18, 1, 0.0);
+		expect(gmres(blocks, numbered(18, 1, 7), block_x, workspace, block_jacobi_preconditioner{ blocks, 4 })
+				   .iterations == 1_ul);
+
+		// Jacobi undoes the scaling of badly scaled matrices
+		const auto scaled = badly_scaled(20);
+		const auto b      = numbered(400, 1, 8);
+
+		auto scaled_x    = mat<double>(400, 1, 0.0);
+		const auto plain = cg(scaled, b, scaled_x, workspace).iterations;
+
+		std::ranges::fill(scaled_x, 0.0);
+		const auto jacobi = cg(scaled, b, scaled_x, workspace, jacobi_preconditioner{ scaled });
+
+		expect(jacobi.converged && jacobi.iterations < plain / 2);
+		expect(relative_residual(scaled, scaled_x, b) < 1e-9);
+
+		// Incomplete factorizations cut the iterations of a grid by a lot more
+		const auto grid   = laplacian(30, 0.0, 0.0);
+		const auto skewed = laplacian(30, 0.0, 0.4);
+		const auto grid_b = numbered(900, 1, 9);
+
+		auto grid_x           = mat<double>(900, 1, 0.0);
+		const auto grid_plain = cg(grid, grid_b, grid_x, workspace).iterations;
+
+		std::ranges::fill(grid_x, 0.0);
+		const auto grid_ic = cg(grid, grid_b, grid_x, workspace, ic0_preconditioner{ grid });
+
+		expect(grid_ic.converged && grid_ic.iterations < grid_plain / 2);
+		expect(relative_residual(grid, grid_x, grid_b) < 1e-9);
+
+		const auto ilu         = ilu0_preconditioner{ skewed };
+		const auto ilu_columns = ilu0_preconditioner{ sparse_mat<double, csc>{ skewed } };
+
+		for (const auto with_ilu : { false, true })
+		{
+			std::ranges::fill(grid_x, 0.0);
+			const auto stab = with_ilu ? bicgstab(skewed, grid_b, grid_x, workspace, ilu)
+									   : bicgstab(skewed, grid_b, grid_x, workspace);
+
+			expect(stab.converged && relative_residual(skewed, grid_x, grid_b) < 1e-9);
+
+			std::ranges::fill(grid_x, 0.0);
+			const auto restarted = with_ilu ? gmres(skewed, grid_b, grid_x, workspace, ilu_columns)
+											: gmres(skewed, grid_b, grid_x, workspace);
+
+			expect(restarted.converged && relative_residual(skewed, grid_x, grid_b) < 1e-9);
+		}
+
+		std::ranges::fill(grid_x, 0.0);
+		const auto stab_plain = bicgstab(skewed, grid_b, grid_x, workspace).iterations;
+		std::ranges::fill(grid_x, 0.0);
+		expect(bicgstab(skewed, grid_b, grid_x, workspace, ilu).iterations < stab_plain / 2);
+	};
+
+	feature("Level-scheduled triangular solves on several threads") = []() {
+		// Rows of the same anti-diagonal of the grid don't depend on each other
+		const auto a   = laplacian(300, 0.0, 0.3);
+		const auto ilu = ilu0_preconditioner{ a };
+		const auto ic  = ic0_preconditioner{ laplacian(300, 0.0, 0.0) };
+		const auto r   = numbered(90000, 1, 10);
+
+		expect(ilu.levels() == std::pair<std::size_t, std::size_t>{ 599, 599 } && ic.levels() == ilu.levels());
+
+		const auto apply_both = [&]() {
+			auto z = std::vector<double>(180000);
+
+			ilu.apply(r, std::span{ z }.first(90000));
+			ic.apply(r, std::span{ z }.last(90000));
+
+			return z;
+		};
+
+		const auto threads = max_threads();
+
+		set_max_threads(1);
+		const auto serial = apply_both();
+
+		set_max_threads(4);
+		const auto parallel = apply_both();
+
+		set_max_threads(threads);
+
+		expect(std::ranges::equal(serial, parallel));
+		expect(std::ranges::all_of(parallel, [](double val) {
+			return std::isfinite(val) && val != 0.0;
+		}));
+	};
+}
@@ -146,6 +146,17 @@ int main()
 		mut(mat).swap(mat_1);
 	} | mats;
 
+	feature(".reshape()") = [&](const auto& mat) {
+		mut(mat).reshape(3, 2);
+
+		expect(mat.rows() == 3_ul);
+		expect(mat.cols() == 2_ul);
+		expect(mat(1, 0) == 3_i);
+
+		// Reshape back for next tests
+		mut(mat).reshape(2, 3);
+	} | mats;
+
 	const auto alloc = std::allocator<int>{};
 
 	feature(".clear()") = [&](const auto& mat) {
@@ -0,0 +1,333 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/ut.hpp>
+
+#include <mpp/algo.hpp>
+#include <mpp/arith.hpp>
+#include <mpp/mat.hpp>
+#include <mpp/sparse.hpp>
+#include <mpp/util/cfg.hpp>
+#include <mpp/util/cmp.hpp>
+
+#include "../include/utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <compare>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace
+{
+	// Small integers at pseudo-random positions, duplicates included, so sums are exact in any order
+	[[nodiscard]] auto scattered(std::size_t rows, std::size_t cols, std::size_t count, std::size_t seed)
+		-> std::vector<mpp::triplet<double>>
+	{
+		auto triplets = std::vector<mpp::triplet<double>>{};
+		triplets.reserve(count);
+
+		auto state = seed;
+
+		for (auto idx = std::size_t{}; idx < count; ++idx)
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+
+			const auto row   = (state >> 33) % rows;
+			const auto col   = (state >> 13) % cols;
+			const auto value = static_cast<double>((state >> 50) % 9) - 4.0;
+
+			triplets.push_back({ row, col, value });
+		}
+
+		return triplets;
+	}
+
+	[[nodiscard]] auto dense_of(std::size_t rows, std::size_t cols, const std::vector<mpp::triplet<double>>& triplets)
+		-> mpp::mat<double>
+	{
+		auto obj = mpp::mat<double>(rows, cols, 0.0);
+
+		for (const auto& [row, col, value] : triplets)
+		{
+			obj(row, col) += value;
+		}
+
+		return obj;
+	}
+
+	[[nodiscard]] auto is_order(std::span<const std::size_t> perm) -> bool
+	{
+		auto sorted = std::vector(perm.begin(), perm.end());
+		std::ranges::sort(sorted);
+
+		for (auto idx = std::size_t{}; idx < sorted.size(); ++idx)
+		{
+			if (sorted[idx] != idx)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	template<typename Format>
+	void check_kernels(std::size_t rows, std::size_t cols, std::size_t count)
+	{
+		using namespace boost::ut;
+
+		const auto triplets = scattered(rows, cols, count, rows + count);
+		const auto dense    = dense_of(rows, cols, triplets);
+		const auto obj      = mpp::sparse_mat<double, Format>{ rows, cols, triplets };
+
+		for (const auto n : { std::size_t{ 1 }, std::size_t{ 3 }, std::size_t{ 17 } })
+		{
+			const auto right = numbered(cols, n, 1);
+			const auto left  = numbered(n, rows, 2);
+
+			expect(same_elems(mpp::mat<double>{ obj * right }, mpp::mat<double>{ dense * right }));
+			expect(same_elems(mpp::mat<double>{ left * obj }, mpp::mat<double>{ left * dense }));
+		}
+
+		const auto other = numbered(rows, cols, 3);
+
+		expect(same_elems(mpp::mat<double>{ obj + other }, mpp::mat<double>{ dense + other }));
+		expect(same_elems(mpp::mat<double>{ other - obj }, mpp::mat<double>{ other - dense }));
+		expect(same_elems(mpp::mat<double>{ obj - other }, mpp::mat<double>{ dense - other }));
+	}
+} // namespace
+
+int main()
+{
+	using namespace boost::ut::bdd;
+	using namespace boost::ut;
+	using namespace mpp;
+
+	feature("Assembling sparse matrices") = []() {
+		// Out of order, with a duplicate and an explicit zero
+		const auto triplets = std::vector<triplet<double>>{ { 2, 1, 4.0 },
+			{ 0, 3, 1.0 },
+			{ 2, 1, -1.5 },
+			{ 1, 0, 0.0 },
+			{ 0, 0, 2.0 } };
+
+		const auto rows_first = sparse_mat{ 3, 4, triplets };
+		const auto cols_first = sparse_mat<double, csc>{ 3, 4, triplets };
+
+		expect(rows_first.nnz() == 4_ul && cols_first.nnz() == 4_ul);
+		expect(std::vector(rows_first.offsets().begin(), rows_first.offsets().end()) ==
+			std::vector<std::size_t>{ 0, 2, 3, 4 });
+		expect(std::vector(rows_first.indices().begin(), rows_first.indices().end()) ==
+			std::vector<std::size_t>{ 0, 3, 0, 1 });
+		expect(rows_first(2, 1) == 2.5_d && rows_first(2, 2) == 0.0_d && cols_first(0, 3) == 1.0_d);
+
+		const auto expected = mat<double>{ { 2.0, 0.0, 0.0, 1.0 }, { 0.0, 0.0, 0.0, 0.0 }, { 0.0, 2.5, 0.0, 0.0 } };
+
+		expect(same_elems(mat<double>{ rows_first }, expected));
+		expect(same_elems(mat<double>{ cols_first }, expected));
+		expect(same_elems(mat<double, std::vector<double>, col_major>{ rows_first }, expected));
+
+		// Conversions keep the indices of every row or column increasing
+		const auto converted = sparse_mat<double, csc>{ rows_first };
+
+		expect(std::vector(converted.offsets().begin(), converted.offsets().end()) ==
+			std::vector(cols_first.offsets().begin(), cols_first.offsets().end()));
+		expect(std::vector(converted.indices().begin(), converted.indices().end()) ==
+			std::vector(cols_first.indices().begin(), cols_first.indices().end()));
+		expect(same_elems(mat<double>{ sparse_mat<double>{ converted } }, expected));
+
+		const auto empty = sparse_mat<double>{ 2, 3 };
+		expect(empty.nnz() == 0_ul && same_elems(mat<double>{ empty }, mat<double>(2, 3, 0.0)));
+
+		// Parallel assembly matches assembling serially
+		const auto many = scattered(500, 400, 100000, 7);
+		expect(same_elems(mat<double>{ sparse_mat{ 500, 400, many } }, dense_of(500, 400, many)));
+	};
+
+	feature("Sparse products, sums and differences") = []() {
+		check_kernels<csr>(40, 30, 120);
+		check_kernels<csc>(40, 30, 120);
+
+		const auto triplets = scattered(6, 5, 12, 3);
+		const auto a        = sparse_mat{ 6, 5, triplets };
+		const auto b        = sparse_mat<double, csc>{ 5, 6, scattered(5, 6, 12, 4) };
+
+		expect(same_elems(mat<double>{ a * b }, mat<double>{ dense_of(6, 5, triplets) * mat<double>{ b } }));
+		expect(same_elems(mat<double>{ a + a }, mat<double>{ dense_of(6, 5, triplets) * 2.0 }));
+
+		// Sparse operands inside bigger expressions
+		const auto x = numbered(5, 1, 5);
+		expect(same_elems(mat<double>{ a * x + numbered(6, 1, 6) },
+			mat<double>{ dense_of(6, 5, triplets) * x + numbered(6, 1, 6) }));
+
+		auto acc = numbered(6, 5, 7);
+		acc += a;
+		acc -= a;
+		acc -= a;
+		expect(same_elems(acc, mat<double>{ numbered(6, 5, 7) - dense_of(6, 5, triplets) }));
+	};
+
+	feature("Fill-reducing orderings") = []() {
+		const auto grid    = laplacian(30, 0.0, 0.0);
+		const auto natural = sparse_analyze(grid, fill_ordering::natural);
+		const auto amd       = sparse_analyze(grid);
+		const auto dissected = sparse_analyze(grid, fill_ordering::nested_dissection);
+
+		expect(is_order(natural.perm()) && is_order(amd.perm()) && is_order(dissected.perm()));
+		expect(amd.factor_nnz() < natural.factor_nnz() && dissected.factor_nnz() < natural.factor_nnz());
+
+		// Disconnected parts and empty rows are ordered too
+		const auto split = sparse_mat{ 300, 300, scattered(300, 300, 200, 9) };
+
+		expect(is_order(sparse_analyze(split, fill_ordering::nested_dissection).perm()));
+		expect(is_order(sparse_analyze(split, fill_ordering::amd).perm()));
+	};
+
+	feature("Sparse Cholesky and LU decompositions") = []() {
+		const auto b = numbered(400, 3, 1);
+
+		for (const auto ordering : { fill_ordering::natural, fill_ordering::amd, fill_ordering::nested_dissection })
+		{
+			const auto spd  = laplacian(20, 0.5, 0.0);
+			const auto skew = sparse_mat<double, csc>{ laplacian(20, 0.5, 0.3) };
+
+			const auto cholesky = sparse_cholesky(spd, ordering);
+			const auto factors  = sparse_lu(skew, ordering);
+
+			expect(near_elems(mat<double>{ spd * cholesky.solve(b) }, b, 1e-10));
+			expect(near_elems(mat<double>{ skew * factors.solve(b) }, b, 1e-10));
+
+			// Same pattern, so only the numeric phase runs again
+			auto scaled = skew;
+
+			for (auto& val : scaled.values())
+			{
+				val *= 2.0;
+			}
+
+			const auto refactored = sparse_lu(scaled, factors.symbolic());
+
+			expect(near_elems(mat<double>{ refactored.solve(b) * 2.0 }, factors.solve(b), 1e-10));
+
+			auto column  = std::vector<double>(400);
+			auto scratch = std::vector<double>(400);
+
+			for (auto row = std::size_t{}; row < 400; ++row)
+			{
+				column[row] = b(row, 0);
+			}
+
+			cholesky.solve_inplace(column, scratch);
+
+			const auto solved = cholesky.solve(b);
+			auto same_column  = true;
+
+			for (auto row = std::size_t{}; row < 400; ++row)
+			{
+				same_column = same_column && std::abs(column[row] - solved(row, 0)) < 1e-12;
+			}
+
+			expect(same_column);
+		}
+
+		// A dense block makes a supernode wider than a block of pivots
+		auto triplets = scattered(150, 150, 600, 11);
+
+		for (auto row = std::size_t{ 20 }; row < 120; ++row)
+		{
+			for (auto col = std::size_t{ 20 }; col < 120; ++col)
+			{
+				triplets.push_back({ row, col, row == col ? 400.0 : 0.25 });
+			}
+		}
+
+		for (auto idx = std::size_t{}; idx < 150; ++idx)
+		{
+			triplets.push_back({ idx, idx, 100.0 });
+		}
+
+		const auto dense_block = sparse_mat{ 150, 150, triplets };
+		const auto factors     = sparse_lu(dense_block);
+		const auto rhs         = numbered(150, 2, 3);
+
+		expect(factors.symbolic().supernodes() < 150_ul);
+		expect(near_elems(mat<double>{ dense_block * factors.solve(rhs) }, rhs, 1e-10));
+	};
+
+	feature("LU and inverses of sparse matrices") = []() {
+		const auto obj = laplacian(6, 0.0, 0.2);
+
+		const auto [l, u] = lu(obj);
+
+		expect(near_elems(mat<double>{ mat<double>{ l } * mat<double>{ u } }, mat<double>{ obj }, 1e-12));
+		expect(l(3, 3) == 1.0_d && l(2, 3) == 0.0_d && u(3, 2) == 0.0_d);
+
+		// An unsymmetric, irregular pattern whose elimination tree isn't in postorder already, so the factorization
+		// runs in another order than the natural one and L and U have to be mapped back
+		auto triplets = std::vector<triplet<double>>{};
+
+		for (auto idx = std::size_t{}; idx < 60; ++idx)
+		{
+			triplets.push_back({ idx, idx, 10.0 });
+			triplets.push_back({ idx, (idx * 7 + 3) % 60, 0.5 + static_cast<double>(idx) * 0.01 });
+			triplets.push_back({ (idx * 13 + 5) % 60, idx, -0.25 });
+		}
+
+		const auto irregular = sparse_mat{ 60, 60, triplets };
+		const auto symbolic  = sparse_analyze(irregular, fill_ordering::natural);
+
+		expect(not std::ranges::is_sorted(symbolic.perm()));
+
+		const auto [irregular_l, irregular_u] = lu(irregular);
+		const auto dense_l                    = mat<double>{ irregular_l };
+		const auto dense_u                    = mat<double>{ irregular_u };
+
+		expect(near_elems(mat<double>{ dense_l * dense_u }, mat<double>{ irregular }, 1e-12));
+
+		auto triangular = true;
+
+		for (auto row = std::size_t{}; row < 60; ++row)
+		{
+			triangular = triangular && dense_l(row, row) == 1.0;
+
+			for (auto col = row + 1; col < 60; ++col)
+			{
+				triangular = triangular && dense_l(row, col) == 0.0 && dense_u(col, row) == 0.0;
+			}
+		}
+
+		expect(triangular);
+
+		const auto inverse = inv(obj);
+
+		expect(near_elems(mat<double>{ inverse * mat<double>{ obj } }, mat<double>(36, 36, identity), 1e-12));
+	};
+
+	feature("Sparse kernels on several threads") = []() {
+		const auto threads = max_threads();
+		set_max_threads(4);
+
+		check_kernels<csr>(700, 600, 80000);
+		check_kernels<csc>(700, 600, 80000);
+
+		set_max_threads(threads);
+	};
+}
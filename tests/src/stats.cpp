@@ -0,0 +1,345 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/ut.hpp>
+
+#include <mpp/algo.hpp>
+#include <mpp/arith.hpp>
+#include <mpp/iterative.hpp>
+#include <mpp/mat.hpp>
+#include <mpp/sparse.hpp>
+#include <mpp/util/cfg.hpp>
+#include <mpp/util/stats.hpp>
+#include <mpp/util/trace.hpp>
+
+#include "../include/utils.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	[[nodiscard]] auto find_op(const std::vector<mpp::stats::op_stats>& snapshot, std::string_view name)
+		-> const mpp::stats::op_stats*
+	{
+		const auto found = std::ranges::find(snapshot, name, &mpp::stats::op_stats::name);
+		return found == snapshot.end() ? nullptr : &*found;
+	}
+} // namespace
+
+int main()
+{
+	using namespace boost::ut::bdd;
+	using namespace boost::ut;
+	using namespace mpp;
+
+	const auto a = mat<double>{ { 2, 1, 1 }, { 1, 3, 2 }, { 1, 0, 0 } };
+	const auto b = mat<double>{ { 1, 2, 3 }, { 4, 5, 6 }, { 7, 8, 9 } };
+
+	feature("Instrumentation is compiled in") = []() {
+		expect(constant<stats::enabled>);
+	};
+
+	feature("CPO calls") = [&]() {
+		stats::reset();
+
+		std::ignore = det(a);
+		std::ignore = det(a);
+		std::ignore = inv(a);
+
+		const auto snapshot   = stats::snapshot();
+		const auto* det_stats = find_op(snapshot, "det");
+		const auto* inv_stats = find_op(snapshot, "inv");
+
+		if (!expect(det_stats != nullptr))
+		{
+			return;
+		}
+
+		expect(det_stats->calls == 2_ull);
+		expect(det_stats->flops == 36.0_d);
+
+		// 3x3 is in the size class of [2, 3]
+		if (!expect(det_stats->shapes.size() == 1_ul))
+		{
+			return;
+		}
+
+		expect(det_stats->shapes[0].min_dim == 2_ul);
+		expect(det_stats->shapes[0].max_dim == 3_ul);
+		expect(det_stats->shapes[0].calls == 2_ull);
+
+		if (!expect(inv_stats != nullptr))
+		{
+			return;
+		}
+
+		expect(inv_stats->calls == 1_ull);
+	};
+
+	feature("Materialized expressions") = [&]() {
+		stats::reset();
+
+		const auto product = mat<double>{ a * b };
+		const auto sum     = mat<double>{ a + b };
+		const auto scaled  = mat<double>{ b * 2.0 };
+
+		const auto snapshot   = stats::snapshot();
+		const auto* mul_stats = find_op(snapshot, "operator*");
+		const auto* add_stats = find_op(snapshot, "operator+");
+		const auto* val_stats = find_op(snapshot, "operator* scalar");
+
+		if (!expect(mul_stats != nullptr))
+		{
+			return;
+		}
+
+		expect(mul_stats->calls == 1_ull);
+		expect(mul_stats->flops == 54.0_d);
+
+		if (!expect(add_stats != nullptr))
+		{
+			return;
+		}
+
+		expect(add_stats->flops == 9.0_d);
+
+		if (!expect(val_stats != nullptr))
+		{
+			return;
+		}
+
+		expect(val_stats->calls == 1_ull);
+
+		// Building an expression without materializing it isn't an operation yet
+		expect(find_op(snapshot, "operator-") == nullptr);
+	};
+
+	feature("Calls from other threads") = [&]() {
+		stats::reset();
+
+		auto threads = std::vector<std::thread>{};
+
+		for (auto idx = 0; idx < 4; ++idx)
+		{
+			threads.emplace_back([&]() {
+				for (auto call = 0; call < 10; ++call)
+				{
+					std::ignore = trps(b);
+				}
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		// The threads exited, but what they recorded stays
+		const auto snapshot    = stats::snapshot();
+		const auto* trps_stats = find_op(snapshot, "trps");
+
+		if (!expect(trps_stats != nullptr))
+		{
+			return;
+		}
+
+		expect(trps_stats->calls == 40_ull);
+	};
+
+	feature("Allocations") = [&]() {
+		using counted_buf_t = std::vector<double, stats::accounting_allocator<double>>;
+
+		stats::reset();
+
+		// det copies the 3x3 buffer once before factoring it in place
+		std::ignore = det(a);
+
+		const auto counted = mat<double, counted_buf_t>{ { 2, 1, 1 }, { 1, 3, 2 }, { 1, 0, 0 } };
+		std::ignore        = inv(counted);
+
+		const auto snapshot   = stats::snapshot();
+		const auto* det_stats = find_op(snapshot, "det");
+		const auto* inv_stats = find_op(snapshot, "inv");
+
+		if (!expect(det_stats != nullptr))
+		{
+			return;
+		}
+
+		expect(det_stats->allocs == 1_ull);
+		expect(det_stats->alloc_bytes == 72_ull);
+		expect(det_stats->peak_bytes == 72_ull);
+
+		if (!expect(inv_stats != nullptr))
+		{
+			return;
+		}
+
+		// The substitution buffers of every column and the counted result
+		expect(inv_stats->allocs > 1_ull);
+		expect(inv_stats->peak_bytes >= 72_ull);
+		expect(inv_stats->peak_bytes < inv_stats->alloc_bytes);
+	};
+
+	feature("Latency percentiles") = [&]() {
+		stats::reset();
+
+		for (auto call = 0; call < 200; ++call)
+		{
+			std::ignore = det(a);
+		}
+
+		const auto snapshot   = stats::snapshot();
+		const auto* det_stats = find_op(snapshot, "det");
+
+		if (!expect(det_stats != nullptr))
+		{
+			return;
+		}
+
+		const auto& latency = det_stats->latency;
+
+		expect(latency.p50.count() > 0_ll);
+		expect(latency.p50 <= latency.p99);
+		expect(latency.p99 <= latency.p999);
+
+		// Every call took at most the time of all of them, give or take the width of a bucket
+		expect(latency.p999 <= det_stats->time * 17 / 16);
+
+		// Only one size class was called, so its percentiles are those of the op
+		if (!expect(det_stats->shapes.size() == 1_ul))
+		{
+			return;
+		}
+
+		expect(det_stats->shapes[0].latency.p50 == latency.p50);
+		expect(det_stats->shapes[0].latency.p999 == latency.p999);
+
+		// Reset histograms don't leak into the percentiles of later calls, with a single call they're all its latency
+		stats::reset();
+		std::ignore = det(a);
+
+		const auto single_snapshot = stats::snapshot();
+		const auto* single_stats   = find_op(single_snapshot, "det");
+
+		if (!expect(single_stats != nullptr))
+		{
+			return;
+		}
+
+		expect(single_stats->latency.p50 == single_stats->latency.p999);
+		expect(single_stats->latency.p999 <= single_stats->time * 17 / 16);
+	};
+
+	feature("Traces") = []() {
+		trace::clear();
+
+		// Big enough for lu_algo to go through 2 panels and for the product to be blocked
+		const auto big = mat<double>(100, 100, [i = 0]() mutable {
+			++i;
+			return i % 101 == 1 ? 100.0 : 1.0 / i;
+		});
+
+		std::ignore        = det(big);
+		const auto product = mat<double>{ big * big };
+
+		auto out = std::stringstream{};
+		trace::write(out);
+
+		const auto json = out.str();
+
+		expect(json.starts_with(R"({"displayTimeUnit": "ns", "traceEvents": [)"));
+		expect(json.ends_with("]}\n"));
+		expect(json.find(R"("name": "det", "ph": "X")") != std::string::npos);
+		expect(json.find(R"("name": "lu panel", "ph": "X")") != std::string::npos);
+		expect(json.find(R"("args": {"first_row": 64, "rows": 100, "cols": 100})") != std::string::npos);
+		expect(json.find(R"("name": "operator*", "ph": "X")") != std::string::npos);
+		expect(json.find(R"("name": "gemm block", "ph": "X")") != std::string::npos);
+
+		trace::clear();
+		out.str("");
+		trace::write(out);
+
+		expect(out.str().find(R"("ph": "X")") == std::string::npos);
+	};
+
+	feature("Reset") = [&]() {
+		std::ignore = det(a);
+		stats::reset();
+
+		expect(stats::snapshot().empty());
+	};
+
+	feature("Solves reusing a workspace") = []() {
+		const auto threads = max_threads();
+		set_max_threads(8);
+
+		// Big enough for the sparse products to run on several threads, where compressed columns sum partial products
+		const auto csr_a = laplacian(150, 0.0, 0.0);
+		const auto csc_a = sparse_mat<double, csc>{ csr_a };
+		const auto b     = numbered(csr_a.rows(), 1, 5);
+		const auto limit = krylov_options{ .max_iterations = 20, .restart = 10 };
+
+		const auto check = [&](const auto& a) {
+			auto workspace = krylov_workspace<double>(cg_t::workspace_size(a, a.rows()));
+			auto x         = mat<double>(a.rows(), 1, 0.0);
+
+			// The first solves grow the workspace to the biggest of them
+			std::ignore = bicgstab(a, b, x, workspace, limit);
+			std::ignore = gmres(a, b, x, workspace, limit);
+
+			stats::reset();
+
+			for (auto solve = 0; solve < 2; ++solve)
+			{
+				std::ranges::fill(x, 0.0);
+				std::ignore = cg(a, b, x, workspace, limit);
+				std::ranges::fill(x, 0.0);
+				std::ignore = bicgstab(a, b, x, workspace, limit);
+				std::ranges::fill(x, 0.0);
+				std::ignore = gmres(a, b, x, workspace, limit);
+			}
+
+			const auto snapshot = stats::snapshot();
+
+			for (const auto* name : { "cg", "bicgstab", "gmres" })
+			{
+				const auto* solver_stats = find_op(snapshot, name);
+
+				if (expect(solver_stats != nullptr) << name)
+				{
+					expect(solver_stats->allocs == 0_ull) << name;
+				}
+			}
+		};
+
+		check(csr_a);
+		check(csc_a);
+
+		set_max_threads(threads);
+	};
+
+	return 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+
+ *   http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <boost/ut.hpp>
+
+#include <mpp/algo.hpp>
+#include <mpp/arith.hpp>
+#include <mpp/io.hpp>
+#include <mpp/mat.hpp>
+#include <mpp/util/cmp.hpp>
+
+#include "../include/utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <compare>
+#include <cstddef>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// Size of a square matrix and of its tiles
+	using tiling = std::pair<std::size_t, std::size_t>;
+} // namespace
+
+int main()
+{
+	using namespace boost::ut::bdd;
+	using namespace boost::ut;
+	using namespace mpp;
+
+	feature("Tiled files") = []() {
+		const auto path     = temp_path("tiles.bin");
+		const auto expected = numbered(37, 23, 1);
+
+		// Edge tiles are partial in both directions
+		auto file = save_tiled(path, expected, 8);
+
+		expect(file.row_tiles() == 5_ul && file.col_tiles() == 3_ul);
+		expect(file.tile_rows(4) == 5_ul && file.tile_cols(2) == 7_ul);
+		expect(same_elems(load_tiled(file), expected));
+		expect(same_elems(load_tiled<double, col_major>(tiled_file<double>::open(path)), expected));
+
+		const auto info = read_binary_info(path);
+		expect(info.rows == 37_ul && info.cols == 23_ul && info.tile_size == 8_ul);
+
+		// Tiles are written in place
+		auto tile = std::vector<double>(file.tile_elems(), 0.0);
+		tile[1]   = 100.0;
+
+		auto writable = tiled_file<double>::open(path, file_access::read_write);
+		writable.write_tile(1, 2, tile.data());
+
+		// Files opened for reading only refuse writes
+		auto read_only = tiled_file<double>::open(path);
+
+		expect(read_only.access() == file_access::read && writable.access() == file_access::read_write);
+		expect(throws<std::runtime_error>([&]() {
+			read_only.write_tile(0, 0, tile.data());
+		}));
+
+		auto changed = mat<double>{ expected };
+
+		for (auto row = std::size_t{ 8 }; row < 16; ++row)
+		{
+			for (auto col = std::size_t{ 16 }; col < 23; ++col)
+			{
+				changed(row, col) = row == 8 && col == 17 ? 100.0 : 0.0;
+			}
+		}
+
+		expect(same_elems(load_tiled(file), changed));
+
+		// Tiled and untiled files can't be mistaken for each other
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = load_binary<double>(path);
+		}));
+
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = tiled_file<float>::open(path);
+		}));
+
+		save_binary(path, expected);
+
+		expect(throws<std::runtime_error>([&]() {
+			std::ignore = tiled_file<double>::open(path);
+		}));
+
+		std::filesystem::remove(path);
+	};
+
+	feature("Out-of-core products") = []() {
+		const auto a_path   = temp_path("a.bin");
+		const auto b_path   = temp_path("b.bin");
+		const auto out_path = temp_path("out.bin");
+
+		const auto a        = numbered(45, 30, 1);
+		const auto b        = numbered(30, 50, 2);
+		const auto expected = mat<double>{ a * b };
+
+		const auto a_file = save_tiled(a_path, a, 8);
+		const auto b_file = save_tiled(b_path, b, 8);
+
+		// From one tile of each panel at a time to everything at once
+		for (const auto max_memory : { 5 * 64 * sizeof(double), 30 * 64 * sizeof(double), default_tiled_memory })
+		{
+			auto out = tiled_file<double>::create(out_path, 45, 50, 8);
+			tiled_mul(a_file, b_file, out, max_memory);
+
+			expect(same_elems(load_tiled(out), expected));
+		}
+
+		// Budgets that can't hold the smallest step are rejected instead of exceeded
+		for (const auto max_memory : { std::size_t{}, 5 * 64 * sizeof(double) - 1 })
+		{
+			auto out = tiled_file<double>::create(out_path, 45, 50, 8);
+
+			expect(throws<std::invalid_argument>([&]() {
+				tiled_mul(a_file, b_file, out, max_memory);
+			}));
+		}
+
+		// Products of empty inner dimensions are zeros
+		const auto empty_a = save_tiled(a_path, mat<double>(3, 0), 2);
+		const auto empty_b = save_tiled(b_path, mat<double>(0, 5), 2);
+
+		auto out = save_tiled(out_path, numbered(3, 5, 3), 2);
+		tiled_mul(empty_a, empty_b, out);
+
+		expect(same_elems(load_tiled(out), mat<double>(3, 5, 0.0)));
+
+		std::filesystem::remove(a_path);
+		std::filesystem::remove(b_path);
+		std::filesystem::remove(out_path);
+	};
+
+	feature("Out-of-core LU decompositions") = []() {
+		const auto path = temp_path("lu.bin");
+
+		// Diagonally dominant, so the unpivoted decomposition is stable
+		for (const auto& [size, tile_size] : { tiling{ 45, 8 }, tiling{ 32, 8 }, tiling{ 5, 8 } })
+		{
+			auto obj = numbered(size, size, 4);
+
+			for (auto idx = std::size_t{}; idx < size; ++idx)
+			{
+				obj(idx, idx) += 10.0 * static_cast<double>(size);
+			}
+
+			const auto [l, u] = lu(obj);
+
+			auto expected = mat<double>{ u };
+
+			for (auto row = std::size_t{}; row < size; ++row)
+			{
+				for (auto col = std::size_t{}; col < row; ++col)
+				{
+					expected(row, col) = l(row, col);
+				}
+			}
+
+			auto file = save_tiled(path, obj, tile_size);
+			tiled_lu(file);
+
+			expect(near_elems(load_tiled(file), expected, 1e-9));
+		}
+
+		std::filesystem::remove(path);
+	};
+
+	feature("Out-of-core Cholesky decompositions") = []() {
+		const auto path = temp_path("cholesky.bin");
+
+		for (const auto& [size, tile_size] : { tiling{ 45, 8 }, tiling{ 16, 16 } })
+		{
+			// M * M^T + n * I is symmetric positive definite
+			const auto factor = numbered(size, size, 5);
+			auto obj          = mat<double>{ factor * trps(factor) };
+
+			for (auto idx = std::size_t{}; idx < size; ++idx)
+			{
+				obj(idx, idx) += static_cast<double>(size);
+			}
+
+			// Only the lower triangle is read, the tiles above the diagonal are left as they are
+			auto file = save_tiled(path, obj, tile_size);
+
+			for (auto tile_row = std::size_t{}; tile_row < file.row_tiles(); ++tile_row)
+			{
+				for (auto tile_col = tile_row + 1; tile_col < file.col_tiles(); ++tile_col)
+				{
+					auto tile = std::vector<double>(file.tile_elems(), 7.0);
+					file.write_tile(tile_row, tile_col, tile.data());
+				}
+			}
+
+			tiled_cholesky(file);
+
+			auto l          = load_tiled(file);
+			auto upper_kept = true;
+
+			for (auto row = std::size_t{}; row < size; ++row)
+			{
+				for (auto col = row + 1; col < size; ++col)
+				{
+					upper_kept = upper_kept && l(row, col) == (row / tile_size == col / tile_size ? 0.0 : 7.0);
+					l(row, col) = 0.0;
+				}
+			}
+
+			expect(upper_kept);
+			expect(near_elems(mat<double>{ l * trps(l) }, obj, 1e-8));
+		}
+
+		std::filesystem::remove(path);
+	};
+
+	return 0;
+}
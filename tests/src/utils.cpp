@@ -19,15 +19,25 @@
 
 #include <boost/ut.hpp>
 
+#include <mpp/detail/util/thread_pool.hpp>
 #include <mpp/mat.hpp>
 #include <mpp/util.hpp>
+#include <mpp/util/cfg.hpp>
 
 #include "../include/utils.hpp"
 
+#include <atomic>
+#include <chrono>
 #include <compare>
 #include <concepts>
 #include <cstddef>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 using namespace boost::ut::bdd;
 using namespace boost::ut;
@@ -35,6 +45,15 @@ using namespace mpp;
 
 namespace
 {
+	template<typename... Args>
+	[[nodiscard]] auto printed(const Args&... args) -> std::string
+	{
+		auto out = std::ostringstream{};
+		print(out, args...);
+
+		return out.str();
+	}
+
 	template<typename Mats, typename Order>
 	void test_cmp_elems(std::string_view test_name)
 	{
@@ -63,5 +82,97 @@ int main()
 			"utils/cmp_elems/4x4_4x4.txt");
 	};
 
+	feature("Printing") = []() {
+		expect(printed(mat<int>{ { 1, -2 }, { 3, 4 } }) == "1 -2\n3 4");
+		expect(printed(mat<int>{}) == "[empty matrix]\n");
+		expect(printed(mat<double, std::vector<double>, col_major>{ { 0.5, 1e-300 } }) == "0.5 1e-300");
+
+		// Six significant digits by default like streams, 0 for the shortest form that round trips
+		const auto thirds = mat<double>{ { 1.0 / 3.0, 2.0 / 3.0 } };
+
+		expect(printed(thirds) == "0.333333 0.666667");
+		expect(printed(thirds, print_options{ .precision = 3 }) == "0.333 0.667");
+		expect(printed(thirds, print_options{ .precision = 0 }) == "0.3333333333333333 0.6666666666666666");
+
+		auto stream = std::ostringstream{};
+		stream.precision(2);
+		stream << thirds;
+
+		expect(stream.str() == "0.33 0.67");
+
+		// Other formatting of the stream applies to every element, like it would if they were streamed one by one
+		const auto streamed = [](const auto& obj, auto&&... manips) {
+			auto out = std::ostringstream{};
+			(out << ... << manips) << obj;
+
+			return out.str();
+		};
+
+		expect(streamed(thirds, std::fixed, std::setprecision(2)) == "0.33 0.67");
+		expect(streamed(mat<double>{ { 1500.0, 0.25 } }, std::scientific, std::setprecision(1)) == "1.5e+03 2.5e-01");
+		expect(streamed(mat<int>{ { 1, -2 }, { 30, 4 } }, std::setw(3)) == "  1  -2\n 30   4");
+		expect(streamed(mat<int>{ { 1, -2 } }, std::showpos) == "+1 -2");
+		expect(streamed(mat<int>{ { 10, 255 } }, std::hex) == "a ff");
+
+		// The width is used up like by any other output
+		stream.str({});
+		stream << std::setw(4) << mat<int>{ { 1 } } << 2;
+
+		expect(stream.str() == "   12");
+
+		// Only the edges of dimensions bigger than twice edge_items are printed
+		auto big = mat<int>{ 5, 6, 0 };
+
+		for (auto row = std::size_t{}; row < big.rows(); ++row)
+		{
+			for (auto col = std::size_t{}; col < big.cols(); ++col)
+			{
+				big(row, col) = static_cast<int>(row * 10 + col);
+			}
+		}
+
+		const auto elided = std::string{ "0 1 ... 4 5\n10 11 ... 14 15\n...\n30 31 ... 34 35\n40 41 ... 44 45" };
+
+		expect(printed(big, print_options{ .edge_items = 2 }) == elided);
+		expect(printed(big, print_options{ .edge_items = 3 }) == printed(big));
+	};
+
+	feature("Exceptions in parallel tasks") = []() {
+		const auto threads = max_threads();
+		set_max_threads(4);
+
+		// Whichever thread throws, the exception reaches the caller once no task is running anymore
+		for (const auto throwing : { std::size_t{ 0 }, std::size_t{ 50 }, std::size_t{ 99 } })
+		{
+			auto running = std::atomic<int>{};
+
+			expect(throws<std::runtime_error>([&]() {
+				mpp::detail::parallel_for(100, [&](std::size_t task) {
+					++running;
+					std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+					--running;
+
+					if (task == throwing)
+					{
+						throw std::runtime_error("task failed");
+					}
+				});
+			}));
+
+			expect(running.load() == 0_i);
+		}
+
+		// The pool still runs jobs afterwards
+		auto sum = std::atomic<std::size_t>{};
+
+		mpp::detail::parallel_for(100, [&](std::size_t task) {
+			sum += task;
+		});
+
+		expect(sum.load() == 4950_ul);
+
+		set_max_threads(threads);
+	};
+
 	return 0;
 }